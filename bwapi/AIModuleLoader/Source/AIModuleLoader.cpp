@@ -32,6 +32,9 @@ int main(int argc, const char* argv[])
     std::getline(std::cin, dllPath);
   }
   
+  // The module links its own copy of the map analysis, so this one is never used
+  MapAnalysis::enableLazyBuild();
+
   std::cout << "Connecting..." << std::endl;
 
   assert(BWAPIClient.isConnected() == false);
@@ -154,7 +157,14 @@ int main(int argc, const char* argv[])
       }
     }
     delete client;
-    FreeLibrary(hMod);
+    if ( hMod )
+    {
+      typedef void (*PFNGameEnd)();
+      PFNGameEnd endGame = (PFNGameEnd)GetProcAddress(hMod, "gameEnd");
+      if ( endGame )
+        endGame();
+      FreeLibrary(hMod);
+    }
     std::cout << "Game ended" << std::endl;
   }
   std::cout << "Press ENTER to continue..." << std::endl;
@@ -7,6 +7,7 @@
 
 #include <BWAPI/PlayerImpl.h>
 #include <BWAPI/RegionImpl.h>
+#include <BWAPI/MapAnalysis.h>
 
 #include "../../../svnrev.h"
 #include "../../../Debug.h"
@@ -28,6 +29,13 @@ namespace BWAPI
     // pre-calculate the map hash
     Map::calculateMapHash();
 
+    // cache the map size for Position validity checks
+    MapBounds::set(Map::getWidth(), Map::getHeight());
+    this->powerGrid.reset(Map::getWidth(), Map::getHeight());
+
+    // start tracking tile changes from an empty map
+    Map::clearSharedMemory();
+
     // Obtain Broodwar Regions
     if ( *BW::BWDATA::SAIPathing )
     {
@@ -39,6 +47,32 @@ namespace BWAPI
       // Iterate regions again and update neighbor lists
       for ( BWAPI::Region r : this->regionsList )
         static_cast<RegionImpl*>(r)->UpdateRegionRelations();
+
+      // Flatten the regions and the region of each walk tile
+      RegionGraph::Input graphInput;
+      graphInput.width = Map::getWidth() * 4;
+      graphInput.height = Map::getHeight() * 4;
+      graphInput.regionIds.resize(static_cast<size_t>(graphInput.width) * graphInput.height);
+      graphInput.walkable.resize(graphInput.regionIds.size());
+      for ( int y = 0; y < graphInput.height; ++y )
+      {
+        for ( int x = 0; x < graphInput.width; ++x )
+        {
+          BWAPI::Region r = this->getRegionAt(x * 8, y * 8);
+          graphInput.regionIds[y * graphInput.width + x] = r ? r->getID() : -1;
+          graphInput.walkable[y * graphInput.width + x] = this->isWalkable(x, y);
+        }
+      }
+      graphInput.nodes.resize(rgnCount);
+      for ( BWAPI::Region r : this->regionsList )
+      {
+        const RegionData *data = static_cast<RegionImpl*>(r)->getData();
+        RegionGraph::Node &node = graphInput.nodes[data->id];
+        node.center = Position(data->center_x, data->center_y);
+        node.groupId = data->islandID;
+        node.neighbors.assign(data->neighbors, data->neighbors + data->neighborCount);
+      }
+      this->regionGraph.build(graphInput);
     } // if SAI_Pathing
 
     // roughly identify which players can possibly participate in this game
@@ -414,6 +448,9 @@ namespace BWAPI
     this->endTick       = GetTickCount();
     this->onStartCalled = false;
 
+    MapBounds::reset();
+    MapAnalysis::onMatchEnd();
+
     this->initializeData();
     this->chooseNewRandomMap();
   }
@@ -24,6 +24,7 @@
 #include <BWAPI/UnaryFilter.h>
 
 #include <BWAPI/Unitset.h>
+#include <BWAPI/DistanceBatch.h>
 
 #include <BW/CUnit.h>
 #include <BW/CBullet.h>
@@ -295,9 +296,11 @@ namespace BWAPI
   }
   Unit GameImpl::getClosestUnitInRectangle(Position center, const UnitFilter &pred, int left, int top, int right, int bottom) const
   {
-    // cppcheck-suppress variableScope
-    int bestDistance = 99999999;
-    Unit pBestUnit = nullptr;
+    // Gather the candidates, then compute all of their distances in one batch. The batch is
+    // borrowed from the member so that its buffers are reused between calls, and a predicate
+    // that makes another query gets a batch of its own.
+    DistanceBatch candidates(std::move(closestUnitCandidates));
+    candidates.clear();
 
     Templates::iterateUnitFinder<BW::unitFinder>( BW::BWDATA::UnitOrderingX.data(),
                                                   BW::BWDATA::UnitOrderingY.data(),
@@ -307,16 +310,10 @@ namespace BWAPI
                                                   right,
                                                   bottom,
                                                   [&](Unit u){ if ( !pred.isValid() || pred(u) )
-                                                                {
-                                                                  int newDistance = u->getDistance(center);
-                                                                  if ( newDistance < bestDistance )
-                                                                  {
-                                                                    pBestUnit = u;
-                                                                    // cppcheck-suppress unreadVariable
-                                                                    bestDistance = newDistance;
-                                                                  }
-                                                                } } );
-    return pBestUnit;
+                                                                  candidates.add(u); });
+    Unit pClosestUnit = candidates.getClosestUnit(center);
+    closestUnitCandidates = std::move(candidates);
+    return pClosestUnit;
   }
   Unit GameImpl::getBestUnit(const BestUnitFilter &best, const UnitFilter &pred, Position center, int radius) const
   {
@@ -414,10 +411,25 @@ namespace BWAPI
       return false;
     return Map::hasCreep(x, y);
   }
+  //--------------------------------------------- IS TILE CHANGED --------------------------------------------
+  bool GameImpl::isTileChanged(int x, int y, TileLayer::Enum layer) const
+  {
+    if ( !TilePosition(x, y) || layer < 0 || layer >= TileLayer::Max )
+      return false;
+    return (server.data->tileChanges[layer][y][x / 32] & (1u << (x % 32))) != 0;
+  }
+  const TilePosition::list &GameImpl::getChangedTileBlocks() const
+  {
+    return changedTileBlocks;
+  }
   //--------------------------------------------- HAS POWER --------------------------------------------------
   bool GameImpl::hasPowerPrecise(int x, int y, UnitType unitType) const
   {
-    return Templates::hasPower(x, y, unitType, pylons);
+    return Templates::hasPower(x, y, unitType, powerGrid);
+  }
+  const PowerGrid &GameImpl::getPowerGrid() const
+  {
+    return powerGrid;
   }
   //------------------------------------------------- PRINTF -------------------------------------------------
   void GameImpl::vPrintf(const char *format, va_list arg)
@@ -890,6 +902,10 @@ namespace BWAPI
     /// @TODO Don't store data in a BW region
     return reinterpret_cast<Region>(rgn->unk_28);
   }
+  const RegionGraph &GameImpl::getRegionGraph() const
+  {
+    return this->regionGraph;
+  }
   int GameImpl::getLastEventTime() const
   {
     return this->lastEventTime;
@@ -8,6 +8,8 @@
 #include <BWAPI/Game.h>
 #include <BWAPI/Server.h>
 #include <BWAPI/Map.h>
+#include <BWAPI/PowerGrid.h>
+#include <BWAPI/RegionGraph.h>
 #include <BWAPI/Client/GameData.h>
 #include <BWAPI/TournamentAction.h>
 #include <BWAPI/CoordinateType.h>
@@ -102,7 +104,10 @@ namespace BWAPI
       virtual bool  isVisible(int x, int y) const override;
       virtual bool  isExplored(int x, int y) const override;
       virtual bool  hasCreep(int x, int y) const override;
+      virtual bool  isTileChanged(int x, int y, TileLayer::Enum layer) const override;
+      virtual const TilePosition::list &getChangedTileBlocks() const override;
       virtual bool  hasPowerPrecise(int x, int y, UnitType unitType = UnitTypes::None ) const override;
+      virtual const PowerGrid &getPowerGrid() const override;
 
       virtual bool  canBuildHere(TilePosition position, UnitType type, Unit builder = nullptr, bool checkExplored = false) override;
       virtual bool  canMake(UnitType type, Unit builder = nullptr) const override;
@@ -171,6 +176,7 @@ namespace BWAPI
 
       virtual const Regionset &getAllRegions() const override;
       virtual BWAPI::Region   getRegionAt(int x, int y) const override;
+      virtual const RegionGraph &getRegionGraph() const override;
 
       virtual int getLastEventTime() const override;
 
@@ -315,13 +321,15 @@ namespace BWAPI
       Unitset       neutralUnits;
       Bulletset     bullets;
       Position::list nukeDots;
-      Unitset pylons;
+      PowerGrid powerGrid;
+      TilePosition::list changedTileBlocks;
 
       Unitset staticMinerals;
       Unitset staticGeysers;
       Unitset staticNeutralUnits;
 
       Regionset regionsList;
+      RegionGraph regionGraph;
 
       BulletImpl* bulletArray[BULLET_ARRAY_MAX_LENGTH];
       std::vector< std::vector<Command *> > commandBuffer;
@@ -339,6 +347,7 @@ namespace BWAPI
       TournamentModule  *tournamentController;
       bool              bTournamentMessageAppeared;
       mutable BWAPI::Error lastError;
+      mutable DistanceBatch closestUnitCandidates;
       Unitset deadUnits;    // Keeps track of units that were removed from the game, used only to deallocate them
       u32 cheatFlags;
       std::string autoMenuLanMode;
@@ -298,6 +298,15 @@ namespace BWAPI
   void GameImpl::copyMapToSharedMemory()
   {
     Map::copyToSharedMemory();
+
+    const int blocksPerRow = 256 / TileLayer::BlockSize;
+    GameData *data = server.data;
+    changedTileBlocks.clear();
+    for ( int i = 0; i < data->changedTileBlockCount; ++i )
+    {
+      int block = data->changedTileBlocks[i];
+      changedTileBlocks.emplace_back(block % blocksPerRow * TileLayer::BlockSize, block / blocksPerRow * TileLayer::BlockSize);
+    }
   }
 
   //------------------------------------------- INTERFACE EVENT UPDATE ---------------------------------------
@@ -380,7 +389,8 @@ namespace BWAPI
     this->geysers.clear();
     this->neutralUnits.clear();
     this->bullets.clear();
-    this->pylons.clear();
+    this->powerGrid.clear();
+    this->changedTileBlocks.clear();
     this->staticMinerals.clear();
     this->staticGeysers.clear();
     this->staticNeutralUnits.clear();
@@ -416,6 +426,7 @@ namespace BWAPI
     for ( Regionset::iterator r = this->regionsList.begin(); r != this->regionsList.end(); ++r )
       delete static_cast<RegionImpl*>(*r);
     this->regionsList.clear();
+    this->regionGraph.clear();
 
     // Reset game speeds and text size
     this->setLocalSpeedDirect(this->speedOverride);
@@ -474,6 +485,9 @@ namespace BWAPI
     this->averageFPS = 0;
     this->accumulatedFrames = 0;
 
+    // Optional export of a module, called before its library is unloaded
+    typedef void (*PFNGameEnd)();
+
     // @NOTE: Freeing libraries comes after because of some destructors for functionals in Interface Events
 
     // Destroy the AI Module client
@@ -486,6 +500,10 @@ namespace BWAPI
     // Unload the AI Module library
     if ( hAIModule )
     {
+      // Let the module release what it still owns, such as the threads of its map analysis
+      PFNGameEnd endGame = (PFNGameEnd)GetProcAddress(hAIModule, "gameEnd");
+      if ( endGame )
+        endGame();
       FreeLibrary(hAIModule);
       hAIModule = nullptr;
     }
@@ -509,6 +527,9 @@ namespace BWAPI
     // Destroy the Tournament Module Library
     if ( hTournamentModule )
     {
+      PFNGameEnd endGame = (PFNGameEnd)GetProcAddress(hTournamentModule, "gameEnd");
+      if ( endGame )
+        endGame();
       FreeLibrary(hTournamentModule);
       hTournamentModule = nullptr;
     }
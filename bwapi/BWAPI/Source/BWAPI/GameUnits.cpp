@@ -165,6 +165,8 @@ namespace BWAPI
         {
           events.push_back(Event::UnitComplete(u));
           u->wasCompleted = true;
+          if ( u->getPlayer() == Broodwar->self() && u->getType() == UnitTypes::Protoss_Pylon )
+            powerGrid.addPylon(u->getID(), u->getPosition());
         }
         if ( !u->wasAccessible )
         {
@@ -212,6 +214,7 @@ namespace BWAPI
         evadeUnits.insert(u);
         events.push_back(Event::UnitEvade(u));
         events.push_back(Event::UnitDestroy(u));
+        powerGrid.removePylon(u->getID());
       }
     }
   }
@@ -317,7 +320,7 @@ namespace BWAPI
   }
   void GameImpl::computeSecondaryUnitSets()
   {
-    // This function computes units on tile, player units, neutral units, minerals, geysers, pylons, and static unit sets
+    // This function computes units on tile, player units, neutral units, minerals, geysers, and static unit sets
     // Also generates the UnitMorph and UnitRenegade callbacks
 
     for(Player p : players)
@@ -350,11 +353,6 @@ namespace BWAPI
         else if ( type == UnitTypes::Resource_Vespene_Geyser )
           geysers.insert(u);
       }
-      else
-      {
-        if ( unitPlayer == Broodwar->self() && type == UnitTypes::Protoss_Pylon )
-          pylons.insert(u);
-      }
     }
     for(Unit u : evadeUnits)
     {
@@ -375,10 +373,6 @@ namespace BWAPI
         else if ( type == UnitTypes::Resource_Vespene_Geyser )
           geysers.erase(u);
       }
-      else if ( unitPlayer == Broodwar->self() && type == UnitTypes::Protoss_Pylon )
-      {
-        pylons.erase(u);
-      }
     }
 
     for(Unit ui : accessibleUnits)
@@ -403,6 +397,12 @@ namespace BWAPI
         events.push_back(Event::UnitRenegade(u));
         static_cast<PlayerImpl*>(u->lastPlayer)->units.erase(u);
         static_cast<PlayerImpl*>(u->_getPlayer)->units.insert(u);
+
+        // A pylon that changes owner powers the grid of the new owner only
+        if ( u->_getPlayer == Broodwar->self() && u->_getType == UnitTypes::Protoss_Pylon && u->isCompleted() )
+          powerGrid.addPylon(u->getID(), u->getPosition());
+        else
+          powerGrid.removePylon(u->getID());
       }
       int allUnits  = UnitTypes::AllUnits;
       int men       = UnitTypes::Men;
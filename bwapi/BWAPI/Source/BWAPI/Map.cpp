@@ -55,43 +55,78 @@ namespace BWAPI
   {
     return std::string{ BW::BWDATA::CurrentMapName };
   }
+  //------------------------------------------ COPY TO SHARED MEMORY -----------------------------------------
   void Map::copyToSharedMemory()
   {
     const int width = getWidth();
     const int height = getHeight();
+    const int blocksPerRow = 256 / TileLayer::BlockSize;
 
     GameData* data = BroodwarImpl.server.data;
     bool completeMapInfo = Broodwar->isFlagEnabled(Flag::CompleteMapInformation);
-    if ( BroodwarImpl.isReplay() )
+    bool isReplay = BroodwarImpl.isReplay() || !BroodwarImpl.BWAPIPlayer;
+    u32 playerFlag = isReplay ? 0 : 1 << BroodwarImpl.BWAPIPlayer->getIndex();
+
+    // Clear the changes of the previous frame
+    for ( int layer = 0; layer < TileLayer::Max; ++layer )
+      memset(data->tileChanges[layer], 0, height * sizeof(data->tileChanges[layer][0]));
+
+    bool changedBlocks[blocksPerRow * blocksPerRow] = {};
+    for(int x = 0; x < width; ++x)
     {
-      for(int x = 0; x < width; ++x)
+      for(int y = 0; y < height; ++y)
       {
-        for(int y = 0; y < height; ++y)
+        BW::activeTile tileData = getActiveTile(x, y);
+        bool values[TileLayer::Max];
+        if ( isReplay )
         {
-          BW::activeTile tileData = getActiveTile(x, y);
-          data->isVisible[x][y]  = tileData.bVisibilityFlags   != 255;
-          data->isExplored[x][y] = tileData.bExploredFlags     != 255;
-          data->hasCreep[x][y]   = tileData.bTemporaryCreep    != 0;
-          data->isOccupied[x][y] = tileData.bCurrentlyOccupied != 0;
+          values[TileLayer::Visible]  = tileData.bVisibilityFlags   != 255;
+          values[TileLayer::Explored] = tileData.bExploredFlags     != 255;
+          values[TileLayer::Creep]    = tileData.bTemporaryCreep    != 0;
+          values[TileLayer::Occupied] = tileData.bCurrentlyOccupied != 0;
         }
-      }
-    }
-    else
-    {
-      int playerIndex = BroodwarImpl.BWAPIPlayer->getIndex();
-      u32 playerFlag = 1 << playerIndex;
-      for(int x = 0; x < width; ++x)
-      {
-        for(int y = 0; y < height; ++y)
+        else
+        {
+          values[TileLayer::Visible]  = !(tileData.bVisibilityFlags & playerFlag);
+          values[TileLayer::Explored] = !(tileData.bExploredFlags & playerFlag);
+          values[TileLayer::Creep]    = (values[TileLayer::Visible] || completeMapInfo) && tileData.bTemporaryCreep != 0;
+          values[TileLayer::Occupied] = (values[TileLayer::Visible] || completeMapInfo) && tileData.bCurrentlyOccupied != 0;
+        }
+
+        bool *layers[TileLayer::Max] = { &data->isVisible[x][y], &data->isExplored[x][y], &data->hasCreep[x][y], &data->isOccupied[x][y] };
+        bool changed = false;
+        for ( int layer = 0; layer < TileLayer::Max; ++layer )
         {
-          BW::activeTile tileData = getActiveTile(x, y);
-          data->isVisible[x][y]   = !(tileData.bVisibilityFlags & playerFlag);
-          data->isExplored[x][y]  = !(tileData.bExploredFlags & playerFlag);
-          data->hasCreep[x][y]    = (data->isVisible[x][y] || completeMapInfo) && tileData.bTemporaryCreep != 0;
-          data->isOccupied[x][y]  = (data->isVisible[x][y] || completeMapInfo) && tileData.bCurrentlyOccupied != 0;
+          if ( *layers[layer] != values[layer] )
+          {
+            *layers[layer] = values[layer];
+            data->tileChanges[layer][y][x / 32] |= 1u << (x % 32);
+            changed = true;
+          }
         }
+        if ( changed )
+          changedBlocks[(y / TileLayer::BlockSize) * blocksPerRow + x / TileLayer::BlockSize] = true;
       }
     }
+
+    // List the changed blocks
+    data->changedTileBlockCount = 0;
+    for ( int i = 0; i < blocksPerRow * blocksPerRow; ++i )
+    {
+      if ( changedBlocks[i] )
+        data->changedTileBlocks[data->changedTileBlockCount++] = static_cast<unsigned short>(i);
+    }
+  }
+  //------------------------------------------ CLEAR SHARED MEMORY -------------------------------------------
+  void Map::clearSharedMemory()
+  {
+    GameData* data = BroodwarImpl.server.data;
+    memset(data->isVisible, 0, sizeof(data->isVisible));
+    memset(data->isExplored, 0, sizeof(data->isExplored));
+    memset(data->hasCreep, 0, sizeof(data->hasCreep));
+    memset(data->isOccupied, 0, sizeof(data->isOccupied));
+    memset(data->tileChanges, 0, sizeof(data->tileChanges));
+    data->changedTileBlockCount = 0;
   }
   //------------------------------------------------ BUILDABLE -----------------------------------------------
   bool Map::buildable(int x, int y)
@@ -36,6 +36,10 @@ namespace BWAPI
       static std::string getMapHash();
       static void copyToSharedMemory();
 
+      // Clears the dynamic tile data so that every tile that is set on the first frame of a
+      // match is reported as changed.
+      static void clearSharedMemory();
+
     private :
       static BW::TileID getTile(int x, int y);
       static BW::activeTile getActiveTile(int x, int y);
@@ -609,8 +609,7 @@ namespace BWAPI
       for(Unit t : Broodwar->getSelectedUnits())
         data->selectedUnits[i++] = getUnitID(t);
 
-      //dynamic map data
-      BroodwarImpl.copyMapToSharedMemory();
+      //(dynamic map data is copied by GameImpl::update)
       //(no dynamic force data)
 
       //dynamic player data
@@ -154,6 +154,9 @@ void GameImpl::update()
   //each frame we add a MatchFrame event to the queue
   events.push_back(Event::MatchFrame());
 
+  //update the dynamic map data and its changes, which are used by both clients and DLLs
+  this->copyMapToSharedMemory();
+
   //if the AI is a client process, this will signal the client to process the next frame
   //if the AI is a DLL, this will translate the events into AIModule callbacks.
   server.update();
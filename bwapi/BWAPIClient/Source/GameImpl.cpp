@@ -17,6 +17,26 @@
 
 namespace BWAPI
 {
+  namespace
+  {
+    // The region ID stored for a walk tile, resolving split tiles through their mini tile mask
+    int getWalkTileRegion(const GameData *data, int x, int y)
+    {
+      unsigned short idx = data->mapTileRegionId[x/4][y/4];
+      if ( !(idx & 0x2000) )
+        return idx;
+
+      const int minitileShift = (x&3) + (y&3) * 4;
+      const int index = idx & 0x1FFF;
+      if ( index >= std::extent<decltype(data->mapSplitTilesMiniTileMask)>::value ||
+           index >= std::extent<decltype(data->mapSplitTilesRegion1)>::value )
+        return -1;
+
+      if ( (data->mapSplitTilesMiniTileMask[index] >> minitileShift) & 1 )
+        return data->mapSplitTilesRegion2[index];
+      return data->mapSplitTilesRegion1[index];
+    }
+  }
   GameImpl::GameImpl(GameData* _data)
     : data(_data)
   {
@@ -111,7 +131,8 @@ namespace BWAPI
     staticGeysers.clear();
     staticNeutralUnits.clear();
     selectedUnits.clear();
-    pylons.clear();
+    powerGrid.clear();
+    changedTileBlocks.clear();
     events.clear();
     thePlayer  = NULL;
     theEnemy   = NULL;
@@ -128,9 +149,13 @@ namespace BWAPI
     for (auto &v : playerVector)
       v.units.clear();
 
+    unitHistory.clear();
+    unitSnapshot.clear();
+
     for( Region r : regionsList )
       delete static_cast<RegionImpl*>(r);
     regionsList.clear();
+    regionGraph.clear();
     memset(this->regionArray, 0, sizeof(this->regionArray));
   }
 
@@ -169,6 +194,8 @@ namespace BWAPI
   {
     clearAll();
     inGame = true;
+    MapBounds::set(data->mapWidth, data->mapHeight);
+    powerGrid.reset(data->mapWidth, data->mapHeight);
 
     //load forces, players, and initial units from shared memory
     for(int i = 1; i < data->forceCount; ++i)
@@ -186,13 +213,39 @@ namespace BWAPI
     for(int i = 0; i < data->startLocationCount; ++i)
       startLocations.push_back(BWAPI::TilePosition(data->startLocations[i].x,data->startLocations[i].y));
 
+    // Flatten the regions and the region of each walk tile before creating the regions
+    RegionGraph::Input graphInput;
+    graphInput.width = data->mapWidth * 4;
+    graphInput.height = data->mapHeight * 4;
+    graphInput.regionIds.resize(static_cast<size_t>(graphInput.width) * graphInput.height);
+    graphInput.walkable.resize(graphInput.regionIds.size());
+    for ( int y = 0; y < graphInput.height; ++y )
+    {
+      for ( int x = 0; x < graphInput.width; ++x )
+      {
+        graphInput.regionIds[y * graphInput.width + x] = getWalkTileRegion(data, x, y);
+        graphInput.walkable[y * graphInput.width + x] = data->isWalkable[x][y];
+      }
+    }
+    graphInput.nodes.resize(data->regionCount);
+    for ( int i = 0; i < data->regionCount; ++i )
+    {
+      const RegionData &r = data->regions[i];
+      RegionGraph::Node &node = graphInput.nodes[i];
+      node.center = Position(r.center_x, r.center_y);
+      node.groupId = r.islandID;
+      node.neighbors.assign(r.neighbors, r.neighbors + r.neighborCount);
+    }
+    regionGraph.build(graphInput);
+
     for ( int i = 0; i < data->regionCount; ++i )
     {
       this->regionArray[i] = new RegionImpl(i);
       regionsList.insert(this->regionArray[i]);
     }
     for ( int i = 0; i < data->regionCount; ++i )
-      this->regionArray[i]->setNeighbors();
+      this->regionArray[i]->setNeighbors(regionGraph);
+    MapAnalysis::onMatchStart();
 
     thePlayer  = getPlayer(data->self);
     theEnemy   = getPlayer(data->enemy);
@@ -230,6 +283,8 @@ namespace BWAPI
   void GameImpl::onMatchEnd()
   {
     clearAll();
+    MapBounds::reset();
+    MapAnalysis::onMatchEnd();
   }
   //------------------------------------------------- ON MATCH FRAME -----------------------------------------
   void GameImpl::onMatchFrame()
@@ -245,6 +300,14 @@ namespace BWAPI
     for(int i = 0; i < data->nukeDotCount; ++i)
       nukeDots.push_back(Position(data->nukeDots[i].x,data->nukeDots[i].y));
 
+    const int blocksPerRow = 256 / TileLayer::BlockSize;
+    changedTileBlocks.clear();
+    for(int i = 0; i < data->changedTileBlockCount; ++i)
+    {
+      int block = data->changedTileBlocks[i];
+      changedTileBlocks.push_back(TilePosition(block % blocksPerRow * TileLayer::BlockSize, block / blocksPerRow * TileLayer::BlockSize));
+    }
+
     for(int e = 0; e < data->eventCount; ++e)
     {
       events.push_back(this->makeEvent(data->events[e]));
@@ -262,11 +325,6 @@ namespace BWAPI
           else if ( u->getType() == UnitTypes::Resource_Vespene_Geyser )
             geysers.insert(u);
         }
-        else
-        {
-          if (u->getPlayer() == this->self() && u->getType() == UnitTypes::Protoss_Pylon)
-            pylons.insert(u);
-        }
       }
       else if (data->events[e].type == EventType::UnitEvade)
       {
@@ -281,11 +339,16 @@ namespace BWAPI
           else if (u->getType()==UnitTypes::Resource_Vespene_Geyser)
             geysers.erase(u);
         }
-        else
-        {
-          if (u->getPlayer() == this->self() && u->getType() == UnitTypes::Protoss_Pylon)
-            pylons.erase(u);
-        }
+      }
+      else if (data->events[e].type == EventType::UnitComplete)
+      {
+        Unit u = &unitVector[id];
+        if (u->getPlayer() == this->self() && u->getType() == UnitTypes::Protoss_Pylon)
+          powerGrid.addPylon(id, u->getPosition());
+      }
+      else if (data->events[e].type == EventType::UnitDestroy)
+      {
+        powerGrid.removePylon(id);
       }
       else if (data->events[e].type==EventType::UnitRenegade)
       {
@@ -293,6 +356,12 @@ namespace BWAPI
         for (auto &p : playerSet)
           static_cast<PlayerImpl*>(p)->units.erase(u);
         static_cast<PlayerImpl*>(u->getPlayer())->units.insert(u);
+
+        // A pylon that changes owner powers the grid of the new owner only
+        if (u->getPlayer() == this->self() && u->getType() == UnitTypes::Protoss_Pylon && u->isCompleted())
+          powerGrid.addPylon(id, u->getPosition());
+        else
+          powerGrid.removePylon(id);
       }
       else if (data->events[e].type == EventType::UnitMorph)
       {
@@ -354,8 +423,22 @@ namespace BWAPI
           _observers.insert(p);
       }
     }
+    // record unit history and rebuild the unit snapshot if they were enabled
+    unitHistory.update(accessibleUnits);
+    unitSnapshot.update(accessibleUnits);
+
     this->processInterfaceEvents(); // Note sure if this should go here?
   }
+  //----------------------------------------------- GET UNIT HISTORY -----------------------------------------
+  UnitHistory &GameImpl::getUnitHistory()
+  {
+    return unitHistory;
+  }
+  //----------------------------------------------- GET UNIT SNAPSHOT ----------------------------------------
+  UnitSnapshot &GameImpl::getUnitSnapshot()
+  {
+    return unitSnapshot;
+  }
   //----------------------------------------------- GET FORCE ------------------------------------------------
   Force GameImpl::getForce(int forceId) const
   {
@@ -489,9 +572,11 @@ namespace BWAPI
   }
   Unit GameImpl::getClosestUnitInRectangle(Position center, const UnitFilter &pred, int left, int top, int right, int bottom) const
   {
-    // cppcheck-suppress variableScope
-    int bestDistance = 99999999;
-    Unit pBestUnit = nullptr;
+    // Gather the candidates, then compute all of their distances in one batch. The batch is
+    // borrowed from the member so that its buffers are reused between calls, and a predicate
+    // that makes another query gets a batch of its own.
+    DistanceBatch candidates(std::move(closestUnitCandidates));
+    candidates.clear();
 
     Templates::iterateUnitFinder<unitFinder>(data->xUnitSearch,
                                              data->yUnitSearch,
@@ -501,16 +586,10 @@ namespace BWAPI
                                              right,
                                              bottom,
                                              [&](Unit u){ if ( !pred.isValid() || pred(u) )
-                                                           {
-                                                              int newDistance = u->getDistance(center);
-                                                              if ( newDistance < bestDistance )
-                                                              {
-                                                                pBestUnit = u;
-                                                                // cppcheck-suppress unreadVariable
-                                                                bestDistance = newDistance;
-                                                              }
-                                                           } } );
-    return pBestUnit;
+                                                             candidates.add(u); });
+    Unit pClosestUnit = candidates.getClosestUnit(center);
+    closestUnitCandidates = std::move(candidates);
+    return pClosestUnit;
   }
   Unit GameImpl::getBestUnit(const BestUnitFilter &best, const UnitFilter &pred, Position center, int radius) const
   {
@@ -612,10 +691,25 @@ namespace BWAPI
       return 0;
     return data->hasCreep[x][y];
   }
+  //--------------------------------------------- IS TILE CHANGED --------------------------------------------
+  bool GameImpl::isTileChanged(int x, int y, TileLayer::Enum layer) const
+  {
+    if ( !TilePosition(x, y) || layer < 0 || layer >= TileLayer::Max )
+      return false;
+    return (data->tileChanges[layer][y][x / 32] & (1u << (x % 32))) != 0;
+  }
+  const TilePosition::list &GameImpl::getChangedTileBlocks() const
+  {
+    return changedTileBlocks;
+  }
   //--------------------------------------------- HAS POWER --------------------------------------------------
   bool GameImpl::hasPowerPrecise(int x, int y, UnitType unitType) const
   {
-    return Templates::hasPower(x, y, unitType, pylons);
+    return Templates::hasPower(x, y, unitType, powerGrid);
+  }
+  const PowerGrid &GameImpl::getPowerGrid() const
+  {
+    return powerGrid;
   }
   //------------------------------------------------ PRINTF --------------------------------------------------
   void GameImpl::vPrintf(const char *format, va_list arg)
@@ -911,33 +1005,12 @@ namespace BWAPI
       this->setLastError(BWAPI::Errors::Invalid_Parameter);
       return nullptr;
     }
-    unsigned short idx = data->mapTileRegionId[x/32][y/32];
-    if ( idx & 0x2000 )
-    {
-      const int minitilePosX = (x&0x1F)/8;
-      const int minitilePosY = (y&0x1F)/8;
-      const int minitileShift = minitilePosX + minitilePosY * 4;
-      const int index = idx & 0x1FFF;
-      if (index >= std::extent<decltype(data->mapSplitTilesMiniTileMask)>::value)
-        return nullptr;
-      
-      unsigned short miniTileMask = data->mapSplitTilesMiniTileMask[index];
-      
-      if (index >= std::extent<decltype(data->mapSplitTilesRegion1)>::value)
-        return nullptr;
-
-      if ((miniTileMask >> minitileShift) & 1)
-      {
-        unsigned short rgn2 = data->mapSplitTilesRegion2[index];
-        return this->getRegion(rgn2);
-      }
-      else
-      {
-        unsigned short rgn1 = data->mapSplitTilesRegion1[index];
-        return this->getRegion(rgn1);
-      }
-    }
-    return this->getRegion(idx);
+    // Split tiles were resolved when the match started
+    return this->getRegion(regionGraph.getRegionId(x/8, y/8));
+  }
+  const RegionGraph &GameImpl::getRegionGraph() const
+  {
+    return regionGraph;
   }
   int GameImpl::getLastEventTime() const
   {
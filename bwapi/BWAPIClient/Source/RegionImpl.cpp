@@ -8,30 +8,14 @@ namespace BWAPI
     , closestAccessibleRgn(nullptr)
     , closestInaccessibleRgn(nullptr)
   { }
-  void RegionImpl::setNeighbors()
+  void RegionImpl::setNeighbors(const RegionGraph &graph)
   {
-    int accessibleBestDist    = 99999;
-    int inaccessibleBestDist  = 99999;
-    for ( int i = 0; i < self->neighborCount; ++i )
-    {
-      BWAPI::Region neighbor = Broodwar->getRegion(self->neighbors[i]);
-      this->neighbors.insert(neighbor);
+    // The graph already holds the neighbors without duplicates, and the closest ones
+    int id = this->getID();
+    for ( const RegionGraph::Edge *e = graph.edgesBegin(id); e != graph.edgesEnd(id); ++e )
+      this->neighbors.insert(Broodwar->getRegion(e->target));
 
-      // Obtain the closest accessible and inaccessible Regions from their Region center
-      int dst = this->getCenter().getApproxDistance(neighbor->getCenter());
-      if ( this->getRegionGroupID() == neighbor->getRegionGroupID() )
-      {
-        if ( dst < accessibleBestDist )
-        {
-          accessibleBestDist = dst;
-          this->closestAccessibleRgn = neighbor;
-        }
-      }
-      else if ( dst < inaccessibleBestDist )
-      {
-        inaccessibleBestDist = dst;
-        this->closestInaccessibleRgn = neighbor;
-      }
-    }
+    this->closestAccessibleRgn = Broodwar->getRegion(graph.getClosestAccessibleRegion(id));
+    this->closestInaccessibleRgn = Broodwar->getRegion(graph.getClosestInaccessibleRegion(id));
   }
 };
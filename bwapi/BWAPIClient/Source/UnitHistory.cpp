@@ -0,0 +1,162 @@
+#include <BWAPI/Client/UnitHistory.h>
+#include <BWAPI/Unit.h>
+
+#include <cmath>
+#include <algorithm>
+
+namespace BWAPI
+{
+  UnitHistory::UnitHistory()
+    : capacity(0)
+    , updateCount(0)
+  {
+  }
+  //--------------------------------------------- ENABLE -----------------------------------------------------
+  void UnitHistory::enable(int capacity)
+  {
+    if ( capacity <= 0 )
+    {
+      this->disable();
+      return;
+    }
+
+    this->capacity = capacity;
+    head.assign(MAX_UNITS, 0);
+    count.assign(MAX_UNITS, 0);
+    lastUpdate.assign(MAX_UNITS, -1);
+    x.assign(MAX_UNITS * capacity, 0);
+    y.assign(MAX_UNITS * capacity, 0);
+    hitPoints.assign(MAX_UNITS * capacity, 0);
+    updateCount = 0;
+  }
+  //--------------------------------------------- DISABLE ----------------------------------------------------
+  void UnitHistory::disable()
+  {
+    capacity = 0;
+    std::vector<int>().swap(head);
+    std::vector<int>().swap(count);
+    std::vector<int>().swap(lastUpdate);
+    std::vector<int>().swap(x);
+    std::vector<int>().swap(y);
+    std::vector<int>().swap(hitPoints);
+    this->clear();
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void UnitHistory::clear()
+  {
+    std::fill(count.begin(), count.end(), 0);
+    std::fill(lastUpdate.begin(), lastUpdate.end(), -1);
+    updateCount = 0;
+
+    units.clear();
+    posX.clear();
+    posY.clear();
+    velocityX.clear();
+    velocityY.clear();
+    topSpeed.clear();
+    acceleration.clear();
+    range.clear();
+  }
+  //--------------------------------------------- UPDATE -----------------------------------------------------
+  void UnitHistory::update(const Unitset &accessibleUnits)
+  {
+    if ( !isEnabled() )
+      return;
+
+    units.clear();
+    posX.clear();
+    posY.clear();
+    velocityX.clear();
+    velocityY.clear();
+    topSpeed.clear();
+    acceleration.clear();
+    range.clear();
+
+    for ( Unit u : accessibleUnits )
+    {
+      int id = u->getID();
+      if ( id < 0 || id >= MAX_UNITS )
+        continue;
+
+      // Start over if the unit was missed in the previous update
+      if ( lastUpdate[id] != updateCount - 1 )
+        count[id] = 0;
+      lastUpdate[id] = updateCount;
+
+      head[id] = (head[id] + 1) % capacity;
+      if ( count[id] < capacity )
+        ++count[id];
+
+      int slot = id * capacity + head[id];
+      Position pos = u->getPosition();
+      x[slot] = pos.x;
+      y[slot] = pos.y;
+      hitPoints[slot] = u->getHitPoints();
+
+      // Motion parameters
+      UnitMotion::State state = UnitMotion::getState(u);
+      units.push_back(u);
+      posX.push_back(state.x);
+      posY.push_back(state.y);
+      velocityX.push_back(state.velocityX);
+      velocityY.push_back(state.velocityY);
+      topSpeed.push_back(state.topSpeed);
+      acceleration.push_back(state.acceleration);
+      range.push_back(state.range);
+    }
+    ++updateCount;
+  }
+  //--------------------------------------------- GET SLOT ---------------------------------------------------
+  int UnitHistory::getSlot(Unit unit, int framesAgo) const
+  {
+    if ( !unit || !isEnabled() || framesAgo < 0 )
+      return -1;
+
+    int id = unit->getID();
+    if ( id < 0 || id >= MAX_UNITS || lastUpdate[id] != updateCount - 1 || framesAgo >= count[id] )
+      return -1;
+
+    return id * capacity + (head[id] - framesAgo + capacity) % capacity;
+  }
+  //--------------------------------------------- GET SAMPLE COUNT -------------------------------------------
+  int UnitHistory::getSampleCount(Unit unit) const
+  {
+    if ( !unit || !isEnabled() )
+      return 0;
+
+    int id = unit->getID();
+    if ( id < 0 || id >= MAX_UNITS || lastUpdate[id] != updateCount - 1 )
+      return 0;
+    return count[id];
+  }
+  //--------------------------------------------- GET POSITION -----------------------------------------------
+  Position UnitHistory::getPosition(Unit unit, int framesAgo) const
+  {
+    int slot = getSlot(unit, framesAgo);
+    if ( slot == -1 )
+      return Positions::Unknown;
+    return Position(x[slot], y[slot]);
+  }
+  //--------------------------------------------- GET HIT POINTS ---------------------------------------------
+  int UnitHistory::getHitPoints(Unit unit, int framesAgo) const
+  {
+    int slot = getSlot(unit, framesAgo);
+    if ( slot == -1 )
+      return -1;
+    return hitPoints[slot];
+  }
+  //--------------------------------------------- PREDICT POSITIONS ------------------------------------------
+  void UnitHistory::predictPositions(int frames, std::vector<Position> &result) const
+  {
+    size_t n = units.size();
+    resultX.resize(n);
+    resultY.resize(n);
+    UnitMotion::predict(posX.data(), posY.data(), velocityX.data(), velocityY.data(),
+                        topSpeed.data(), acceleration.data(), range.data(), n,
+                        frames, resultX.data(), resultY.data());
+
+    result.resize(n);
+    for ( size_t i = 0; i < n; ++i )
+      result[i] = Position(static_cast<int>(std::lround(resultX[i])), static_cast<int>(std::lround(resultY[i])));
+  }
+}
@@ -0,0 +1,118 @@
+#include <BWAPI/Client/UnitSnapshot.h>
+#include <BWAPI/Unit.h>
+#include <BWAPI/Player.h>
+
+namespace BWAPI
+{
+  UnitSnapshot::UnitSnapshot()
+    : enabled(false)
+  {
+  }
+  //--------------------------------------------- ENABLE -----------------------------------------------------
+  void UnitSnapshot::enable(bool enabled)
+  {
+    this->enabled = enabled;
+    if ( !enabled )
+      this->clear();
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void UnitSnapshot::clear()
+  {
+    units.clear();
+    ids.clear();
+    players.clear();
+    types.clear();
+    x.clear();
+    y.clear();
+    hitPoints.clear();
+    shields.clear();
+    flags.clear();
+  }
+  //--------------------------------------------- UPDATE -----------------------------------------------------
+  void UnitSnapshot::update(const Unitset &accessibleUnits)
+  {
+    if ( !enabled )
+      return;
+
+    size_t count = accessibleUnits.size();
+    units.resize(count);
+    ids.resize(count);
+    players.resize(count);
+    types.resize(count);
+    x.resize(count);
+    y.resize(count);
+    hitPoints.resize(count);
+    shields.resize(count);
+    flags.resize(count);
+
+    size_t i = 0;
+    for ( Unit u : accessibleUnits )
+    {
+      UnitType type = u->getType();
+      Player player = u->getPlayer();
+      Position pos = u->getPosition();
+
+      unsigned int f = 0;
+      if ( u->isCompleted() )     f |= Completed;
+      if ( u->isFlying() )        f |= Flying;
+      if ( type.isBuilding() )    f |= Building;
+      if ( type.isWorker() )      f |= Worker;
+      if ( u->isCloaked() )       f |= Cloaked;
+      if ( u->isBurrowed() )      f |= Burrowed;
+      if ( u->isDetected() )      f |= Detected;
+      if ( u->isVisible() )       f |= Visible;
+      if ( u->isMoving() )        f |= Moving;
+      if ( u->isAttacking() )     f |= Attacking;
+      if ( u->isUnderAttack() )   f |= UnderAttack;
+      if ( u->isIdle() )          f |= Idle;
+      if ( u->isLoaded() )        f |= Loaded;
+
+      units[i]     = u;
+      ids[i]       = u->getID();
+      players[i]   = player ? player->getID() : -1;
+      types[i]     = type.getID();
+      x[i]         = pos.x;
+      y[i]         = pos.y;
+      hitPoints[i] = u->getHitPoints();
+      shields[i]   = u->getShields();
+      flags[i]     = f;
+      ++i;
+    }
+  }
+  //--------------------------------------------- FILTER -----------------------------------------------------
+  size_t UnitSnapshot::filter(int playerID, unsigned int requiredFlags, unsigned int excludedFlags, std::vector<int> &result) const
+  {
+    result.clear();
+    for ( size_t i = 0; i < units.size(); ++i )
+    {
+      if ( (playerID == -1 || players[i] == playerID) &&
+           (flags[i] & requiredFlags) == requiredFlags &&
+           (flags[i] & excludedFlags) == 0 )
+        result.push_back(static_cast<int>(i));
+    }
+    return result.size();
+  }
+  //--------------------------------------------- GET CENTROID -----------------------------------------------
+  Position UnitSnapshot::getCentroid(const std::vector<int> &indexes) const
+  {
+    if ( indexes.empty() )
+      return Positions::Invalid;
+
+    long long sumX = 0, sumY = 0;
+    for ( int i : indexes )
+    {
+      sumX += x[i];
+      sumY += y[i];
+    }
+    long long n = static_cast<long long>(indexes.size());
+    return Position(static_cast<int>(sumX / n), static_cast<int>(sumY / n));
+  }
+  //--------------------------------------------- GET TOTAL HEALTH -------------------------------------------
+  int UnitSnapshot::getTotalHealth(const std::vector<int> &indexes) const
+  {
+    int total = 0;
+    for ( int i : indexes )
+      total += hitPoints[i] + shields[i];
+    return total;
+  }
+}
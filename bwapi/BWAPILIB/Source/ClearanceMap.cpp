@@ -0,0 +1,204 @@
+#include <BWAPI/ClearanceMap.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace BWAPI
+{
+  namespace
+  {
+    // Calls function(first, last) for consecutive parts of [0, count) on several threads
+    template <class _T>
+    void parallelFor(int count, unsigned int threadCount, const _T &function)
+    {
+      if ( threadCount == 0 )
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+      threadCount = std::max(1u, std::min<unsigned int>(threadCount, count));
+
+      std::vector<std::thread> threads;
+      int step = (count + threadCount - 1) / threadCount;
+      for ( unsigned int i = 1; i < threadCount; ++i )
+      {
+        int first = i * step;
+        int last = std::min(count, first + step);
+        if ( first < last )
+          threads.emplace_back([&function, first, last]() { function(first, last); });
+      }
+      function(0, std::min(count, step));
+      for ( auto &t : threads )
+        t.join();
+    }
+
+    // One dimensional squared distance transform of Felzenszwalb and Huttenlocher. Computes the
+    // lower envelope of the parabolas rooted at every sample, then reads it back in order.
+    void transformLine(const int *input, int *output, int count, int *vertices, double *boundaries)
+    {
+      int k = 0;
+      vertices[0] = 0;
+      boundaries[0] = -std::numeric_limits<double>::max();
+      boundaries[1] = std::numeric_limits<double>::max();
+      for ( int q = 1; q < count; ++q )
+      {
+        double s;
+        for ( ;; )
+        {
+          int v = vertices[k];
+          s = static_cast<double>((input[q] + q * q) - (input[v] + v * v)) / (2 * (q - v));
+          if ( s > boundaries[k] )
+            break;
+          --k;
+        }
+        ++k;
+        vertices[k] = q;
+        boundaries[k] = s;
+        boundaries[k + 1] = std::numeric_limits<double>::max();
+      }
+
+      k = 0;
+      for ( int q = 0; q < count; ++q )
+      {
+        while ( boundaries[k + 1] < q )
+          ++k;
+        int v = vertices[k];
+        output[q] = (q - v) * (q - v) + input[v];
+      }
+    }
+
+    // The half width of the largest ground unit of each size class: the Dark Templar, the
+    // Vulture and Lurker, and the Ultralisk
+    const int SIZE_CLASS_RADIUS[3] = { 13, 16, 19 };
+
+    int sizeClassIndex(UnitSizeType size)
+    {
+      switch ( size )
+      {
+      case UnitSizeTypes::Enum::Small:
+        return 0;
+      case UnitSizeTypes::Enum::Medium:
+        return 1;
+      case UnitSizeTypes::Enum::Large:
+        return 2;
+      default:
+        return -1;
+      }
+    }
+  }
+  //--------------------------------------------- BUILD ------------------------------------------------------
+  void ClearanceMap::build(int width, int height, const std::vector<bool> &walkable, unsigned int threadCount)
+  {
+    this->clear();
+    if ( width <= 0 || height <= 0 || walkable.size() < static_cast<size_t>(width) * height )
+      return;
+    this->width = width;
+    this->height = height;
+
+    // Pass 1: distance along each column to the nearest blocked tile, counting the map edges
+    std::vector<int> columnDistances(static_cast<size_t>(width) * height);
+    parallelFor(width, threadCount, [&](int first, int last)
+    {
+      for ( int x = first; x < last; ++x )
+      {
+        int distance = 0;
+        for ( int y = 0; y < height; ++y )
+        {
+          distance = walkable[y * width + x] ? distance + 1 : 0;
+          columnDistances[y * width + x] = distance;
+        }
+        distance = 0;
+        for ( int y = height - 1; y >= 0; --y )
+        {
+          distance = walkable[y * width + x] ? distance + 1 : 0;
+          columnDistances[y * width + x] = std::min(columnDistances[y * width + x], distance);
+        }
+      }
+    });
+
+    // Pass 2: combine the columns along each row, then derive the masks for that row
+    distances.resize(columnDistances.size());
+    maskStride = (width + 31) / 32;
+    for ( auto &mask : masks )
+      mask.assign(static_cast<size_t>(maskStride) * height, 0);
+
+    int required[3];
+    for ( int i = 0; i < 3; ++i )
+    {
+      int radius = getRadius(UnitSizeType(UnitSizeTypes::Enum::Small + i));
+      required[i] = radius * radius;
+    }
+
+    parallelFor(height, threadCount, [&](int first, int last)
+    {
+      std::vector<int> input(width), output(width), vertices(width);
+      std::vector<double> boundaries(width + 1);
+      for ( int y = first; y < last; ++y )
+      {
+        for ( int x = 0; x < width; ++x )
+        {
+          int d = columnDistances[y * width + x];
+          input[x] = d * d;
+        }
+        transformLine(input.data(), output.data(), width, vertices.data(), boundaries.data());
+
+        for ( int x = 0; x < width; ++x )
+        {
+          // The tiles beyond the left and right edges are blocked as well
+          int squared = std::min(output[x], std::min((x + 1) * (x + 1), (width - x) * (width - x)));
+
+          int pixelsSquared = squared * 64;
+          distances[y * width + x] = static_cast<std::uint16_t>(std::min(65535.0, std::sqrt(static_cast<double>(pixelsSquared))));
+          for ( int i = 0; i < 3; ++i )
+          {
+            if ( pixelsSquared >= required[i] )
+              masks[i][y * maskStride + x / 32] |= 1u << (x % 32);
+          }
+        }
+      }
+    });
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void ClearanceMap::clear()
+  {
+    width = height = maskStride = 0;
+    distances.clear();
+    for ( auto &mask : masks )
+      mask.clear();
+  }
+  //--------------------------------------------- GET DISTANCE -----------------------------------------------
+  int ClearanceMap::getDistance(WalkPosition position) const
+  {
+    if ( position.x < 0 || position.y < 0 || position.x >= width || position.y >= height )
+      return 0;
+    return distances[position.y * width + position.x];
+  }
+  //--------------------------------------------- IS PASSABLE ------------------------------------------------
+  bool ClearanceMap::isPassable(WalkPosition position, UnitSizeType size) const
+  {
+    int i = sizeClassIndex(size);
+    if ( i == -1 || position.x < 0 || position.y < 0 || position.x >= width || position.y >= height )
+      return false;
+    return ((masks[i][position.y * maskStride + position.x / 32] >> (position.x % 32)) & 1) != 0;
+  }
+  bool ClearanceMap::isPassable(WalkPosition position, UnitType type) const
+  {
+    return this->getDistance(position) >= getRadius(type);
+  }
+  //--------------------------------------------- GET MASK ---------------------------------------------------
+  const std::vector<std::uint32_t> &ClearanceMap::getMask(UnitSizeType size) const
+  {
+    static const std::vector<std::uint32_t> none;
+    int i = sizeClassIndex(size);
+    return i == -1 ? none : masks[i];
+  }
+  //--------------------------------------------- GET RADIUS -------------------------------------------------
+  int ClearanceMap::getRadius(UnitSizeType size)
+  {
+    int i = sizeClassIndex(size);
+    return i == -1 ? 0 : SIZE_CLASS_RADIUS[i];
+  }
+  int ClearanceMap::getRadius(UnitType type)
+  {
+    return (std::max(type.width(), type.height()) + 1) / 2;
+  }
+}
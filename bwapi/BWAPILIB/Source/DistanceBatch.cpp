@@ -0,0 +1,306 @@
+#include <BWAPI/DistanceBatch.h>
+#include <BWAPI/Unit.h>
+#include <BWAPI/Unitset.h>
+#include <BWAPI/Game.h>
+
+#include <limits>
+#include <cstdlib>
+#include <algorithm>
+#include <utility>
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+  #define BWAPI_DISTANCE_AVX2
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+  #include <emmintrin.h>
+  #define BWAPI_DISTANCE_SSE2
+#endif
+
+namespace BWAPI
+{
+  namespace
+  {
+    // Point::getApproxDistance for a non-negative x and y distance
+    inline int approxDistance(unsigned int min, unsigned int max)
+    {
+      if ( max < min )
+        std::swap(min, max);
+
+      if ( min < (max >> 2) )
+        return max;
+
+      unsigned int minCalc = (3*min) >> 3;
+      return (minCalc >> 5) + minCalc + max - (max >> 4) - (max >> 6);
+    }
+
+    // The distance between two ranges, or 0 if they overlap. UnitInterface::getDistance tests
+    // each side in turn, which is the same as taking the maximum when low <= high.
+    inline int edgeDistance(int low, int high, int targetLow, int targetHigh)
+    {
+      return std::max(std::max(low - targetHigh, targetLow - high), 0);
+    }
+
+#if defined(BWAPI_DISTANCE_AVX2)
+    const size_t LaneCount = 8;
+
+    inline __m256i approxDistance(__m256i dx, __m256i dy)
+    {
+      __m256i min = _mm256_min_epi32(dx, dy);
+      __m256i max = _mm256_max_epi32(dx, dy);
+
+      __m256i minCalc = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(min, min), min), 3);
+      __m256i result  = _mm256_add_epi32(_mm256_add_epi32(_mm256_srli_epi32(minCalc, 5), minCalc), max);
+      result = _mm256_sub_epi32(result, _mm256_srli_epi32(max, 4));
+      result = _mm256_sub_epi32(result, _mm256_srli_epi32(max, 6));
+
+      // min < (max >> 2) returns max
+      __m256i isStraight = _mm256_cmpgt_epi32(_mm256_srli_epi32(max, 2), min);
+      return _mm256_blendv_epi8(result, max, isStraight);
+    }
+    inline __m256i edgeDistance(__m256i low, __m256i high, __m256i targetLow, __m256i targetHigh)
+    {
+      __m256i dist = _mm256_max_epi32(_mm256_sub_epi32(low, targetHigh), _mm256_sub_epi32(targetLow, high));
+      return _mm256_max_epi32(dist, _mm256_setzero_si256());
+    }
+    inline __m256i load(const int *p)
+    {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+    inline void store(int *p, __m256i v)
+    {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+    }
+    inline __m256i absDifference(__m256i a, __m256i b)
+    {
+      return _mm256_abs_epi32(_mm256_sub_epi32(a, b));
+    }
+    inline __m256i broadcast(int v)
+    {
+      return _mm256_set1_epi32(v);
+    }
+#elif defined(BWAPI_DISTANCE_SSE2)
+    const size_t LaneCount = 4;
+
+    // SSE2 has no 32-bit min, max, abs, or blend, so they are built from compares and masks
+    inline __m128i select(__m128i mask, __m128i a, __m128i b)
+    {
+      return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+    inline __m128i approxDistance(__m128i dx, __m128i dy)
+    {
+      __m128i isYGreater = _mm_cmpgt_epi32(dy, dx);
+      __m128i min = select(isYGreater, dx, dy);
+      __m128i max = select(isYGreater, dy, dx);
+
+      __m128i minCalc = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(min, min), min), 3);
+      __m128i result  = _mm_add_epi32(_mm_add_epi32(_mm_srli_epi32(minCalc, 5), minCalc), max);
+      result = _mm_sub_epi32(result, _mm_srli_epi32(max, 4));
+      result = _mm_sub_epi32(result, _mm_srli_epi32(max, 6));
+
+      // min < (max >> 2) returns max
+      __m128i isStraight = _mm_cmpgt_epi32(_mm_srli_epi32(max, 2), min);
+      return select(isStraight, max, result);
+    }
+    inline __m128i edgeDistance(__m128i low, __m128i high, __m128i targetLow, __m128i targetHigh)
+    {
+      __m128i a = _mm_sub_epi32(low, targetHigh);
+      __m128i b = _mm_sub_epi32(targetLow, high);
+      __m128i dist = select(_mm_cmpgt_epi32(a, b), a, b);
+      return _mm_and_si128(dist, _mm_cmpgt_epi32(dist, _mm_setzero_si128()));
+    }
+    inline __m128i load(const int *p)
+    {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+    inline void store(int *p, __m128i v)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+    }
+    inline __m128i absDifference(__m128i a, __m128i b)
+    {
+      __m128i diff = _mm_sub_epi32(a, b);
+      __m128i sign = _mm_srai_epi32(diff, 31);
+      return _mm_sub_epi32(_mm_xor_si128(diff, sign), sign);
+    }
+    inline __m128i broadcast(int v)
+    {
+      return _mm_set1_epi32(v);
+    }
+#endif
+  }
+  //--------------------------------------------- GET APPROX DISTANCES ---------------------------------------
+  void DistanceBatch::getApproxDistances(const int *x, const int *y, size_t count, Position target, int *result)
+  {
+    size_t i = 0;
+#if defined(BWAPI_DISTANCE_AVX2) || defined(BWAPI_DISTANCE_SSE2)
+    auto tx = broadcast(target.x);
+    auto ty = broadcast(target.y);
+    for ( ; i + LaneCount <= count; i += LaneCount )
+      store(&result[i], approxDistance(absDifference(load(&x[i]), tx), absDifference(load(&y[i]), ty)));
+#endif
+    // Remainder
+    for ( ; i < count; ++i )
+      result[i] = approxDistance(std::abs(x[i] - target.x), std::abs(y[i] - target.y));
+  }
+  //--------------------------------------------- GET EDGE DISTANCES -----------------------------------------
+  void DistanceBatch::getEdgeDistances(const int *left, const int *top, const int *right, const int *bottom, size_t count,
+                                       int targetLeft, int targetTop, int targetRight, int targetBottom, int *result)
+  {
+    size_t i = 0;
+#if defined(BWAPI_DISTANCE_AVX2) || defined(BWAPI_DISTANCE_SSE2)
+    auto tl = broadcast(targetLeft);
+    auto tt = broadcast(targetTop);
+    auto tr = broadcast(targetRight);
+    auto tb = broadcast(targetBottom);
+    for ( ; i + LaneCount <= count; i += LaneCount )
+    {
+      auto dx = edgeDistance(load(&left[i]), load(&right[i]), tl, tr);
+      auto dy = edgeDistance(load(&top[i]), load(&bottom[i]), tt, tb);
+      store(&result[i], approxDistance(dx, dy));
+    }
+#endif
+    // Remainder
+    for ( ; i < count; ++i )
+    {
+      result[i] = approxDistance(edgeDistance(left[i], right[i], targetLeft, targetRight),
+                                 edgeDistance(top[i], bottom[i], targetTop, targetBottom));
+    }
+  }
+  //--------------------------------------------- GET INSTRUCTION SET ----------------------------------------
+  const char *DistanceBatch::getInstructionSet()
+  {
+#if defined(BWAPI_DISTANCE_AVX2)
+    return "AVX2";
+#elif defined(BWAPI_DISTANCE_SSE2)
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+  }
+  //--------------------------------------------- CONSTRUCTOR ------------------------------------------------
+  DistanceBatch::DistanceBatch(const Unitset &units)
+  {
+    this->assign(units);
+  }
+  //--------------------------------------------- ASSIGN -----------------------------------------------------
+  void DistanceBatch::assign(const Unitset &units)
+  {
+    this->clear();
+    this->units.reserve(units.size());
+    this->left.reserve(units.size());
+    this->top.reserve(units.size());
+    this->right.reserve(units.size());
+    this->bottom.reserve(units.size());
+    for ( Unit u : units )
+      this->add(u);
+  }
+  //--------------------------------------------- ADD --------------------------------------------------------
+  void DistanceBatch::add(Unit unit)
+  {
+    if ( !unit || !unit->exists() )
+    {
+      // Keep the indexes aligned with the units, but never report a distance for this one
+      missing.push_back(units.size());
+      units.push_back(unit);
+      left.push_back(0);
+      top.push_back(0);
+      right.push_back(0);
+      bottom.push_back(0);
+      return;
+    }
+    units.push_back(unit);
+    left.push_back(unit->getLeft());
+    top.push_back(unit->getTop());
+    right.push_back(unit->getRight());
+    bottom.push_back(unit->getBottom());
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void DistanceBatch::clear()
+  {
+    units.clear();
+    missing.clear();
+    left.clear();
+    top.clear();
+    right.clear();
+    bottom.clear();
+  }
+  //--------------------------------------------- GET DISTANCES ----------------------------------------------
+  void DistanceBatch::getDistances(PositionOrUnit target, int *result) const
+  {
+    if ( this->empty() )
+      return;
+
+    const int maxDistance = std::numeric_limits<int>::max();
+
+    // Retrieve the bounds of the target, expanded the same way as UnitInterface::getDistance
+    int targetLeft, targetTop, targetRight, targetBottom;
+    Unit pUnit = target.getUnit();
+    if ( target.isPosition() )
+    {
+      Position targPos = target.getPosition();
+      if ( !targPos )
+      {
+        std::fill(result, result + size(), maxDistance);
+        return;
+      }
+      targetLeft    = targPos.x - 1;
+      targetTop     = targPos.y - 1;
+      targetRight   = targPos.x + 1;
+      targetBottom  = targPos.y + 1;
+    }
+    else
+    {
+      if ( !pUnit || !pUnit->exists() )
+      {
+        std::fill(result, result + size(), maxDistance);
+        return;
+      }
+      targetLeft    = pUnit->getLeft() - 1;
+      targetTop     = pUnit->getTop() - 1;
+      targetRight   = pUnit->getRight() + 1;
+      targetBottom  = pUnit->getBottom() + 1;
+    }
+
+    getEdgeDistances(left.data(), top.data(), right.data(), bottom.data(), size(),
+                     targetLeft, targetTop, targetRight, targetBottom, result);
+
+    // Patch the units that have no distance
+    for ( size_t i : missing )
+      result[i] = maxDistance;
+    if ( pUnit )
+    {
+      for ( size_t i = 0; i < size(); ++i )
+      {
+        if ( units[i] == pUnit )
+          result[i] = maxDistance;
+      }
+    }
+  }
+  std::vector<int> DistanceBatch::getDistances(PositionOrUnit target) const
+  {
+    std::vector<int> result(size());
+    this->getDistances(target, result.data());
+    return result;
+  }
+  //--------------------------------------------- GET CLOSEST UNIT -------------------------------------------
+  Unit DistanceBatch::getClosestUnit(PositionOrUnit target, int radius, int *distance) const
+  {
+    scratch.resize(size());
+    this->getDistances(target, scratch.data());
+
+    Unit pBestUnit = nullptr;
+    int bestDistance = std::numeric_limits<int>::max();
+    for ( size_t i = 0; i < size(); ++i )
+    {
+      if ( scratch[i] < bestDistance && scratch[i] <= radius )
+      {
+        pBestUnit = units[i];
+        bestDistance = scratch[i];
+      }
+    }
+
+    if ( distance && pBestUnit )
+      *distance = bestDistance;
+    return pBestUnit;
+  }
+}
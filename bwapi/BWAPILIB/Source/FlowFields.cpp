@@ -0,0 +1,413 @@
+#include <BWAPI/FlowFields.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+
+namespace BWAPI
+{
+  namespace
+  {
+    // Move costs in thousandths of a walk tile, as in the Pathfinder
+    const int STRAIGHT_COST = 1000;
+    const int DIAGONAL_COST = 1414;
+
+    // The 8 directions, straight moves first and each one next to its opposite, so that d ^ 1
+    // reverses direction d. A tile with no direction stores NO_DIRECTION.
+    const int DIRECTIONS[8][2] = { { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 }, { 1, 1 }, { -1, -1 }, { 1, -1 }, { -1, 1 } };
+    const std::uint8_t NO_DIRECTION = 8;
+
+    int sign(int value)
+    {
+      return (value > 0) - (value < 0);
+    }
+  }
+  //--------------------------------------------- CONSTRUCTOR ------------------------------------------------
+  FlowFields::FlowFields()
+    : width(0)
+    , height(0)
+    , cacheSize(32)
+    , cacheHits(0)
+    , cacheMisses(0)
+    , background(true)
+    , stopping(false)
+    , busy(0)
+  {
+  }
+  //--------------------------------------------- DESTRUCTOR -------------------------------------------------
+  FlowFields::~FlowFields()
+  {
+    this->stopWorker();
+  }
+  //--------------------------------------------- BUILD ------------------------------------------------------
+  void FlowFields::build(int width, int height, const std::vector<bool> &walkable,
+                         const std::vector<int> &regionIds, const std::vector< std::vector<int> > &regionNeighbors)
+  {
+    this->clear();
+    if ( width <= 0 || height <= 0 || walkable.size() != static_cast<size_t>(width) * height ||
+         regionIds.size() != walkable.size() )
+      return;
+
+    // Copy the walkable tiles into a grid with an unwalkable border, so that neighbors never
+    // need bounds checks
+    passable.assign(static_cast<size_t>(width + 2) * (height + 2), 0);
+    for ( int y = 0; y < height; ++y )
+    {
+      for ( int x = 0; x < width; ++x )
+        passable[(y + 1) * (width + 2) + x + 1] = walkable[y * width + x] ? 1 : 0;
+    }
+    this->regionIds = regionIds;
+    this->regionNeighbors = regionNeighbors;
+
+    int regionCount = static_cast<int>(regionNeighbors.size());
+    for ( int id : regionIds )
+      regionCount = std::max(regionCount, id + 1);
+    this->regionNeighbors.resize(regionCount);
+
+    // Average position of the walkable tiles of each region
+    std::vector<long long> sumX(regionCount, 0), sumY(regionCount, 0), count(regionCount, 0);
+    for ( int y = 0; y < height; ++y )
+    {
+      for ( int x = 0; x < width; ++x )
+      {
+        int id = regionIds[y * width + x];
+        if ( id < 0 || !walkable[y * width + x] )
+          continue;
+        sumX[id] += x;
+        sumY[id] += y;
+        ++count[id];
+      }
+    }
+
+    // The destination is the walkable tile of the region closest to that average
+    std::vector<WalkPosition> centers(regionCount);
+    std::vector<long long> best(regionCount, std::numeric_limits<long long>::max());
+    destinations.assign(regionCount, WalkPositions::None);
+    for ( int id = 0; id < regionCount; ++id )
+    {
+      if ( count[id] > 0 )
+        centers[id] = WalkPosition(static_cast<int>(sumX[id] / count[id]), static_cast<int>(sumY[id] / count[id]));
+    }
+    for ( int y = 0; y < height; ++y )
+    {
+      for ( int x = 0; x < width; ++x )
+      {
+        int id = regionIds[y * width + x];
+        if ( id < 0 || !walkable[y * width + x] )
+          continue;
+        long long dx = x - centers[id].x, dy = y - centers[id].y;
+        if ( dx * dx + dy * dy < best[id] )
+        {
+          best[id] = dx * dx + dy * dy;
+          destinations[id] = WalkPosition(x, y);
+        }
+      }
+    }
+
+    this->width = width;
+    this->height = height;
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void FlowFields::clear()
+  {
+    this->stopWorker();
+    this->clearCache();
+    width = height = 0;
+    passable.clear();
+    regionIds.clear();
+    regionNeighbors.clear();
+    destinations.clear();
+  }
+  //--------------------------------------------- GET FLOW DIRECTION -----------------------------------------
+  WalkPosition FlowFields::getFlowDirection(WalkPosition position, int destinationId)
+  {
+    if ( position.x < 0 || position.y < 0 || position.x >= width || position.y >= height )
+      return WalkPosition(0, 0);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CacheEntry *entry = this->getEntry(destinationId);
+    if ( !entry )
+      return WalkPosition(0, 0);
+
+    int tile = position.y * width + position.x;
+    if ( !entry->directions.empty() && entry->directions[tile] != NO_DIRECTION )
+      return WalkPosition(DIRECTIONS[entry->directions[tile]][0], DIRECTIONS[entry->directions[tile]][1]);
+
+    // Head for the destination tile of the next region, or of the destination itself
+    int region = regionIds[tile];
+    if ( region < 0 || entry->nextRegion[region] < 0 )
+      return WalkPosition(0, 0);
+    WalkPosition target = destinations[entry->nextRegion[region]];
+    return WalkPosition(sign(target.x - position.x), sign(target.y - position.y));
+  }
+  //--------------------------------------------- REQUEST ----------------------------------------------------
+  bool FlowFields::request(int destinationId)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return this->getEntry(destinationId) != nullptr;
+  }
+  //--------------------------------------------- IS READY ---------------------------------------------------
+  bool FlowFields::isReady(int destinationId) const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = cacheIndex.find(destinationId);
+    return it != cacheIndex.end() && !it->second->directions.empty();
+  }
+  //--------------------------------------------- WAIT UNTIL IDLE --------------------------------------------
+  void FlowFields::waitUntilIdle()
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this]() { return stopping || (pending.empty() && busy == 0); });
+  }
+  //--------------------------------------------- GET DESTINATION --------------------------------------------
+  WalkPosition FlowFields::getDestination(int destinationId) const
+  {
+    if ( destinationId < 0 || destinationId >= static_cast<int>(destinations.size()) )
+      return WalkPositions::None;
+    return destinations[destinationId];
+  }
+  //--------------------------------------------- IS VALID DESTINATION ---------------------------------------
+  bool FlowFields::isValidDestination(int destinationId) const
+  {
+    return this->getDestination(destinationId) != WalkPositions::None;
+  }
+  //--------------------------------------------- GET ENTRY --------------------------------------------------
+  FlowFields::CacheEntry *FlowFields::getEntry(int destinationId)
+  {
+    if ( !this->isValidDestination(destinationId) || cacheSize == 0 )
+      return nullptr;
+
+    auto cached = cacheIndex.find(destinationId);
+    if ( cached != cacheIndex.end() )
+    {
+      ++cacheHits;
+      cache.splice(cache.begin(), cache, cached->second);
+      return &cache.front();
+    }
+
+    ++cacheMisses;
+    this->evict(cacheSize - 1);
+    cache.emplace_front();
+    cacheIndex[destinationId] = cache.begin();
+
+    CacheEntry &entry = cache.front();
+    entry.destination = destinationId;
+    entry.queued = false;
+    this->computeRegions(destinationId, entry.nextRegion);
+
+    if ( background )
+    {
+      this->startWorker();
+      entry.queued = true;
+      pending.push_back(destinationId);
+      wakeup.notify_one();
+    }
+    else
+    {
+      std::vector<int> cost;
+      std::vector< std::pair<int,int> > open;
+      this->computeField(destinationId, entry.directions, cost, open);
+    }
+    return &entry;
+  }
+  //--------------------------------------------- EVICT ------------------------------------------------------
+  void FlowFields::evict(size_t size)
+  {
+    while ( cache.size() > size )
+    {
+      // Fields that are still waiting for the worker are not needed anymore
+      CacheEntry &last = cache.back();
+      if ( last.queued )
+      {
+        auto it = std::find(pending.begin(), pending.end(), last.destination);
+        if ( it != pending.end() )
+          pending.erase(it);
+      }
+      cacheIndex.erase(last.destination);
+      cache.pop_back();
+    }
+  }
+  //--------------------------------------------- COMPUTE REGIONS --------------------------------------------
+  void FlowFields::computeRegions(int destinationId, std::vector<int> &nextRegion) const
+  {
+    // Dijkstra's algorithm from the destination, following neighbor links backwards. The
+    // neighbor graph of Broodwar is symmetric, so the links are used as they are.
+    int regionCount = static_cast<int>(destinations.size());
+    std::vector<int> dist(regionCount, -1);
+    nextRegion.assign(regionCount, -1);
+
+    std::vector< std::pair<int,int> > queue;
+    auto cmp = std::greater< std::pair<int,int> >();
+    dist[destinationId] = 0;
+    nextRegion[destinationId] = destinationId;
+    queue.emplace_back(0, destinationId);
+    while ( !queue.empty() )
+    {
+      std::pop_heap(queue.begin(), queue.end(), cmp);
+      std::pair<int,int> top = queue.back();
+      queue.pop_back();
+      if ( top.first > dist[top.second] )
+        continue;
+
+      WalkPosition from = destinations[top.second];
+      for ( int next : regionNeighbors[top.second] )
+      {
+        if ( next < 0 || next >= regionCount || destinations[next] == WalkPositions::None )
+          continue;
+        int d = top.first + from.getApproxDistance(destinations[next]);
+        if ( dist[next] == -1 || d < dist[next] )
+        {
+          dist[next] = d;
+          nextRegion[next] = top.second;
+          queue.emplace_back(d, next);
+          std::push_heap(queue.begin(), queue.end(), cmp);
+        }
+      }
+    }
+  }
+  //--------------------------------------------- COMPUTE FIELD ----------------------------------------------
+  void FlowFields::computeField(int destinationId, std::vector<std::uint8_t> &directions,
+                                std::vector<int> &cost, std::vector< std::pair<int,int> > &open) const
+  {
+    // Tiles are indexed in the padded grid, where the border is never passable
+    int stride = width + 2;
+    int offsets[8];
+    for ( int d = 0; d < 8; ++d )
+      offsets[d] = DIRECTIONS[d][1] * stride + DIRECTIONS[d][0];
+
+    directions.assign(static_cast<size_t>(width) * height, NO_DIRECTION);
+    cost.assign(passable.size(), -1);
+    open.clear();
+
+    // Dijkstra's algorithm from the destination tile. Each tile points back to the tile that it
+    // was reached from, which is the next step on a shortest path to the destination.
+    auto cmp = std::greater< std::pair<int,int> >();
+    WalkPosition goal = destinations[destinationId];
+    int start = (goal.y + 1) * stride + goal.x + 1;
+    cost[start] = 0;
+    open.emplace_back(0, start);
+    while ( !open.empty() )
+    {
+      std::pop_heap(open.begin(), open.end(), cmp);
+      std::pair<int,int> top = open.back();
+      open.pop_back();
+      if ( top.first > cost[top.second] )
+        continue;
+
+      for ( int d = 0; d < 8; ++d )
+      {
+        int next = top.second + offsets[d];
+        if ( !passable[next] )
+          continue;
+
+        // Diagonal moves may not cut corners
+        bool diagonal = d >= 4;
+        if ( diagonal && (!passable[top.second + DIRECTIONS[d][0]] || !passable[top.second + DIRECTIONS[d][1] * stride]) )
+          continue;
+
+        int newCost = top.first + (diagonal ? DIAGONAL_COST : STRAIGHT_COST);
+        if ( cost[next] == -1 || newCost < cost[next] )
+        {
+          cost[next] = newCost;
+          directions[(next / stride - 1) * width + next % stride - 1] = static_cast<std::uint8_t>(d ^ 1);
+          open.emplace_back(newCost, next);
+          std::push_heap(open.begin(), open.end(), cmp);
+        }
+      }
+    }
+  }
+  //--------------------------------------------- START WORKER -----------------------------------------------
+  void FlowFields::startWorker()
+  {
+    if ( worker.joinable() )
+      return;
+    stopping = false;
+    worker = std::thread(&FlowFields::runWorker, this);
+  }
+  //--------------------------------------------- STOP WORKER ------------------------------------------------
+  void FlowFields::stopWorker()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if ( !worker.joinable() )
+        return;
+      stopping = true;
+      pending.clear();
+    }
+    wakeup.notify_all();
+    worker.join();
+    idle.notify_all();
+  }
+  //--------------------------------------------- RUN WORKER -------------------------------------------------
+  void FlowFields::runWorker()
+  {
+    std::vector<std::uint8_t> directions;
+    std::vector<int> cost;
+    std::vector< std::pair<int,int> > open;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;)
+    {
+      wakeup.wait(lock, [this]() { return stopping || !pending.empty(); });
+      if ( stopping )
+        break;
+
+      int destinationId = pending.front();
+      pending.pop_front();
+      ++busy;
+
+      // The map does not change while the worker runs, so the field is computed without the lock
+      lock.unlock();
+      this->computeField(destinationId, directions, cost, open);
+      lock.lock();
+
+      --busy;
+      auto it = cacheIndex.find(destinationId);
+      if ( it != cacheIndex.end() )
+      {
+        it->second->directions.swap(directions);
+        it->second->queued = false;
+      }
+      if ( pending.empty() && busy == 0 )
+        idle.notify_all();
+    }
+  }
+  //--------------------------------------------- SET BACKGROUND COMPUTATION ---------------------------------
+  void FlowFields::setBackgroundComputation(bool enabled)
+  {
+    if ( !enabled )
+      this->waitUntilIdle();
+    std::lock_guard<std::mutex> lock(mutex);
+    background = enabled;
+  }
+  //--------------------------------------------- SET CACHE SIZE ---------------------------------------------
+  void FlowFields::setCacheSize(size_t size)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    cacheSize = size;
+    this->evict(cacheSize);
+  }
+  size_t FlowFields::getCacheSize() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cacheSize;
+  }
+  //--------------------------------------------- CLEAR CACHE ------------------------------------------------
+  void FlowFields::clearCache()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->evict(0);
+    cacheHits = cacheMisses = 0;
+  }
+  unsigned int FlowFields::getCacheHits() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cacheHits;
+  }
+  unsigned int FlowFields::getCacheMisses() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cacheMisses;
+  }
+}
@@ -7,6 +7,7 @@
 #include <BWAPI/Region.h>
 #include <BWAPI/Filters.h>
 #include <BWAPI/Player.h>
+#include <BWAPI/MapAnalysis.h>
 
 #include <BWAPI/UnitSizeType.h>
 #include <BWAPI/DamageType.h>
@@ -14,6 +15,10 @@
 #include <BWAPI/WeaponType.h>
 
 #include <cstdarg>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
 
 // Needed by other compilers.
 #include <cstring>
@@ -600,6 +605,453 @@ namespace BWAPI
 
     return bestPosition;
   }
+  //------------------------------------------ BUILD LOCATIONS ---------------------------------------
+  // One bit per build tile of the whole map, stored in rows of 64 bit words
+  class PlacementGrid
+  {
+  public:
+    PlacementGrid(int width, int height)
+      : width(width), height(height), stride((width + 63) / 64)
+      , bits(static_cast<size_t>(stride) * height, 0)
+    {};
+
+    bool getValue(int x, int y) const
+    {
+      if ( x < 0 || y < 0 || x >= width || y >= height )
+        return false;
+      return ((bits[y * stride + x / 64] >> (x % 64)) & 1) != 0;
+    };
+    void setValue(int x, int y)
+    {
+      if ( x >= 0 && y >= 0 && x < width && y < height )
+        bits[y * stride + x / 64] |= 1ull << (x % 64);
+    };
+    void setRange(TilePosition lt, TilePosition rb)
+    {
+      for ( int y = lt.y; y < rb.y; ++y )
+        for ( int x = lt.x; x < rb.x; ++x )
+          this->setValue(x,y);
+    };
+
+    // Bit i of the result is the value at (x + i, y), tiles outside of the map are 0
+    std::uint64_t getRow(int x, int y) const
+    {
+      if ( y < 0 || y >= height || x <= -64 || x >= width )
+        return 0;
+      if ( x < 0 )
+        return this->getWord(0, y) << -x;
+
+      int shift = x % 64;
+      std::uint64_t result = this->getWord(x / 64, y) >> shift;
+      if ( shift != 0 )
+        result |= this->getWord(x / 64 + 1, y) << (64 - shift);
+      return result;
+    };
+
+    // Bit i of the result is set if a structure of the given size with its top left tile at
+    // (x + i, y) covers a set tile
+    std::uint64_t getFootprintRow(int x, int y, TilePosition size) const
+    {
+      std::uint64_t low = 0, high = 0;
+      for ( int row = y; row < y + size.y; ++row )
+      {
+        low |= this->getRow(x, row);
+        high |= this->getRow(x + 64, row);
+      }
+
+      std::uint64_t result = low;
+      for ( int i = 1; i < size.x; ++i )
+        result |= (low >> i) | (high << (64 - i));
+      return result;
+    };
+  private:
+    std::uint64_t getWord(int i, int y) const
+    {
+      return i < stride ? bits[y * stride + i] : 0;
+    };
+
+    int width, height, stride;
+    std::vector<std::uint64_t> bits;
+  };
+
+  // Same as PlacementReserve with one bit per position, bit x of row y is the value at (x,y)
+  class PlacementMask
+  {
+  public:
+    PlacementMask(int maxRange)
+    {
+      // The area that PlacementReserve::iterate visits
+      int maxSearch = std::min(std::max(0,maxRange),MAX_RANGE);
+      int min = MAX_RANGE/2 - maxSearch/2;
+      std::uint64_t columns = maxSearch == MAX_RANGE ? ~0ull : ((1ull << maxSearch) - 1) << min;
+      for ( int y = 0; y < MAX_RANGE; ++y )
+        searchArea[y] = (y >= min && y < min + maxSearch) ? columns : 0;
+
+      memset(data,0,sizeof(data));
+      this->backup();
+    };
+
+    std::uint64_t getRow(int y) const
+    {
+      return data[y];
+    };
+    std::uint64_t getSearchArea(int y) const
+    {
+      return searchArea[y];
+    };
+    void setRow(int y, std::uint64_t value)
+    {
+      data[y] = value & searchArea[y];
+    };
+    void removeFromRow(int y, std::uint64_t value)
+    {
+      data[y] &= ~value;
+    };
+    void setValue(int x, int y, bool value)
+    {
+      if ( !PlacementReserve::isValidPos(x,y) )
+        return;
+      if ( value )
+        this->setRow(y, data[y] | (1ull << x));
+      else
+        this->removeFromRow(y, 1ull << x);
+    };
+
+    bool hasValidSpace() const
+    {
+      for ( int y = 0; y < MAX_RANGE; ++y )
+      {
+        if ( data[y] != 0 )
+          return true;
+      }
+      return false;
+    };
+
+    void backup()
+    {
+      memcpy(save, data, sizeof(data));
+    };
+    void restoreIfInvalid()
+    {
+      if ( !hasValidSpace() )
+        memcpy(data, save, sizeof(data));
+    };
+  private:
+    std::uint64_t data[MAX_RANGE];
+    std::uint64_t save[MAX_RANGE];
+    std::uint64_t searchArea[MAX_RANGE];
+  };
+
+  // The padding that ReserveDefault keeps around an owned unit
+  int getDefaultPadding(UnitType type)
+  {
+    switch ( type )
+    {
+    case UnitTypes::Enum::Terran_Barracks:
+    case UnitTypes::Enum::Terran_Bunker:
+    case UnitTypes::Enum::Zerg_Creep_Colony:
+      return 1;
+    default:
+      return 2;
+    }
+  }
+
+  // Marks the tiles that a structure must not cover to stay out of the space that
+  // ReserveStructureWithPadding reserves around a unit. That function removes the positions
+  // from currentPosition - size - paddingSize/2 - 1 up to currentPosition + paddingSize -
+  // paddingSize/2, which are exactly the positions where the footprint of the new structure
+  // overlaps these tiles, whatever its size.
+  void PaintStructureWithPadding(PlacementGrid &grid, TilePosition currentPosition, TilePosition sizeExtra, int padding)
+  {
+    TilePosition paddingSize = sizeExtra + TilePosition(padding,padding)*2;
+    TilePosition topLeft = currentPosition - paddingSize/2 - TilePosition(2,2);
+    TilePosition bottomRight = currentPosition + paddingSize - paddingSize/2;
+    grid.setRange(topLeft, bottomRight);
+  }
+
+  // Finds the build locations of several structures. The units are examined once, their
+  // reservations are painted on map wide bit grids, and each structure that is placed is added
+  // to the grids, so that every request gets the same result that getBuildLocation would
+  // return if construction of the previous structures had already started.
+  class PlacementPlanner
+  {
+  public:
+    PlacementPlanner(int maxRange)
+      : maxRange(maxRange)
+      , width(Broodwar->mapWidth()), height(Broodwar->mapHeight())
+      , planned(width, height), resources(width, height), depots(width, height)
+      , structures(width, height), addons(width, height)
+      , groundHeights(static_cast<size_t>(width) * height, -1)
+    {
+      // The units of ReserveAllStructures, ReserveExistingAddonPlacement and ReserveDefault
+      for ( auto &u : Broodwar->self()->getUnits() )
+      {
+        if ( !u->exists() )
+          continue;
+
+        UnitType type = u->getType();
+        TilePosition currentPosition(u->getPosition());
+        PaintStructureWithPadding(structures, currentPosition, type.tileSize(), getDefaultPadding(type));
+        if ( (u->isCompleted() || (type.producesLarva() && u->isMorphing())) && type.isBuilding() && (type.isResourceDepot() || type.isRefinery()) )
+          PaintStructureWithPadding(depots, currentPosition, type.tileSize(), 2);
+        if ( type.canBuildAddon() )
+          addons.setRange(u->getTilePosition() + TilePosition(4,1), u->getTilePosition() + TilePosition(6,3));
+      }
+      for ( auto &u : Broodwar->getNeutralUnits() )
+      {
+        if ( u->exists() && u->getType().isResourceContainer() )
+          PaintStructureWithPadding(resources, TilePosition(u->getPosition()), u->getType().tileSize(), 2);
+      }
+    };
+
+    TilePosition place(UnitType type, TilePosition desiredPosition)
+    {
+      // Do type-specific checks
+      bool trimPlacement = true;
+      switch ( type )
+      {
+      case UnitTypes::Enum::Protoss_Pylon:
+        if ( Unit pSpecialUnitTarget = Broodwar->getClosestUnit(Position(desiredPosition), IsOwned && !IsPowered) )
+        {
+          desiredPosition = TilePosition(pSpecialUnitTarget->getPosition());
+          trimPlacement = false;
+        }
+        break;
+      case UnitTypes::Enum::Terran_Command_Center:
+      case UnitTypes::Enum::Protoss_Nexus:
+      case UnitTypes::Enum::Zerg_Hatchery:
+      case UnitTypes::Enum::Special_Start_Location:
+        trimPlacement = false;
+        break;
+      }
+
+      PlacementMask mask(maxRange);
+      this->reservePlacement(mask, type, desiredPosition);
+
+      if ( trimPlacement )
+      {
+        mask.backup();
+        for ( buildTemplate *t = buildTemplates; t->startX != -1; ++t )
+        {
+          int x = t->startX, y = t->startY;
+          for ( int i = 0; i < 64; ++i )
+          {
+            mask.setValue(x, y, false);
+            x += t->stepX;
+            y += t->stepY;
+          }
+        }
+        mask.restoreIfInvalid();
+      }
+
+      // Find the best position
+      TilePosition centerPosition = desiredPosition - TilePosition(MAX_RANGE,MAX_RANGE)/2;
+      int bestDistance = 999999, fallbackDistance = 999999;
+      TilePosition bestPosition = TilePositions::None, fallbackPosition = TilePositions::None;
+      for ( int y = 0; y < MAX_RANGE; ++y )
+      {
+        for ( std::uint64_t row = mask.getRow(y); row != 0; row &= row - 1 )
+        {
+          int x = lowestBit(row);
+          TilePosition currentPosition(TilePosition(x,y) + centerPosition);
+          int currentDistance = desiredPosition.getApproxDistance(currentPosition);
+          if ( currentDistance < bestDistance )
+          {
+            if ( currentDistance <= maxRange )
+            {
+              bestDistance = currentDistance;
+              bestPosition = currentPosition;
+            }
+            else if ( currentDistance < fallbackDistance )
+            {
+              fallbackDistance = currentDistance;
+              fallbackPosition = currentPosition;
+            }
+          }
+        }
+      }
+      if ( bestPosition == TilePositions::None )
+        bestPosition = fallbackPosition;
+
+      if ( bestPosition != TilePositions::None )
+        this->addStructure(type, bestPosition);
+      return bestPosition;
+    };
+  private:
+    static int lowestBit(std::uint64_t value)
+    {
+      int result = 0;
+      while ( !(value & 1) )
+      {
+        value >>= 1;
+        ++result;
+      }
+      return result;
+    };
+
+    // Adds a placed structure to the grids, as if its construction had started
+    void addStructure(UnitType type, TilePosition position)
+    {
+      planned.setRange(position, position + type.tileSize());
+      PaintStructureWithPadding(structures, TilePosition(Position(position) + Position(type.tileSize())/2), type.tileSize(), getDefaultPadding(type));
+      if ( type.canBuildAddon() )
+        addons.setRange(position + TilePosition(4,1), position + TilePosition(6,3));
+    };
+
+    // Game::canBuildHere, remembered for each type and tile
+    bool canBuildHere(TilePosition position, UnitType type)
+    {
+      if ( !position.isValid() )
+        return false;
+
+      auto it = buildable.find(type);
+      if ( it == buildable.end() )
+        it = buildable.insert(std::make_pair(type, std::make_pair(PlacementGrid(width, height), PlacementGrid(width, height)))).first;
+
+      PlacementGrid &known = it->second.first, &result = it->second.second;
+      if ( !known.getValue(position.x, position.y) )
+      {
+        known.setValue(position.x, position.y);
+        if ( Broodwar->canBuildHere(position, type) )
+          result.setValue(position.x, position.y);
+      }
+      return result.getValue(position.x, position.y);
+    };
+
+    // Game::getGroundHeight, remembered for each tile
+    int getGroundHeight(TilePosition position)
+    {
+      signed char &value = groundHeights[position.y * width + position.x];
+      if ( value == -1 )
+        value = static_cast<signed char>(Broodwar->getGroundHeight(position));
+      return value;
+    };
+
+    // Same steps as ReservePlacement, on whole rows of the mask
+    void reservePlacement(PlacementMask &mask, UnitType type, TilePosition desiredPosition)
+    {
+      TilePosition start = desiredPosition - TilePosition(MAX_RANGE,MAX_RANGE)/2;
+      TilePosition size = type.tileSize();
+
+      // Assign 1 to all buildable, connected locations on the map. Planned structures occupy
+      // their tiles and the addon space is checked as well. Only the tiles within maxRange are
+      // examined, since the others can never be set.
+      bool hasAddon = type.canBuildAddon();
+      for ( int y = 0; y < MAX_RANGE; ++y )
+      {
+        std::uint64_t candidates = mask.getSearchArea(y);
+        if ( candidates == 0 )
+          continue;
+        candidates &= ~planned.getFootprintRow(start.x, start.y + y, size);
+        if ( hasAddon )
+          candidates &= ~planned.getFootprintRow(start.x + 4, start.y + y + 1, TilePosition(2,2));
+
+        std::uint64_t row = 0;
+        for ( ; candidates != 0; candidates &= candidates - 1 )
+        {
+          int x = lowestBit(candidates);
+          TilePosition currentPosition = start + TilePosition(x,y);
+          if ( !currentPosition.isValid() )
+            continue;
+
+          if ( (!hasAddon || this->canBuildHere(currentPosition + TilePosition(4,1), UnitTypes::Terran_Missile_Turret)) &&
+               this->canBuildHere(currentPosition, type) &&
+               Broodwar->hasPath(Position(desiredPosition), Position(currentPosition)) )
+            row |= 1ull << x;
+        }
+        mask.setRow(y, row);
+      }
+
+      // Return if can't find a valid space
+      if ( !mask.hasValidSpace() )
+        return;
+
+      // Exclude locations with a different ground height
+      mask.backup();
+      int targetHeight = Broodwar->getGroundHeight(desiredPosition);
+      for ( int y = 0; y < MAX_RANGE; ++y )
+      {
+        for ( std::uint64_t row = mask.getRow(y); row != 0; row &= row - 1 )
+        {
+          int x = lowestBit(row);
+          if ( this->getGroundHeight(start + TilePosition(x,y)) != targetHeight )
+            mask.setValue(x, y, false);
+        }
+      }
+      mask.restoreIfInvalid();
+
+      if ( !type.isResourceDepot() )
+      {
+        // Reserve space around owned resource depots and resource containers
+        if ( !type.isAddon() )
+        {
+          mask.backup();
+          for ( int y = 0; y < MAX_RANGE; ++y )
+          {
+            mask.removeFromRow(y, depots.getFootprintRow(start.x, start.y + y, size));
+            if ( type != UnitTypes::Terran_Bunker )
+              mask.removeFromRow(y, resources.getFootprintRow(start.x, start.y + y, size));
+          }
+          mask.restoreIfInvalid();
+        }
+
+        // Exclude addon placement locations
+        mask.backup();
+        for ( int y = 0; y < MAX_RANGE; ++y )
+          mask.removeFromRow(y, addons.getRow(start.x, start.y + y));
+        mask.restoreIfInvalid();
+      }
+
+      // Reserve some space around owned units
+      switch ( type )
+      {
+      case UnitTypes::Enum::Protoss_Pylon:
+      case UnitTypes::Enum::Terran_Bunker:
+      case UnitTypes::Enum::Terran_Missile_Turret:
+      case UnitTypes::Enum::Protoss_Photon_Cannon:
+      case UnitTypes::Enum::Zerg_Creep_Colony:
+        break;
+      default:
+        if ( !type.isResourceDepot() )
+        {
+          mask.backup();
+          for ( int y = 0; y < MAX_RANGE; ++y )
+            mask.removeFromRow(y, structures.getFootprintRow(start.x, start.y + y, size));
+          mask.restoreIfInvalid();
+        }
+        break;
+      }
+    };
+
+    int maxRange;
+    int width, height;
+    PlacementGrid planned, resources, depots, structures, addons;
+    std::map< UnitType, std::pair<PlacementGrid,PlacementGrid> > buildable;
+    std::vector<signed char> groundHeights;
+  };
+
+  // ----- GET BUILD LOCATIONS
+  std::vector<TilePosition> Game::getBuildLocations(const std::vector< std::pair<UnitType, TilePosition> > &requests, int maxRange, bool /*creep*/) const
+  {
+    this->setLastError(); // Reset last error
+
+    std::vector<TilePosition> result;
+    result.reserve(requests.size());
+
+    PlacementPlanner planner(maxRange);
+    for ( auto &r : requests )
+    {
+      // Make sure the type is compatible
+      if ( !r.first.isBuilding() )
+      {
+        this->setLastError(Errors::Incompatible_UnitType);
+        result.push_back(TilePositions::Invalid);
+        continue;
+      }
+      result.push_back(planner.place(r.first, r.second));
+    }
+    return result;
+  }
   //------------------------------------------ ACTIONS -----------------------------------------------
   bool Game::setMap(const std::string &mapFileName)
   {
@@ -686,6 +1138,10 @@ namespace BWAPI
   {
     return this->hasCreep(position.x, position.y);
   }
+  bool Game::isTileChanged(TilePosition position, TileLayer::Enum layer) const
+  {
+    return this->isTileChanged(position.x, position.y, layer);
+  }
   Unitset Game::getUnitsOnTile(int tileX, int tileY, const UnitFilter &pred) const
   {
     return this->getUnitsOnTile(TilePosition(tileX,tileY), pred);
@@ -740,6 +1196,58 @@ namespace BWAPI
     }
     return this->setLastError(Errors::Unreachable_Location);
   }
+  //------------------------------------------ GET GROUND DISTANCE ------------------------------------
+  int Game::getGroundDistance(Position source, Position destination) const
+  {
+    this->setLastError();
+    if ( source.isValid() && destination.isValid() )
+    {
+      Region rgnA = getRegionAt(source);
+      Region rgnB = getRegionAt(destination);
+      if ( rgnA && rgnB )
+      {
+        int distance = MapAnalysis::getRegionDistances().getGroundDistance(source, rgnA->getID(), destination, rgnB->getID());
+        if ( distance >= 0 )
+          return distance;
+      }
+    }
+    this->setLastError(Errors::Unreachable_Location);
+    return -1;
+  }
+  //------------------------------------------ GET GROUND PATH ----------------------------------------
+  int Game::getGroundPath(Position source, Position destination, std::vector<Position> &path, UnitType type) const
+  {
+    this->setLastError();
+    path.clear();
+    if ( source.isValid() && destination.isValid() )
+    {
+      std::vector<WalkPosition> walkPath;
+      int size = type == UnitTypes::None ? 1 : Pathfinder::getUnitSize(type);
+      int length = MapAnalysis::getPathfinder().findPath(WalkPosition(source), WalkPosition(destination), size, walkPath);
+      if ( length >= 0 )
+      {
+        // Use the exact end points and the centers of the walk tiles in between
+        path.push_back(source);
+        for ( size_t i = 1; i + 1 < walkPath.size(); ++i )
+          path.push_back(Position(walkPath[i]) + Position(4, 4));
+        if ( walkPath.size() > 1 )
+          path.push_back(destination);
+        return length;
+      }
+    }
+    this->setLastError(Errors::Unreachable_Location);
+    return -1;
+  }
+  //------------------------------------------ GET CLEARANCE ------------------------------------------
+  int Game::getClearance(WalkPosition position) const
+  {
+    return MapAnalysis::getClearanceMap().getDistance(position);
+  }
+  //------------------------------------------ IS PASSABLE --------------------------------------------
+  bool Game::isPassable(WalkPosition position, UnitType type) const
+  {
+    return MapAnalysis::getClearanceMap().isPassable(position, type);
+  }
   //------------------------------------------ DRAW TEXT ----------------------------------------------
   void Game::drawText(CoordinateType::Enum ctype, int x, int y, const char *format, ...)
   {
@@ -0,0 +1,312 @@
+#include <BWAPI/InfluenceMap.h>
+#include <BWAPI/Unit.h>
+#include <BWAPI/Unitset.h>
+#include <BWAPI/Player.h>
+#include <BWAPI/UnitType.h>
+#include <BWAPI/WeaponType.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+  #define BWAPI_INFLUENCE_AVX2
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+  #include <emmintrin.h>
+  #define BWAPI_INFLUENCE_SSE2
+#endif
+
+namespace BWAPI
+{
+  namespace
+  {
+    // Rounds towards negative infinity, so that positions left of the map get negative cells
+    inline int floorDivide(int value, int divisor)
+    {
+      return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+    }
+
+    // Adds a value to a span of cells
+    inline void addSpan(std::int32_t *cells, int count, int value)
+    {
+      int i = 0;
+#if defined(BWAPI_INFLUENCE_AVX2)
+      __m256i v = _mm256_set1_epi32(value);
+      for ( ; i + 8 <= count; i += 8 )
+      {
+        __m256i *p = reinterpret_cast<__m256i*>(&cells[i]);
+        _mm256_storeu_si256(p, _mm256_add_epi32(_mm256_loadu_si256(p), v));
+      }
+#elif defined(BWAPI_INFLUENCE_SSE2)
+      __m128i v = _mm_set1_epi32(value);
+      for ( ; i + 4 <= count; i += 4 )
+      {
+        __m128i *p = reinterpret_cast<__m128i*>(&cells[i]);
+        _mm_storeu_si128(p, _mm_add_epi32(_mm_loadu_si128(p), v));
+      }
+#endif
+      // Remainder
+      for ( ; i < count; ++i )
+        cells[i] += value;
+    }
+
+    // Scarabs and interceptors have a weapon cooldown of one frame. These are the intervals at
+    // which reavers and interceptors attack with them.
+    const int SCARAB_COOLDOWN = 60;
+    const int INTERCEPTOR_COOLDOWN = 37;
+
+    // Adds the threat of the weapons of a unit type to the radius and value of each layer. The
+    // values of several units are summed and the largest range is kept.
+    void addThreat(Player player, UnitType type, int count, int rangeBonus, int radius[], int value[])
+    {
+      WeaponType weapons[InfluenceMap::LayerCount] = { type.groundWeapon(), type.airWeapon() };
+      for ( int layer = 0; layer < InfluenceMap::LayerCount; ++layer )
+      {
+        WeaponType weapon = weapons[layer];
+        if ( weapon == WeaponTypes::None || weapon == WeaponTypes::Unknown )
+          continue;
+
+        // Player::weaponDamageCooldown only applies to the ground weapon
+        int damage = player ? player->damage(weapon) : weapon.damageAmount() * weapon.damageFactor();
+        int cooldown = player && weapon == type.groundWeapon() ? player->weaponDamageCooldown(type) : weapon.damageCooldown();
+        int range = player ? player->weaponMaxRange(weapon) : weapon.maxRange();
+        if ( type == UnitTypes::Protoss_Scarab )
+          cooldown = SCARAB_COOLDOWN;
+        else if ( type == UnitTypes::Protoss_Interceptor )
+          cooldown = INTERCEPTOR_COOLDOWN;
+
+        value[layer] += count * (damage * 256 / std::max(cooldown, 1));
+        radius[layer] = std::max(radius[layer], range + rangeBonus);
+      }
+    }
+
+    // The number of interceptors of a carrier when they are not known, such as for the units of
+    // other players
+    const int DEFAULT_INTERCEPTOR_COUNT = 4;
+  }
+  //--------------------------------------------- RESET ------------------------------------------------------
+  void InfluenceMap::reset(int mapWidth, int mapHeight, int resolution)
+  {
+    this->clear();
+    if ( mapWidth <= 0 || mapHeight <= 0 || resolution <= 0 || resolution > TileResolution )
+      return;
+
+    this->resolution = resolution;
+    width = mapWidth * TileResolution / resolution;
+    height = mapHeight * TileResolution / resolution;
+    for ( auto &layer : layers )
+      layer.assign(static_cast<size_t>(width) * height, 0);
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void InfluenceMap::clear()
+  {
+    width = height = 0;
+    for ( auto &layer : layers )
+      layer.clear();
+    sources.clear();
+    activeSources.clear();
+    spans.clear();
+  }
+  //--------------------------------------------- SET SOURCE -------------------------------------------------
+  void InfluenceMap::setSource(int id, Position position, int groundRadius, int groundValue, int airRadius, int airValue)
+  {
+    if ( id < 0 || width == 0 )
+      return;
+    if ( static_cast<size_t>(id) >= sources.size() )
+      sources.resize(id + 1);
+
+    Source &s = sources[id];
+    s.lastUpdate = updateCount;
+
+    int cellX = floorDivide(position.x, resolution);
+    int cellY = floorDivide(position.y, resolution);
+    int radius[LayerCount] = { groundRadius, airRadius };
+    int value[LayerCount] = { groundValue, airValue };
+
+    if ( !s.active )
+    {
+      s.active = true;
+      s.index = static_cast<int>(activeSources.size());
+      activeSources.push_back(id);
+    }
+    else if ( s.cellX == cellX && s.cellY == cellY && std::equal(radius, radius + LayerCount, s.radius) && std::equal(value, value + LayerCount, s.value) )
+    {
+      // Nothing changed
+      return;
+    }
+    else
+    {
+      for ( int layer = 0; layer < LayerCount; ++layer )
+        this->stamp(static_cast<Layer>(layer), s.cellX, s.cellY, s.radius[layer], -s.value[layer]);
+    }
+
+    s.cellX = cellX;
+    s.cellY = cellY;
+    for ( int layer = 0; layer < LayerCount; ++layer )
+    {
+      s.radius[layer] = radius[layer];
+      s.value[layer] = value[layer];
+      this->stamp(static_cast<Layer>(layer), cellX, cellY, radius[layer], value[layer]);
+    }
+  }
+  //--------------------------------------------- REMOVE SOURCE ----------------------------------------------
+  bool InfluenceMap::removeSource(int id)
+  {
+    if ( id < 0 || static_cast<size_t>(id) >= sources.size() || !sources[id].active )
+      return false;
+
+    Source &s = sources[id];
+    for ( int layer = 0; layer < LayerCount; ++layer )
+      this->stamp(static_cast<Layer>(layer), s.cellX, s.cellY, s.radius[layer], -s.value[layer]);
+
+    // Move the last active source into the free slot
+    int last = activeSources.back();
+    activeSources[s.index] = last;
+    sources[last].index = s.index;
+    activeSources.pop_back();
+    s.active = false;
+    return true;
+  }
+  //--------------------------------------------- UPDATE UNIT ------------------------------------------------
+  void InfluenceMap::updateUnit(Unit unit)
+  {
+    if ( !unit )
+      return;
+    if ( !unit->exists() || !unit->isCompleted() )
+    {
+      this->removeSource(unit->getID());
+      return;
+    }
+
+    Player player = unit->getPlayer();
+    UnitType type = unit->getType();
+    int radius[LayerCount] = { 0, 0 };
+    int value[LayerCount] = { 0, 0 };
+    switch ( type )
+    {
+    case UnitTypes::Enum::Protoss_Reaver:
+    case UnitTypes::Enum::Hero_Warbringer:
+      // Reavers attack with scarabs, which travel up to the seek range of the reaver
+      addThreat(player, UnitTypes::Protoss_Scarab, 1, 0, radius, value);
+      radius[Ground] = std::max(radius[Ground], type.seekRange());
+      break;
+    case UnitTypes::Enum::Protoss_Carrier:
+    case UnitTypes::Enum::Hero_Gantrithor:
+      {
+        // Carriers attack with their interceptors, which are launched within the seek range of
+        // the carrier
+        int count = unit->getInterceptorCount();
+        addThreat(player, UnitTypes::Protoss_Interceptor, count > 0 ? count : DEFAULT_INTERCEPTOR_COUNT, 0, radius, value);
+        for ( int layer = 0; layer < LayerCount; ++layer )
+          radius[layer] = std::max(radius[layer], type.seekRange());
+      }
+      break;
+    case UnitTypes::Enum::Terran_Bunker:
+      {
+        // Bunkers attack with the weapons of their loaded units, with one more tile of range. A
+        // bunker whose loaded units are not known is assumed to be full of marines.
+        Unitset loaded = unit->getLoadedUnits();
+        for ( auto &u : loaded )
+          addThreat(player, u->getType(), 1, 32, radius, value);
+        if ( loaded.empty() )
+          addThreat(player, UnitTypes::Terran_Marine, type.spaceProvided() / UnitTypes::Terran_Marine.spaceRequired(), 32, radius, value);
+      }
+      break;
+    default:
+      addThreat(player, type, 1, 0, radius, value);
+      break;
+    }
+
+    if ( value[Ground] == 0 && value[Air] == 0 )
+    {
+      this->removeSource(unit->getID());
+      return;
+    }
+    for ( auto &r : radius )
+      r += std::max(type.width(), type.height()) / 2;
+    this->setSource(unit->getID(), unit->getPosition(), radius[Ground], value[Ground], radius[Air], value[Air]);
+  }
+  //--------------------------------------------- UPDATE -----------------------------------------------------
+  void InfluenceMap::update(const Unitset &units)
+  {
+    ++updateCount;
+    for ( auto &u : units )
+      this->updateUnit(u);
+
+    // Remove the sources of units that are not in the set anymore
+    for ( size_t i = 0; i < activeSources.size(); )
+    {
+      if ( sources[activeSources[i]].lastUpdate != updateCount )
+        this->removeSource(activeSources[i]);
+      else
+        ++i;
+    }
+  }
+  //--------------------------------------------- GET VALUE --------------------------------------------------
+  int InfluenceMap::getValue(Layer layer, int x, int y) const
+  {
+    if ( layer < 0 || layer >= LayerCount || x < 0 || y < 0 || x >= width || y >= height )
+      return 0;
+    return layers[layer][y * width + x];
+  }
+  int InfluenceMap::getValue(Layer layer, Position position) const
+  {
+    return this->getValue(layer, floorDivide(position.x, resolution), floorDivide(position.y, resolution));
+  }
+  //--------------------------------------------- GET SPANS --------------------------------------------------
+  const std::vector<int> &InfluenceMap::getSpans(int radius)
+  {
+    auto it = spans.find(radius);
+    if ( it != spans.end() )
+      return it->second;
+
+    // Half width, in cells, of each row of the disc from the center row down. Cell centers are
+    // a whole number of cells apart, so a cell is covered when (dx^2 + dy^2) * resolution^2 is
+    // at most radius^2.
+    std::vector<int> &result = spans[radius];
+    long long radiusSquared = static_cast<long long>(radius) * radius;
+    long long cellSquared = static_cast<long long>(resolution) * resolution;
+    for ( long long dy = 0; dy * dy * cellSquared <= radiusSquared; ++dy )
+    {
+      long long dx = static_cast<long long>(std::sqrt(static_cast<double>(radiusSquared / cellSquared - dy * dy)));
+      while ( (dx + 1) * (dx + 1) * cellSquared + dy * dy * cellSquared <= radiusSquared )
+        ++dx;
+      while ( dx > 0 && dx * dx * cellSquared + dy * dy * cellSquared > radiusSquared )
+        --dx;
+      result.push_back(static_cast<int>(dx));
+    }
+    return result;
+  }
+  //--------------------------------------------- STAMP ------------------------------------------------------
+  void InfluenceMap::stamp(Layer layer, int cellX, int cellY, int radius, int value)
+  {
+    if ( value == 0 || radius < 0 )
+      return;
+
+    const std::vector<int> &halfWidths = this->getSpans(radius);
+    int rows = static_cast<int>(halfWidths.size());
+    for ( int dy = -(rows - 1); dy < rows; ++dy )
+    {
+      int y = cellY + dy;
+      if ( y < 0 || y >= height )
+        continue;
+
+      int halfWidth = halfWidths[std::abs(dy)];
+      int left = std::max(cellX - halfWidth, 0);
+      int right = std::min(cellX + halfWidth + 1, width);
+      if ( left < right )
+        addSpan(&layers[layer][y * width + left], right - left, value);
+    }
+  }
+  //--------------------------------------------- GET INSTRUCTION SET ----------------------------------------
+  const char *InfluenceMap::getInstructionSet()
+  {
+#if defined(BWAPI_INFLUENCE_AVX2)
+    return "AVX2";
+#elif defined(BWAPI_INFLUENCE_SSE2)
+    return "SSE2";
+#else
+    return "Scalar";
+#endif
+  }
+}
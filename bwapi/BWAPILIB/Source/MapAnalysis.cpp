@@ -0,0 +1,345 @@
+#include <BWAPI/MapAnalysis.h>
+#include <BWAPI/Game.h>
+#include <BWAPI/Region.h>
+#include <BWAPI/Regionset.h>
+#include <BWAPI/Unit.h>
+#include <BWAPI/Unitset.h>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace BWAPI
+{
+  namespace
+  {
+    RegionDistances regionDistances;
+    Pathfinder pathfinder;
+    ClearanceMap clearanceMap;
+    TerrainAnalysis terrainAnalysis;
+    bool terrainCacheEnabled = true;
+    bool lazyBuildEnabled = false;
+
+    // The flow fields own a worker thread, so they are allocated for each match and deleted when
+    // it ends. As a static object, their destructor would run when a module is unloaded.
+    FlowFields *flowFields = nullptr;
+
+    // Set when each analysis is complete, so that the getters only lock while one is built
+    std::atomic<bool> regionDistancesReady(false);
+    std::atomic<bool> pathfinderReady(false);
+    std::atomic<bool> clearanceMapReady(false);
+    std::atomic<bool> flowFieldsReady(false);
+    std::atomic<bool> terrainAnalysisReady(false);
+
+    // Held while the analyses or the terrain inputs they share are built or released
+    std::recursive_mutex buildMutex;
+
+    // Terrain inputs shared by the analyses, computed once per match
+    std::vector<bool> staticWalkability;
+    std::vector<int> walkRegionIds;
+    std::vector< std::vector<int> > groundNeighbors;
+
+    // Walkable terrain that is not covered by a static building or resource, in walk tiles
+    const std::vector<bool> &getStaticWalkability()
+    {
+      if ( !staticWalkability.empty() )
+        return staticWalkability;
+
+      int width = BroodwarPtr->mapWidth() * 4, height = BroodwarPtr->mapHeight() * 4;
+      std::vector<bool> &walkable = staticWalkability;
+      walkable.resize(static_cast<size_t>(width) * height);
+      for ( int y = 0; y < height; ++y )
+      {
+        for ( int x = 0; x < width; ++x )
+          walkable[y * width + x] = BroodwarPtr->isWalkable(x, y);
+      }
+
+      for ( Unit u : BroodwarPtr->getStaticNeutralUnits() )
+      {
+        UnitType type = u->getInitialType();
+        if ( !type.isBuilding() || type.isFlyer() )
+          continue;
+
+        Position p = u->getInitialPosition();
+        int left = std::max(0, (p.x - type.dimensionLeft()) / 8);
+        int top = std::max(0, (p.y - type.dimensionUp()) / 8);
+        int right = std::min(width - 1, (p.x + type.dimensionRight()) / 8);
+        int bottom = std::min(height - 1, (p.y + type.dimensionDown()) / 8);
+        for ( int y = top; y <= bottom; ++y )
+        {
+          for ( int x = left; x <= right; ++x )
+            walkable[y * width + x] = false;
+        }
+      }
+      return walkable;
+    }
+
+    // The region ID of each walk tile, or -1 for none
+    const std::vector<int> &getRegionIds()
+    {
+      if ( !walkRegionIds.empty() )
+        return walkRegionIds;
+
+      int width = BroodwarPtr->mapWidth() * 4, height = BroodwarPtr->mapHeight() * 4;
+      std::vector<int> &regionIds = walkRegionIds;
+      regionIds.assign(static_cast<size_t>(width) * height, -1);
+      for ( int y = 0; y < height; ++y )
+      {
+        for ( int x = 0; x < width; ++x )
+        {
+          Region region = BroodwarPtr->getRegionAt(x * 8 + 4, y * 8 + 4);
+          if ( region )
+            regionIds[y * width + x] = region->getID();
+        }
+      }
+      return regionIds;
+    }
+
+    // The neighbors of each region, only keeping the connections that ground units can use
+    const std::vector< std::vector<int> > &getGroundNeighbors()
+    {
+      std::vector< std::vector<int> > &neighbors = groundNeighbors;
+      if ( !neighbors.empty() )
+        return neighbors;
+
+      for ( auto region : BroodwarPtr->getAllRegions() )
+      {
+        if ( region->getID() >= static_cast<int>(neighbors.size()) )
+          neighbors.resize(region->getID() + 1);
+        if ( !region->isAccessible() )
+          continue;
+        for ( auto neighbor : region->getNeighbors() )
+        {
+          if ( neighbor->isAccessible() )
+            neighbors[region->getID()].push_back(neighbor->getID());
+        }
+      }
+      return neighbors;
+    }
+
+    // Builds an analysis the first time that any thread requests it, unless it was already
+    // built when the match started
+    template <class _T, class _F>
+    _T &getAnalysis(_T &analysis, std::atomic<bool> &ready, const _F &build)
+    {
+      if ( !ready.load(std::memory_order_acquire) )
+      {
+        std::lock_guard<std::recursive_mutex> lock(buildMutex);
+        if ( !ready.load(std::memory_order_relaxed) && BroodwarPtr )
+        {
+          build();
+          ready.store(true, std::memory_order_release);
+        }
+      }
+      return analysis;
+    }
+
+    std::string getTerrainCacheName(const std::string &hash)
+    {
+      return "terrain-" + hash + ".dat";
+    }
+
+    // Tournament modules read from bwapi-data/read and write to bwapi-data/write
+    bool loadTerrainCache()
+    {
+      std::string hash = BroodwarPtr->mapHash();
+      return terrainCacheEnabled &&
+             (terrainAnalysis.load("bwapi-data/read/" + getTerrainCacheName(hash), hash) ||
+              terrainAnalysis.load("bwapi-data/write/" + getTerrainCacheName(hash), hash));
+    }
+    void saveTerrainCache()
+    {
+      std::string hash = BroodwarPtr->mapHash();
+      if ( terrainCacheEnabled )
+        terrainAnalysis.save("bwapi-data/write/" + getTerrainCacheName(hash), hash);
+    }
+
+    // The terrain and resources that the terrain analysis is computed from, without a clearance map
+    void getTerrainInput(TerrainAnalysis::Input &input)
+    {
+      input.width = BroodwarPtr->mapWidth();
+      input.height = BroodwarPtr->mapHeight();
+      input.buildable.resize(static_cast<size_t>(input.width) * input.height);
+      for ( int y = 0; y < input.height; ++y )
+      {
+        for ( int x = 0; x < input.width; ++x )
+          input.buildable[y * input.width + x] = BroodwarPtr->isBuildable(x, y);
+      }
+      for ( Unit u : BroodwarPtr->getStaticNeutralUnits() )
+      {
+        UnitType type = u->getInitialType();
+        if ( !type.isBuilding() || type.isFlyer() || type.isResourceContainer() )
+          continue;
+
+        TilePosition tp = u->getInitialTilePosition();
+        for ( int y = std::max(0, tp.y); y < std::min(input.height, tp.y + type.tileHeight()); ++y )
+        {
+          for ( int x = std::max(0, tp.x); x < std::min(input.width, tp.x + type.tileWidth()); ++x )
+            input.buildable[y * input.width + x] = false;
+        }
+      }
+
+      input.walkable = getStaticWalkability();
+      input.regionIds = getRegionIds();
+      for ( auto &resources : { &BroodwarPtr->getStaticMinerals(), &BroodwarPtr->getStaticGeysers() } )
+      {
+        for ( Unit u : *resources )
+        {
+          TerrainAnalysis::Resource r;
+          r.type = u->getInitialType();
+          r.tilePosition = u->getInitialTilePosition();
+          r.amount = u->getInitialResources();
+          input.resources.push_back(r);
+        }
+      }
+      auto &starts = BroodwarPtr->getStartLocations();
+      input.startLocations.assign(starts.begin(), starts.end());
+    }
+  }
+  namespace MapAnalysis
+  {
+    //------------------------------------------- ON MATCH START ---------------------------------------------
+    void onMatchStart()
+    {
+      onMatchEnd();
+      if ( lazyBuildEnabled || !BroodwarPtr )
+        return;
+
+      std::lock_guard<std::recursive_mutex> lock(buildMutex);
+      int width = BroodwarPtr->mapWidth() * 4, height = BroodwarPtr->mapHeight() * 4;
+
+      // Everything that is read from the game is gathered on this thread, before the others start,
+      // including the map size that positions are checked against
+      MapBounds::set(BroodwarPtr->mapWidth(), BroodwarPtr->mapHeight());
+      const std::vector<bool> &walkable = getStaticWalkability();
+      const std::vector<int> &regionIds = getRegionIds();
+      const std::vector< std::vector<int> > &neighbors = getGroundNeighbors();
+      TerrainAnalysis::Input terrainInput;
+      bool terrainCached = loadTerrainCache();
+      if ( !terrainCached )
+        getTerrainInput(terrainInput);
+
+      // The pathfinder and the flow fields are built on one thread while the clearance map and
+      // the region distances use the others, and the terrain is analyzed once the clearance map
+      // it depends on is ready
+      flowFields = new FlowFields();
+      std::thread gridThread([&]
+      {
+        pathfinder.build(width, height, walkable, regionIds, neighbors);
+        flowFields->build(width, height, walkable, regionIds, neighbors);
+      });
+      clearanceMap.build(width, height, walkable);
+
+      std::thread terrainThread;
+      if ( !terrainCached )
+      {
+        terrainInput.clearance = &clearanceMap;
+        terrainThread = std::thread([&] { terrainAnalysis.analyze(terrainInput); });
+      }
+      regionDistances.build(BroodwarPtr->getAllRegions());
+
+      if ( terrainThread.joinable() )
+      {
+        terrainThread.join();
+        saveTerrainCache();
+      }
+      gridThread.join();
+
+      regionDistancesReady = true;
+      pathfinderReady = true;
+      clearanceMapReady = true;
+      flowFieldsReady = true;
+      terrainAnalysisReady = true;
+    }
+    //------------------------------------------- ON MATCH END -----------------------------------------------
+    void onMatchEnd()
+    {
+      std::lock_guard<std::recursive_mutex> lock(buildMutex);
+      regionDistancesReady = false;
+      pathfinderReady = false;
+      clearanceMapReady = false;
+      flowFieldsReady = false;
+      terrainAnalysisReady = false;
+
+      regionDistances.clear();
+      pathfinder.clear();
+      clearanceMap.clear();
+      terrainAnalysis.clear();
+      if ( flowFields )
+      {
+        flowFields->clear();
+        delete flowFields;
+        flowFields = nullptr;
+      }
+      std::vector<bool>().swap(staticWalkability);
+      std::vector<int>().swap(walkRegionIds);
+      std::vector< std::vector<int> >().swap(groundNeighbors);
+    }
+    //------------------------------------------- ENABLE TERRAIN CACHE ---------------------------------------
+    void enableTerrainCache(bool enabled)
+    {
+      terrainCacheEnabled = enabled;
+    }
+    //------------------------------------------- ENABLE LAZY BUILD ------------------------------------------
+    void enableLazyBuild(bool enabled)
+    {
+      lazyBuildEnabled = enabled;
+    }
+    //------------------------------------------- GET REGION DISTANCES ---------------------------------------
+    const RegionDistances &getRegionDistances()
+    {
+      return getAnalysis(regionDistances, regionDistancesReady, []
+      {
+        regionDistances.build(BroodwarPtr->getAllRegions());
+      });
+    }
+    //------------------------------------------- GET PATHFINDER ---------------------------------------------
+    Pathfinder &getPathfinder()
+    {
+      return getAnalysis(pathfinder, pathfinderReady, []
+      {
+        pathfinder.build(BroodwarPtr->mapWidth() * 4, BroodwarPtr->mapHeight() * 4, getStaticWalkability(), getRegionIds(), getGroundNeighbors());
+      });
+    }
+    //------------------------------------------- GET CLEARANCE MAP ------------------------------------------
+    const ClearanceMap &getClearanceMap()
+    {
+      return getAnalysis(clearanceMap, clearanceMapReady, []
+      {
+        clearanceMap.build(BroodwarPtr->mapWidth() * 4, BroodwarPtr->mapHeight() * 4, getStaticWalkability());
+      });
+    }
+    //------------------------------------------- GET FLOW FIELDS --------------------------------------------
+    FlowFields &getFlowFields()
+    {
+      if ( !flowFieldsReady.load(std::memory_order_acquire) )
+      {
+        std::lock_guard<std::recursive_mutex> lock(buildMutex);
+        if ( !flowFields )
+          flowFields = new FlowFields();
+        getAnalysis(*flowFields, flowFieldsReady, []
+        {
+          flowFields->build(BroodwarPtr->mapWidth() * 4, BroodwarPtr->mapHeight() * 4, getStaticWalkability(), getRegionIds(), getGroundNeighbors());
+        });
+      }
+      return *flowFields;
+    }
+    //------------------------------------------- GET TERRAIN ANALYSIS ---------------------------------------
+    const TerrainAnalysis &getTerrainAnalysis()
+    {
+      return getAnalysis(terrainAnalysis, terrainAnalysisReady, []
+      {
+        if ( loadTerrainCache() )
+          return;
+
+        TerrainAnalysis::Input input;
+        getTerrainInput(input);
+        input.clearance = &getClearanceMap();
+        terrainAnalysis.analyze(input);
+        saveTerrainCache();
+      });
+    }
+  }
+}
@@ -0,0 +1,724 @@
+#include <BWAPI/Pathfinder.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace BWAPI
+{
+  namespace
+  {
+    // Move costs in thousandths of a walk tile
+    const int STRAIGHT_COST = 1000;
+    const int DIAGONAL_COST = 1414;
+
+    int octileCost(int dx, int dy)
+    {
+      dx = std::abs(dx);
+      dy = std::abs(dy);
+      return STRAIGHT_COST * std::max(dx, dy) + (DIAGONAL_COST - STRAIGHT_COST) * std::min(dx, dy);
+    }
+    int sign(int value)
+    {
+      return (value > 0) - (value < 0);
+    }
+
+    int lowestBit(std::uint32_t value)
+    {
+#ifdef _MSC_VER
+      unsigned long result;
+      _BitScanForward(&result, value);
+      return static_cast<int>(result);
+#else
+      return __builtin_ctz(value);
+#endif
+    }
+    int highestBit(std::uint32_t value)
+    {
+#ifdef _MSC_VER
+      unsigned long result;
+      _BitScanReverse(&result, value);
+      return static_cast<int>(result);
+#else
+      return 31 - __builtin_clz(value);
+#endif
+    }
+
+    // Scans a line of tiles 32 at a time for the first tile that is blocked, or that has a
+    // passable tile beside it which was blocked beside the previous tile. These are the places
+    // where a straight jump ends.
+    //
+    // Returns the position of that tile if it is passable, or -1 if it is blocked.
+    int scanLine(const std::uint32_t *line, const std::uint32_t *before, const std::uint32_t *after,
+                 int stride, int length, int start, int direction, int goal)
+    {
+      if ( start < 0 || start >= length )
+        return -1;
+
+      int word = start >> 5;
+      if ( direction > 0 )
+      {
+        for ( ; word < stride; ++word )
+        {
+          std::uint32_t stop = ~line[word];
+          if ( before )
+            stop |= before[word] & ~((before[word] << 1) | (word > 0 ? before[word - 1] >> 31 : 0));
+          if ( after )
+            stop |= after[word] & ~((after[word] << 1) | (word > 0 ? after[word - 1] >> 31 : 0));
+          if ( goal >= 0 && (goal >> 5) == word )
+            stop |= 1u << (goal & 31);
+          if ( word == start >> 5 )
+            stop &= ~0u << (start & 31);
+          if ( stop )
+          {
+            int found = (word << 5) + lowestBit(stop);
+            return (line[word] >> (found & 31)) & 1 ? found : -1;
+          }
+        }
+      }
+      else
+      {
+        for ( ; word >= 0; --word )
+        {
+          std::uint32_t stop = ~line[word];
+          if ( before )
+            stop |= before[word] & ~((before[word] >> 1) | (word + 1 < stride ? before[word + 1] << 31 : 0));
+          if ( after )
+            stop |= after[word] & ~((after[word] >> 1) | (word + 1 < stride ? after[word + 1] << 31 : 0));
+          if ( goal >= 0 && (goal >> 5) == word )
+            stop |= 1u << (goal & 31);
+          if ( word == start >> 5 )
+            stop &= ~0u >> (31 - (start & 31));
+          if ( stop )
+          {
+            int found = (word << 5) + highestBit(stop);
+            return (line[word] >> (found & 31)) & 1 ? found : -1;
+          }
+        }
+      }
+      return -1;
+    }
+
+    // Copies the bits from first to last, inclusive, of one line
+    void copyBits(std::uint32_t *target, const std::uint32_t *source, int first, int last)
+    {
+      for ( int word = first >> 5; word <= last >> 5; ++word )
+      {
+        std::uint32_t mask = ~0u;
+        if ( word == first >> 5 )
+          mask &= ~0u << (first & 31);
+        if ( word == last >> 5 )
+          mask &= ~0u >> (31 - (last & 31));
+        target[word] |= source[word] & mask;
+      }
+    }
+    void clearBits(std::uint32_t *target, int first, int last)
+    {
+      for ( int word = first >> 5; word <= last >> 5; ++word )
+      {
+        std::uint32_t mask = ~0u;
+        if ( word == first >> 5 )
+          mask &= ~0u << (first & 31);
+        if ( word == last >> 5 )
+          mask &= ~0u >> (31 - (last & 31));
+        target[word] &= ~mask;
+      }
+    }
+  }
+  Pathfinder::Pathfinder()
+    : width(0)
+    , height(0)
+    , unitSize(1)
+    , goalX(0)
+    , goalY(0)
+    , rows(nullptr)
+    , columns(nullptr)
+    , searchStamp(0)
+    , regionStamp(0)
+    , corridorStamp(0)
+    , cacheSize(256)
+    , cacheHits(0)
+    , cacheMisses(0)
+  {
+  }
+  //--------------------------------------------- BUILD ------------------------------------------------------
+  void Pathfinder::build(int width, int height, const std::vector<bool> &walkable,
+                         const std::vector<int> &regionIds, const std::vector< std::vector<int> > &regionNeighbors)
+  {
+    this->clear();
+    if ( width <= 0 || height <= 0 || walkable.size() < static_cast<size_t>(width) * height )
+      return;
+    this->width = width;
+    this->height = height;
+
+    // The clearance of a tile is one more than the smallest clearance to its right, below, and
+    // diagonally below it, so it can be computed in a single pass from the bottom right corner
+    clearance.assign(static_cast<size_t>(width) * height, 0);
+    for ( int y = height - 1; y >= 0; --y )
+    {
+      for ( int x = width - 1; x >= 0; --x )
+      {
+        if ( !walkable[index(x, y)] )
+          continue;
+        int right = x + 1 < width ? clearance[index(x + 1, y)] : 0;
+        int below = y + 1 < height ? clearance[index(x, y + 1)] : 0;
+        int diagonal = x + 1 < width && y + 1 < height ? clearance[index(x + 1, y + 1)] : 0;
+        clearance[index(x, y)] = static_cast<std::uint8_t>(std::min(255, 1 + std::min(right, std::min(below, diagonal))));
+      }
+    }
+
+    // Region IDs are packed into 24 bits of the cache key
+    if ( regionIds.size() >= clearance.size() && !regionNeighbors.empty() && regionNeighbors.size() < 0xFFFFFF )
+    {
+      int regionCount = static_cast<int>(regionNeighbors.size());
+      this->regionIds.assign(regionIds.begin(), regionIds.begin() + clearance.size());
+      for ( int &region : this->regionIds )
+      {
+        if ( region >= regionCount )
+          region = -1;
+      }
+      this->regionNeighbors = regionNeighbors;
+
+      // Split each region into horizontal and vertical runs, so that a corridor of regions can
+      // be copied into the search grids without visiting every tile
+      regionRows.resize(regionCount);
+      regionColumns.resize(regionCount);
+      for ( int y = 0; y < height; ++y )
+      {
+        for ( int x = 0; x < width; )
+        {
+          int region = this->regionIds[index(x, y)], first = x;
+          while ( x < width && this->regionIds[index(x, y)] == region )
+            ++x;
+          if ( region >= 0 )
+            regionRows[region].push_back(Run{ y, first, x - 1 });
+        }
+      }
+      for ( int x = 0; x < width; ++x )
+      {
+        for ( int y = 0; y < height; )
+        {
+          int region = this->regionIds[index(x, y)], first = y;
+          while ( y < height && this->regionIds[index(x, y)] == region )
+            ++y;
+          if ( region >= 0 )
+            regionColumns[region].push_back(Run{ x, first, y - 1 });
+        }
+      }
+      regionMarks.assign(regionNeighbors.size(), 0);
+      corridorMarks.assign(regionNeighbors.size(), 0);
+      regionParent.assign(regionNeighbors.size(), -1);
+    }
+
+    visited.assign(clearance.size(), 0);
+    closed.assign(clearance.size(), 0);
+    cost.assign(clearance.size(), 0);
+    parent.assign(clearance.size(), -1);
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void Pathfinder::clear()
+  {
+    width = height = 0;
+    clearance.clear();
+    regionIds.clear();
+    regionNeighbors.clear();
+    regionRows.clear();
+    regionColumns.clear();
+    sizeRows.clear();
+    sizeColumns.clear();
+    corridorRows.bits.clear();
+    corridorColumns.bits.clear();
+    corridorRegions.clear();
+    rows = columns = nullptr;
+    visited.clear();
+    closed.clear();
+    cost.clear();
+    parent.clear();
+    open.clear();
+    regionMarks.clear();
+    corridorMarks.clear();
+    regionParent.clear();
+    regionQueue.clear();
+    components.clear();
+    searchStamp = regionStamp = corridorStamp = 0;
+    this->clearCache();
+  }
+  //--------------------------------------------- GET UNIT SIZE ----------------------------------------------
+  int Pathfinder::getUnitSize(UnitType type)
+  {
+    int size = std::max(type.width(), type.height());
+    return std::max(1, (size + 7) / 8);
+  }
+  //--------------------------------------------- GET CLEARANCE ----------------------------------------------
+  int Pathfinder::getClearance(WalkPosition position) const
+  {
+    if ( position.x < 0 || position.y < 0 || position.x >= width || position.y >= height )
+      return 0;
+    return clearance[index(position.x, position.y)];
+  }
+  //--------------------------------------------- IS PASSABLE ------------------------------------------------
+  bool Pathfinder::isPassable(int x, int y) const
+  {
+    if ( x < 0 || y < 0 || x >= width || y >= height )
+      return false;
+    return (rows->bits[y * rows->stride + (x >> 5)] >> (x & 31)) & 1;
+  }
+  //--------------------------------------------- FIND ANCHOR ------------------------------------------------
+  bool Pathfinder::findAnchor(WalkPosition center, WalkPosition &anchor) const
+  {
+    // The anchor is the top left tile of the unit. Prefer the one that centers the unit on the
+    // requested tile, then any other one that still covers it.
+    int preferredX = center.x - (unitSize - 1) / 2;
+    int preferredY = center.y - (unitSize - 1) / 2;
+    int bestDistance = -1;
+    for ( int y = center.y - unitSize + 1; y <= center.y; ++y )
+    {
+      for ( int x = center.x - unitSize + 1; x <= center.x; ++x )
+      {
+        if ( !this->isPassable(x, y) )
+          continue;
+        int distance = std::abs(x - preferredX) + std::abs(y - preferredY);
+        if ( bestDistance == -1 || distance < bestDistance )
+        {
+          bestDistance = distance;
+          anchor = WalkPosition(x, y);
+        }
+      }
+    }
+    return bestDistance != -1;
+  }
+  //--------------------------------------------- SELECT SIZE ------------------------------------------------
+  void Pathfinder::selectSize(int size)
+  {
+    if ( static_cast<int>(sizeRows.size()) <= size )
+    {
+      sizeRows.resize(size + 1);
+      sizeColumns.resize(size + 1);
+    }
+
+    BitGrid &byRow = sizeRows[size], &byColumn = sizeColumns[size];
+    if ( byRow.bits.empty() )
+    {
+      byRow.lines = height;
+      byRow.length = width;
+      byRow.stride = (width + 31) / 32;
+      byRow.bits.assign(static_cast<size_t>(byRow.lines) * byRow.stride, 0);
+      byColumn.lines = width;
+      byColumn.length = height;
+      byColumn.stride = (height + 31) / 32;
+      byColumn.bits.assign(static_cast<size_t>(byColumn.lines) * byColumn.stride, 0);
+      for ( int y = 0; y < height; ++y )
+      {
+        for ( int x = 0; x < width; ++x )
+        {
+          if ( clearance[index(x, y)] < size )
+            continue;
+          byRow.bits[y * byRow.stride + (x >> 5)] |= 1u << (x & 31);
+          byColumn.bits[x * byColumn.stride + (y >> 5)] |= 1u << (y & 31);
+        }
+      }
+    }
+    unitSize = size;
+    rows = &byRow;
+    columns = &byColumn;
+  }
+  //--------------------------------------------- GET COMPONENTS ---------------------------------------------
+  const std::vector<int> &Pathfinder::getComponents(int size)
+  {
+    if ( static_cast<int>(components.size()) <= size )
+      components.resize(size + 1);
+    std::vector<int> &labels = components[size];
+    if ( !labels.empty() )
+      return labels;
+
+    // Flood fill every area that a unit of this size can move around in
+    labels.assign(clearance.size(), 0);
+    std::vector<int> queue;
+    int label = 0;
+    for ( size_t i = 0; i < clearance.size(); ++i )
+    {
+      if ( labels[i] != 0 || clearance[i] < size )
+        continue;
+      ++label;
+      labels[i] = label;
+      queue.assign(1, static_cast<int>(i));
+      while ( !queue.empty() )
+      {
+        int node = queue.back();
+        queue.pop_back();
+        int x = node % width, y = node / width;
+        for ( int dy = -1; dy <= 1; ++dy )
+        {
+          for ( int dx = -1; dx <= 1; ++dx )
+          {
+            int nx = x + dx, ny = y + dy;
+            if ( nx < 0 || ny < 0 || nx >= width || ny >= height || clearance[index(nx, ny)] < size || labels[index(nx, ny)] != 0 )
+              continue;
+            if ( dx != 0 && dy != 0 && (clearance[index(nx, y)] < size || clearance[index(x, ny)] < size) )
+              continue;
+            labels[index(nx, ny)] = label;
+            queue.push_back(index(nx, ny));
+          }
+        }
+      }
+    }
+    return labels;
+  }
+  //--------------------------------------------- FIND CORRIDOR ----------------------------------------------
+  bool Pathfinder::findCorridor(int sourceRegion, int destinationRegion, std::vector<int> &corridor)
+  {
+    corridor.clear();
+    int regionCount = static_cast<int>(regionNeighbors.size());
+    if ( sourceRegion < 0 || sourceRegion >= regionCount || destinationRegion < 0 || destinationRegion >= regionCount )
+      return true;
+
+    // Breadth first search over the region graph
+    ++regionStamp;
+    regionQueue.clear();
+    regionQueue.push_back(sourceRegion);
+    regionMarks[sourceRegion] = regionStamp;
+    regionParent[sourceRegion] = -1;
+    for ( size_t i = 0; i < regionQueue.size() && regionMarks[destinationRegion] != regionStamp; ++i )
+    {
+      for ( int next : regionNeighbors[regionQueue[i]] )
+      {
+        if ( next < 0 || next >= regionCount || regionMarks[next] == regionStamp )
+          continue;
+        regionMarks[next] = regionStamp;
+        regionParent[next] = regionQueue[i];
+        regionQueue.push_back(next);
+      }
+    }
+    if ( regionMarks[destinationRegion] != regionStamp )
+      return false;
+
+    // The corridor is every region on the way and all of their neighbors
+    for ( int r = destinationRegion; r != -1; r = regionParent[r] )
+    {
+      corridor.push_back(r);
+      corridor.insert(corridor.end(), regionNeighbors[r].begin(), regionNeighbors[r].end());
+    }
+    return true;
+  }
+  //--------------------------------------------- RESTRICT TO CORRIDOR ---------------------------------------
+  void Pathfinder::restrictToCorridor(const std::vector<int> &corridor, int startRegion, int goalRegion)
+  {
+    const BitGrid &byRow = sizeRows[unitSize], &byColumn = sizeColumns[unitSize];
+    if ( corridorRows.bits.empty() )
+    {
+      corridorRows.lines = byRow.lines;
+      corridorRows.length = byRow.length;
+      corridorRows.stride = byRow.stride;
+      corridorRows.bits.assign(byRow.bits.size(), 0);
+      corridorColumns.lines = byColumn.lines;
+      corridorColumns.length = byColumn.length;
+      corridorColumns.stride = byColumn.stride;
+      corridorColumns.bits.assign(byColumn.bits.size(), 0);
+    }
+
+    // Only the regions of the previous corridor have bits to clear
+    for ( int region : corridorRegions )
+    {
+      for ( const Run &run : regionRows[region] )
+        clearBits(&corridorRows.bits[run.line * byRow.stride], run.first, run.last);
+      for ( const Run &run : regionColumns[region] )
+        clearBits(&corridorColumns.bits[run.line * byColumn.stride], run.first, run.last);
+    }
+    corridorRegions.clear();
+
+    // Copy the passable tiles of each region in the corridor once
+    ++corridorStamp;
+    auto copyRegion = [&](int region)
+    {
+      if ( region < 0 || region >= static_cast<int>(corridorMarks.size()) || corridorMarks[region] == corridorStamp )
+        return;
+      corridorMarks[region] = corridorStamp;
+      corridorRegions.push_back(region);
+      for ( const Run &run : regionRows[region] )
+        copyBits(&corridorRows.bits[run.line * byRow.stride], &byRow.bits[run.line * byRow.stride], run.first, run.last);
+      for ( const Run &run : regionColumns[region] )
+        copyBits(&corridorColumns.bits[run.line * byColumn.stride], &byColumn.bits[run.line * byColumn.stride], run.first, run.last);
+    };
+    for ( int region : corridor )
+      copyRegion(region);
+
+    // A large unit can be anchored in a region next to the one its center is in
+    copyRegion(startRegion);
+    copyRegion(goalRegion);
+
+    rows = &corridorRows;
+    columns = &corridorColumns;
+  }
+  //--------------------------------------------- JUMP -------------------------------------------------------
+  int Pathfinder::jump(int x, int y, int dx, int dy) const
+  {
+    if ( dy == 0 )
+    {
+      if ( y < 0 || y >= height )
+        return -1;
+      const std::uint32_t *line = &rows->bits[y * rows->stride];
+      int found = scanLine(line, y > 0 ? line - rows->stride : nullptr, y + 1 < height ? line + rows->stride : nullptr,
+                           rows->stride, width, x, dx, y == goalY ? goalX : -1);
+      return found == -1 ? -1 : index(found, y);
+    }
+    if ( dx == 0 )
+    {
+      if ( x < 0 || x >= width )
+        return -1;
+      const std::uint32_t *line = &columns->bits[x * columns->stride];
+      int found = scanLine(line, x > 0 ? line - columns->stride : nullptr, x + 1 < width ? line + columns->stride : nullptr,
+                           columns->stride, height, y, dy, x == goalX ? goalY : -1);
+      return found == -1 ? -1 : index(x, found);
+    }
+
+    for (;;)
+    {
+      if ( !this->isPassable(x, y) )
+        return -1;
+      if ( x == goalX && y == goalY )
+        return index(x, y);
+
+      // A diagonal move stops where either of its straight components finds a jump point
+      if ( this->jump(x + dx, y, dx, 0) != -1 || this->jump(x, y + dy, 0, dy) != -1 )
+        return index(x, y);
+      if ( !this->isPassable(x + dx, y) || !this->isPassable(x, y + dy) )
+        return -1;
+      x += dx;
+      y += dy;
+    }
+  }
+  //--------------------------------------------- SEARCH -----------------------------------------------------
+  int Pathfinder::search(int start, int goal)
+  {
+    ++searchStamp;
+    goalX = goal % width;
+    goalY = goal / width;
+
+    auto cmp = std::greater< std::pair<int,int> >();
+    open.clear();
+    cost[start] = 0;
+    parent[start] = -1;
+    visited[start] = searchStamp;
+    open.emplace_back(octileCost(start % width - goalX, start / width - goalY), start);
+
+    int directions[8][2];
+    while ( !open.empty() )
+    {
+      std::pop_heap(open.begin(), open.end(), cmp);
+      int node = open.back().second;
+      open.pop_back();
+      if ( closed[node] == searchStamp )
+        continue;
+      closed[node] = searchStamp;
+      if ( node == goal )
+        return goal;
+
+      int x = node % width, y = node / width;
+      int count = 0;
+      auto add = [&](int dx, int dy)
+      {
+        directions[count][0] = dx;
+        directions[count][1] = dy;
+        ++count;
+      };
+
+      // Prune the directions that can be reached more cheaply without going through this node
+      if ( parent[node] == -1 )
+      {
+        for ( int dy = -1; dy <= 1; ++dy )
+        {
+          for ( int dx = -1; dx <= 1; ++dx )
+          {
+            if ( (dx != 0 || dy != 0) && (dx == 0 || dy == 0 || (this->isPassable(x + dx, y) && this->isPassable(x, y + dy))) )
+              add(dx, dy);
+          }
+        }
+      }
+      else
+      {
+        int dx = sign(x - parent[node] % width);
+        int dy = sign(y - parent[node] / width);
+        if ( dx != 0 && dy != 0 )
+        {
+          bool horizontal = this->isPassable(x + dx, y);
+          bool vertical = this->isPassable(x, y + dy);
+          if ( vertical )
+            add(0, dy);
+          if ( horizontal )
+            add(dx, 0);
+          if ( horizontal && vertical )
+            add(dx, dy);
+        }
+        else if ( dx != 0 )
+        {
+          // Only turn where an obstacle behind this node hid the side from the parent
+          bool next = this->isPassable(x + dx, y);
+          if ( next )
+            add(dx, 0);
+          for ( int side = -1; side <= 1; side += 2 )
+          {
+            if ( this->isPassable(x, y + side) && !this->isPassable(x - dx, y + side) )
+            {
+              add(0, side);
+              if ( next )
+                add(dx, side);
+            }
+          }
+        }
+        else
+        {
+          bool next = this->isPassable(x, y + dy);
+          if ( next )
+            add(0, dy);
+          for ( int side = -1; side <= 1; side += 2 )
+          {
+            if ( this->isPassable(x + side, y) && !this->isPassable(x + side, y - dy) )
+            {
+              add(side, 0);
+              if ( next )
+                add(side, dy);
+            }
+          }
+        }
+      }
+
+      for ( int i = 0; i < count; ++i )
+      {
+        int jumpPoint = this->jump(x + directions[i][0], y + directions[i][1], directions[i][0], directions[i][1]);
+        if ( jumpPoint == -1 || closed[jumpPoint] == searchStamp )
+          continue;
+
+        int jx = jumpPoint % width, jy = jumpPoint / width;
+        int newCost = cost[node] + octileCost(jx - x, jy - y);
+        if ( visited[jumpPoint] != searchStamp || newCost < cost[jumpPoint] )
+        {
+          visited[jumpPoint] = searchStamp;
+          cost[jumpPoint] = newCost;
+          parent[jumpPoint] = node;
+          open.emplace_back(newCost + octileCost(jx - goalX, jy - goalY), jumpPoint);
+          std::push_heap(open.begin(), open.end(), cmp);
+        }
+      }
+    }
+    return -1;
+  }
+  //--------------------------------------------- FIND PATH --------------------------------------------------
+  int Pathfinder::findPath(WalkPosition source, WalkPosition destination, int unitSize, std::vector<WalkPosition> &path)
+  {
+    path.clear();
+    if ( !this->isBuilt() ||
+         source.x < 0 || source.y < 0 || source.x >= width || source.y >= height ||
+         destination.x < 0 || destination.y < 0 || destination.x >= width || destination.y >= height )
+      return -1;
+
+    this->selectSize(std::max(1, unitSize));
+
+    WalkPosition startAnchor, goalAnchor;
+    if ( !this->findAnchor(source, startAnchor) || !this->findAnchor(destination, goalAnchor) )
+      return -1;
+
+    // Tiles that are not connected at all never need a search
+    const std::vector<int> &labels = this->getComponents(this->unitSize);
+    if ( labels[index(startAnchor.x, startAnchor.y)] != labels[index(goalAnchor.x, goalAnchor.y)] )
+      return -1;
+
+    int sourceRegion = -1, destinationRegion = -1;
+    if ( !regionIds.empty() )
+    {
+      sourceRegion = regionIds[index(source.x, source.y)];
+      destinationRegion = regionIds[index(destination.x, destination.y)];
+    }
+    // Regions are offset by one so that -1 fits. The unit size is at most 255, since no tile
+    // has a larger clearance.
+    std::uint64_t key = (static_cast<std::uint64_t>(sourceRegion + 1) << 40) |
+                        (static_cast<std::uint64_t>(destinationRegion + 1) << 16) |
+                        static_cast<std::uint64_t>(this->unitSize);
+
+    // Look for a previous query between the same regions
+    std::vector<int> corridor;
+    auto cached = cacheIndex.find(key);
+    if ( cached != cacheIndex.end() )
+    {
+      ++cacheHits;
+      cache.splice(cache.begin(), cache, cached->second);
+      CacheEntry &entry = cache.front();
+      if ( entry.source == source && entry.destination == destination )
+      {
+        path = entry.path;
+        return entry.length;
+      }
+      corridor = entry.corridor;
+    }
+    else
+    {
+      ++cacheMisses;
+      if ( !this->findCorridor(sourceRegion, destinationRegion, corridor) )
+        return -1;
+    }
+
+    // Search inside the corridor first, then the whole map
+    int goal = -1;
+    if ( !corridor.empty() )
+    {
+      this->restrictToCorridor(corridor, regionIds[index(startAnchor.x, startAnchor.y)], regionIds[index(goalAnchor.x, goalAnchor.y)]);
+      goal = this->search(index(startAnchor.x, startAnchor.y), index(goalAnchor.x, goalAnchor.y));
+      this->selectSize(this->unitSize);
+    }
+    if ( goal == -1 )
+      goal = this->search(index(startAnchor.x, startAnchor.y), index(goalAnchor.x, goalAnchor.y));
+    if ( goal == -1 )
+      return -1;
+
+    // Walk back along the jump points, converting anchors back to center tiles
+    int offset = (this->unitSize - 1) / 2;
+    path.push_back(destination);
+    for ( int node = parent[goal]; node != -1 && parent[node] != -1; node = parent[node] )
+      path.emplace_back(node % width + offset, node / width + offset);
+    path.push_back(source);
+    std::reverse(path.begin(), path.end());
+
+    int length = (cost[goal] * 8 + STRAIGHT_COST / 2) / STRAIGHT_COST;
+    if ( cacheSize == 0 )
+      return length;
+
+    // Store the result
+    if ( cached == cacheIndex.end() )
+    {
+      cache.emplace_front();
+      cache.front().key = key;
+      cacheIndex[key] = cache.begin();
+      if ( cache.size() > cacheSize )
+      {
+        cacheIndex.erase(cache.back().key);
+        cache.pop_back();
+      }
+    }
+    CacheEntry &entry = cache.front();
+    entry.source = source;
+    entry.destination = destination;
+    entry.length = length;
+    entry.path = path;
+    entry.corridor.swap(corridor);
+    return length;
+  }
+  //--------------------------------------------- CACHE ------------------------------------------------------
+  void Pathfinder::setCacheSize(size_t size)
+  {
+    cacheSize = size;
+    while ( cache.size() > cacheSize )
+    {
+      cacheIndex.erase(cache.back().key);
+      cache.pop_back();
+    }
+  }
+  void Pathfinder::clearCache()
+  {
+    cache.clear();
+    cacheIndex.clear();
+    cacheHits = cacheMisses = 0;
+  }
+}
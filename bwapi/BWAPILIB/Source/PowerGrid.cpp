@@ -0,0 +1,131 @@
+#include <BWAPI/PowerGrid.h>
+
+#include <algorithm>
+
+namespace BWAPI
+{
+  namespace
+  {
+    // The psi field of a pylon, in build tiles. The pylon is between columns 7 and 8 and
+    // between rows 4 and 5.
+    const bool bPsiFieldMask[10][16] = {
+      { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 },
+      { 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
+      { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
+      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+      { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
+      { 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
+      { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 }
+    };
+  }
+  //--------------------------------------------- RESET ------------------------------------------------------
+  void PowerGrid::reset(int width, int height)
+  {
+    this->clear();
+    if ( width <= 0 || height <= 0 )
+      return;
+    this->width = width;
+    this->height = height;
+    counts.assign(static_cast<size_t>(width) * height, 0);
+    leftEdges.assign(counts.size(), 0);
+    topEdges.assign(counts.size(), 0);
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void PowerGrid::clear()
+  {
+    width = height = 0;
+    counts.clear();
+    leftEdges.clear();
+    topEdges.clear();
+    pylons.clear();
+  }
+  //--------------------------------------------- ADD PYLON --------------------------------------------------
+  bool PowerGrid::addPylon(int id, Position position)
+  {
+    for ( auto &p : pylons )
+    {
+      if ( p.first == id )
+        return false;
+    }
+    pylons.emplace_back(id, position);
+    this->stamp(position, 1);
+    return true;
+  }
+  //--------------------------------------------- REMOVE PYLON -----------------------------------------------
+  bool PowerGrid::removePylon(int id)
+  {
+    auto it = std::find_if(pylons.begin(), pylons.end(), [id](const std::pair<int,Position> &p) { return p.first == id; });
+    if ( it == pylons.end() )
+      return false;
+
+    this->stamp(it->second, -1);
+    *it = pylons.back();
+    pylons.pop_back();
+    return true;
+  }
+  //--------------------------------------------- STAMP ------------------------------------------------------
+  void PowerGrid::stamp(Position position, int delta)
+  {
+    // Tile of the top left corner of the mask
+    int left = position.x / 32 - 8;
+    int top = position.y / 32 - 5;
+    for ( int row = 0; row < 10; ++row )
+    {
+      int y = top + row;
+      if ( y < 0 || y >= height )
+        continue;
+      for ( int column = 0; column < 16; ++column )
+      {
+        int x = left + column;
+        if ( !bPsiFieldMask[row][column] || x < 0 || x >= width )
+          continue;
+
+        size_t i = y * width + x;
+        counts[i] = static_cast<std::uint16_t>(counts[i] + delta);
+        if ( column == 0 )
+          leftEdges[i] = static_cast<std::uint16_t>(leftEdges[i] + delta);
+        if ( row == 0 )
+          topEdges[i] = static_cast<std::uint16_t>(topEdges[i] + delta);
+      }
+    }
+  }
+  //--------------------------------------------- HAS POWER --------------------------------------------------
+  bool PowerGrid::hasPower(int x, int y) const
+  {
+    if ( x < 0 || y < 0 || x >= width * 32 || y >= height * 32 )
+      return false;
+
+    size_t i = (y / 32) * width + x / 32;
+    int count = counts[i];
+    if ( x % 32 == 0 )
+      count -= leftEdges[i];
+    if ( y % 32 == 0 )
+      count -= topEdges[i];
+    return count > 0;
+  }
+  //--------------------------------------------- GET COUNT --------------------------------------------------
+  int PowerGrid::getCount(TilePosition position) const
+  {
+    if ( position.x < 0 || position.y < 0 || position.x >= width || position.y >= height )
+      return 0;
+    return counts[position.y * width + position.x];
+  }
+  //--------------------------------------------- COUNT POWERED TILES ----------------------------------------
+  int PowerGrid::countPoweredTiles(TilePosition topLeft, int width, int height) const
+  {
+    int left = std::max(0, topLeft.x), right = std::min(this->width, topLeft.x + width);
+    int top = std::max(0, topLeft.y), bottom = std::min(this->height, topLeft.y + height);
+
+    int result = 0;
+    for ( int y = top; y < bottom; ++y )
+    {
+      const std::uint16_t *row = &counts[y * this->width];
+      for ( int x = left; x < right; ++x )
+        result += row[x] != 0 ? 1 : 0;
+    }
+    return result;
+  }
+}
@@ -0,0 +1,169 @@
+#include <BWAPI/RegionDistances.h>
+#include <BWAPI/Region.h>
+#include <BWAPI/Regionset.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <utility>
+
+namespace BWAPI
+{
+  //--------------------------------------------- BUILD ------------------------------------------------------
+  void RegionDistances::build(const std::vector<Node> &nodes, unsigned int threadCount)
+  {
+    this->clear();
+    if ( nodes.empty() )
+      return;
+    this->nodes = nodes;
+
+    // Flatten the neighbor lists, only keeping walkable connections
+    int n = this->size();
+    edgeStart.assign(n + 1, 0);
+    for ( int i = 0; i < n; ++i )
+    {
+      edgeStart[i] = static_cast<int>(edgeTarget.size());
+      if ( !nodes[i].accessible )
+        continue;
+      for ( int j : nodes[i].neighbors )
+      {
+        if ( j < 0 || j >= n || j == i || !nodes[j].accessible )
+          continue;
+        edgeTarget.push_back(j);
+        edgeLength.push_back(nodes[i].center.getApproxDistance(nodes[j].center));
+      }
+    }
+    edgeStart[n] = static_cast<int>(edgeTarget.size());
+
+    table.assign(static_cast<size_t>(n) * n, -1);
+
+    // Each row is independent, so hand them out to the threads one at a time
+    if ( threadCount == 0 )
+      threadCount = std::max(1u, std::thread::hardware_concurrency());
+    threadCount = std::min<unsigned int>(threadCount, n);
+
+    std::atomic<int> nextRow(0);
+    auto worker = [&]()
+    {
+      std::vector< std::pair<int,int> > queue;
+      for ( int row = nextRow++; row < n; row = nextRow++ )
+        this->computeRow(row, queue);
+    };
+
+    std::vector<std::thread> threads;
+    for ( unsigned int i = 1; i < threadCount; ++i )
+      threads.emplace_back(worker);
+    worker();
+    for ( auto &t : threads )
+      t.join();
+  }
+  void RegionDistances::build(const Regionset &regions, unsigned int threadCount)
+  {
+    int n = 0;
+    for ( auto r : regions )
+      n = std::max(n, r->getID() + 1);
+
+    std::vector<Node> input(n);
+    for ( auto r : regions )
+    {
+      Node &node = input[r->getID()];
+      node.center = r->getCenter();
+      node.accessible = r->isAccessible();
+      for ( auto neighbor : r->getNeighbors() )
+        node.neighbors.push_back(neighbor->getID());
+    }
+    this->build(input, threadCount);
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void RegionDistances::clear()
+  {
+    nodes.clear();
+    edgeStart.clear();
+    edgeTarget.clear();
+    edgeLength.clear();
+    table.clear();
+  }
+  //--------------------------------------------- COMPUTE ROW ------------------------------------------------
+  void RegionDistances::computeRow(int source, std::vector< std::pair<int,int> > &queue)
+  {
+    int n = this->size();
+    int *dist = &table[static_cast<size_t>(source) * n];
+    dist[source] = 0;
+    if ( !nodes[source].accessible )
+      return;
+
+    // Binary heap of (distance, region), smallest first
+    queue.clear();
+    auto cmp = std::greater< std::pair<int,int> >();
+    queue.emplace_back(0, source);
+    while ( !queue.empty() )
+    {
+      std::pop_heap(queue.begin(), queue.end(), cmp);
+      std::pair<int,int> top = queue.back();
+      queue.pop_back();
+      if ( top.first > dist[top.second] )
+        continue;
+
+      for ( int e = edgeStart[top.second]; e < edgeStart[top.second + 1]; ++e )
+      {
+        int next = edgeTarget[e];
+        int d = top.first + edgeLength[e];
+        if ( dist[next] == -1 || d < dist[next] )
+        {
+          dist[next] = d;
+          queue.emplace_back(d, next);
+          std::push_heap(queue.begin(), queue.end(), cmp);
+        }
+      }
+    }
+  }
+  //--------------------------------------------- GET DISTANCE -----------------------------------------------
+  int RegionDistances::getDistance(int fromRegion, int toRegion) const
+  {
+    int n = this->size();
+    if ( fromRegion < 0 || fromRegion >= n || toRegion < 0 || toRegion >= n )
+      return -1;
+    return table[static_cast<size_t>(fromRegion) * n + toRegion];
+  }
+  //--------------------------------------------- GET GROUND DISTANCE ----------------------------------------
+  int RegionDistances::getGroundDistance(Position source, int sourceRegion, Position destination, int destinationRegion) const
+  {
+    int n = this->size();
+    if ( sourceRegion < 0 || sourceRegion >= n || destinationRegion < 0 || destinationRegion >= n )
+      return -1;
+    if ( !nodes[sourceRegion].accessible || !nodes[destinationRegion].accessible )
+      return -1;
+
+    // Within a single region, the straight line is used
+    if ( sourceRegion == destinationRegion )
+      return source.getApproxDistance(destination);
+
+    if ( this->getDistance(sourceRegion, destinationRegion) < 0 )
+      return -1;
+
+    // Try leaving through the source region or any of its neighbors, and entering through the
+    // destination region or any of its neighbors
+    int best = std::numeric_limits<int>::max();
+    auto tryPair = [&](int from, int to)
+    {
+      int between = table[static_cast<size_t>(from) * n + to];
+      if ( between < 0 )
+        return;
+      int total = source.getApproxDistance(nodes[from].center) + between + nodes[to].center.getApproxDistance(destination);
+      best = std::min(best, total);
+    };
+
+    for ( int e = edgeStart[sourceRegion] - 1; e < edgeStart[sourceRegion + 1]; ++e )
+    {
+      int from = e < edgeStart[sourceRegion] ? sourceRegion : edgeTarget[e];
+      for ( int f = edgeStart[destinationRegion] - 1; f < edgeStart[destinationRegion + 1]; ++f )
+      {
+        int to = f < edgeStart[destinationRegion] ? destinationRegion : edgeTarget[f];
+        tryPair(from, to);
+      }
+    }
+    return best;
+  }
+}
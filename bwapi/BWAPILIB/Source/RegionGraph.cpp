@@ -0,0 +1,190 @@
+#include <BWAPI/RegionGraph.h>
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+namespace BWAPI
+{
+  namespace
+  {
+    // The walk tiles of a contiguous segment of a border, as a bounding box
+    struct BorderBox
+    {
+      int left = std::numeric_limits<int>::max();
+      int top = std::numeric_limits<int>::max();
+      int right = -1;
+      int bottom = -1;
+
+      void add(int x, int y)
+      {
+        left = std::min(left, x);
+        top = std::min(top, y);
+        right = std::max(right, x);
+        bottom = std::max(bottom, y);
+      }
+    };
+
+    std::uint32_t borderKey(int a, int b)
+    {
+      return a < b ? (static_cast<std::uint32_t>(a) << 16) | b : (static_cast<std::uint32_t>(b) << 16) | a;
+    }
+  }
+  //--------------------------------------------- BUILD ------------------------------------------------------
+  void RegionGraph::build(const Input &input)
+  {
+    this->clear();
+    size_t tiles = static_cast<size_t>(input.width) * input.height;
+    if ( input.width <= 0 || input.height <= 0 || input.regionIds.size() != tiles || input.nodes.size() >= NoRegion )
+      return;
+
+    int n = static_cast<int>(input.nodes.size());
+    width = input.width;
+    height = input.height;
+
+    // Walk tile lookup, with every ID that is not a region mapped to none
+    regionIds.resize(tiles);
+    for ( size_t i = 0; i < tiles; ++i )
+    {
+      int id = input.regionIds[i];
+      regionIds[i] = id >= 0 && id < n ? static_cast<std::uint16_t>(id) : NoRegion;
+    }
+
+    // Flatten the neighbor lists, keeping their order and skipping duplicates
+    centers.resize(n);
+    closestAccessible.assign(n, -1);
+    closestInaccessible.assign(n, -1);
+    edgeStart.assign(n + 1, 0);
+    for ( int i = 0; i < n; ++i )
+    {
+      const Node &node = input.nodes[i];
+      centers[i] = node.center;
+      edgeStart[i] = static_cast<int>(edges.size());
+
+      // The closest neighbors follow the distance rules of the neighbor scan that RegionImpl
+      // used to do. Unlike that scan, self links and IDs that are not regions are skipped, so a
+      // region is never its own closest neighbor.
+      int accessibleBestDist = 99999;
+      int inaccessibleBestDist = 99999;
+      for ( int j : node.neighbors )
+      {
+        if ( j < 0 || j >= n || j == i )
+          continue;
+        if ( std::any_of(edges.begin() + edgeStart[i], edges.end(), [j](const Edge &e) { return e.target == j; }) )
+          continue;
+
+        Edge e;
+        e.target = j;
+        e.length = node.center.getApproxDistance(input.nodes[j].center);
+        e.width = 0;
+        edges.push_back(e);
+
+        if ( node.groupId == input.nodes[j].groupId )
+        {
+          if ( e.length < accessibleBestDist )
+          {
+            accessibleBestDist = e.length;
+            closestAccessible[i] = j;
+          }
+        }
+        else if ( e.length < inaccessibleBestDist )
+        {
+          inaccessibleBestDist = e.length;
+          closestInaccessible[i] = j;
+        }
+      }
+    }
+    edgeStart[n] = static_cast<int>(edges.size());
+
+    // Find the walkable walk tiles where two regions touch
+    if ( input.walkable.size() != tiles )
+      return;
+
+    std::unordered_map< std::uint32_t, std::vector<int> > borders;
+    auto addBorder = [&](int x, int y, int nx, int ny)
+    {
+      size_t i = y * width + x, j = ny * width + nx;
+      if ( regionIds[i] == regionIds[j] || regionIds[j] == NoRegion || !input.walkable[j] )
+        return;
+      std::vector<int> &border = borders[borderKey(regionIds[i], regionIds[j])];
+      border.push_back(static_cast<int>(i));
+      border.push_back(static_cast<int>(j));
+    };
+    for ( int y = 0; y < height; ++y )
+    {
+      for ( int x = 0; x < width; ++x )
+      {
+        if ( regionIds[y * width + x] == NoRegion || !input.walkable[y * width + x] )
+          continue;
+        if ( x + 1 < width )
+          addBorder(x, y, x + 1, y);
+        if ( y + 1 < height )
+          addBorder(x, y, x, y + 1);
+      }
+    }
+
+    // Two regions can touch in several places, so each segment of 8-connected border tiles is
+    // measured on its own, as the diagonal of its bounding box, and the widest one is kept. The
+    // stamp of a tile tells whether it is on the current border and whether it was visited.
+    std::unordered_map<std::uint32_t, int> borderWidths;
+    std::vector<int> stamp(tiles, -1), stack;
+    int onBorder = 0;
+    for ( auto &border : borders )
+    {
+      int visited = onBorder + 1;
+      for ( int t : border.second )
+        stamp[t] = onBorder;
+
+      int widest = 0;
+      for ( int t : border.second )
+      {
+        if ( stamp[t] != onBorder )
+          continue;
+
+        BorderBox box;
+        stamp[t] = visited;
+        stack.push_back(t);
+        while ( !stack.empty() )
+        {
+          int x = stack.back() % width, y = stack.back() / width;
+          stack.pop_back();
+          box.add(x, y);
+          for ( int ny = std::max(0, y - 1); ny <= std::min(height - 1, y + 1); ++ny )
+          {
+            for ( int nx = std::max(0, x - 1); nx <= std::min(width - 1, x + 1); ++nx )
+            {
+              if ( stamp[ny * width + nx] != onBorder )
+                continue;
+              stamp[ny * width + nx] = visited;
+              stack.push_back(ny * width + nx);
+            }
+          }
+        }
+        widest = std::max(widest, Position(0, 0).getApproxDistance(Position((box.right - box.left + 1) * 8, (box.bottom - box.top + 1) * 8)));
+      }
+      borderWidths[border.first] = widest;
+      onBorder += 2;
+    }
+
+    for ( int i = 0; i < n; ++i )
+    {
+      for ( int e = edgeStart[i]; e < edgeStart[i + 1]; ++e )
+      {
+        auto it = borderWidths.find(borderKey(i, edges[e].target));
+        if ( it != borderWidths.end() )
+          edges[e].width = it->second;
+      }
+    }
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void RegionGraph::clear()
+  {
+    width = height = 0;
+    regionIds.clear();
+    centers.clear();
+    closestAccessible.clear();
+    closestInaccessible.clear();
+    edgeStart.clear();
+    edges.clear();
+  }
+}
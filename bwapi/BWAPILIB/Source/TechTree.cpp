@@ -0,0 +1,433 @@
+#include <BWAPI/TechTree.h>
+#include <BWAPI/Player.h>
+#include <BWAPI/Unit.h>
+#include <BWAPI/Unitset.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace BWAPI
+{
+  namespace TechTree
+  {
+    namespace
+    {
+      // The static dependency graph, built once on first use
+      struct Graph
+      {
+        Graph();
+
+        std::vector<NodeSet> requirements;
+        std::vector<NodeSet> allRequirements;
+        std::vector< std::vector<int> > requirementList;
+        std::vector<int> time;
+        std::vector<int> mineralPrice;
+        std::vector<int> gasPrice;
+        std::vector<bool> producible;
+
+        // All nodes, ordered so that every node appears after its requirements
+        std::vector<int> order;
+      private:
+        void addRequirement(int node, int req);
+        void visit(int node, std::vector<char> &mark);
+      };
+
+      void Graph::addRequirement(int node, int req)
+      {
+        if ( node < 0 || req < 0 || node == req )
+          return;
+        if ( !requirements[node].test(req) )
+        {
+          requirements[node].set(req);
+          requirementList[node].push_back(req);
+        }
+      }
+
+      // Depth-first post-order; back edges (cycles) are dropped so that the graph stays acyclic
+      void Graph::visit(int node, std::vector<char> &mark)
+      {
+        mark[node] = 1;
+        auto &reqs = requirementList[node];
+        for ( auto it = reqs.begin(); it != reqs.end(); )
+        {
+          if ( mark[*it] == 1 )
+          {
+            requirements[node].reset(*it);
+            it = reqs.erase(it);
+            continue;
+          }
+          if ( mark[*it] == 0 )
+            visit(*it, mark);
+          ++it;
+        }
+        mark[node] = 2;
+        order.push_back(node);
+      }
+
+      Graph::Graph()
+        : requirements(NodeCount)
+        , allRequirements(NodeCount)
+        , requirementList(NodeCount)
+        , time(NodeCount, 0)
+        , mineralPrice(NodeCount, 0)
+        , gasPrice(NodeCount, 0)
+        , producible(NodeCount, false)
+      {
+        // Units
+        for ( UnitType t : UnitTypes::allUnitTypes() )
+        {
+          int node = getNode(t);
+          if ( node < 0 )
+            continue;
+
+          time[node]         = t.buildTime();
+          mineralPrice[node] = t.mineralPrice();
+          gasPrice[node]     = t.gasPrice();
+          producible[node]   = t.whatBuilds().first != UnitTypes::None;
+
+          for ( auto &req : t.requiredUnits() )
+          {
+            // Break the worker -> depot -> worker cycle
+            if ( (t.isWorker() || t == UnitTypes::Zerg_Larva) && req.first.isResourceDepot() )
+              continue;
+            addRequirement(node, getNode(req.first));
+          }
+          if ( t.requiredTech() != TechTypes::None )
+            addRequirement(node, getNode(t.requiredTech()));
+        }
+
+        // Techs
+        for ( TechType t : TechTypes::allTechTypes() )
+        {
+          int node = getNode(t);
+          if ( node < 0 )
+            continue;
+
+          time[node]         = t.researchTime();
+          mineralPrice[node] = t.mineralPrice();
+          gasPrice[node]     = t.gasPrice();
+          producible[node]   = t.whatResearches() != UnitTypes::None;
+
+          if ( t.whatResearches() != UnitTypes::None )
+            addRequirement(node, getNode(t.whatResearches()));
+          if ( t == TechTypes::Lurker_Aspect )
+            addRequirement(node, getNode(UnitTypes::Zerg_Lair));
+        }
+
+        // Upgrades, one node per level
+        for ( UpgradeType t : UpgradeTypes::allUpgradeTypes() )
+        {
+          for ( int level = 1; level <= MAX_UPGRADE_LEVEL; ++level )
+          {
+            int node = getNode(t, level);
+            if ( node < 0 )
+              continue;
+
+            time[node]         = t.upgradeTime(level);
+            mineralPrice[node] = t.mineralPrice(level);
+            gasPrice[node]     = t.gasPrice(level);
+            producible[node]   = level <= t.maxRepeats() && t.whatUpgrades() != UnitTypes::None;
+
+            if ( t.whatUpgrades() != UnitTypes::None )
+              addRequirement(node, getNode(t.whatUpgrades()));
+            if ( t.whatsRequired(level) != UnitTypes::None )
+              addRequirement(node, getNode(t.whatsRequired(level)));
+            if ( level > 1 )
+              addRequirement(node, getNode(t, level - 1));
+          }
+        }
+
+        // Order the nodes and compute the closures
+        std::vector<char> mark(NodeCount, 0);
+        order.reserve(NodeCount);
+        for ( int i = 0; i < NodeCount; ++i )
+        {
+          if ( mark[i] == 0 )
+            visit(i, mark);
+        }
+        for ( int node : order )
+        {
+          allRequirements[node] = requirements[node];
+          for ( int req : requirementList[node] )
+            allRequirements[node] |= allRequirements[req];
+        }
+      }
+
+      const Graph &graph()
+      {
+        static const Graph g;
+        return g;
+      }
+
+      bool isValidNode(int node)
+      {
+        return node >= 0 && node < NodeCount;
+      }
+
+      // Types that also satisfy requirements on another type
+      const std::pair<UnitType, UnitType> equivalentTypes[] =
+      {
+        { UnitTypes::Zerg_Lair,                    UnitTypes::Zerg_Hatchery },
+        { UnitTypes::Zerg_Hive,                    UnitTypes::Zerg_Hatchery },
+        { UnitTypes::Zerg_Hive,                    UnitTypes::Zerg_Lair },
+        { UnitTypes::Zerg_Greater_Spire,           UnitTypes::Zerg_Spire },
+        { UnitTypes::Terran_Siege_Tank_Siege_Mode, UnitTypes::Terran_Siege_Tank_Tank_Mode }
+      };
+    }
+
+    //--------------------------------------------- NODES ------------------------------------------------------
+    int getNode(UnitType type)
+    {
+      if ( type < 0 || type >= UnitTypes::None )
+        return -1;
+      return UnitNodeOffset + type;
+    }
+    int getNode(TechType type)
+    {
+      if ( type < 0 || type >= TechTypes::None )
+        return -1;
+      return TechNodeOffset + type;
+    }
+    int getNode(UpgradeType type, int level)
+    {
+      if ( type < 0 || type >= UpgradeTypes::None || level < 1 || level > MAX_UPGRADE_LEVEL )
+        return -1;
+      return UpgradeNodeOffset + type*MAX_UPGRADE_LEVEL + (level - 1);
+    }
+    UnitType getUnitType(int node)
+    {
+      if ( node < UnitNodeOffset || node >= TechNodeOffset )
+        return UnitTypes::None;
+      return UnitType(node - UnitNodeOffset);
+    }
+    TechType getTechType(int node)
+    {
+      if ( node < TechNodeOffset || node >= UpgradeNodeOffset )
+        return TechTypes::None;
+      return TechType(node - TechNodeOffset);
+    }
+    std::pair<UpgradeType, int> getUpgradeType(int node)
+    {
+      if ( node < UpgradeNodeOffset || node >= NodeCount )
+        return std::make_pair(UpgradeType(UpgradeTypes::None), 0);
+      int index = node - UpgradeNodeOffset;
+      return std::make_pair(UpgradeType(index / MAX_UPGRADE_LEVEL), index % MAX_UPGRADE_LEVEL + 1);
+    }
+    int getTime(int node)
+    {
+      return isValidNode(node) ? graph().time[node] : 0;
+    }
+    int getMineralPrice(int node)
+    {
+      return isValidNode(node) ? graph().mineralPrice[node] : 0;
+    }
+    int getGasPrice(int node)
+    {
+      return isValidNode(node) ? graph().gasPrice[node] : 0;
+    }
+    const NodeSet &getRequirements(int node)
+    {
+      static const NodeSet none;
+      return isValidNode(node) ? graph().requirements[node] : none;
+    }
+    const NodeSet &getAllRequirements(int node)
+    {
+      static const NodeSet none;
+      return isValidNode(node) ? graph().allRequirements[node] : none;
+    }
+    //--------------------------------------------- STATE ------------------------------------------------------
+    State::State()
+      : counts(NodeCount, 0)
+      , remaining(NodeCount, -1)
+    {
+    }
+    State::State(Player player)
+      : State()
+    {
+      if ( !player )
+        return;
+
+      this->minerals = player->minerals();
+      this->gas      = player->gas();
+
+      // Units, as well as anything they are currently researching or upgrading
+      for ( auto &u : player->getUnits() )
+      {
+        if ( u->isCompleted() )
+        {
+          int node = getNode(u->getType());
+          if ( isValidNode(node) )
+            this->setOwned(node, counts[node] + 1);
+        }
+        else
+        {
+          UnitType type = u->getType();
+          if ( u->isMorphing() && u->getBuildType() != UnitTypes::None )
+            type = u->getBuildType();
+          this->setInProgress(getNode(type), u->getRemainingBuildTime());
+        }
+
+        if ( u->getTech() != TechTypes::None )
+          this->setInProgress(getNode(u->getTech()), u->getRemainingResearchTime());
+        if ( u->getUpgrade() != UpgradeTypes::None )
+          this->setInProgress(getNode(u->getUpgrade(), player->getUpgradeLevel(u->getUpgrade()) + 1), u->getRemainingUpgradeTime());
+      }
+
+      // Upgraded buildings satisfy the requirements of their base type
+      for ( auto &eq : equivalentTypes )
+      {
+        int from = getNode(eq.first), to = getNode(eq.second);
+        if ( owned.test(from) )
+          this->setOwned(to, counts[to] + counts[from]);
+      }
+
+      for ( TechType t : TechTypes::allTechTypes() )
+      {
+        if ( getNode(t) >= 0 && player->hasResearched(t) )
+          this->setOwned(getNode(t));
+      }
+
+      for ( UpgradeType t : UpgradeTypes::allUpgradeTypes() )
+      {
+        int level = std::min(player->getUpgradeLevel(t), MAX_UPGRADE_LEVEL);
+        for ( int i = 1; i <= level; ++i )
+          this->setOwned(getNode(t, i));
+      }
+    }
+    void State::setOwned(int node, int count)
+    {
+      if ( !isValidNode(node) )
+        return;
+      owned.set(node, count > 0);
+      counts[node] = count;
+    }
+    void State::setInProgress(int node, int remainingFrames)
+    {
+      if ( !isValidNode(node) )
+        return;
+      remainingFrames = std::max(remainingFrames, 0);
+      if ( !inProgress.test(node) || remainingFrames < remaining[node] )
+        remaining[node] = remainingFrames;
+      inProgress.set(node);
+    }
+    bool State::isOwned(int node) const
+    {
+      return isValidNode(node) && owned.test(node);
+    }
+    int State::getCount(int node) const
+    {
+      return isValidNode(node) ? counts[node] : 0;
+    }
+    int State::getRemainingTime(int node) const
+    {
+      if ( !isValidNode(node) )
+        return -1;
+      if ( owned.test(node) )
+        return 0;
+      return inProgress.test(node) ? remaining[node] : -1;
+    }
+    //--------------------------------------------- GOAL -------------------------------------------------------
+    Goal &Goal::add(UnitType type, int count)
+    {
+      if ( getNode(type) >= 0 && count > 0 )
+        nodes.emplace_back(getNode(type), count);
+      return *this;
+    }
+    Goal &Goal::add(TechType type)
+    {
+      if ( getNode(type) >= 0 )
+        nodes.emplace_back(getNode(type), 1);
+      return *this;
+    }
+    Goal &Goal::add(UpgradeType type, int level)
+    {
+      if ( getNode(type, level) >= 0 )
+        nodes.emplace_back(getNode(type, level), 1);
+      return *this;
+    }
+    //--------------------------------------------- SOLVE ------------------------------------------------------
+    Plan solve(const State &state, const Goal &goal)
+    {
+      const Graph &g = graph();
+      Plan plan;
+
+      // Goal nodes that must be made, and how many of each
+      NodeSet produce;
+      std::array<int, NodeCount> quantity;
+      quantity.fill(0);
+
+      for ( auto &it : goal.nodes )
+      {
+        int node = it.first;
+        if ( !isValidNode(node) )
+          continue;
+
+        int want = it.second;
+        int have = state.getCount(node);
+        if ( have >= want )
+          continue;
+
+        // Something that is already on its way may satisfy the goal
+        if ( state.getInProgress().test(node) && have + 1 >= want )
+        {
+          plan.frames = std::max(plan.frames, state.getRemainingTime(node));
+          continue;
+        }
+        produce.set(node);
+        quantity[node] = std::max(quantity[node], want - have - (state.getInProgress().test(node) ? 1 : 0));
+      }
+
+      // Expand the requirements of everything that must be made. Iterating in reverse dependency
+      // order means that every node is expanded after all nodes that depend on it.
+      const NodeSet available = state.getOwned() | state.getInProgress();
+      NodeSet need = produce;
+      for ( auto it = g.order.rbegin(); it != g.order.rend(); ++it )
+      {
+        int node = *it;
+        if ( need.test(node) && (produce.test(node) || !available.test(node)) )
+          need |= g.requirements[node];
+      }
+      plan.missing = (need & ~available) | produce;
+
+      // Earliest completion of each needed node, in dependency order
+      std::array<int, NodeCount> finish;
+      for ( int node : g.order )
+      {
+        if ( !need.test(node) )
+          continue;
+
+        if ( !plan.missing.test(node) )
+        {
+          finish[node] = state.getRemainingTime(node);
+          continue;
+        }
+
+        int start = 0;
+        for ( int req : g.requirementList[node] )
+          start = std::max(start, finish[req]);
+        finish[node] = start + g.time[node];
+
+        int count = std::max(quantity[node], 1);
+        plan.minerals += g.mineralPrice[node] * count;
+        plan.gas      += g.gasPrice[node] * count;
+        plan.possible &= g.producible[node];
+        plan.order.push_back(node);
+      }
+
+      for ( auto &it : goal.nodes )
+      {
+        if ( isValidNode(it.first) && produce.test(it.first) )
+          plan.frames = std::max(plan.frames, finish[it.first]);
+      }
+
+      // Resource bound
+      if ( state.mineralRate > 0 && plan.minerals > state.minerals )
+        plan.frames = std::max(plan.frames, static_cast<int>(std::ceil((plan.minerals - state.minerals) / state.mineralRate)));
+      if ( state.gasRate > 0 && plan.gas > state.gas )
+        plan.frames = std::max(plan.frames, static_cast<int>(std::ceil((plan.gas - state.gas) / state.gasRate)));
+
+      return plan;
+    }
+  }
+}
@@ -0,0 +1,484 @@
+#include <BWAPI/TerrainAnalysis.h>
+#include <BWAPI/ClearanceMap.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <numeric>
+
+namespace BWAPI
+{
+  namespace
+  {
+    // Resource depots can not be placed this many tiles or closer to a resource, as in Game::canBuildHere
+    const int ResourceExclusion = 3;
+
+    // How far from its resources a base location is searched for, in tiles
+    const int BaseSearchRange = 10;
+
+    // How far from a start location the base location of a cluster may be to be replaced, in pixels
+    const int StartLocationRange = 384;
+
+    // The file starts with "TERR"
+    const std::uint32_t CacheMagic = 0x52524554;
+
+    // Protects the loader from allocating huge amounts of memory for a damaged file
+    const int MaximumCount = 1 << 16;
+
+    Position getCenter(UnitType type, TilePosition tilePosition)
+    {
+      return Position(tilePosition) + Position(type.tileWidth() * 16, type.tileHeight() * 16);
+    }
+
+    int findRoot(std::vector<int> &parents, int i)
+    {
+      while ( parents[i] != i )
+      {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+      }
+      return i;
+    }
+
+    void writeInt(std::ostream &out, int value)
+    {
+      std::uint32_t v = static_cast<std::uint32_t>(value);
+      char bytes[4] = { static_cast<char>(v), static_cast<char>(v >> 8), static_cast<char>(v >> 16), static_cast<char>(v >> 24) };
+      out.write(bytes, 4);
+    }
+    int readInt(std::istream &in)
+    {
+      unsigned char bytes[4] = { 0, 0, 0, 0 };
+      in.read(reinterpret_cast<char*>(bytes), 4);
+      return static_cast<int>(bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24));
+    }
+    int readCount(std::istream &in)
+    {
+      int count = readInt(in);
+      if ( count < 0 || count > MaximumCount )
+      {
+        in.setstate(std::ios::failbit);
+        return 0;
+      }
+      return count;
+    }
+
+    template <class _T>
+    void writePoint(std::ostream &out, _T point)
+    {
+      writeInt(out, point.x);
+      writeInt(out, point.y);
+    }
+    template <class _T>
+    _T readPoint(std::istream &in)
+    {
+      int x = readInt(in);
+      int y = readInt(in);
+      return _T(x, y);
+    }
+
+    void writePoints(std::ostream &out, const std::vector<TilePosition> &points)
+    {
+      writeInt(out, static_cast<int>(points.size()));
+      for ( auto &p : points )
+        writePoint(out, p);
+    }
+    void readPoints(std::istream &in, std::vector<TilePosition> &points)
+    {
+      points.resize(readCount(in));
+      for ( auto &p : points )
+        p = readPoint<TilePosition>(in);
+    }
+  }
+  //--------------------------------------------- ANALYZE ----------------------------------------------------
+  void TerrainAnalysis::analyze(const Input &input)
+  {
+    this->clear();
+    this->findClusters(input);
+    this->findBases(input);
+    this->findChokePoints(input);
+    analyzed = true;
+  }
+  //--------------------------------------------- CLEAR ------------------------------------------------------
+  void TerrainAnalysis::clear()
+  {
+    analyzed = false;
+    clusters.clear();
+    bases.clear();
+    chokes.clear();
+  }
+  //--------------------------------------------- FIND CLUSTERS ----------------------------------------------
+  void TerrainAnalysis::findClusters(const Input &input)
+  {
+    std::vector<const Resource*> resources;
+    for ( auto &r : input.resources )
+    {
+      if ( r.type == UnitTypes::Resource_Vespene_Geyser || (r.type.isMineralField() && r.amount > BlockerAmount) )
+        resources.push_back(&r);
+    }
+
+    // Single linkage: resources closer than ClusterDistance end up in the same cluster
+    std::vector<int> parents(resources.size());
+    std::iota(parents.begin(), parents.end(), 0);
+    for ( size_t i = 0; i < resources.size(); ++i )
+    {
+      Position a = getCenter(resources[i]->type, resources[i]->tilePosition);
+      for ( size_t j = i + 1; j < resources.size(); ++j )
+      {
+        Position b = getCenter(resources[j]->type, resources[j]->tilePosition);
+        if ( a.getApproxDistance(b) <= ClusterDistance )
+          parents[findRoot(parents, static_cast<int>(j))] = findRoot(parents, static_cast<int>(i));
+      }
+    }
+
+    std::vector<int> clusterOf(resources.size(), -1);
+    std::vector<ResourceCluster> found;
+    std::vector<Position> sums;
+    for ( size_t i = 0; i < resources.size(); ++i )
+    {
+      int root = findRoot(parents, static_cast<int>(i));
+      if ( clusterOf[root] == -1 )
+      {
+        clusterOf[root] = static_cast<int>(found.size());
+        found.emplace_back();
+        sums.emplace_back(0, 0);
+      }
+
+      ResourceCluster &cluster = found[clusterOf[root]];
+      const Resource &r = *resources[i];
+      if ( r.type.isMineralField() )
+        cluster.minerals.push_back(r.tilePosition);
+      else
+        cluster.geysers.push_back(r.tilePosition);
+      cluster.amount += r.amount;
+      sums[clusterOf[root]] += getCenter(r.type, r.tilePosition);
+    }
+
+    for ( size_t i = 0; i < found.size(); ++i )
+    {
+      ResourceCluster &cluster = found[i];
+      if ( cluster.geysers.empty() && static_cast<int>(cluster.minerals.size()) < MinimumMinerals )
+        continue;
+      cluster.center = sums[i] / static_cast<int>(cluster.minerals.size() + cluster.geysers.size());
+      clusters.push_back(std::move(cluster));
+    }
+  }
+  //--------------------------------------------- FIND BASES -------------------------------------------------
+  void TerrainAnalysis::findBases(const Input &input)
+  {
+    int width = input.width, height = input.height;
+    if ( width <= 0 || height <= 0 || input.buildable.size() < static_cast<size_t>(width) * height )
+      return;
+
+    // Mark the tiles that a resource depot may cover, then sum them up so that any
+    // rectangle can be tested in constant time
+    std::vector<bool> allowed(input.buildable.begin(), input.buildable.begin() + width * height);
+    for ( auto &r : input.resources )
+    {
+      int left = std::max(0, r.tilePosition.x - ResourceExclusion);
+      int top = std::max(0, r.tilePosition.y - ResourceExclusion);
+      int right = std::min(width, r.tilePosition.x + r.type.tileWidth() + ResourceExclusion);
+      int bottom = std::min(height, r.tilePosition.y + r.type.tileHeight() + ResourceExclusion);
+      for ( int y = top; y < bottom; ++y )
+      {
+        for ( int x = left; x < right; ++x )
+          allowed[y * width + x] = false;
+      }
+    }
+
+    int stride = width + 1;
+    std::vector<int> blockedSums(static_cast<size_t>(stride) * (height + 1), 0);
+    for ( int y = 0; y < height; ++y )
+    {
+      for ( int x = 0; x < width; ++x )
+      {
+        blockedSums[(y + 1) * stride + x + 1] = (allowed[y * width + x] ? 0 : 1)
+          + blockedSums[y * stride + x + 1] + blockedSums[(y + 1) * stride + x] - blockedSums[y * stride + x];
+      }
+    }
+
+    UnitType depot = UnitTypes::Terran_Command_Center;
+    int depotWidth = depot.tileWidth(), depotHeight = depot.tileHeight();
+    auto canPlaceDepot = [&](int x, int y)
+    {
+      int x2 = x + depotWidth, y2 = y + depotHeight;
+      return blockedSums[y2 * stride + x2] - blockedSums[y * stride + x2] - blockedSums[y2 * stride + x] + blockedSums[y * stride + x] == 0;
+    };
+    auto getRegion = [&](Position p)
+    {
+      size_t i = static_cast<size_t>(p.y / 8) * (width * 4) + p.x / 8;
+      return i < input.regionIds.size() ? input.regionIds[i] : -1;
+    };
+
+    for ( size_t c = 0; c < clusters.size(); ++c )
+    {
+      const ResourceCluster &cluster = clusters[c];
+      std::vector<Position> centers;
+      for ( auto &t : cluster.minerals )
+      {
+        centers.push_back(getCenter(UnitTypes::Resource_Mineral_Field, t));
+      }
+      for ( auto &t : cluster.geysers )
+      {
+        centers.push_back(getCenter(UnitTypes::Resource_Vespene_Geyser, t));
+      }
+
+      int left = width, top = height, right = 0, bottom = 0;
+      for ( auto &p : centers )
+      {
+        left = std::min(left, p.x / 32);
+        top = std::min(top, p.y / 32);
+        right = std::max(right, p.x / 32);
+        bottom = std::max(bottom, p.y / 32);
+      }
+      left = std::max(0, left - BaseSearchRange);
+      top = std::max(0, top - BaseSearchRange);
+      right = std::min(width - depotWidth, right + BaseSearchRange);
+      bottom = std::min(height - depotHeight, bottom + BaseSearchRange);
+
+      double bestScore = std::numeric_limits<double>::max();
+      BaseLocation best;
+      for ( int y = top; y <= bottom; ++y )
+      {
+        for ( int x = left; x <= right; ++x )
+        {
+          if ( !canPlaceDepot(x, y) )
+            continue;
+
+          Position center = getCenter(depot, TilePosition(x, y));
+          double score = 0;
+          for ( auto &p : centers )
+            score += center.getDistance(p);
+
+          if ( score < bestScore )
+          {
+            bestScore = score;
+            best.tilePosition = TilePosition(x, y);
+            best.position = center;
+          }
+        }
+      }
+
+      if ( bestScore == std::numeric_limits<double>::max() )
+        continue;
+      best.cluster = static_cast<int>(c);
+      best.region = getRegion(best.position);
+      bases.push_back(best);
+    }
+
+    // The start locations are where the map maker intended the main bases to be
+    for ( auto &start : input.startLocations )
+    {
+      Position center = getCenter(depot, start);
+      BaseLocation *closest = nullptr;
+      for ( auto &b : bases )
+      {
+        if ( !b.startLocation && b.position.getApproxDistance(center) <= StartLocationRange &&
+             (!closest || b.position.getApproxDistance(center) < closest->position.getApproxDistance(center)) )
+          closest = &b;
+      }
+
+      if ( !closest )
+      {
+        bases.emplace_back();
+        closest = &bases.back();
+      }
+      closest->tilePosition = start;
+      closest->position = center;
+      closest->region = getRegion(center);
+      closest->startLocation = true;
+    }
+  }
+  //--------------------------------------------- FIND CHOKE POINTS ------------------------------------------
+  void TerrainAnalysis::findChokePoints(const Input &input)
+  {
+    int width = input.width * 4, height = input.height * 4;
+    size_t size = static_cast<size_t>(width) * height;
+    if ( width <= 0 || height <= 0 || input.walkable.size() < size || input.regionIds.size() < size )
+      return;
+
+    // Use the caller's clearance map if it was built for this terrain
+    ClearanceMap computed;
+    const ClearanceMap *clearance = input.clearance;
+    if ( !clearance || clearance->getWidth() != width || clearance->getHeight() != height )
+    {
+      computed.build(width, height, input.walkable);
+      clearance = &computed;
+    }
+
+    struct Border
+    {
+      WalkPosition first, last;      // extremes along x
+      WalkPosition top, bottom;      // extremes along y
+      WalkPosition widest;
+      int clearance = -1;
+    };
+    std::map< std::pair<int,int>, Border > borders;
+
+    auto addTile = [&](Border &border, WalkPosition p)
+    {
+      if ( border.clearance == -1 )
+        border.first = border.last = border.top = border.bottom = p;
+      if ( p.x < border.first.x ) border.first = p;
+      if ( p.x > border.last.x ) border.last = p;
+      if ( p.y < border.top.y ) border.top = p;
+      if ( p.y > border.bottom.y ) border.bottom = p;
+
+      int d = clearance->getDistance(p);
+      if ( d > border.clearance )
+      {
+        border.clearance = d;
+        border.widest = p;
+      }
+    };
+
+    for ( int y = 0; y < height; ++y )
+    {
+      for ( int x = 0; x < width; ++x )
+      {
+        int i = y * width + x;
+        int a = input.regionIds[i];
+        if ( a < 0 || !input.walkable[i] )
+          continue;
+
+        // Right and bottom neighbors, so that each pair of tiles is only visited once
+        for ( int n = 0; n < 2; ++n )
+        {
+          int nx = x + (n == 0 ? 1 : 0), ny = y + (n == 1 ? 1 : 0);
+          if ( nx >= width || ny >= height )
+            continue;
+          int j = ny * width + nx;
+          int b = input.regionIds[j];
+          if ( b < 0 || b == a || !input.walkable[j] )
+            continue;
+
+          Border &border = borders[std::make_pair(std::min(a, b), std::max(a, b))];
+          addTile(border, WalkPosition(x, y));
+          addTile(border, WalkPosition(nx, ny));
+        }
+      }
+    }
+
+    for ( auto &entry : borders )
+    {
+      const Border &border = entry.second;
+      int chokeWidth = border.clearance * 2;
+      if ( chokeWidth > MaximumChokeWidth )
+        continue;
+
+      bool horizontal = border.last.x - border.first.x >= border.bottom.y - border.top.y;
+      ChokePoint choke;
+      choke.regions[0] = entry.first.first;
+      choke.regions[1] = entry.first.second;
+      choke.center = Position(border.widest) + Position(4, 4);
+      choke.sides[0] = Position(horizontal ? border.first : border.top) + Position(4, 4);
+      choke.sides[1] = Position(horizontal ? border.last : border.bottom) + Position(4, 4);
+      choke.width = chokeWidth;
+      chokes.push_back(choke);
+    }
+  }
+  //--------------------------------------------- SAVE -------------------------------------------------------
+  bool TerrainAnalysis::save(const std::string &filename, const std::string &mapHash) const
+  {
+    if ( !analyzed )
+      return false;
+
+    std::ofstream out(filename, std::ios::binary | std::ios::trunc);
+    if ( !out )
+      return false;
+
+    writeInt(out, CacheMagic);
+    writeInt(out, CacheVersion);
+    writeInt(out, static_cast<int>(mapHash.size()));
+    out.write(mapHash.data(), mapHash.size());
+
+    writeInt(out, static_cast<int>(clusters.size()));
+    for ( auto &c : clusters )
+    {
+      writePoints(out, c.minerals);
+      writePoints(out, c.geysers);
+      writeInt(out, c.amount);
+      writePoint(out, c.center);
+    }
+
+    writeInt(out, static_cast<int>(bases.size()));
+    for ( auto &b : bases )
+    {
+      writePoint(out, b.tilePosition);
+      writePoint(out, b.position);
+      writeInt(out, b.cluster);
+      writeInt(out, b.region);
+      writeInt(out, b.startLocation ? 1 : 0);
+    }
+
+    writeInt(out, static_cast<int>(chokes.size()));
+    for ( auto &c : chokes )
+    {
+      writeInt(out, c.regions[0]);
+      writeInt(out, c.regions[1]);
+      writePoint(out, c.center);
+      writePoint(out, c.sides[0]);
+      writePoint(out, c.sides[1]);
+      writeInt(out, c.width);
+    }
+    return out.good();
+  }
+  //--------------------------------------------- LOAD -------------------------------------------------------
+  bool TerrainAnalysis::load(const std::string &filename, const std::string &mapHash)
+  {
+    this->clear();
+
+    std::ifstream in(filename, std::ios::binary);
+    if ( !in )
+      return false;
+
+    if ( static_cast<std::uint32_t>(readInt(in)) != CacheMagic || readInt(in) != CacheVersion )
+      return false;
+
+    std::string hash(readCount(in), '\0');
+    in.read(&hash[0], hash.size());
+    if ( !in || hash != mapHash )
+      return false;
+
+    clusters.resize(readCount(in));
+    for ( auto &c : clusters )
+    {
+      readPoints(in, c.minerals);
+      readPoints(in, c.geysers);
+      c.amount = readInt(in);
+      c.center = readPoint<Position>(in);
+    }
+
+    bases.resize(readCount(in));
+    for ( auto &b : bases )
+    {
+      b.tilePosition = readPoint<TilePosition>(in);
+      b.position = readPoint<Position>(in);
+      b.cluster = readInt(in);
+      b.region = readInt(in);
+      b.startLocation = readInt(in) != 0;
+    }
+
+    chokes.resize(readCount(in));
+    for ( auto &c : chokes )
+    {
+      c.regions[0] = readInt(in);
+      c.regions[1] = readInt(in);
+      c.center = readPoint<Position>(in);
+      c.sides[0] = readPoint<Position>(in);
+      c.sides[1] = readPoint<Position>(in);
+      c.width = readInt(in);
+    }
+
+    if ( !in )
+    {
+      this->clear();
+      return false;
+    }
+    analyzed = true;
+    return true;
+  }
+}
@@ -9,6 +9,7 @@
 #include <BWAPI/Player.h>
 #include <BWAPI/Filters.h>
 #include <BWAPI/Flag.h>
+#include <BWAPI/UnitMotion.h>
 
 #include <limits>
 
@@ -155,6 +156,13 @@ namespace BWAPI
     // compute actual distance
     return Positions::Origin.getApproxDistance(Position(xDist, yDist));
   }
+  //--------------------------------------------- PREDICT POSITION -------------------------------------------
+  Position UnitInterface::predictPosition(int frames) const
+  {
+    if ( !exists() )
+      return Positions::Unknown;
+    return UnitMotion::predict(UnitMotion::getState(const_cast<UnitInterface*>(this)), frames);
+  }
   //--------------------------------------------- HAS PATH ---------------------------------------------------
   bool UnitInterface::hasPath(PositionOrUnit target) const
   {
@@ -0,0 +1,104 @@
+#include <BWAPI/UnitMotion.h>
+#include <BWAPI/Unit.h>
+#include <BWAPI/UnitType.h>
+#include <BWAPI/Player.h>
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+namespace BWAPI
+{
+  namespace UnitMotion
+  {
+    namespace
+    {
+      // Prevents division by zero without adding a branch
+      const float Epsilon = 1e-6f;
+
+      // Shared by the single and batch predictions so that both produce identical results
+      inline void predictOne(float x, float y, float vx, float vy, float topSpeed, float acceleration, float range,
+                             float frames, float &resultX, float &resultY)
+      {
+        float speed = std::sqrt(vx*vx + vy*vy);
+        float top   = std::max(topSpeed, speed);
+
+        // Time spent accelerating, then the distance covered while accelerating and at top speed
+        float accelFrames = std::min(frames, (top - speed) / std::max(acceleration, Epsilon));
+        float dist = speed*accelFrames + 0.5f*acceleration*accelFrames*accelFrames + top*(frames - accelFrames);
+        dist = std::min(dist, range);
+
+        // Continue along the current heading
+        float scale = dist / std::max(speed, Epsilon);
+        resultX = x + vx*scale;
+        resultY = y + vy*scale;
+      }
+    }
+    //------------------------------------------- GET STATE ------------------------------------------------
+    State getState(Unit unit)
+    {
+      State state;
+      if ( !unit )
+        return state;
+
+      Position pos = unit->getPosition();
+      state.x = static_cast<float>(pos.x);
+      state.y = static_cast<float>(pos.y);
+      if ( !unit->exists() )
+        return state;
+
+      UnitType type = unit->getType();
+      Player player = unit->getPlayer();
+
+      state.velocityX = static_cast<float>(unit->getVelocityX());
+      state.velocityY = static_cast<float>(unit->getVelocityY());
+      state.topSpeed  = static_cast<float>(player ? player->topSpeed(type) : type.topSpeed());
+
+      // Acceleration and halt distance are in 1/256ths of a pixel. Types that report 1 move by
+      // their animation, so their acceleration is left at 0 and they keep their current speed.
+      if ( type.acceleration() > 1 )
+        state.acceleration = type.acceleration() / 256.0f;
+
+      float speed = std::sqrt(state.velocityX*state.velocityX + state.velocityY*state.velocityY);
+      if ( !unit->isMoving() || unit->isBraking() )
+      {
+        // Halt distance is the distance needed to stop from the type's base top speed
+        state.range = 0;
+        if ( type.haltDistance() > 1 && type.topSpeed() > 0 )
+        {
+          float ratio = speed / static_cast<float>(type.topSpeed());
+          state.range = type.haltDistance() / 256.0f * ratio * ratio;
+        }
+      }
+      else
+      {
+        // Stop at the move target if it is known
+        Position target = unit->getTargetPosition();
+        if ( target.isValid() )
+          state.range = static_cast<float>(pos.getDistance(target));
+        else
+          state.range = std::numeric_limits<float>::max();
+      }
+      return state;
+    }
+    //------------------------------------------- PREDICT --------------------------------------------------
+    Position predict(const State &state, int frames)
+    {
+      float x, y;
+      predictOne(state.x, state.y, state.velocityX, state.velocityY, state.topSpeed, state.acceleration, state.range,
+                 static_cast<float>(std::max(frames, 0)), x, y);
+      return Position(static_cast<int>(std::lround(x)), static_cast<int>(std::lround(y)));
+    }
+    void predict(const float *x, const float *y, const float *velocityX, const float *velocityY,
+                 const float *topSpeed, const float *acceleration, const float *range, size_t count,
+                 int frames, float *resultX, float *resultY)
+    {
+      const float f = static_cast<float>(std::max(frames, 0));
+      for ( size_t i = 0; i < count; ++i )
+      {
+        predictOne(x[i], y[i], velocityX[i], velocityY[i], topSpeed[i], acceleration[i], range[i],
+                   f, resultX[i], resultY[i]);
+      }
+    }
+  }
+}
@@ -4,6 +4,7 @@
 #include <BWAPI/Unit.h>
 #include <BWAPI/Game.h>
 #include <BWAPI/TechType.h>
+#include <BWAPI/DistanceBatch.h>
 
 #include <utility>
 
@@ -98,6 +99,14 @@ namespace BWAPI
 
     return Broodwar->getClosestUnit(this->getPosition(), pred, radius);
   }
+  std::vector<int> Unitset::getDistances(PositionOrUnit target) const
+  {
+    return DistanceBatch(*this).getDistances(target);
+  }
+  Unit Unitset::getClosestUnitTo(PositionOrUnit target, int radius) const
+  {
+    return DistanceBatch(*this).getClosestUnit(target, radius);
+  }
 
   bool Unitset::issueCommand(UnitCommand command) const
   {
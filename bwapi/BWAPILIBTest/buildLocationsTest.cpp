@@ -0,0 +1,159 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include "fakeUnit.h"
+#include "fakeGame.h"
+#include <BWAPI.h>
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  TEST_CLASS(buildLocationsTest)
+  {
+    // A map with an unbuildable column at x = 40 and a raised plateau in the top left corner
+    static void makeTerrain(FakeGame &game)
+    {
+      for ( int y = 0; y < game.height; ++y )
+        game.buildable[y * game.width + 40] = false;
+      for ( int y = 0; y < 20; ++y )
+        for ( int x = 0; x < 20; ++x )
+          game.groundHeight[y * game.width + x] = 2;
+    }
+
+    // Checks that each batch result is what getBuildLocation returns once the structures placed
+    // before it have been started, and that the structures stay within range without overlapping.
+    static void checkSequential(FakeGame &game, const std::vector< std::pair<UnitType, TilePosition> > &requests, int maxRange)
+    {
+      std::vector<TilePosition> batch = game.getBuildLocations(requests, maxRange);
+      Assert::AreEqual(requests.size(), batch.size());
+
+      std::vector< std::unique_ptr<FakeUnit> > started;
+      for ( size_t i = 0; i < requests.size(); ++i )
+      {
+        UnitType type = requests[i].first;
+        TilePosition expected = game.getBuildLocation(type, requests[i].second, maxRange);
+        Assert::AreEqual(expected, batch[i]);
+        if ( expected == TilePositions::None )
+          continue;
+
+        Assert::IsTrue(expected.getApproxDistance(requests[i].second) <= maxRange);
+        Assert::IsTrue(expected.x >= 0 && expected.y >= 0);
+        Assert::IsTrue(expected.x + type.tileWidth() <= game.width && expected.y + type.tileHeight() <= game.height);
+        for ( int y = expected.y; y < expected.y + type.tileHeight(); ++y )
+          for ( int x = expected.x; x < expected.x + type.tileWidth(); ++x )
+            Assert::IsTrue(game.isBuildable(x, y, true));
+
+        started.emplace_back(new FakeUnit(1000 + static_cast<int>(i), Position(expected) + Position(type.tileSize()) / 2, type.maxHitPoints()));
+        started.back()->type = type;
+        started.back()->alive = true;
+        game.player.units.insert(started.back().get());
+      }
+      game.player.units.clear();
+    }
+  public:
+    TEST_METHOD(BuildLocationsMatchSequential)
+    {
+      FakeGame game(64, 64);
+      makeTerrain(game);
+      MapBounds::set(64, 64);
+      BroodwarPtr = &game;
+
+      checkSequential(game, {
+        { UnitTypes::Protoss_Gateway, TilePosition(36, 30) },
+        { UnitTypes::Protoss_Gateway, TilePosition(36, 30) },
+        { UnitTypes::Protoss_Forge, TilePosition(36, 30) },
+        { UnitTypes::Protoss_Cybernetics_Core, TilePosition(42, 30) },
+        { UnitTypes::Protoss_Photon_Cannon, TilePosition(18, 18) },
+        { UnitTypes::Protoss_Stargate, TilePosition(36, 30) },
+        { UnitTypes::Protoss_Photon_Cannon, TilePosition(18, 18) }
+      }, 64);
+
+      BroodwarPtr = nullptr;
+      MapBounds::reset();
+    }
+    TEST_METHOD(BuildLocationsSmallRange)
+    {
+      FakeGame game(64, 64);
+      makeTerrain(game);
+      MapBounds::set(64, 64);
+      BroodwarPtr = &game;
+
+      // Only a few gateways fit this close, after which the requests fail
+      std::vector< std::pair<UnitType, TilePosition> > requests(8, std::make_pair(UnitTypes::Protoss_Gateway, TilePosition(38, 30)));
+      checkSequential(game, requests, 6);
+      Assert::AreEqual(TilePositions::None, game.getBuildLocations(requests, 6).back());
+
+      BroodwarPtr = nullptr;
+      MapBounds::reset();
+    }
+    TEST_METHOD(BuildLocationsNotBuilding)
+    {
+      FakeGame game(64, 64);
+      MapBounds::set(64, 64);
+      BroodwarPtr = &game;
+
+      std::vector<TilePosition> batch = game.getBuildLocations({ { UnitTypes::Protoss_Zealot, TilePosition(10, 10) } });
+      Assert::AreEqual(size_t(1), batch.size());
+      Assert::AreEqual(TilePositions::Invalid, batch[0]);
+      Assert::AreEqual(Errors::Incompatible_UnitType, game.getLastError());
+
+      BroodwarPtr = nullptr;
+      MapBounds::reset();
+    }
+    BEGIN_TEST_METHOD_ATTRIBUTE(BuildLocationsBenchmark)
+      TEST_IGNORE()
+    END_TEST_METHOD_ATTRIBUTE()
+    TEST_METHOD(BuildLocationsBenchmark)
+    {
+      FakeGame game(128, 128);
+      makeTerrain(game);
+      MapBounds::set(128, 128);
+      BroodwarPtr = &game;
+
+      // A base worth of structures around the same point, planned in one batch or placed one at a
+      // time, with each structure started before the next getBuildLocation call as a bot would
+      const UnitType types[] = { UnitTypes::Protoss_Pylon, UnitTypes::Protoss_Gateway, UnitTypes::Protoss_Forge,
+                                 UnitTypes::Protoss_Cybernetics_Core, UnitTypes::Protoss_Photon_Cannon, UnitTypes::Protoss_Stargate };
+      std::vector< std::pair<UnitType, TilePosition> > requests;
+      for ( int i = 0; i < 36; ++i )
+        requests.emplace_back(types[i % 6], TilePosition(60, 60));
+
+      auto begin = std::chrono::high_resolution_clock::now();
+      std::vector<TilePosition> batch = game.getBuildLocations(requests);
+      auto middle = std::chrono::high_resolution_clock::now();
+
+      std::vector<TilePosition> single;
+      std::vector< std::unique_ptr<FakeUnit> > started;
+      for ( auto &r : requests )
+      {
+        single.push_back(game.getBuildLocation(r.first, r.second));
+        if ( single.back() == TilePositions::None )
+          continue;
+        started.emplace_back(new FakeUnit(1000 + static_cast<int>(started.size()), Position(single.back()) + Position(r.first.tileSize()) / 2, r.first.maxHitPoints()));
+        started.back()->type = r.first;
+        started.back()->alive = true;
+        game.player.units.insert(started.back().get());
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+
+      Assert::IsTrue(batch == single);
+      game.player.units.clear();
+      BroodwarPtr = nullptr;
+      MapBounds::reset();
+
+      std::ostringstream ss;
+      ss << "getBuildLocations: " << requests.size() << " structures on a 128x128 map take "
+         << std::chrono::duration<double, std::milli>(middle - begin).count() << " ms in one batch and "
+         << std::chrono::duration<double, std::milli>(end - middle).count() << " ms with getBuildLocation\n";
+      Logger::WriteMessage(ss.str().c_str());
+    }
+  };
+}
@@ -0,0 +1,140 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include <BWAPI.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  namespace
+  {
+    std::vector<bool> randomMap(int width, int height, int obstacles, unsigned int seed)
+    {
+      std::vector<bool> walkable(width * height, true);
+      std::srand(seed);
+      for ( int i = 0; i < obstacles; ++i )
+      {
+        int x = std::rand() % width, y = std::rand() % height;
+        int w = 1 + std::rand() % 12, h = 1 + std::rand() % 12;
+        for ( int ty = y; ty < std::min(height, y + h); ++ty )
+          for ( int tx = x; tx < std::min(width, x + w); ++tx )
+            walkable[ty * width + tx] = false;
+      }
+      return walkable;
+    }
+  }
+
+  TEST_CLASS(clearanceMapTest)
+  {
+  public:
+    TEST_METHOD(ClearanceMapRadius)
+    {
+      Assert::AreEqual(13, ClearanceMap::getRadius(UnitSizeTypes::Small));
+      Assert::AreEqual(16, ClearanceMap::getRadius(UnitSizeTypes::Medium));
+      Assert::AreEqual(19, ClearanceMap::getRadius(UnitSizeTypes::Large));
+      Assert::AreEqual(0, ClearanceMap::getRadius(UnitSizeTypes::Independent));
+      Assert::AreEqual(16, ClearanceMap::getRadius(UnitTypes::Protoss_Dragoon));
+
+      // Every ground unit fits in the radius of its size class
+      for ( UnitType type : UnitTypes::allUnitTypes() )
+      {
+        if ( type.size() == UnitSizeTypes::Independent || !type.canMove() || type.isFlyer() || type.isBuilding() || type.isCritter() || type.isPowerup() )
+          continue;
+        Assert::IsTrue(ClearanceMap::getRadius(type) <= ClearanceMap::getRadius(type.size()));
+      }
+    }
+    TEST_METHOD(ClearanceMapMatchesBruteForce)
+    {
+      const int width = 70, height = 45;
+      std::vector<bool> walkable = randomMap(width, height, 30, 33);
+
+      ClearanceMap map;
+      Assert::IsFalse(map.isBuilt());
+      map.build(width, height, walkable, 3);
+      Assert::IsTrue(map.isBuilt());
+
+      for ( int y = 0; y < height; ++y )
+      {
+        for ( int x = 0; x < width; ++x )
+        {
+          // Nearest blocked tile, including the ring of tiles around the map
+          int best = std::min(std::min(x + 1, width - x), std::min(y + 1, height - y));
+          best *= best;
+          for ( int by = 0; by < height; ++by )
+            for ( int bx = 0; bx < width; ++bx )
+              if ( !walkable[by * width + bx] )
+                best = std::min(best, (bx - x) * (bx - x) + (by - y) * (by - y));
+
+          int expected = static_cast<int>(std::sqrt(static_cast<double>(best * 64)));
+          Assert::AreEqual(expected, map.getDistance(WalkPosition(x, y)));
+
+          for ( UnitSizeType size : { UnitSizeTypes::Small, UnitSizeTypes::Medium, UnitSizeTypes::Large } )
+          {
+            int required = ClearanceMap::getRadius(size);
+            Assert::AreEqual(best * 64 >= required * required, map.isPassable(WalkPosition(x, y), size));
+          }
+        }
+      }
+      Assert::AreEqual(0, map.getDistance(WalkPosition(-1, 0)));
+      Assert::IsFalse(map.isPassable(WalkPosition(0, height), UnitSizeTypes::Small));
+      Assert::IsTrue(map.getMask(UnitSizeTypes::None).empty());
+    }
+    TEST_METHOD(ClearanceMapCorridor)
+    {
+      // A horizontal corridor 4 walk tiles (32 pixels) high across the middle of a 40x15 map
+      const int width = 40, height = 15;
+      std::vector<bool> walkable(width * height, false);
+      for ( int y = 5; y < 9; ++y )
+        for ( int x = 0; x < width; ++x )
+          walkable[y * width + x] = true;
+
+      ClearanceMap map;
+      map.build(width, height, walkable);
+
+      // Small and medium units fit in the middle of the corridor, large ones do not
+      Assert::AreEqual(16, map.getDistance(WalkPosition(20, 6)));
+      Assert::IsTrue(map.isPassable(WalkPosition(20, 6), UnitSizeTypes::Small));
+      Assert::IsTrue(map.isPassable(WalkPosition(20, 6), UnitSizeTypes::Medium));
+      Assert::IsFalse(map.isPassable(WalkPosition(20, 5), UnitSizeTypes::Small));
+      Assert::IsFalse(map.isPassable(WalkPosition(20, 6), UnitSizeTypes::Large));
+      Assert::IsTrue(map.isPassable(WalkPosition(20, 6), UnitTypes::Terran_Marine));
+      Assert::IsFalse(map.isPassable(WalkPosition(20, 6), UnitTypes::Zerg_Ultralisk));
+    }
+    BEGIN_TEST_METHOD_ATTRIBUTE(ClearanceMapBenchmark)
+      TEST_IGNORE()
+    END_TEST_METHOD_ATTRIBUTE()
+    TEST_METHOD(ClearanceMapBenchmark)
+    {
+      // A 256x256 tile map is 1024x1024 walk tiles
+      const int size = 1024;
+      std::vector<bool> walkable = randomMap(size, size, 4000, 34);
+
+      ClearanceMap single, multi;
+      auto start = std::chrono::high_resolution_clock::now();
+      single.build(size, size, walkable, 1);
+      auto singleEnd = std::chrono::high_resolution_clock::now();
+      multi.build(size, size, walkable);
+      auto multiEnd = std::chrono::high_resolution_clock::now();
+
+      Assert::IsTrue(single.getDistances() == multi.getDistances());
+      Assert::IsTrue(single.getMask(UnitSizeTypes::Large) == multi.getMask(UnitSizeTypes::Large));
+
+      double multiMs = std::chrono::duration<double, std::milli>(multiEnd - singleEnd).count();
+      Assert::IsTrue(multiMs < 1000);
+
+      std::ostringstream ss;
+      ss << "ClearanceMap: 1024x1024 walk tiles in " << std::chrono::duration<double, std::milli>(singleEnd - start).count()
+         << " ms on one thread, " << multiMs << " ms on all cores\n";
+      Logger::WriteMessage(ss.str().c_str());
+    }
+  };
+}
@@ -0,0 +1,101 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include <BWAPI.h>
+
+#include <vector>
+#include <random>
+#include <algorithm>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  TEST_CLASS(distanceBatchTest)
+  {
+  public:
+    TEST_METHOD(DistanceBatchApproxDistances)
+    {
+      std::mt19937 rng(1234);
+      std::uniform_int_distribution<int> coord(0, 256 * 32);
+
+      // An odd count so that the scalar remainder is exercised too
+      const size_t count = 1003;
+      std::vector<int> x(count), y(count), result(count);
+      for ( size_t i = 0; i < count; ++i )
+      {
+        x[i] = coord(rng);
+        y[i] = coord(rng);
+      }
+
+      for ( int t = 0; t < 16; ++t )
+      {
+        Position target(coord(rng), coord(rng));
+        DistanceBatch::getApproxDistances(x.data(), y.data(), count, target, result.data());
+        for ( size_t i = 0; i < count; ++i )
+          Assert::AreEqual(target.getApproxDistance(Position(x[i], y[i])), result[i]);
+      }
+    }
+    TEST_METHOD(DistanceBatchEdgeDistances)
+    {
+      std::mt19937 rng(5678);
+      std::uniform_int_distribution<int> coord(0, 256 * 32);
+
+      // Boxes built from unit type dimensions, like UnitInterface::getLeft etc.
+      std::vector<UnitType> types;
+      for ( UnitType t : UnitTypes::allUnitTypes() )
+      {
+        if ( t.width() > 0 )
+          types.push_back(t);
+      }
+
+      const size_t count = 517;
+      std::vector<int> left(count), top(count), right(count), bottom(count), result(count);
+      for ( size_t i = 0; i < count; ++i )
+      {
+        UnitType t = types[i % types.size()];
+        int x = coord(rng), y = coord(rng);
+        left[i]   = x - t.dimensionLeft();
+        top[i]    = y - t.dimensionUp();
+        right[i]  = x + t.dimensionRight();
+        bottom[i] = y + t.dimensionDown();
+      }
+
+      for ( int t = 0; t < 16; ++t )
+      {
+        // Include targets that overlap the boxes
+        Position target = t == 0 ? Position(left[3] + 1, top[3]) : Position(coord(rng), coord(rng));
+        DistanceBatch::getEdgeDistances(left.data(), top.data(), right.data(), bottom.data(), count,
+                                        target.x - 1, target.y - 1, target.x + 1, target.y + 1, result.data());
+        for ( size_t i = 0; i < count; ++i )
+        {
+          // Same steps as UnitInterface::getDistance
+          int xDist = left[i] - (target.x + 1);
+          if ( xDist < 0 )
+          {
+            xDist = (target.x - 1) - right[i];
+            if ( xDist < 0 )
+              xDist = 0;
+          }
+          int yDist = top[i] - (target.y + 1);
+          if ( yDist < 0 )
+          {
+            yDist = (target.y - 1) - bottom[i];
+            if ( yDist < 0 )
+              yDist = 0;
+          }
+          Assert::AreEqual(Positions::Origin.getApproxDistance(Position(xDist, yDist)), result[i]);
+        }
+        if ( t == 0 )
+          Assert::AreEqual(0, result[3]);
+      }
+    }
+    TEST_METHOD(DistanceBatchEmpty)
+    {
+      DistanceBatch batch;
+      Assert::IsTrue(batch.empty());
+      Assert::IsTrue(batch.getClosestUnit(Positions::Origin) == nullptr);
+    }
+  };
+}
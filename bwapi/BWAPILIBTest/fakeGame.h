@@ -0,0 +1,257 @@
+#pragma once
+#include <BWAPI.h>
+#include <BWAPI/PowerGrid.h>
+#include <BWAPI/RegionGraph.h>
+
+#include <vector>
+
+namespace BWAPILIBTest
+{
+  using namespace BWAPI;
+
+  // A region that every tile of a FakeGame belongs to
+  class FakeRegion : public RegionInterface
+  {
+  public:
+    Regionset neighbors;
+
+    virtual int getID() const override { return 0; }
+    virtual int getRegionGroupID() const override { return 0; }
+    virtual BWAPI::Position getCenter() const override { return BWAPI::Position(); }
+    virtual bool isHigherGround() const override { return false; }
+    virtual int getDefensePriority() const override { return 0; }
+    virtual bool isAccessible() const override { return false; }
+    virtual const Regionset &getNeighbors() const override { return neighbors; }
+    virtual int getBoundsLeft() const override { return 0; }
+    virtual int getBoundsTop() const override { return 0; }
+    virtual int getBoundsRight() const override { return 0; }
+    virtual int getBoundsBottom() const override { return 0; }
+    virtual BWAPI::Region getClosestAccessibleRegion() const override { return nullptr; }
+    virtual BWAPI::Region getClosestInaccessibleRegion() const override { return nullptr; }
+  };
+
+  // The player of a FakeGame, owning the units that the test adds to #units
+  class FakePlayer : public PlayerInterface
+  {
+  public:
+    Unitset units;
+
+    virtual int getID() const override { return 0; }
+    virtual std::string getName() const override { return std::string(); }
+    virtual const Unitset &getUnits() const override  { return units; }
+    virtual Race getRace() const override { return Race(); }
+    virtual PlayerType getType() const override { return PlayerType(); }
+    virtual Force getForce() const override { return nullptr; }
+    virtual bool isAlly(const Player) const override { return false; }
+    virtual bool isEnemy(const Player) const override { return false; }
+    virtual bool isNeutral() const override { return false; }
+    virtual TilePosition getStartLocation() const override { return TilePosition(); }
+    virtual bool isVictorious() const override { return false; }
+    virtual bool isDefeated() const override { return false; }
+    virtual bool leftGame() const override { return false; }
+    virtual int minerals() const override { return 0; }
+    virtual int gas() const override { return 0; }
+    virtual int gatheredMinerals() const override { return 0; }
+    virtual int gatheredGas() const override { return 0; }
+    virtual int repairedMinerals() const override { return 0; }
+    virtual int repairedGas() const override { return 0; }
+    virtual int refundedMinerals() const override { return 0; }
+    virtual int refundedGas() const override { return 0; }
+    virtual int spentMinerals() const override { return 0; }
+    virtual int spentGas() const override { return 0; }
+    virtual int supplyTotal(Race) const override { return 0; }
+    virtual int supplyUsed(Race) const override { return 0; }
+    virtual int allUnitCount(UnitType) const override { return 0; }
+    virtual int visibleUnitCount(UnitType) const override { return 0; }
+    virtual int completedUnitCount(UnitType) const override { return 0; }
+    virtual int deadUnitCount(UnitType) const override { return 0; }
+    virtual int killedUnitCount(UnitType) const override { return 0; }
+    virtual int getUpgradeLevel(UpgradeType) const override { return 0; }
+    virtual bool hasResearched(TechType) const override { return false; }
+    virtual bool isResearching(TechType) const override { return false; }
+    virtual bool isUpgrading(UpgradeType) const override { return false; }
+    virtual BWAPI::Color getColor() const override { return BWAPI::Color(); }
+    virtual int getUnitScore() const override { return 0; }
+    virtual int getKillScore() const override { return 0; }
+    virtual int getBuildingScore() const override { return 0; }
+    virtual int getRazingScore() const override { return 0; }
+    virtual int getCustomScore() const override { return 0; }
+    virtual bool isObserver() const override { return false; }
+    virtual int getMaxUpgradeLevel(UpgradeType) const override { return 0; }
+    virtual bool isResearchAvailable(TechType) const override { return false; }
+    virtual bool isUnitAvailable(UnitType) const override { return false; }
+  };
+
+  // A map of build tiles with buildability and ground height, for testing code that queries
+  // Broodwar without a running game. Every tile is in the same region, the player's units
+  // occupy the tiles under their type's footprint, and there are no neutral units.
+  class FakeGame : public Game
+  {
+  public:
+    int width;
+    int height;
+    std::vector<bool> buildable;
+    std::vector<int> groundHeight;
+    PowerGrid powerGrid;
+    mutable FakePlayer player;
+    mutable FakeRegion region;
+    mutable Error lastError;
+
+    FakeGame(int width, int height)
+      : width(width), height(height)
+      , buildable(static_cast<size_t>(width) * height, true)
+      , groundHeight(static_cast<size_t>(width) * height, 0)
+    {};
+
+    bool isInMap(int tileX, int tileY) const
+    {
+      return tileX >= 0 && tileY >= 0 && tileX < width && tileY < height;
+    };
+    bool isOccupied(int tileX, int tileY) const
+    {
+      for ( Unit u : player.units )
+      {
+        TilePosition topLeft = u->getTilePosition();
+        TilePosition size = u->getType().tileSize();
+        if ( tileX >= topLeft.x && tileY >= topLeft.y && tileX < topLeft.x + size.x && tileY < topLeft.y + size.y )
+          return true;
+      }
+      return false;
+    };
+
+    virtual const Forceset& getForces() const override { return noForces; }
+    virtual const Playerset& getPlayers() const override { return noPlayers; }
+    virtual const Unitset& getAllUnits() const override { return noUnits; }
+    virtual const Unitset& getMinerals() const override { return noUnits; }
+    virtual const Unitset& getGeysers() const override { return noUnits; }
+    virtual const Unitset& getNeutralUnits() const override { return noUnits; }
+    virtual const Unitset& getStaticMinerals() const override { return noUnits; }
+    virtual const Unitset& getStaticGeysers() const override { return noUnits; }
+    virtual const Unitset& getStaticNeutralUnits() const override { return noUnits; }
+    virtual const Bulletset& getBullets() const override { return noBullets; }
+    virtual const Position::list& getNukeDots() const override { return noPositions; }
+    virtual const std::list< Event >& getEvents() const override { return noEvents; }
+    virtual Force getForce(int) const override { return nullptr; }
+    virtual Player getPlayer(int) const override { return nullptr; }
+    virtual Unit getUnit(int) const override { return nullptr; }
+    virtual Unit indexToUnit(int) const override { return nullptr; }
+    virtual Region getRegion(int) const override { return nullptr; }
+    virtual GameType getGameType() const override { return GameType(); }
+    virtual int getLatency() const override { return 0; }
+    virtual int getFrameCount() const override { return 0; }
+    virtual int getReplayFrameCount() const override { return 0; }
+    virtual int getFPS() const override { return 0; }
+    virtual double getAverageFPS() const override { return 0.0; }
+    virtual Position getMousePosition() const override { return Position(); }
+    virtual bool getMouseState(MouseButton) const override { return false; }
+    virtual bool getKeyState(Key) const override { return false; }
+    virtual BWAPI::Position getScreenPosition() const override { return BWAPI::Position(); }
+    virtual void setScreenPosition(int, int) override { }
+    virtual void pingMinimap(int, int) override { }
+    virtual bool isFlagEnabled(int) const override { return false; }
+    virtual void enableFlag(int) override { }
+    virtual Unitset getUnitsInRectangle(int, int, int, int, const UnitFilter &) const override { return Unitset(); }
+    virtual Unit getClosestUnitInRectangle(Position, const UnitFilter &, int, int, int, int) const override { return nullptr; }
+    virtual Unit getBestUnit(const BestUnitFilter &, const UnitFilter &, Position, int) const override { return nullptr; }
+    virtual Error getLastError() const override { return lastError; }
+    virtual bool setLastError(BWAPI::Error e) const override
+    {
+      lastError = e;
+      return e == Errors::None;
+    }
+    virtual int mapWidth() const override { return width; }
+    virtual int mapHeight() const override { return height; }
+    virtual std::string mapFileName() const override { return std::string(); }
+    virtual std::string mapPathName() const override { return std::string(); }
+    virtual std::string mapName() const override { return std::string(); }
+    virtual std::string mapHash() const override { return std::string(); }
+    virtual bool isWalkable(int walkX, int walkY) const override { return walkX >= 0 && walkY >= 0 && walkX < width * 4 && walkY < height * 4; }
+    virtual int getGroundHeight(int tileX, int tileY) const override { return this->isInMap(tileX, tileY) ? groundHeight[tileY * width + tileX] : 0; }
+    virtual bool isBuildable(int tileX, int tileY, bool includeBuildings) const override { return this->isInMap(tileX, tileY) && buildable[tileY * width + tileX] && (!includeBuildings || !this->isOccupied(tileX, tileY)); }
+    virtual bool isVisible(int, int) const override { return false; }
+    virtual bool isExplored(int, int) const override { return false; }
+    virtual bool hasCreep(int, int) const override { return false; }
+    virtual bool isTileChanged(int, int, TileLayer::Enum) const override { return false; }
+    virtual const TilePosition::list &getChangedTileBlocks() const override { return noTiles; }
+    virtual bool hasPowerPrecise(int, int, UnitType) const override { return false; }
+    virtual const PowerGrid &getPowerGrid() const override { return powerGrid; }
+    virtual bool canBuildHere(TilePosition position, UnitType type, Unit builder, bool checkExplored) override
+    {
+      for ( int y = position.y; y < position.y + type.tileHeight(); ++y )
+      {
+        for ( int x = position.x; x < position.x + type.tileWidth(); ++x )
+        {
+          if ( !this->isBuildable(x, y, true) )
+            return false;
+        }
+      }
+      return true;
+    }
+    virtual bool canMake(UnitType, Unit) const override { return false; }
+    virtual bool canResearch(TechType, Unit, bool) override { return false; }
+    virtual bool canUpgrade(UpgradeType, Unit, bool) override { return false; }
+    virtual const TilePosition::list& getStartLocations() const override { return noTiles; }
+    virtual void vPrintf(const char *, va_list) override { }
+    virtual void vSendTextEx(bool, const char *, va_list) override { }
+    virtual bool isInGame() const override { return false; }
+    virtual bool isMultiplayer() const override { return false; }
+    virtual bool isBattleNet() const override { return false; }
+    virtual bool isPaused() const override { return false; }
+    virtual bool isReplay() const override { return false; }
+    virtual void pauseGame() override { }
+    virtual void resumeGame() override { }
+    virtual void leaveGame() override { }
+    virtual void restartGame() override { }
+    virtual void setLocalSpeed(int) override { }
+    virtual bool issueCommand(const Unitset&, UnitCommand) override { return false; }
+    virtual const Unitset& getSelectedUnits() const override { return noUnits; }
+    virtual Player self() const override { return &player; }
+    virtual Player enemy() const override { return nullptr; }
+    virtual Player neutral() const override { return nullptr; }
+    virtual Playerset& allies() override { return noPlayers; }
+    virtual Playerset& enemies() override { return noPlayers; }
+    virtual Playerset& observers() override { return noPlayers; }
+    virtual void setTextSize(Text::Size::Enum) override { }
+    virtual void vDrawText(CoordinateType::Enum, int, int, const char *, va_list) override { }
+    virtual void drawBox(CoordinateType::Enum, int, int, int, int, Color, bool) override { }
+    virtual void drawTriangle(CoordinateType::Enum, int, int, int, int, int, int, Color, bool) override { }
+    virtual void drawCircle(CoordinateType::Enum, int, int, int, Color, bool) override { }
+    virtual void drawEllipse(CoordinateType::Enum, int, int, int, int, Color, bool) override { }
+    virtual void drawDot(CoordinateType::Enum, int, int, Color) override { }
+    virtual void drawLine(CoordinateType::Enum, int, int, int, int, Color) override { }
+    virtual int getLatencyFrames() const override { return 0; }
+    virtual int getLatencyTime() const override { return 0; }
+    virtual int getRemainingLatencyFrames() const override { return 0; }
+    virtual int getRemainingLatencyTime() const override { return 0; }
+    virtual int getRevision() const override { return 0; }
+    virtual bool isDebug() const override { return false; }
+    virtual bool isLatComEnabled() const override { return false; }
+    virtual void setLatCom(bool) override { }
+    virtual bool isGUIEnabled() const override { return false; }
+    virtual void setGUI(bool) override { }
+    virtual int getInstanceNumber() const override { return 0; }
+    virtual int getAPM(bool) const override { return 0; }
+    virtual bool setMap(const char *) override { return false; }
+    virtual void setFrameSkip(int) override { }
+    virtual bool setAlliance(BWAPI::Player, bool, bool) override { return false; }
+    virtual bool setVision(BWAPI::Player, bool) override { return false; }
+    virtual int elapsedTime() const override { return 0; }
+    virtual void setCommandOptimizationLevel(int) override { }
+    virtual int countdownTimer() const override { return 0; }
+    virtual const Regionset &getAllRegions() const override { return noRegions; }
+    virtual BWAPI::Region getRegionAt(int x, int y) const override { return &region; }
+    virtual const RegionGraph &getRegionGraph() const override { return regionGraph; }
+    virtual int getLastEventTime() const override { return 0; }
+    virtual bool setRevealAll(bool) override { return false; }
+  private:
+    Forceset noForces;
+    Playerset noPlayers;
+    Unitset noUnits;
+    Bulletset noBullets;
+    Position::list noPositions;
+    std::list< Event > noEvents;
+    TilePosition::list noTiles;
+    Regionset noRegions;
+    RegionGraph regionGraph;
+  };
+}
@@ -0,0 +1,285 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include <BWAPI.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  namespace
+  {
+    // A walk tile map with random rectangular obstacles and square regions
+    struct FlowGrid
+    {
+      int width, height;
+      std::vector<bool> walkable;
+      std::vector<int> regionIds;
+      std::vector< std::vector<int> > neighbors;
+
+      FlowGrid(int width, int height, int obstacles, int regionSize, unsigned int seed)
+        : width(width), height(height)
+        , walkable(width * height, true)
+      {
+        std::srand(seed);
+        for ( int i = 0; i < obstacles; ++i )
+        {
+          int x = std::rand() % width, y = std::rand() % height;
+          int w = 2 + std::rand() % 24, h = 2 + std::rand() % 24;
+          for ( int ty = y; ty < std::min(height, y + h); ++ty )
+            for ( int tx = x; tx < std::min(width, x + w); ++tx )
+              walkable[ty * width + tx] = false;
+        }
+
+        int columns = width / regionSize, rows = height / regionSize;
+        for ( int y = 0; y < height; ++y )
+          for ( int x = 0; x < width; ++x )
+            regionIds.push_back((y / regionSize) * columns + x / regionSize);
+        neighbors.resize(columns * rows);
+        for ( int ry = 0; ry < rows; ++ry )
+          for ( int rx = 0; rx < columns; ++rx )
+            for ( int oy = -1; oy <= 1; ++oy )
+              for ( int ox = -1; ox <= 1; ++ox )
+                if ( (ox != 0 || oy != 0) && rx + ox >= 0 && ry + oy >= 0 && rx + ox < columns && ry + oy < rows )
+                  neighbors[ry * columns + rx].push_back((ry + oy) * columns + rx + ox);
+      }
+
+      bool isWalkable(int x, int y) const
+      {
+        return x >= 0 && y >= 0 && x < width && y < height && walkable[y * width + x];
+      }
+
+      // Plain Dijkstra from the destination, with the move costs of the Pathfinder
+      std::vector<int> distances(WalkPosition destination) const
+      {
+        std::vector<int> cost(width * height, -1);
+        typedef std::pair<int,int> Entry;
+        std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > open;
+        cost[destination.y * width + destination.x] = 0;
+        open.emplace(0, destination.y * width + destination.x);
+        while ( !open.empty() )
+        {
+          Entry top = open.top();
+          open.pop();
+          if ( top.first > cost[top.second] )
+            continue;
+          int x = top.second % width, y = top.second / width;
+          for ( int dy = -1; dy <= 1; ++dy )
+          {
+            for ( int dx = -1; dx <= 1; ++dx )
+            {
+              if ( (dx == 0 && dy == 0) || !isWalkable(x + dx, y + dy) )
+                continue;
+              if ( dx != 0 && dy != 0 && (!isWalkable(x + dx, y) || !isWalkable(x, y + dy)) )
+                continue;
+              int next = (y + dy) * width + x + dx;
+              int c = top.first + (dx != 0 && dy != 0 ? 1414 : 1000);
+              if ( cost[next] == -1 || c < cost[next] )
+              {
+                cost[next] = c;
+                open.emplace(c, next);
+              }
+            }
+          }
+        }
+        return cost;
+      }
+    };
+  }
+
+  TEST_CLASS(flowFieldsTest)
+  {
+  public:
+    TEST_METHOD(FlowFieldsFollowShortestPaths)
+    {
+      FlowGrid grid(128, 96, 40, 16, 39);
+      FlowFields flow;
+      flow.setBackgroundComputation(false);
+      flow.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+      Assert::IsTrue(flow.isBuilt());
+
+      for ( int destinationId : { 0, 27, 47 } )
+      {
+        WalkPosition destination = flow.getDestination(destinationId);
+        Assert::IsTrue(destination != WalkPositions::None);
+        Assert::IsTrue(grid.isWalkable(destination.x, destination.y));
+        Assert::AreEqual(destinationId, grid.regionIds[destination.y * grid.width + destination.x]);
+
+        // Every reachable tile points to a neighbor that is one move closer on a shortest path
+        std::vector<int> cost = grid.distances(destination);
+        for ( int y = 0; y < grid.height; ++y )
+        {
+          for ( int x = 0; x < grid.width; ++x )
+          {
+            WalkPosition direction = flow.getFlowDirection(WalkPosition(x, y), destinationId);
+            int c = cost[y * grid.width + x];
+            if ( c <= 0 )
+            {
+              if ( c == 0 )
+                Assert::IsTrue(direction == WalkPosition(0, 0));
+              continue;
+            }
+
+            Assert::IsTrue(direction != WalkPosition(0, 0));
+            int nx = x + direction.x, ny = y + direction.y;
+            Assert::IsTrue(grid.isWalkable(nx, ny));
+            int step = direction.x != 0 && direction.y != 0 ? 1414 : 1000;
+            Assert::AreEqual(c, cost[ny * grid.width + nx] + step);
+          }
+        }
+      }
+      Assert::IsTrue(flow.getFlowDirection(WalkPosition(0, 0), -1) == WalkPosition(0, 0));
+      Assert::IsTrue(flow.getFlowDirection(WalkPosition(0, 0), 1000) == WalkPosition(0, 0));
+    }
+    TEST_METHOD(FlowFieldsBackgroundAndCache)
+    {
+      FlowGrid grid(128, 128, 50, 16, 40);
+      FlowFields sync, async;
+      sync.setBackgroundComputation(false);
+      sync.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+      async.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+      async.setCacheSize(2);
+
+      // Requests return immediately, and the fields are the same once the worker is done
+      Assert::IsTrue(async.request(5));
+      Assert::IsTrue(async.request(60));
+      async.waitUntilIdle();
+      Assert::IsTrue(async.isReady(5));
+      Assert::IsTrue(async.isReady(60));
+      for ( int y = 0; y < grid.height; y += 3 )
+      {
+        for ( int x = 0; x < grid.width; x += 3 )
+        {
+          Assert::IsTrue(sync.getFlowDirection(WalkPosition(x, y), 5) == async.getFlowDirection(WalkPosition(x, y), 5));
+          Assert::IsTrue(sync.getFlowDirection(WalkPosition(x, y), 60) == async.getFlowDirection(WalkPosition(x, y), 60));
+        }
+      }
+
+      // Region 5 was used most recently, so requesting a third field evicts region 60
+      Assert::IsTrue(async.request(5));
+      Assert::IsTrue(async.request(33));
+      async.waitUntilIdle();
+      Assert::IsTrue(async.isReady(5));
+      Assert::IsTrue(async.isReady(33));
+      Assert::IsFalse(async.isReady(60));
+      Assert::AreEqual(3u, async.getCacheMisses());
+
+      async.clear();
+      Assert::IsFalse(async.isBuilt());
+      Assert::IsFalse(async.isReady(5));
+    }
+    TEST_METHOD(FlowFieldsDestroyedWhileComputing)
+    {
+      FlowGrid grid(256, 256, 150, 16, 41);
+
+      // The destructor stops the worker and discards the pending requests without clear
+      {
+        FlowFields flow;
+        flow.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+        for ( int region = 0; region < 64; ++region )
+          flow.request(region);
+      }
+    }
+    TEST_METHOD(FlowFieldsUnitsArrive)
+    {
+      // Every unit that has a ground path reaches the destination by following the field
+      FlowGrid grid(128, 96, 40, 16, 41);
+      const int destinationId = 2 * 8 + 4;
+      FlowFields flow;
+      flow.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+      WalkPosition destination = flow.getDestination(destinationId);
+      flow.request(destinationId);
+      flow.waitUntilIdle();
+
+      Pathfinder pathfinder;
+      pathfinder.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+      std::vector<WalkPosition> path;
+      std::srand(43);
+      for ( int i = 0; i < 40; ++i )
+      {
+        WalkPosition u(std::rand() % grid.width, std::rand() % grid.height);
+        if ( !grid.isWalkable(u.x, u.y) )
+          continue;
+        bool reachable = pathfinder.findPath(u, destination, 1, path) >= 0;
+        for ( int step = 0; step < grid.width * grid.height; ++step )
+        {
+          WalkPosition direction = flow.getFlowDirection(u, destinationId);
+          if ( direction == WalkPosition(0, 0) )
+            break;
+          u += direction;
+        }
+        Assert::AreEqual(reachable, u == destination);
+      }
+      flow.clear();
+    }
+    BEGIN_TEST_METHOD_ATTRIBUTE(FlowFieldsBenchmark)
+      TEST_IGNORE()
+    END_TEST_METHOD_ATTRIBUTE()
+    TEST_METHOD(FlowFieldsBenchmark)
+    {
+      // 150 units moving to the same region, with one path query each or one field for all
+      FlowGrid grid(256, 256, 150, 16, 41);
+      const int unitCount = 150, destinationId = 8 * 16 + 8;
+
+      FlowFields flow;
+      flow.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+      WalkPosition destination = flow.getDestination(destinationId);
+
+      std::srand(42);
+      std::vector<WalkPosition> units;
+      while ( static_cast<int>(units.size()) < unitCount )
+      {
+        int x = std::rand() % grid.width, y = std::rand() % grid.height;
+        if ( grid.isWalkable(x, y) )
+          units.emplace_back(x, y);
+      }
+
+      Pathfinder pathfinder;
+      pathfinder.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+      pathfinder.setCacheSize(0);
+      std::vector<WalkPosition> path;
+      int pathsFound = 0;
+      auto begin = std::chrono::high_resolution_clock::now();
+      for ( auto &u : units )
+        pathsFound += pathfinder.findPath(u, destination, 1, path) >= 0 ? 1 : 0;
+      auto middle = std::chrono::high_resolution_clock::now();
+
+      // Compute the field on the worker, then walk every unit to the destination
+      flow.request(destinationId);
+      flow.waitUntilIdle();
+      auto computed = std::chrono::high_resolution_clock::now();
+      int arrived = 0;
+      for ( auto u : units )
+      {
+        for ( int step = 0; step < grid.width * grid.height; ++step )
+        {
+          WalkPosition direction = flow.getFlowDirection(u, destinationId);
+          if ( direction == WalkPosition(0, 0) )
+            break;
+          u += direction;
+        }
+        arrived += u == destination ? 1 : 0;
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+
+      Assert::AreEqual(pathsFound, arrived);
+      flow.clear();
+
+      std::ostringstream ss;
+      ss << "FlowFields: " << unitCount << " units on a 256x256 walk tile map take "
+         << std::chrono::duration<double, std::milli>(middle - begin).count() << " ms with one path query each, "
+         << std::chrono::duration<double, std::milli>(computed - middle).count() << " ms to compute one field and "
+         << std::chrono::duration<double, std::milli>(end - computed).count() << " ms to follow it to the destination\n";
+      Logger::WriteMessage(ss.str().c_str());
+    }
+  };
+}
@@ -0,0 +1,266 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include "fakeUnit.h"
+#include <BWAPI.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  namespace
+  {
+    struct TestSource
+    {
+      Position position;
+      int radius[InfluenceMap::LayerCount];
+      int value[InfluenceMap::LayerCount];
+    };
+
+    // Recomputes a layer from scratch by testing every cell around every source
+    std::vector<int> referenceLayer(const std::vector<TestSource> &sources, InfluenceMap::Layer layer, int width, int height, int resolution)
+    {
+      std::vector<int> result(width * height, 0);
+      for ( auto &s : sources )
+      {
+        int cx = s.position.x / resolution, cy = s.position.y / resolution;
+        int cells = s.radius[layer] / resolution;
+        for ( int y = std::max(cy - cells, 0); y <= std::min(cy + cells, height - 1); ++y )
+        {
+          for ( int x = std::max(cx - cells, 0); x <= std::min(cx + cells, width - 1); ++x )
+          {
+            int dx = (x - cx) * resolution, dy = (y - cy) * resolution;
+            if ( dx * dx + dy * dy <= s.radius[layer] * s.radius[layer] )
+              result[y * width + x] += s.value[layer];
+          }
+        }
+      }
+      return result;
+    }
+
+    TestSource randomSource(int mapWidth, int mapHeight)
+    {
+      TestSource s;
+      s.position = Position(std::rand() % (mapWidth * 32), std::rand() % (mapHeight * 32));
+      s.radius[InfluenceMap::Ground] = 32 + std::rand() % 256;
+      s.value[InfluenceMap::Ground] = 1 + std::rand() % 500;
+      s.radius[InfluenceMap::Air] = std::rand() % 2 ? 0 : 32 + std::rand() % 256;
+      s.value[InfluenceMap::Air] = s.radius[InfluenceMap::Air] ? 1 + std::rand() % 500 : 0;
+      return s;
+    }
+
+    // Moves a source by up to 8 pixels in each direction, as a unit does in one frame
+    void moveSource(TestSource &s, int mapWidth, int mapHeight)
+    {
+      s.position.x = std::min(std::max(s.position.x + std::rand() % 17 - 8, 0), mapWidth * 32 - 1);
+      s.position.y = std::min(std::max(s.position.y + std::rand() % 17 - 8, 0), mapHeight * 32 - 1);
+    }
+
+    // The value of a weapon for a unit without a player
+    int weaponValue(WeaponType weapon, int cooldown = 0)
+    {
+      return weapon.damageAmount() * weapon.damageFactor() * 256 / (cooldown ? cooldown : weapon.damageCooldown());
+    }
+
+    void setSource(InfluenceMap &map, int id, const TestSource &s)
+    {
+      map.setSource(id, s.position, s.radius[InfluenceMap::Ground], s.value[InfluenceMap::Ground],
+                    s.radius[InfluenceMap::Air], s.value[InfluenceMap::Air]);
+    }
+  }
+
+  TEST_CLASS(influenceMapTest)
+  {
+  public:
+    TEST_METHOD(InfluenceMapSingleSource)
+    {
+      InfluenceMap map;
+      map.reset(64, 64, InfluenceMap::TileResolution);
+      Assert::AreEqual(64, map.getWidth());
+
+      // A range of 2 tiles covers 13 tiles, the corners of the 5x5 square are too far
+      map.setSource(3, Position(10 * 32 + 5, 10 * 32 + 30), 64, 7, 0, 0);
+      Assert::AreEqual(1, map.getSourceCount());
+      Assert::AreEqual(7, map.getValue(InfluenceMap::Ground, 10, 10));
+      Assert::AreEqual(7, map.getValue(InfluenceMap::Ground, 12, 10));
+      Assert::AreEqual(7, map.getValue(InfluenceMap::Ground, 11, 11));
+      Assert::AreEqual(0, map.getValue(InfluenceMap::Ground, 12, 12));
+      Assert::AreEqual(0, map.getValue(InfluenceMap::Ground, 13, 10));
+      Assert::AreEqual(0, map.getValue(InfluenceMap::Air, 10, 10));
+      Assert::AreEqual(7, map.getValue(InfluenceMap::Ground, Position(9 * 32, 10 * 32)));
+
+      int total = 0;
+      for ( int v : map.getLayer(InfluenceMap::Ground) )
+        total += v;
+      Assert::AreEqual(13 * 7, total);
+
+      // Moving within the cell changes nothing, moving to another cell moves the disc
+      map.setSource(3, Position(10 * 32 + 20, 10 * 32), 64, 7, 0, 0);
+      Assert::AreEqual(0, map.getValue(InfluenceMap::Ground, 12, 12));
+      map.setSource(3, Position(11 * 32, 11 * 32), 64, 7, 0, 0);
+      Assert::AreEqual(7, map.getValue(InfluenceMap::Ground, 12, 12));
+      Assert::AreEqual(0, map.getValue(InfluenceMap::Ground, 8, 10));
+
+      Assert::IsTrue(map.removeSource(3));
+      Assert::IsFalse(map.removeSource(3));
+      for ( int v : map.getLayer(InfluenceMap::Ground) )
+        Assert::AreEqual(0, v);
+    }
+    TEST_METHOD(InfluenceMapSpecialUnits)
+    {
+      InfluenceMap map;
+      map.reset(64, 64, InfluenceMap::TileResolution);
+      FakeUnit unit(1, Position(20 * 32 + 16, 20 * 32 + 16), 100);
+      unit.alive = true;
+
+      // A reaver has no weapon of its own, it reaches 7 tiles with its scarabs, which it fires
+      // every 60 frames
+      unit.type = UnitTypes::Protoss_Reaver;
+      map.updateUnit(&unit);
+      int scarab = weaponValue(WeaponTypes::Scarab, 60);
+      Assert::AreEqual(1, map.getSourceCount());
+      Assert::AreEqual(scarab, map.getValue(InfluenceMap::Ground, 27, 20));
+      Assert::AreEqual(0, map.getValue(InfluenceMap::Air, 20, 20));
+
+      // A carrier has the weapons of 4 interceptors until their number is known. Each of them
+      // attacks every 37 frames.
+      int pulse = weaponValue(WeaponTypes::Pulse_Cannon, 37);
+      unit.type = UnitTypes::Protoss_Carrier;
+      map.updateUnit(&unit);
+      Assert::AreEqual(4 * pulse, map.getValue(InfluenceMap::Air, 27, 20));
+      Assert::AreEqual(4 * pulse, map.getValue(InfluenceMap::Ground, 27, 20));
+      unit.interceptorCount = 8;
+      map.updateUnit(&unit);
+      Assert::AreEqual(8 * pulse, map.getValue(InfluenceMap::Air, 27, 20));
+
+      // A bunker has the weapons of 4 marines until its loaded units are known, with one more
+      // tile of range than a marine
+      int marine = weaponValue(WeaponTypes::Gauss_Rifle);
+      unit.type = UnitTypes::Terran_Bunker;
+      map.updateUnit(&unit);
+      Assert::AreEqual(4 * marine, map.getValue(InfluenceMap::Ground, 25, 20));
+      Assert::AreEqual(4 * marine, map.getValue(InfluenceMap::Air, 25, 20));
+
+      FakeUnit firebat(2, unit.position, 50);
+      firebat.type = UnitTypes::Terran_Firebat;
+      unit.loadedUnits.insert(&firebat);
+      map.updateUnit(&unit);
+      Assert::AreEqual(weaponValue(WeaponTypes::Flame_Thrower), map.getValue(InfluenceMap::Ground, 21, 20));
+      Assert::AreEqual(0, map.getValue(InfluenceMap::Ground, 25, 20));
+      Assert::AreEqual(0, map.getValue(InfluenceMap::Air, 20, 20));
+
+      unit.alive = false;
+      map.updateUnit(&unit);
+      Assert::AreEqual(0, map.getSourceCount());
+    }
+    TEST_METHOD(InfluenceMapMatchesRecompute)
+    {
+      const int mapWidth = 96, mapHeight = 64;
+      for ( int resolution : { InfluenceMap::WalkResolution, InfluenceMap::TileResolution } )
+      {
+        std::srand(38);
+        std::vector<TestSource> sources;
+        InfluenceMap map;
+        map.reset(mapWidth, mapHeight, resolution);
+        for ( int i = 0; i < 50; ++i )
+        {
+          sources.push_back(randomSource(mapWidth, mapHeight));
+          setSource(map, i, sources.back());
+        }
+
+        for ( int frame = 0; frame < 20; ++frame )
+        {
+          for ( size_t i = 0; i < sources.size(); ++i )
+          {
+            moveSource(sources[i], mapWidth, mapHeight);
+            if ( frame % 5 == 0 && i % 7 == 0 )
+              sources[i].value[InfluenceMap::Ground] += 10;
+            setSource(map, static_cast<int>(i), sources[i]);
+          }
+        }
+
+        // Remove some sources from the middle
+        for ( int i = 10; i < 20; ++i )
+          Assert::IsTrue(map.removeSource(i));
+        sources.erase(sources.begin() + 10, sources.begin() + 20);
+
+        for ( int layer = 0; layer < InfluenceMap::LayerCount; ++layer )
+        {
+          std::vector<int> expected = referenceLayer(sources, static_cast<InfluenceMap::Layer>(layer), map.getWidth(), map.getHeight(), resolution);
+          auto &actual = map.getLayer(static_cast<InfluenceMap::Layer>(layer));
+          for ( size_t i = 0; i < expected.size(); ++i )
+            Assert::AreEqual(expected[i], actual[i]);
+        }
+      }
+    }
+    BEGIN_TEST_METHOD_ATTRIBUTE(InfluenceMapBenchmark)
+      TEST_IGNORE()
+    END_TEST_METHOD_ATTRIBUTE()
+    TEST_METHOD(InfluenceMapBenchmark)
+    {
+      // 400 enemy units moving every frame on a 128x128 map
+      const int mapWidth = 128, mapHeight = 128, unitCount = 400, frames = 100;
+      for ( int resolution : { InfluenceMap::TileResolution, InfluenceMap::WalkResolution } )
+      {
+        std::srand(400);
+        std::vector<TestSource> sources;
+        for ( int i = 0; i < unitCount; ++i )
+          sources.push_back(randomSource(mapWidth, mapHeight));
+        std::vector<TestSource> initial = sources;
+
+        // Recomputed from scratch every frame
+        std::vector<int> recomputed, recomputedAir;
+        auto begin = std::chrono::high_resolution_clock::now();
+        for ( int frame = 0; frame < frames; ++frame )
+        {
+          for ( auto &s : sources )
+            moveSource(s, mapWidth, mapHeight);
+          recomputed = referenceLayer(sources, InfluenceMap::Ground, mapWidth * 32 / resolution, mapHeight * 32 / resolution, resolution);
+          recomputedAir = referenceLayer(sources, InfluenceMap::Air, mapWidth * 32 / resolution, mapHeight * 32 / resolution, resolution);
+        }
+        auto middle = std::chrono::high_resolution_clock::now();
+
+        // Updated incrementally, with the same movements
+        std::srand(400);
+        for ( int i = 0; i < unitCount; ++i )
+          randomSource(mapWidth, mapHeight);
+        sources = initial;
+        InfluenceMap map;
+        map.reset(mapWidth, mapHeight, resolution);
+        for ( int i = 0; i < unitCount; ++i )
+          setSource(map, i, sources[i]);
+        auto incrementalBegin = std::chrono::high_resolution_clock::now();
+        for ( int frame = 0; frame < frames; ++frame )
+        {
+          for ( int i = 0; i < unitCount; ++i )
+          {
+            moveSource(sources[i], mapWidth, mapHeight);
+            setSource(map, i, sources[i]);
+          }
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+
+        auto &actual = map.getLayer(InfluenceMap::Ground);
+        auto &actualAir = map.getLayer(InfluenceMap::Air);
+        for ( size_t i = 0; i < recomputed.size(); ++i )
+        {
+          Assert::AreEqual(recomputed[i], actual[i]);
+          Assert::AreEqual(recomputedAir[i], actualAir[i]);
+        }
+
+        std::ostringstream ss;
+        ss << "InfluenceMap (" << InfluenceMap::getInstructionSet() << "): " << unitCount << " moving units at "
+           << resolution << " pixels per cell take "
+           << std::chrono::duration<double, std::micro>(middle - begin).count() / frames << " us per frame recomputed, "
+           << std::chrono::duration<double, std::micro>(end - incrementalBegin).count() / frames << " us per frame incrementally\n";
+        Logger::WriteMessage(ss.str().c_str());
+      }
+    }
+  };
+}
@@ -0,0 +1,281 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include <BWAPI.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  namespace
+  {
+    // A walk tile map with random rectangular obstacles and square regions
+    struct TestGrid
+    {
+      int width, height, regionSize;
+      std::vector<bool> walkable;
+      std::vector<int> regionIds;
+      std::vector< std::vector<int> > neighbors;
+
+      TestGrid(int width, int height, int obstacles, int regionSize, unsigned int seed)
+        : width(width), height(height), regionSize(regionSize)
+        , walkable(width * height, true)
+      {
+        std::srand(seed);
+        for ( int i = 0; i < obstacles; ++i )
+        {
+          int x = std::rand() % width, y = std::rand() % height;
+          int w = 2 + std::rand() % 24, h = 2 + std::rand() % 24;
+          for ( int ty = y; ty < std::min(height, y + h); ++ty )
+            for ( int tx = x; tx < std::min(width, x + w); ++tx )
+              walkable[ty * width + tx] = false;
+        }
+
+        int columns = width / regionSize, rows = height / regionSize;
+        for ( int y = 0; y < height; ++y )
+          for ( int x = 0; x < width; ++x )
+            regionIds.push_back((y / regionSize) * columns + x / regionSize);
+        neighbors.resize(columns * rows);
+        for ( int ry = 0; ry < rows; ++ry )
+          for ( int rx = 0; rx < columns; ++rx )
+            for ( int oy = -1; oy <= 1; ++oy )
+              for ( int ox = -1; ox <= 1; ++ox )
+                if ( (ox != 0 || oy != 0) && rx + ox >= 0 && ry + oy >= 0 && rx + ox < columns && ry + oy < rows )
+                  neighbors[ry * columns + rx].push_back((ry + oy) * columns + rx + ox);
+      }
+
+      bool fits(int x, int y, int size) const
+      {
+        if ( x < 0 || y < 0 || x + size > width || y + size > height )
+          return false;
+        for ( int ty = y; ty < y + size; ++ty )
+          for ( int tx = x; tx < x + size; ++tx )
+            if ( !walkable[ty * width + tx] )
+              return false;
+        return true;
+      }
+
+      // Plain A* with the same move rules, anchored at the top left tile of the unit
+      int aStar(WalkPosition source, WalkPosition destination, int size) const
+      {
+        int offset = (size - 1) / 2;
+        int sx = source.x - offset, sy = source.y - offset;
+        int dx = destination.x - offset, dy = destination.y - offset;
+        if ( !fits(sx, sy, size) || !fits(dx, dy, size) )
+          return -2;
+
+        std::vector<int> cost(width * height, -1);
+        typedef std::pair<int,int> Entry;
+        std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > open;
+        cost[sy * width + sx] = 0;
+        open.emplace(0, sy * width + sx);
+        while ( !open.empty() )
+        {
+          int current = open.top().second;
+          open.pop();
+          int x = current % width, y = current / width;
+          if ( x == dx && y == dy )
+            return (cost[current] * 8 + 500) / 1000;
+          for ( int oy = -1; oy <= 1; ++oy )
+          {
+            for ( int ox = -1; ox <= 1; ++ox )
+            {
+              if ( (ox == 0 && oy == 0) || !fits(x + ox, y + oy, size) )
+                continue;
+              if ( ox != 0 && oy != 0 && (!fits(x + ox, y, size) || !fits(x, y + oy, size)) )
+                continue;
+              int next = (y + oy) * width + x + ox;
+              int c = cost[current] + ((ox != 0 && oy != 0) ? 1414 : 1000);
+              if ( cost[next] == -1 || c < cost[next] )
+              {
+                cost[next] = c;
+                int hx = std::abs(x + ox - dx), hy = std::abs(y + oy - dy);
+                open.emplace(c + 1000 * std::max(hx, hy) + 414 * std::min(hx, hy), next);
+              }
+            }
+          }
+        }
+        return -1;
+      }
+
+      WalkPosition randomOpenTile(int size) const
+      {
+        int offset = (size - 1) / 2;
+        for ( ;; )
+        {
+          WalkPosition p(std::rand() % width, std::rand() % height);
+          if ( fits(p.x - offset, p.y - offset, size) )
+            return p;
+        }
+      }
+    };
+  }
+
+  TEST_CLASS(pathfinderTest)
+  {
+  public:
+    TEST_METHOD(PathfinderClearance)
+    {
+      // 4x3 map with a single blocked tile at (3,0)
+      std::vector<bool> walkable(12, true);
+      walkable[3] = false;
+      Pathfinder pathfinder;
+      Assert::IsFalse(pathfinder.isBuilt());
+      pathfinder.build(4, 3, walkable);
+      Assert::IsTrue(pathfinder.isBuilt());
+
+      Assert::AreEqual(3, pathfinder.getClearance(WalkPosition(0, 0)));
+      Assert::AreEqual(2, pathfinder.getClearance(WalkPosition(1, 0)));
+      Assert::AreEqual(1, pathfinder.getClearance(WalkPosition(2, 0)));
+      Assert::AreEqual(0, pathfinder.getClearance(WalkPosition(3, 0)));
+      Assert::AreEqual(2, pathfinder.getClearance(WalkPosition(2, 1)));
+      Assert::AreEqual(0, pathfinder.getClearance(WalkPosition(4, 0)));
+
+      Assert::AreEqual(1, Pathfinder::getUnitSize(UnitTypes::Protoss_Scarab));
+      Assert::AreEqual(3, Pathfinder::getUnitSize(UnitTypes::Terran_Marine));
+      Assert::AreEqual(4, Pathfinder::getUnitSize(UnitTypes::Protoss_Dragoon));
+    }
+    TEST_METHOD(PathfinderStraightLine)
+    {
+      std::vector<bool> walkable(32 * 32, true);
+      Pathfinder pathfinder;
+      pathfinder.build(32, 32, walkable);
+
+      std::vector<WalkPosition> path;
+      Assert::AreEqual(80, pathfinder.findPath(WalkPosition(2, 5), WalkPosition(12, 5), 1, path));
+      Assert::AreEqual(2u, path.size());
+      Assert::AreEqual(WalkPosition(2, 5), path.front());
+      Assert::AreEqual(WalkPosition(12, 5), path.back());
+
+      Assert::AreEqual(0, pathfinder.findPath(WalkPosition(3, 3), WalkPosition(3, 3), 1, path));
+      Assert::AreEqual(-1, pathfinder.findPath(WalkPosition(-1, 3), WalkPosition(3, 3), 1, path));
+      Assert::IsTrue(path.empty());
+    }
+    TEST_METHOD(PathfinderMatchesAStar)
+    {
+      TestGrid grid(128, 128, 40, 16, 32);
+      Pathfinder pathfinder;
+      pathfinder.build(grid.width, grid.height, grid.walkable);
+
+      std::vector<WalkPosition> path;
+      for ( int size = 1; size <= 3; ++size )
+      {
+        for ( int i = 0; i < 40; ++i )
+        {
+          WalkPosition a = grid.randomOpenTile(size), b = grid.randomOpenTile(size);
+          int expected = grid.aStar(a, b, size);
+          int actual = pathfinder.findPath(a, b, size, path);
+          Assert::AreEqual(expected, actual);
+          if ( actual >= 0 )
+          {
+            Assert::AreEqual(a, path.front());
+            Assert::AreEqual(b, path.back());
+          }
+        }
+      }
+    }
+    TEST_METHOD(PathfinderRegionsAndCache)
+    {
+      TestGrid grid(128, 128, 40, 16, 33);
+      Pathfinder pathfinder;
+      pathfinder.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+
+      std::vector<WalkPosition> path, again;
+      WalkPosition a = grid.randomOpenTile(2), b = grid.randomOpenTile(2);
+      int length = pathfinder.findPath(a, b, 2, path);
+      Assert::AreEqual(0u, pathfinder.getCacheHits());
+      Assert::AreEqual(1u, pathfinder.getCacheMisses());
+
+      // The corridor can only make the path longer than the optimal one
+      Assert::IsTrue(length >= grid.aStar(a, b, 2));
+
+      Assert::AreEqual(length, pathfinder.findPath(a, b, 2, again));
+      Assert::AreEqual(1u, pathfinder.getCacheHits());
+      Assert::IsTrue(path == again);
+
+      // Different unit sizes are separate entries
+      pathfinder.findPath(a, b, 1, again);
+      Assert::AreEqual(2u, pathfinder.getCacheMisses());
+
+      pathfinder.setCacheSize(1);
+      pathfinder.findPath(a, b, 2, again);
+      Assert::AreEqual(3u, pathfinder.getCacheMisses());
+
+      // Disconnected regions fail in the region pass
+      std::vector< std::vector<int> > isolated = grid.neighbors;
+      for ( auto &n : isolated )
+        n.erase(std::remove(n.begin(), n.end(), 0), n.end());
+      isolated[0].clear();
+      pathfinder.build(grid.width, grid.height, grid.walkable, grid.regionIds, isolated);
+      Assert::AreEqual(-1, pathfinder.findPath(WalkPosition(1, 1), WalkPosition(100, 100), 1, path));
+    }
+    TEST_METHOD(PathfinderCorridorReuse)
+    {
+      // Each corridor search must only see its own regions, whatever the previous queries were
+      TestGrid grid(128, 128, 40, 16, 35);
+      Pathfinder shared;
+      shared.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+      shared.setCacheSize(0);
+
+      std::vector<WalkPosition> path, freshPath;
+      for ( int i = 0; i < 30; ++i )
+      {
+        int size = 1 + i % 3;
+        WalkPosition a = grid.randomOpenTile(size), b = grid.randomOpenTile(size);
+        Pathfinder fresh;
+        fresh.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+        Assert::AreEqual(fresh.findPath(a, b, size, freshPath), shared.findPath(a, b, size, path));
+        Assert::IsTrue(path == freshPath);
+      }
+    }
+    BEGIN_TEST_METHOD_ATTRIBUTE(PathfinderBenchmark)
+      TEST_IGNORE()
+    END_TEST_METHOD_ATTRIBUTE()
+    TEST_METHOD(PathfinderBenchmark)
+    {
+      // A 512x512 walk tile map, the size of a 128x128 tile map
+      TestGrid grid(512, 512, 600, 32, 34);
+      Pathfinder pathfinder;
+      pathfinder.build(grid.width, grid.height, grid.walkable, grid.regionIds, grid.neighbors);
+
+      std::vector< std::pair<WalkPosition,WalkPosition> > queries;
+      for ( int i = 0; i < 200; ++i )
+        queries.emplace_back(grid.randomOpenTile(2), grid.randomOpenTile(2));
+
+      // Connected areas are computed on the first query of each unit size
+      std::vector<WalkPosition> path;
+      pathfinder.findPath(queries[0].first, queries[0].first, 2, path);
+      auto start = std::chrono::high_resolution_clock::now();
+      for ( auto &q : queries )
+        pathfinder.findPath(q.first, q.second, 2, path);
+      auto cold = std::chrono::high_resolution_clock::now();
+      for ( auto &q : queries )
+        pathfinder.findPath(q.first, q.second, 2, path);
+      auto warm = std::chrono::high_resolution_clock::now();
+
+      Pathfinder flat;
+      flat.build(grid.width, grid.height, grid.walkable);
+      flat.findPath(queries[0].first, queries[0].first, 2, path);
+      auto flatStart = std::chrono::high_resolution_clock::now();
+      for ( auto &q : queries )
+        flat.findPath(q.first, q.second, 2, path);
+      auto unrestricted = std::chrono::high_resolution_clock::now();
+
+      std::ostringstream ss;
+      ss << "Pathfinder: " << queries.size() << " queries on 512x512, average "
+         << std::chrono::duration<double, std::micro>(cold - start).count() / queries.size() << " us with regions, "
+         << std::chrono::duration<double, std::micro>(warm - cold).count() / queries.size() << " us cached, "
+         << std::chrono::duration<double, std::micro>(unrestricted - flatStart).count() / queries.size() << " us without regions\n";
+      Logger::WriteMessage(ss.str().c_str());
+    }
+  };
+}
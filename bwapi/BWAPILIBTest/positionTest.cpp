@@ -2,6 +2,9 @@
 #include "CppUnitTest.h"
 #include "specializations.h"
 #include <sstream>
+#include <vector>
+#include <random>
+#include <chrono>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 using namespace BWAPI;
@@ -308,6 +311,58 @@ namespace BWAPILIBTest
       ss >> p1;
       Assert::AreEqual(Position(2, -3), p1);
     }
+    TEST_METHOD(PositionCachedBounds)
+    {
+      MapBounds::set(128, 96);
+      Assert::IsTrue(TilePosition(127, 95).isValid());
+      Assert::IsFalse(TilePosition(128, 0).isValid());
+      Assert::IsFalse(TilePosition(0, 96).isValid());
+      Assert::AreEqual(WalkPosition(511, 383), WalkPosition(600, 600).makeValid());
+      Assert::AreEqual(Position(128 * 32 - 1, 0), Position(5000, -5).makeValid());
+
+      MapBounds::reset();
+      Assert::IsTrue(TilePosition(255, 255).isValid());
+    }
+    BEGIN_TEST_METHOD_ATTRIBUTE(PositionValidityBenchmark)
+      TEST_IGNORE()
+    END_TEST_METHOD_ATTRIBUTE()
+    TEST_METHOD(PositionValidityBenchmark)
+    {
+      const int count = 1000000;
+      std::vector<Position> positions;
+      positions.reserve(count);
+
+      std::mt19937 rng(42);
+      std::uniform_int_distribution<int> coord(-512, 128 * 32 + 512);
+      for ( int i = 0; i < count; ++i )
+        positions.emplace_back(coord(rng), coord(rng));
+
+      MapBounds::set(128, 128);
+
+      auto start = std::chrono::high_resolution_clock::now();
+      int valid = 0;
+      for ( const Position &p : positions )
+      {
+        if ( p.isValid() )
+          ++valid;
+      }
+      auto mid = std::chrono::high_resolution_clock::now();
+      for ( Position &p : positions )
+        p.makeValid();
+      auto end = std::chrono::high_resolution_clock::now();
+
+      MapBounds::reset();
+
+      Assert::IsTrue(valid > 0 && valid < count);
+      for ( const Position &p : positions )
+        Assert::IsTrue(p.x >= 0 && p.y >= 0 && p.x < 128 * 32 && p.y < 128 * 32);
+
+      std::stringstream ss;
+      ss << "isValid: " << std::chrono::duration_cast<std::chrono::microseconds>(mid - start).count() << "us, "
+         << "makeValid: " << std::chrono::duration_cast<std::chrono::microseconds>(end - mid).count() << "us "
+         << "for " << count << " positions (" << valid << " valid)" << std::endl;
+      Logger::WriteMessage(ss.str().c_str());
+    }
 
 	};
 }
\ No newline at end of file
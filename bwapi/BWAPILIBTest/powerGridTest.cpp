@@ -0,0 +1,228 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include "fakeUnit.h"
+#include "fakeGame.h"
+#include <BWAPI.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  namespace
+  {
+    // The loop over every pylon that the grid replaces
+    bool hasPowerReference(int x, int y, const std::vector<Position> &pylons)
+    {
+      static const bool bPsiFieldMask[10][16] = {
+        { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 },
+        { 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
+        { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
+        { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+        { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+        { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+        { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
+        { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
+        { 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
+        { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 }
+      };
+      for ( auto &p : pylons )
+      {
+        if ( std::abs(p.x - x) >= 256 || std::abs(p.y - y) >= 160 )
+          continue;
+        if ( bPsiFieldMask[(y - p.y + 160) / 32][(x - p.x + 256) / 32] )
+          return true;
+      }
+      return false;
+    }
+
+    // Pylons are 2x2 tiles, so their centers are on tile corners
+    std::vector<Position> randomPylons(int count, int mapWidth, int mapHeight, unsigned int seed)
+    {
+      std::srand(seed);
+      std::vector<Position> pylons;
+      for ( int i = 0; i < count; ++i )
+        pylons.emplace_back(Position(TilePosition(1 + std::rand() % (mapWidth - 2), 1 + std::rand() % (mapHeight - 2))));
+      return pylons;
+    }
+
+    // A FakeGame whose canBuildHere also checks psi power as BWAPI does, either with the grid or
+    // with the loop over every pylon that the grid replaces. Like the tile flags of BWAPI, the
+    // tiles under the pylons are looked up instead of testing every unit.
+    class PoweredGame : public FakeGame
+    {
+    public:
+      std::vector<Position> pylons;
+      std::vector<bool> occupied;
+      bool usePylonLoop = false;
+
+      PoweredGame(int width, int height)
+        : FakeGame(width, height)
+        , occupied(static_cast<size_t>(width) * height, false)
+      {};
+
+      void addPylon(int id, Position position)
+      {
+        pylons.push_back(position);
+        powerGrid.addPylon(id, position);
+        TilePosition topLeft = TilePosition(position) - TilePosition(1, 1);
+        for ( int y = topLeft.y; y < topLeft.y + 2; ++y )
+          for ( int x = topLeft.x; x < topLeft.x + 2; ++x )
+            occupied[y * width + x] = true;
+      }
+
+      virtual bool isBuildable(int tileX, int tileY, bool includeBuildings) const override
+      {
+        return this->isInMap(tileX, tileY) && buildable[tileY * width + tileX] && (!includeBuildings || !occupied[tileY * width + tileX]);
+      }
+
+      virtual bool hasPowerPrecise(int x, int y, UnitType unitType) const override
+      {
+        if ( unitType >= 0 && unitType < UnitTypes::None && (!unitType.requiresPsi() || !unitType.isBuilding()) )
+          return true;
+        return usePylonLoop ? hasPowerReference(x, y, pylons) : powerGrid.hasPower(x, y);
+      }
+      virtual bool canBuildHere(TilePosition position, UnitType type, Unit builder, bool checkExplored) override
+      {
+        return FakeGame::canBuildHere(position, type, builder, checkExplored) &&
+               (!type.requiresPsi() || this->hasPower(position, type));
+      }
+    };
+  }
+
+  TEST_CLASS(powerGridTest)
+  {
+  public:
+    TEST_METHOD(PowerGridSinglePylon)
+    {
+      PowerGrid grid;
+      grid.reset(64, 64);
+      Assert::IsTrue(grid.addPylon(7, Position(TilePosition(20, 20))));
+      Assert::IsFalse(grid.addPylon(7, Position(TilePosition(20, 20))));
+      Assert::AreEqual(1, grid.getPylonCount());
+
+      // The mask is 256 pixels wide on each side and 160 pixels high, exclusive
+      Assert::IsTrue(grid.hasPower(640, 640));
+      Assert::IsTrue(grid.hasPower(640 - 255, 640));
+      Assert::IsFalse(grid.hasPower(640 - 256, 640));
+      Assert::IsTrue(grid.hasPower(640 + 255, 640));
+      Assert::IsFalse(grid.hasPower(640 + 256, 640));
+      Assert::IsTrue(grid.hasPower(640, 640 - 159));
+      Assert::IsFalse(grid.hasPower(640, 640 - 160));
+      Assert::IsFalse(grid.hasPower(-1, 640));
+
+      Assert::AreEqual(1, grid.getCount(TilePosition(20, 20)));
+      Assert::AreEqual(0, grid.getCount(TilePosition(12, 15)));
+      Assert::AreEqual(0, grid.getCount(TilePosition(-1, 0)));
+
+      // 6 + 12 + 14 + 16 * 4 + 14 + 12 + 6 tiles
+      Assert::AreEqual(128, grid.countPoweredTiles(TilePosition(0, 0), 64, 64));
+      Assert::AreEqual(16, grid.countPoweredTiles(TilePosition(18, 18), 4, 4));
+
+      Assert::IsTrue(grid.removePylon(7));
+      Assert::IsFalse(grid.removePylon(7));
+      Assert::IsFalse(grid.hasPower(640, 640));
+      Assert::AreEqual(0, grid.countPoweredTiles(TilePosition(0, 0), 64, 64));
+    }
+    TEST_METHOD(PowerGridMatchesPylonLoop)
+    {
+      const int width = 96, height = 64;
+      std::vector<Position> pylons = randomPylons(40, width, height, 35);
+
+      PowerGrid grid;
+      grid.reset(width, height);
+      for ( size_t i = 0; i < pylons.size(); ++i )
+        grid.addPylon(static_cast<int>(i), pylons[i]);
+
+      // Every pixel on the tile edges and one inside each tile
+      for ( int round = 0; round < 2; ++round )
+      {
+        for ( int ty = 0; ty < height; ++ty )
+        {
+          for ( int tx = 0; tx < width; ++tx )
+          {
+            for ( int offset : { 0, 1, 17, 31 } )
+            {
+              int x = tx * 32 + offset, y = ty * 32 + (offset * 7) % 32;
+              Assert::AreEqual(hasPowerReference(x, y, pylons), grid.hasPower(x, y));
+              Assert::AreEqual(hasPowerReference(tx * 32, y, pylons), grid.hasPower(tx * 32, y));
+              Assert::AreEqual(hasPowerReference(x, ty * 32, pylons), grid.hasPower(x, ty * 32));
+            }
+          }
+        }
+
+        if ( round == 1 )
+          break;
+
+        // Destroy every other pylon and check again
+        std::vector<Position> remaining;
+        for ( size_t i = 0; i < pylons.size(); ++i )
+        {
+          if ( i % 2 == 0 )
+            Assert::IsTrue(grid.removePylon(static_cast<int>(i)));
+          else
+            remaining.push_back(pylons[i]);
+        }
+        pylons = remaining;
+      }
+    }
+    BEGIN_TEST_METHOD_ATTRIBUTE(PowerGridBenchmark)
+      TEST_IGNORE()
+    END_TEST_METHOD_ATTRIBUTE()
+    TEST_METHOD(PowerGridBenchmark)
+    {
+      // getBuildLocation for Protoss Gateways among 30 completed pylons, with power checked by
+      // looping over the pylons as before the grid, and then with the grid
+      const int width = 128, height = 128;
+      PoweredGame game(width, height);
+      game.powerGrid.reset(width, height);
+      std::vector<Position> pylons = randomPylons(30, width, height, 36);
+      std::vector< std::unique_ptr<FakeUnit> > units;
+      for ( size_t i = 0; i < pylons.size(); ++i )
+      {
+        game.addPylon(static_cast<int>(i), pylons[i]);
+        units.emplace_back(new FakeUnit(static_cast<int>(i), pylons[i], UnitTypes::Protoss_Pylon.maxHitPoints()));
+        units.back()->type = UnitTypes::Protoss_Pylon;
+        units.back()->alive = true;
+        game.player.units.insert(units.back().get());
+      }
+      MapBounds::set(width, height);
+      BroodwarPtr = &game;
+
+      const TilePosition desired[] = { TilePosition(64, 64), TilePosition(30, 40), TilePosition(100, 90), TilePosition(20, 110) };
+      const int repeats = 10;
+      std::vector<TilePosition> reference, locations;
+      game.usePylonLoop = true;
+      auto begin = std::chrono::high_resolution_clock::now();
+      for ( int r = 0; r < repeats; ++r )
+        for ( auto &p : desired )
+          reference.push_back(game.getBuildLocation(UnitTypes::Protoss_Gateway, p));
+      auto middle = std::chrono::high_resolution_clock::now();
+      game.usePylonLoop = false;
+      for ( int r = 0; r < repeats; ++r )
+        for ( auto &p : desired )
+          locations.push_back(game.getBuildLocation(UnitTypes::Protoss_Gateway, p));
+      auto end = std::chrono::high_resolution_clock::now();
+
+      Assert::IsTrue(reference == locations);
+      Assert::IsTrue(locations.front().isValid());
+      game.player.units.clear();
+      BroodwarPtr = nullptr;
+      MapBounds::reset();
+
+      const int calls = repeats * static_cast<int>(sizeof(desired) / sizeof(desired[0]));
+      std::ostringstream ss;
+      ss << "PowerGrid: getBuildLocation for a Gateway with 30 pylons takes "
+         << std::chrono::duration<double, std::micro>(middle - begin).count() / calls << " us looping over pylons, "
+         << std::chrono::duration<double, std::micro>(end - middle).count() / calls << " us with the grid\n";
+      Logger::WriteMessage(ss.str().c_str());
+    }
+  };
+}
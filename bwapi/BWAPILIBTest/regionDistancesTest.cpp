@@ -0,0 +1,249 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include <BWAPI.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <sstream>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  namespace
+  {
+    // A synthetic map made of square regions on a walk tile grid
+    struct TestMap
+    {
+      static const int blockSize = 16;  // walk tiles per region side
+      static const int blocks = 16;     // regions per map side
+      static const int size = blockSize * blocks;
+
+      std::vector<bool> walkable;
+      std::vector<RegionDistances::Node> nodes;
+
+      TestMap()
+        : walkable(size * size, true)
+        , nodes(blocks * blocks)
+      {
+        // A wall of regions down the middle with a single gap near the bottom
+        for ( int by = 0; by < blocks; ++by )
+        {
+          if ( by != 12 )
+            block(8, by);
+        }
+        // An isolated region in the corner
+        block(1, 0);
+        block(0, 1);
+        block(1, 1);
+
+        for ( int by = 0; by < blocks; ++by )
+        {
+          for ( int bx = 0; bx < blocks; ++bx )
+          {
+            RegionDistances::Node &node = nodes[by * blocks + bx];
+            node.center = Position(bx * blockSize * 8 + blockSize * 4, by * blockSize * 8 + blockSize * 4);
+            node.accessible = walkable[by * blockSize * size + bx * blockSize];
+            for ( int oy = -1; oy <= 1; ++oy )
+            {
+              for ( int ox = -1; ox <= 1; ++ox )
+              {
+                int nx = bx + ox, ny = by + oy;
+                if ( (ox != 0 || oy != 0) && nx >= 0 && ny >= 0 && nx < blocks && ny < blocks )
+                  node.neighbors.push_back(ny * blocks + nx);
+              }
+            }
+          }
+        }
+      }
+      void block(int bx, int by)
+      {
+        for ( int y = by * blockSize; y < (by + 1) * blockSize; ++y )
+          std::fill_n(walkable.begin() + y * size + bx * blockSize, blockSize, false);
+      }
+      int regionAt(Position p) const
+      {
+        return (p.y / 8 / blockSize) * blocks + p.x / 8 / blockSize;
+      }
+
+      // Walk tile A* with octile moves, returning pixels
+      int aStar(Position source, Position destination) const
+      {
+        int sx = source.x / 8, sy = source.y / 8;
+        int dx = destination.x / 8, dy = destination.y / 8;
+        auto heuristic = [&](int x, int y)
+        {
+          int ax = std::abs(x - dx), ay = std::abs(y - dy);
+          return 80 * std::max(ax, ay) + 33 * std::min(ax, ay);
+        };
+
+        std::vector<int> cost(size * size, -1);
+        typedef std::pair<int,int> Entry;
+        std::priority_queue< Entry, std::vector<Entry>, std::greater<Entry> > open;
+        cost[sy * size + sx] = 0;
+        open.emplace(heuristic(sx, sy), sy * size + sx);
+        while ( !open.empty() )
+        {
+          int current = open.top().second;
+          open.pop();
+          int x = current % size, y = current / size;
+          if ( x == dx && y == dy )
+            return cost[current] / 10;
+
+          for ( int oy = -1; oy <= 1; ++oy )
+          {
+            for ( int ox = -1; ox <= 1; ++ox )
+            {
+              int nx = x + ox, ny = y + oy;
+              if ( (ox == 0 && oy == 0) || nx < 0 || ny < 0 || nx >= size || ny >= size || !walkable[ny * size + nx] )
+                continue;
+              int next = ny * size + nx;
+              int c = cost[current] + ((ox != 0 && oy != 0) ? 113 : 80);
+              if ( cost[next] == -1 || c < cost[next] )
+              {
+                cost[next] = c;
+                open.emplace(c + heuristic(nx, ny), next);
+              }
+            }
+          }
+        }
+        return -1;
+      }
+    };
+  }
+
+  TEST_CLASS(regionDistancesTest)
+  {
+  public:
+    TEST_METHOD(RegionDistancesTable)
+    {
+      TestMap map;
+      RegionDistances distances;
+      Assert::IsFalse(distances.isBuilt());
+      distances.build(map.nodes);
+      Assert::IsTrue(distances.isBuilt());
+      Assert::AreEqual(TestMap::blocks * TestMap::blocks, distances.size());
+
+      // Neighboring regions are connected directly, including diagonally
+      Assert::AreEqual(0, distances.getDistance(34, 34));
+      Assert::AreEqual(128, distances.getDistance(34, 35));
+      Assert::AreEqual(Position(0, 0).getApproxDistance(Position(128, 128)), distances.getDistance(34, 51));
+      Assert::AreEqual(256, distances.getDistance(34, 66));
+
+      // The corner region is cut off, as are the regions in the wall
+      Assert::AreEqual(-1, distances.getDistance(0, 34));
+      Assert::AreEqual(-1, distances.getDistance(34, 8));
+      Assert::AreEqual(-1, distances.getDistance(-1, 34));
+
+      // Crossing the wall must go through the gap
+      Assert::IsTrue(distances.getDistance(7, 9) > 128 * 22);
+
+      for ( int a = 0; a < distances.size(); ++a )
+        for ( int b = 0; b < distances.size(); ++b )
+          Assert::AreEqual(distances.getDistance(a, b), distances.getDistance(b, a));
+
+      distances.clear();
+      Assert::IsFalse(distances.isBuilt());
+    }
+    TEST_METHOD(RegionDistancesThreadCount)
+    {
+      TestMap map;
+      RegionDistances single, multi;
+      single.build(map.nodes, 1);
+      multi.build(map.nodes, 4);
+      for ( int a = 0; a < single.size(); ++a )
+        for ( int b = 0; b < single.size(); ++b )
+          Assert::AreEqual(single.getDistance(a, b), multi.getDistance(a, b));
+    }
+    TEST_METHOD(RegionDistancesGroundDistance)
+    {
+      TestMap map;
+      RegionDistances distances;
+      distances.build(map.nodes);
+
+      // Same region uses the straight line
+      Position a(300, 300), b(330, 340);
+      Assert::AreEqual(a.getApproxDistance(b), distances.getGroundDistance(a, map.regionAt(a), b, map.regionAt(b)));
+
+      // Unreachable
+      Position corner(10, 10);
+      Assert::AreEqual(-1, distances.getGroundDistance(corner, map.regionAt(corner), a, map.regionAt(a)));
+    }
+    TEST_METHOD(RegionDistancesApproximatesAStar)
+    {
+      TestMap map;
+      RegionDistances distances;
+      distances.build(map.nodes);
+
+      std::srand(17);
+      int checked = 0;
+      while ( checked < 50 )
+      {
+        Position p(std::rand() % (TestMap::size * 8), std::rand() % (TestMap::size * 8));
+        Position q(std::rand() % (TestMap::size * 8), std::rand() % (TestMap::size * 8));
+        int fast = distances.getGroundDistance(p, map.regionAt(p), q, map.regionAt(q));
+        if ( fast <= 0 )
+          continue;
+
+        int exact = map.aStar(p, q);
+        Assert::IsTrue(exact > 0);
+        Assert::IsTrue(std::abs(fast - exact) / static_cast<double>(std::max(exact, 64)) < 0.25);
+        ++checked;
+      }
+    }
+    BEGIN_TEST_METHOD_ATTRIBUTE(RegionDistancesBenchmark)
+      TEST_IGNORE()
+    END_TEST_METHOD_ATTRIBUTE()
+    TEST_METHOD(RegionDistancesBenchmark)
+    {
+      TestMap map;
+      RegionDistances distances;
+
+      auto start = std::chrono::high_resolution_clock::now();
+      distances.build(map.nodes);
+      auto built = std::chrono::high_resolution_clock::now();
+
+      // Random reachable pairs
+      std::vector< std::pair<Position,Position> > queries;
+      std::srand(31);
+      while ( queries.size() < 200 )
+      {
+        Position p(std::rand() % (TestMap::size * 8), std::rand() % (TestMap::size * 8));
+        Position q(std::rand() % (TestMap::size * 8), std::rand() % (TestMap::size * 8));
+        if ( distances.getGroundDistance(p, map.regionAt(p), q, map.regionAt(q)) > 0 )
+          queries.emplace_back(p, q);
+      }
+
+      std::vector<int> fast, exact;
+      auto fastStart = std::chrono::high_resolution_clock::now();
+      for ( auto &query : queries )
+        fast.push_back(distances.getGroundDistance(query.first, map.regionAt(query.first), query.second, map.regionAt(query.second)));
+      auto fastEnd = std::chrono::high_resolution_clock::now();
+      for ( auto &query : queries )
+        exact.push_back(map.aStar(query.first, query.second));
+      auto exactEnd = std::chrono::high_resolution_clock::now();
+
+      double totalError = 0;
+      for ( size_t i = 0; i < queries.size(); ++i )
+      {
+        Assert::IsTrue(exact[i] > 0);
+        double error = std::abs(fast[i] - exact[i]) / static_cast<double>(std::max(exact[i], 64));
+        Assert::IsTrue(error < 0.25);
+        totalError += error;
+      }
+
+      std::ostringstream ss;
+      ss << "RegionDistances: build " << std::chrono::duration<double, std::milli>(built - start).count() << " ms, "
+         << queries.size() << " queries " << std::chrono::duration<double, std::micro>(fastEnd - fastStart).count() << " us; "
+         << "walk tile A* " << std::chrono::duration<double, std::milli>(exactEnd - fastEnd).count() << " ms; "
+         << "mean error " << 100 * totalError / queries.size() << "%\n";
+      Logger::WriteMessage(ss.str().c_str());
+    }
+  };
+}
@@ -0,0 +1,210 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include <BWAPI.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <unordered_set>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  namespace
+  {
+    // Square regions of regionSize walk tiles, each connected to its 8 surrounding regions
+    RegionGraph::Input squareRegions(int columns, int rows, int regionSize)
+    {
+      RegionGraph::Input input;
+      input.width = columns * regionSize;
+      input.height = rows * regionSize;
+      for ( int y = 0; y < input.height; ++y )
+        for ( int x = 0; x < input.width; ++x )
+          input.regionIds.push_back((y / regionSize) * columns + x / regionSize);
+      input.walkable.assign(input.regionIds.size(), true);
+
+      input.nodes.resize(columns * rows);
+      for ( int ry = 0; ry < rows; ++ry )
+      {
+        for ( int rx = 0; rx < columns; ++rx )
+        {
+          RegionGraph::Node &node = input.nodes[ry * columns + rx];
+          node.center = Position(WalkPosition(rx * regionSize + regionSize / 2, ry * regionSize + regionSize / 2));
+          for ( int oy = -1; oy <= 1; ++oy )
+            for ( int ox = -1; ox <= 1; ++ox )
+              if ( (ox != 0 || oy != 0) && rx + ox >= 0 && ry + oy >= 0 && rx + ox < columns && ry + oy < rows )
+                node.neighbors.push_back((ry + oy) * columns + rx + ox);
+        }
+      }
+      return input;
+    }
+  }
+
+  TEST_CLASS(regionGraphTest)
+  {
+  public:
+    TEST_METHOD(RegionGraphLookupAndEdges)
+    {
+      RegionGraph::Input input = squareRegions(4, 4, 16);
+
+      // Walk tiles without a region, and a wall that leaves 4 walk tiles between regions 0 and 1
+      input.regionIds[3 * input.width + 5] = -1;
+      input.regionIds[3 * input.width + 6] = 5000;
+      for ( int y = 0; y < 12; ++y )
+      {
+        input.walkable[y * input.width + 15] = false;
+        input.walkable[y * input.width + 16] = false;
+      }
+
+      // Duplicates and self links are dropped, and the order is kept
+      input.nodes[0].neighbors = { 4, 1, 1, 0, 5 };
+
+      // Region 1 is in another group
+      input.nodes[1].groupId = 1;
+
+      // A wall with gaps of 2 and 5 walk tiles between regions 2 and 3
+      for ( int y = 0; y < 16; ++y )
+      {
+        if ( (y >= 2 && y < 4) || (y >= 10 && y < 15) )
+          continue;
+        input.walkable[y * input.width + 47] = false;
+        input.walkable[y * input.width + 48] = false;
+      }
+
+      RegionGraph graph;
+      graph.build(input);
+      Assert::IsTrue(graph.isBuilt());
+      Assert::AreEqual(16, graph.size());
+
+      Assert::AreEqual(0, graph.getRegionId(0, 0));
+      Assert::AreEqual(5, graph.getRegionId(WalkPosition(16, 16)));
+      Assert::AreEqual(15, graph.getRegionId(63, 63));
+      Assert::AreEqual(-1, graph.getRegionId(5, 3));
+      Assert::AreEqual(-1, graph.getRegionId(6, 3));
+      Assert::AreEqual(-1, graph.getRegionId(64, 0));
+      Assert::AreEqual(-1, graph.getRegionId(-1, 0));
+
+      Assert::AreEqual(3, graph.getNeighborCount(0));
+      const RegionGraph::Edge *e = graph.edgesBegin(0);
+      Assert::AreEqual(4, e[0].target);
+      Assert::AreEqual(1, e[1].target);
+      Assert::AreEqual(5, e[2].target);
+      Assert::IsTrue(e + 3 == graph.edgesEnd(0));
+      Assert::AreEqual(graph.getCenter(0).getApproxDistance(graph.getCenter(5)), e[2].length);
+
+      // Borders are measured on both sides: 2 walk tiles across and 16 or 4 walk tiles along.
+      // Regions 0 and 5 only touch at a corner.
+      Assert::AreEqual(Position(0, 0).getApproxDistance(Position(16, 128)), e[0].width);
+      Assert::AreEqual(Position(0, 0).getApproxDistance(Position(16, 32)), e[1].width);
+      Assert::AreEqual(0, e[2].width);
+
+      // Only the wider gap counts, not the box around both
+      Assert::AreEqual(3, graph.edgesBegin(2)[1].target);
+      Assert::AreEqual(Position(0, 0).getApproxDistance(Position(16, 40)), graph.edgesBegin(2)[1].width);
+
+      // Region 4 is closer than region 5, and region 1 is in another group
+      Assert::AreEqual(4, graph.getClosestAccessibleRegion(0));
+      Assert::AreEqual(1, graph.getClosestInaccessibleRegion(0));
+      Assert::AreEqual(-1, graph.getClosestInaccessibleRegion(10));
+
+      graph.clear();
+      Assert::IsFalse(graph.isBuilt());
+      Assert::AreEqual(-1, graph.getRegionId(0, 0));
+    }
+    TEST_METHOD(RegionGraphEdgesMatchNeighbors)
+    {
+      // The edges of each region are exactly its neighbors, each with the distance between centers
+      RegionGraph::Input input = squareRegions(12, 9, 8);
+      RegionGraph graph;
+      graph.build(input);
+      Assert::AreEqual(12 * 9, graph.size());
+
+      for ( int r = 0; r < graph.size(); ++r )
+      {
+        auto &neighbors = input.nodes[r].neighbors;
+        std::unordered_set<int> expected(neighbors.begin(), neighbors.end()), actual;
+        Assert::AreEqual(static_cast<int>(neighbors.size()), graph.getNeighborCount(r));
+        for ( const RegionGraph::Edge *e = graph.edgesBegin(r); e != graph.edgesEnd(r); ++e )
+        {
+          actual.insert(e->target);
+          Assert::AreEqual(graph.getCenter(r).getApproxDistance(graph.getCenter(e->target)), e->length);
+        }
+        Assert::IsTrue(expected == actual);
+      }
+    }
+    BEGIN_TEST_METHOD_ATTRIBUTE(RegionGraphBenchmark)
+      TEST_IGNORE()
+    END_TEST_METHOD_ATTRIBUTE()
+    TEST_METHOD(RegionGraphBenchmark)
+    {
+      // Breadth first searches from every region, over hash sets of neighbors like Regionset
+      // and over the flat graph
+      RegionGraph::Input input = squareRegions(32, 32, 8);
+      RegionGraph graph;
+      graph.build(input);
+
+      int n = graph.size();
+      std::vector< std::unordered_set<int> > sets(n);
+      for ( int i = 0; i < n; ++i )
+        sets[i].insert(input.nodes[i].neighbors.begin(), input.nodes[i].neighbors.end());
+
+      std::vector<int> visited(n), queue(n);
+      long long setTotal = 0, graphTotal = 0;
+      auto begin = std::chrono::high_resolution_clock::now();
+      for ( int source = 0; source < n; ++source )
+      {
+        std::fill(visited.begin(), visited.end(), -1);
+        int head = 0, tail = 0;
+        visited[source] = 0;
+        queue[tail++] = source;
+        while ( head < tail )
+        {
+          int r = queue[head++];
+          for ( int next : sets[r] )
+          {
+            if ( visited[next] == -1 )
+            {
+              visited[next] = visited[r] + 1;
+              setTotal += visited[next];
+              queue[tail++] = next;
+            }
+          }
+        }
+      }
+      auto middle = std::chrono::high_resolution_clock::now();
+      for ( int source = 0; source < n; ++source )
+      {
+        std::fill(visited.begin(), visited.end(), -1);
+        int head = 0, tail = 0;
+        visited[source] = 0;
+        queue[tail++] = source;
+        while ( head < tail )
+        {
+          int r = queue[head++];
+          for ( const RegionGraph::Edge *e = graph.edgesBegin(r); e != graph.edgesEnd(r); ++e )
+          {
+            if ( visited[e->target] == -1 )
+            {
+              visited[e->target] = visited[r] + 1;
+              graphTotal += visited[e->target];
+              queue[tail++] = e->target;
+            }
+          }
+        }
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+
+      Assert::AreEqual(setTotal, graphTotal);
+
+      std::ostringstream ss;
+      ss << "RegionGraph: " << n << " breadth first searches over " << n << " regions take "
+         << std::chrono::duration<double, std::milli>(middle - begin).count() << " ms over hash sets, "
+         << std::chrono::duration<double, std::milli>(end - middle).count() << " ms over the flat graph\n";
+      Logger::WriteMessage(ss.str().c_str());
+    }
+  };
+}
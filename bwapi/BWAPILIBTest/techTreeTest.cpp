@@ -0,0 +1,91 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include <BWAPI.h>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  TEST_CLASS(techTreeTest)
+  {
+  public:
+    TEST_METHOD(TechTreeNodes)
+    {
+      int dragoon = TechTree::getNode(UnitTypes::Protoss_Dragoon);
+      int lurker = TechTree::getNode(TechTypes::Lurker_Aspect);
+      int carapace = TechTree::getNode(UpgradeTypes::Zerg_Carapace, 2);
+
+      Assert::AreEqual(UnitTypes::Protoss_Dragoon.getID(), TechTree::getUnitType(dragoon).getID());
+      Assert::AreEqual(TechTypes::Lurker_Aspect.getID(), TechTree::getTechType(lurker).getID());
+      Assert::AreEqual(UpgradeTypes::Zerg_Carapace.getID(), TechTree::getUpgradeType(carapace).first.getID());
+      Assert::AreEqual(2, TechTree::getUpgradeType(carapace).second);
+
+      Assert::AreEqual(-1, TechTree::getNode(UnitTypes::None));
+      Assert::AreEqual(-1, TechTree::getNode(UpgradeTypes::Zerg_Carapace, 0));
+    }
+    TEST_METHOD(TechTreeRequirements)
+    {
+      int dragoon = TechTree::getNode(UnitTypes::Protoss_Dragoon);
+      auto &direct = TechTree::getRequirements(dragoon);
+      auto &all = TechTree::getAllRequirements(dragoon);
+
+      Assert::IsTrue(direct.test(TechTree::getNode(UnitTypes::Protoss_Gateway)));
+      Assert::IsTrue(direct.test(TechTree::getNode(UnitTypes::Protoss_Cybernetics_Core)));
+      Assert::IsFalse(direct.test(TechTree::getNode(UnitTypes::Protoss_Probe)));
+      Assert::IsTrue(all.test(TechTree::getNode(UnitTypes::Protoss_Probe)));
+      Assert::IsTrue(all.test(TechTree::getNode(UnitTypes::Protoss_Nexus)));
+
+      // Level 3 carapace requires the previous levels and a Hive
+      auto &carapace = TechTree::getAllRequirements(TechTree::getNode(UpgradeTypes::Zerg_Carapace, 3));
+      Assert::IsTrue(carapace.test(TechTree::getNode(UpgradeTypes::Zerg_Carapace, 1)));
+      Assert::IsTrue(carapace.test(TechTree::getNode(UnitTypes::Zerg_Hive)));
+    }
+    TEST_METHOD(TechTreeSolve)
+    {
+      TechTree::State state;
+      state.setOwned(TechTree::getNode(UnitTypes::Protoss_Nexus));
+      state.setOwned(TechTree::getNode(UnitTypes::Protoss_Probe), 4);
+      state.setOwned(TechTree::getNode(UnitTypes::Protoss_Pylon));
+
+      TechTree::Goal goal;
+      goal.add(UnitTypes::Protoss_Dragoon, 2).add(UpgradeTypes::Singularity_Charge);
+      TechTree::Plan plan = TechTree::solve(state, goal);
+
+      Assert::IsTrue(plan.possible);
+      Assert::AreEqual(size_t(4), plan.missing.count());
+      Assert::IsTrue(plan.missing.test(TechTree::getNode(UnitTypes::Protoss_Gateway)));
+      Assert::IsTrue(plan.missing.test(TechTree::getNode(UnitTypes::Protoss_Cybernetics_Core)));
+      Assert::IsFalse(plan.missing.test(TechTree::getNode(UnitTypes::Protoss_Nexus)));
+
+      // Gateway -> Cybernetics Core -> Singularity Charge is the critical path
+      int expected = UnitTypes::Protoss_Gateway.buildTime() +
+                     UnitTypes::Protoss_Cybernetics_Core.buildTime() +
+                     UpgradeTypes::Singularity_Charge.upgradeTime();
+      Assert::AreEqual(expected, plan.frames);
+
+      // Requirements always appear before the nodes that need them
+      Assert::AreEqual(TechTree::getNode(UnitTypes::Protoss_Gateway), plan.order.front());
+    }
+    TEST_METHOD(TechTreeSolveInProgress)
+    {
+      TechTree::State state;
+      state.setOwned(TechTree::getNode(UnitTypes::Protoss_Gateway));
+      state.setInProgress(TechTree::getNode(UnitTypes::Protoss_Cybernetics_Core), 100);
+
+      TechTree::Goal goal;
+      goal.add(UnitTypes::Protoss_Dragoon);
+      TechTree::Plan plan = TechTree::solve(state, goal);
+
+      Assert::AreEqual(size_t(1), plan.missing.count());
+      Assert::AreEqual(100 + UnitTypes::Protoss_Dragoon.buildTime(), plan.frames);
+    }
+    TEST_METHOD(TechTreeSolveImpossible)
+    {
+      TechTree::Goal goal;
+      goal.add(UnitTypes::Hero_Tassadar);
+      Assert::IsFalse(TechTree::solve(TechTree::State(), goal).possible);
+    }
+  };
+}
@@ -0,0 +1,199 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include <BWAPI.h>
+
+#include <cstdio>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  namespace
+  {
+    // A 64x64 tile map with two bases, a blocker mineral, and a wall with a gap between the
+    // left and right halves. The right half is split into a top and a bottom region.
+    TerrainAnalysis::Input makeInput()
+    {
+      TerrainAnalysis::Input input;
+      input.width = input.height = 64;
+      input.buildable.assign(64 * 64, true);
+
+      const int walkWidth = 256;
+      input.walkable.assign(walkWidth * walkWidth, true);
+      input.regionIds.resize(walkWidth * walkWidth);
+      for ( int y = 0; y < walkWidth; ++y )
+      {
+        for ( int x = 0; x < walkWidth; ++x )
+        {
+          input.regionIds[y * walkWidth + x] = x < 128 ? 0 : (y < 128 ? 1 : 2);
+          if ( x >= 126 && x < 130 && (y < 100 || y >= 110) )
+            input.walkable[y * walkWidth + x] = false;
+        }
+      }
+
+      auto addResource = [&](UnitType type, int x, int y, int amount)
+      {
+        TerrainAnalysis::Resource r;
+        r.type = type;
+        r.tilePosition = TilePosition(x, y);
+        r.amount = amount;
+        input.resources.push_back(r);
+      };
+      for ( int i = 0; i < 8; ++i )
+        addResource(UnitTypes::Resource_Mineral_Field, 4 + (i % 2), 8 + i, 1500);
+      addResource(UnitTypes::Resource_Vespene_Geyser, 9, 4, 5000);
+
+      for ( int i = 0; i < 6; ++i )
+        addResource(UnitTypes::Resource_Mineral_Field_Type_2, 40 + 2 * i, 58, 1000);
+      addResource(UnitTypes::Resource_Vespene_Geyser, 52, 53, 5000);
+
+      addResource(UnitTypes::Resource_Mineral_Field, 30, 30, 0);
+      return input;
+    }
+
+    // The same test as Game::canBuildHere for resource depots
+    bool isTooCloseToResources(const TerrainAnalysis::Input &input, TilePosition lt)
+    {
+      for ( auto &r : input.resources )
+      {
+        TilePosition tp = r.tilePosition;
+        if ( r.type.isMineralField() && tp.x > lt.x - 5 && tp.y > lt.y - 4 && tp.x < lt.x + 7 && tp.y < lt.y + 6 )
+          return true;
+        if ( !r.type.isMineralField() && tp.x > lt.x - 7 && tp.y > lt.y - 5 && tp.x < lt.x + 7 && tp.y < lt.y + 6 )
+          return true;
+      }
+      return false;
+    }
+  }
+
+  TEST_CLASS(terrainAnalysisTest)
+  {
+  public:
+    TEST_METHOD(TerrainAnalysisClusters)
+    {
+      TerrainAnalysis::Input input = makeInput();
+      TerrainAnalysis analysis;
+      Assert::IsFalse(analysis.isAnalyzed());
+      analysis.analyze(input);
+      Assert::IsTrue(analysis.isAnalyzed());
+
+      // The blocker is not a resource
+      auto &clusters = analysis.getResourceClusters();
+      Assert::AreEqual(2u, clusters.size());
+      Assert::AreEqual(8u, clusters[0].minerals.size());
+      Assert::AreEqual(1u, clusters[0].geysers.size());
+      Assert::AreEqual(8 * 1500 + 5000, clusters[0].amount);
+      Assert::AreEqual(6u, clusters[1].minerals.size());
+      Assert::AreEqual(1u, clusters[1].geysers.size());
+
+      auto &bases = analysis.getBaseLocations();
+      Assert::AreEqual(2u, bases.size());
+      for ( auto &b : bases )
+      {
+        Assert::IsFalse(b.startLocation);
+        Assert::IsFalse(isTooCloseToResources(input, b.tilePosition));
+        Assert::IsTrue(b.position.getApproxDistance(clusters[b.cluster].center) < 256);
+        Assert::AreEqual(Position(b.tilePosition) + Position(64, 48), b.position);
+      }
+      Assert::AreEqual(0, bases[0].region);
+      Assert::AreEqual(2, bases[1].region);
+    }
+    TEST_METHOD(TerrainAnalysisStartLocations)
+    {
+      TerrainAnalysis::Input input = makeInput();
+      input.startLocations.push_back(TilePosition(11, 10));
+      input.startLocations.push_back(TilePosition(40, 4));
+
+      TerrainAnalysis analysis;
+      analysis.analyze(input);
+
+      // The first start location replaces the nearby base, the second one has no resources
+      auto &bases = analysis.getBaseLocations();
+      Assert::AreEqual(3u, bases.size());
+      Assert::AreEqual(TilePosition(11, 10), bases[0].tilePosition);
+      Assert::IsTrue(bases[0].startLocation);
+      Assert::AreEqual(0, bases[0].cluster);
+      Assert::IsFalse(bases[1].startLocation);
+      Assert::AreEqual(TilePosition(40, 4), bases[2].tilePosition);
+      Assert::IsTrue(bases[2].startLocation);
+      Assert::AreEqual(-1, bases[2].cluster);
+      Assert::AreEqual(1, bases[2].region);
+    }
+    TEST_METHOD(TerrainAnalysisChokePoints)
+    {
+      TerrainAnalysis analysis;
+      analysis.analyze(makeInput());
+
+      // The border between the two regions on the right is open, only the gap is a choke
+      auto &chokes = analysis.getChokePoints();
+      Assert::AreEqual(1u, chokes.size());
+      Assert::AreEqual(0, chokes[0].regions[0]);
+      Assert::AreEqual(1, chokes[0].regions[1]);
+      Assert::AreEqual(80, chokes[0].width);
+      Assert::AreEqual(WalkPosition(127, 104), WalkPosition(chokes[0].center));
+      Assert::AreEqual(100, WalkPosition(chokes[0].sides[0]).y);
+      Assert::AreEqual(109, WalkPosition(chokes[0].sides[1]).y);
+    }
+    TEST_METHOD(TerrainAnalysisSharedClearance)
+    {
+      TerrainAnalysis::Input input = makeInput();
+      ClearanceMap clearance;
+      clearance.build(input.width * 4, input.height * 4, input.walkable);
+      input.clearance = &clearance;
+
+      TerrainAnalysis shared, computed;
+      shared.analyze(input);
+      computed.analyze(makeInput());
+
+      Assert::AreEqual(computed.getChokePoints().size(), shared.getChokePoints().size());
+      Assert::AreEqual(computed.getChokePoints()[0].center, shared.getChokePoints()[0].center);
+      Assert::AreEqual(computed.getChokePoints()[0].width, shared.getChokePoints()[0].width);
+    }
+    TEST_METHOD(TerrainAnalysisCache)
+    {
+      const char *filename = "terrainAnalysisTest.dat";
+      TerrainAnalysis::Input input = makeInput();
+      input.startLocations.push_back(TilePosition(11, 10));
+
+      TerrainAnalysis analysis;
+      analysis.analyze(input);
+      Assert::IsTrue(analysis.save(filename, "0123456789abcdef"));
+
+      TerrainAnalysis loaded;
+      Assert::IsTrue(loaded.load(filename, "0123456789abcdef"));
+
+      Assert::IsTrue(loaded.isAnalyzed());
+      Assert::AreEqual(analysis.getResourceClusters().size(), loaded.getResourceClusters().size());
+      for ( size_t i = 0; i < loaded.getResourceClusters().size(); ++i )
+      {
+        auto &a = analysis.getResourceClusters()[i], &b = loaded.getResourceClusters()[i];
+        Assert::IsTrue(a.minerals == b.minerals && a.geysers == b.geysers);
+        Assert::AreEqual(a.amount, b.amount);
+        Assert::AreEqual(a.center, b.center);
+      }
+      Assert::AreEqual(analysis.getBaseLocations().size(), loaded.getBaseLocations().size());
+      for ( size_t i = 0; i < loaded.getBaseLocations().size(); ++i )
+      {
+        auto &a = analysis.getBaseLocations()[i], &b = loaded.getBaseLocations()[i];
+        Assert::AreEqual(a.tilePosition, b.tilePosition);
+        Assert::AreEqual(a.position, b.position);
+        Assert::AreEqual(a.cluster, b.cluster);
+        Assert::AreEqual(a.region, b.region);
+        Assert::AreEqual(a.startLocation, b.startLocation);
+      }
+      Assert::AreEqual(analysis.getChokePoints().size(), loaded.getChokePoints().size());
+      Assert::AreEqual(analysis.getChokePoints()[0].center, loaded.getChokePoints()[0].center);
+      Assert::AreEqual(analysis.getChokePoints()[0].width, loaded.getChokePoints()[0].width);
+
+      // A file written for another map is ignored
+      Assert::IsFalse(loaded.load(filename, "fedcba9876543210"));
+      Assert::IsFalse(loaded.isAnalyzed());
+      Assert::IsTrue(loaded.getBaseLocations().empty());
+      Assert::IsFalse(loaded.load("terrainAnalysisTest.missing", "0123456789abcdef"));
+      std::remove(filename);
+    }
+  };
+}
@@ -0,0 +1,124 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include "fakeUnit.h"
+#include <BWAPI.h>
+#include <BWAPI/Client/UnitHistory.h>
+
+#include <vector>
+#include <algorithm>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  TEST_CLASS(unitHistoryTest)
+  {
+  public:
+    TEST_METHOD(UnitHistoryDisabled)
+    {
+      FakeUnit marine(1, Position(10, 20), 40);
+      Unitset units;
+      units.insert(&marine);
+
+      UnitHistory history;
+      history.update(units);
+      Assert::IsFalse(history.isEnabled());
+      Assert::AreEqual(0, history.getSampleCount(&marine));
+      Assert::AreEqual(Positions::Unknown, history.getPosition(&marine));
+      Assert::AreEqual(-1, history.getHitPoints(&marine));
+    }
+    TEST_METHOD(UnitHistoryRingWrapAround)
+    {
+      FakeUnit marine(1, Positions::Origin, 0);
+      Unitset units;
+      units.insert(&marine);
+
+      // Record more frames than the capacity so that the ring overwrites its oldest samples
+      UnitHistory history;
+      history.enable(3);
+      for ( int frame = 0; frame < 7; ++frame )
+      {
+        marine.position = Position(frame * 10, frame);
+        marine.hitPoints = 40 - frame;
+        history.update(units);
+        Assert::AreEqual(std::min(frame + 1, 3), history.getSampleCount(&marine));
+      }
+
+      for ( int framesAgo = 0; framesAgo < 3; ++framesAgo )
+      {
+        int frame = 6 - framesAgo;
+        Assert::AreEqual(Position(frame * 10, frame), history.getPosition(&marine, framesAgo));
+        Assert::AreEqual(40 - frame, history.getHitPoints(&marine, framesAgo));
+      }
+      Assert::AreEqual(Positions::Unknown, history.getPosition(&marine, 3));
+      Assert::AreEqual(-1, history.getHitPoints(&marine, 3));
+      Assert::AreEqual(Positions::Unknown, history.getPosition(&marine, -1));
+    }
+    TEST_METHOD(UnitHistoryMissedUpdate)
+    {
+      FakeUnit marine(1, Position(10, 10), 40);
+      FakeUnit zealot(2, Position(50, 50), 100);
+      Unitset both, zealotOnly;
+      both.insert(&marine);
+      both.insert(&zealot);
+      zealotOnly.insert(&zealot);
+
+      UnitHistory history;
+      history.enable(4);
+      history.update(both);
+      history.update(both);
+
+      // A unit that is not in an update has no history until it is seen again
+      history.update(zealotOnly);
+      Assert::AreEqual(0, history.getSampleCount(&marine));
+      Assert::AreEqual(Positions::Unknown, history.getPosition(&marine));
+      Assert::AreEqual(3, history.getSampleCount(&zealot));
+
+      marine.position = Position(20, 20);
+      history.update(both);
+      Assert::AreEqual(1, history.getSampleCount(&marine));
+      Assert::AreEqual(Position(20, 20), history.getPosition(&marine));
+      Assert::AreEqual(Positions::Unknown, history.getPosition(&marine, 1));
+      Assert::AreEqual(4, history.getSampleCount(&zealot));
+    }
+    TEST_METHOD(UnitHistoryClear)
+    {
+      FakeUnit marine(1, Position(10, 10), 40);
+      Unitset units;
+      units.insert(&marine);
+
+      UnitHistory history;
+      history.enable(2);
+      history.update(units);
+      history.update(units);
+      history.clear();
+      Assert::AreEqual(2, history.getCapacity());
+      Assert::AreEqual(0, history.getSampleCount(&marine));
+      Assert::IsTrue(history.getUnits().empty());
+
+      history.update(units);
+      Assert::AreEqual(1, history.getSampleCount(&marine));
+    }
+    TEST_METHOD(UnitHistoryPredictStationary)
+    {
+      // Units that do not exist have no motion, so they are predicted where they are
+      FakeUnit marine(1, Position(10, 20), 40);
+      FakeUnit zealot(2, Position(300, 400), 100);
+      Unitset units;
+      units.insert(&marine);
+      units.insert(&zealot);
+
+      UnitHistory history;
+      history.enable(1);
+      history.update(units);
+
+      std::vector<Position> predicted;
+      history.predictPositions(24, predicted);
+      Assert::AreEqual(size_t(2), predicted.size());
+      for ( size_t i = 0; i < predicted.size(); ++i )
+        Assert::AreEqual(history.getUnits()[i]->getPosition(), predicted[i]);
+    }
+  };
+}
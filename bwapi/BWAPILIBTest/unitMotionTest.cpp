@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include <BWAPI.h>
+
+#include <vector>
+#include <limits>
+#include <cmath>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  TEST_CLASS(unitMotionTest)
+  {
+  public:
+    TEST_METHOD(UnitMotionStationary)
+    {
+      UnitMotion::State state;
+      state.x = 100;
+      state.y = 200;
+      state.topSpeed = 4;
+      state.range = std::numeric_limits<float>::max();
+      Assert::AreEqual(Position(100, 200), UnitMotion::predict(state, 24));
+    }
+    TEST_METHOD(UnitMotionConstantSpeed)
+    {
+      // No acceleration, so the unit keeps its current speed
+      UnitMotion::State state;
+      state.velocityX = 3;
+      state.velocityY = -4;
+      state.topSpeed = 5;
+      state.range = std::numeric_limits<float>::max();
+      Assert::AreEqual(Position(30, -40), UnitMotion::predict(state, 10));
+    }
+    TEST_METHOD(UnitMotionAcceleration)
+    {
+      // Vulture-like: 1 px/frame, accelerating at 0.5 px/frame^2 up to 4 px/frame
+      UnitMotion::State state;
+      state.velocityX = 1;
+      state.topSpeed = 4;
+      state.acceleration = 0.5f;
+      state.range = std::numeric_limits<float>::max();
+
+      // 6 frames to reach top speed: 1*6 + 0.5*0.5*36 = 15, then 4 frames at top speed = 16
+      Assert::AreEqual(Position(31, 0), UnitMotion::predict(state, 10));
+
+      // Stops at the range
+      state.range = 20;
+      Assert::AreEqual(Position(20, 0), UnitMotion::predict(state, 10));
+      Assert::AreEqual(Position(0, 0), UnitMotion::predict(state, 0));
+    }
+    TEST_METHOD(UnitMotionBatch)
+    {
+      std::vector<UnitMotion::State> states(37);
+      for ( size_t i = 0; i < states.size(); ++i )
+      {
+        states[i].x = static_cast<float>(i * 10);
+        states[i].y = static_cast<float>(i * 7);
+        states[i].velocityX = static_cast<float>(i % 5) - 2;
+        states[i].velocityY = static_cast<float>(i % 3) - 1;
+        states[i].topSpeed = 4 + static_cast<float>(i % 4);
+        states[i].acceleration = (i % 2) ? 0.25f : 0;
+        states[i].range = (i % 7) ? std::numeric_limits<float>::max() : 12.0f;
+      }
+
+      std::vector<float> x, y, vx, vy, top, accel, range;
+      for ( auto &s : states )
+      {
+        x.push_back(s.x);
+        y.push_back(s.y);
+        vx.push_back(s.velocityX);
+        vy.push_back(s.velocityY);
+        top.push_back(s.topSpeed);
+        accel.push_back(s.acceleration);
+        range.push_back(s.range);
+      }
+
+      std::vector<float> rx(states.size()), ry(states.size());
+      UnitMotion::predict(x.data(), y.data(), vx.data(), vy.data(), top.data(), accel.data(), range.data(),
+                          states.size(), 16, rx.data(), ry.data());
+      for ( size_t i = 0; i < states.size(); ++i )
+      {
+        Position single = UnitMotion::predict(states[i], 16);
+        Assert::AreEqual(single, Position(static_cast<int>(std::lround(rx[i])), static_cast<int>(std::lround(ry[i]))));
+      }
+    }
+  };
+}
@@ -0,0 +1,107 @@
+#include "stdafx.h"
+#include "CppUnitTest.h"
+#include "specializations.h"
+#include "fakeUnit.h"
+#include <BWAPI.h>
+#include <BWAPI/Client/UnitSnapshot.h>
+
+#include <vector>
+#include <set>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+using namespace BWAPI;
+
+namespace BWAPILIBTest
+{
+  TEST_CLASS(unitSnapshotTest)
+  {
+  public:
+    TEST_METHOD(UnitSnapshotDisabled)
+    {
+      FakeUnit marine(1, Position(10, 20), 40);
+      Unitset units;
+      units.insert(&marine);
+
+      UnitSnapshot snapshot;
+      snapshot.update(units);
+      Assert::IsTrue(snapshot.empty());
+
+      snapshot.enable();
+      snapshot.update(units);
+      Assert::AreEqual(size_t(1), snapshot.size());
+
+      snapshot.enable(false);
+      Assert::IsTrue(snapshot.empty());
+    }
+    TEST_METHOD(UnitSnapshotArrays)
+    {
+      FakeUnit marine(1, Position(10, 20), 40);
+      FakeUnit zealot(2, Position(30, 40), 100);
+      zealot.type = UnitTypes::Protoss_Zealot;
+      zealot.shields = 60;
+      Unitset units;
+      units.insert(&marine);
+      units.insert(&zealot);
+
+      UnitSnapshot snapshot;
+      snapshot.enable();
+      snapshot.update(units);
+      Assert::AreEqual(size_t(2), snapshot.size());
+
+      // Every array describes the same unit at each index
+      for ( size_t i = 0; i < snapshot.size(); ++i )
+      {
+        Unit u = snapshot.getUnit(i);
+        Assert::AreEqual(u->getID(), snapshot.getIDs()[i]);
+        Assert::AreEqual(-1, snapshot.getPlayers()[i]);
+        Assert::AreEqual(u->getType().getID(), snapshot.getTypes()[i]);
+        Assert::AreEqual(u->getPosition(), Position(snapshot.getX()[i], snapshot.getY()[i]));
+        Assert::AreEqual(u->getHitPoints(), snapshot.getHitPoints()[i]);
+        Assert::AreEqual(u->getShields(), snapshot.getShields()[i]);
+      }
+    }
+    TEST_METHOD(UnitSnapshotFilter)
+    {
+      FakeUnit marine(1, Position(0, 0), 40);
+      FakeUnit wraith(2, Position(100, 0), 120);
+      wraith.type = UnitTypes::Terran_Wraith;
+      wraith.flying = true;
+      FakeUnit scv(3, Position(0, 100), 60);
+      scv.type = UnitTypes::Terran_SCV;
+      FakeUnit barracks(4, Position(500, 500), 1000);
+      barracks.type = UnitTypes::Terran_Barracks;
+      barracks.completed = false;
+      Unitset units;
+      units.insert(&marine);
+      units.insert(&wraith);
+      units.insert(&scv);
+      units.insert(&barracks);
+
+      UnitSnapshot snapshot;
+      snapshot.enable();
+      snapshot.update(units);
+
+      std::vector<int> result;
+      Assert::AreEqual(size_t(4), snapshot.filter(-1, 0, 0, result));
+
+      // Completed ground units
+      Assert::AreEqual(size_t(2), snapshot.filter(-1, UnitSnapshot::Completed, UnitSnapshot::Flying | UnitSnapshot::Building, result));
+      std::set<int> selected;
+      for ( int i : result )
+        selected.insert(snapshot.getIDs()[i]);
+      Assert::IsTrue(selected == std::set<int>{ marine.id, scv.id });
+      Assert::AreEqual(Position(0, 50), snapshot.getCentroid(result));
+      Assert::AreEqual(100, snapshot.getTotalHealth(result));
+
+      Assert::AreEqual(size_t(1), snapshot.filter(-1, UnitSnapshot::Worker, 0, result));
+      Assert::IsTrue(snapshot.getUnit(result[0]) == &scv);
+
+      Assert::AreEqual(size_t(1), snapshot.filter(-1, UnitSnapshot::Building, UnitSnapshot::Completed, result));
+      Assert::IsTrue(snapshot.getUnit(result[0]) == &barracks);
+
+      // The units are not owned by any player
+      Assert::AreEqual(size_t(0), snapshot.filter(0, 0, 0, result));
+      Assert::AreEqual(Positions::Invalid, snapshot.getCentroid(result));
+    }
+  };
+}
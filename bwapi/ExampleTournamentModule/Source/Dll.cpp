@@ -3,6 +3,7 @@
 #include "ExampleTournamentModule.h"
 
 extern "C" __declspec(dllexport) void gameInit(BWAPI::Game* game) { BWAPI::BroodwarPtr = game; }
+extern "C" __declspec(dllexport) void gameEnd() { BWAPI::MapAnalysis::onMatchEnd(); }
 
 BOOL APIENTRY DllMain(HANDLE, DWORD, LPVOID)
 {
@@ -10,6 +10,7 @@
 /* 02.05.03  1.01  Lad  Stress test done                                     */
 /*****************************************************************************/
 
+#include <string.h>
 #include "pklib.h"
 
 //-----------------------------------------------------------------------------
@@ -46,6 +47,33 @@ typedef struct
   unsigned short LenBase[0x10];       // 3114 - Buffer for 
 } TDcmpStruct;
 
+// Work structure of explode_fast, which fits in the work buffer of explode
+typedef struct
+{
+  unsigned long long bit_buff;        // Bit buffer, whose lowest bit is the next one
+  unsigned long bit_count;            // Number of valid bits in bit_buff
+  unsigned long ctype;                // Compression type (CMP_BINARY or CMP_ASCII)
+  unsigned long dsize_bits;           // Dict size (4, 5, 6 for 0x400, 0x800, 0x1000)
+  unsigned long dsize_mask;           // Dict size bitmask (0x0F, 0x1F, 0x3F for 0x400, 0x800, 0x1000)
+  unsigned long in_pos;               // Position in in_buff
+  unsigned long in_bytes;             // Number of bytes in input buffer
+  unsigned long in_eof;               // read_buf has no more data
+  void        * param;                // Custom parameter
+  unsigned int (PKEXPORT *read_buf)(char *buf, unsigned  int *size, void *param);
+  void         (PKEXPORT *write_buf)(char *buf, unsigned  int *size, void *param);
+  unsigned char out_buff[0x2210];     // Output circle buffer, like in explode, with room for the longest
+                                      // match past 0x2000 and the bytes that the match copy writes past it
+  unsigned char in_buff[0x800];       // Buffer for data to be decompressed
+  unsigned char ChBitsAsc[0x100];     // Same as in TDcmpStruct, for CMP_ASCII
+  unsigned char offs2C34[0x100];
+  unsigned char offs2D34[0x100];
+  unsigned char offs2E34[0x80];
+  unsigned char offs2EB4[0x100];
+} TFastDcmpStruct;
+
+// Fails to compile if TFastDcmpStruct does not fit in EXP_BUFFER_SIZE bytes
+typedef char TFastDcmpStructFits[sizeof(TFastDcmpStruct) <= EXP_BUFFER_SIZE ? 1 : -1];
+
 //-----------------------------------------------------------------------------
 // Tables
 
@@ -142,6 +170,82 @@ static unsigned short ChCodeAsc[] =
   0x1C00, 0x0C00, 0x1400, 0x0400, 0x1800, 0x0800, 0x1000, 0x0000
 };
 
+// Decode tables of explode_fast, indexed by the next 8 bits, that are the same as the tables that
+// GenDecodeTabs generates. LenDecode entries are (LenBase << 7) | (ExLenBits << 3) | LenBits, and
+// DistDecode entries are (position << 4) | DistBits.
+
+static const unsigned short LenDecode[0x100] =
+{
+  0x8347, 0x0103, 0x0284, 0x0082, 0x040D, 0x0003, 0x0183, 0x0082,
+  0x071D, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x132E, 0x0103, 0x0284, 0x0082, 0x0385, 0x0003, 0x0183, 0x0082,
+  0x0515, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x2336, 0x0103, 0x0284, 0x0082, 0x040D, 0x0003, 0x0183, 0x0082,
+  0x071D, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x0B26, 0x0103, 0x0284, 0x0082, 0x0385, 0x0003, 0x0183, 0x0082,
+  0x0515, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x433F, 0x0103, 0x0284, 0x0082, 0x040D, 0x0003, 0x0183, 0x0082,
+  0x071D, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x132E, 0x0103, 0x0284, 0x0082, 0x0385, 0x0003, 0x0183, 0x0082,
+  0x0515, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x2336, 0x0103, 0x0284, 0x0082, 0x040D, 0x0003, 0x0183, 0x0082,
+  0x071D, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x0B26, 0x0103, 0x0284, 0x0082, 0x0385, 0x0003, 0x0183, 0x0082,
+  0x0515, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x8347, 0x0103, 0x0284, 0x0082, 0x040D, 0x0003, 0x0183, 0x0082,
+  0x071D, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x132E, 0x0103, 0x0284, 0x0082, 0x0385, 0x0003, 0x0183, 0x0082,
+  0x0515, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x2336, 0x0103, 0x0284, 0x0082, 0x040D, 0x0003, 0x0183, 0x0082,
+  0x071D, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x0B26, 0x0103, 0x0284, 0x0082, 0x0385, 0x0003, 0x0183, 0x0082,
+  0x0515, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x433F, 0x0103, 0x0284, 0x0082, 0x040D, 0x0003, 0x0183, 0x0082,
+  0x071D, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x132E, 0x0103, 0x0284, 0x0082, 0x0385, 0x0003, 0x0183, 0x0082,
+  0x0515, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x2336, 0x0103, 0x0284, 0x0082, 0x040D, 0x0003, 0x0183, 0x0082,
+  0x071D, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082,
+  0x0B26, 0x0103, 0x0284, 0x0082, 0x0385, 0x0003, 0x0183, 0x0082,
+  0x0515, 0x0103, 0x0204, 0x0082, 0x0304, 0x0003, 0x0183, 0x0082
+};
+
+static const unsigned short DistDecode[0x100] =
+{
+  0x03F8, 0x0065, 0x0177, 0x0002, 0x0277, 0x0024, 0x00E6, 0x0002,
+  0x02F7, 0x0045, 0x0126, 0x0002, 0x01F7, 0x0014, 0x00A6, 0x0002,
+  0x0378, 0x0055, 0x0146, 0x0002, 0x0237, 0x0024, 0x00C6, 0x0002,
+  0x02B7, 0x0035, 0x0106, 0x0002, 0x01B7, 0x0014, 0x0086, 0x0002,
+  0x03B8, 0x0065, 0x0156, 0x0002, 0x0257, 0x0024, 0x00D6, 0x0002,
+  0x02D7, 0x0045, 0x0116, 0x0002, 0x01D7, 0x0014, 0x0096, 0x0002,
+  0x0338, 0x0055, 0x0136, 0x0002, 0x0217, 0x0024, 0x00B6, 0x0002,
+  0x0297, 0x0035, 0x00F6, 0x0002, 0x0197, 0x0014, 0x0076, 0x0002,
+  0x03D8, 0x0065, 0x0167, 0x0002, 0x0267, 0x0024, 0x00E6, 0x0002,
+  0x02E7, 0x0045, 0x0126, 0x0002, 0x01E7, 0x0014, 0x00A6, 0x0002,
+  0x0358, 0x0055, 0x0146, 0x0002, 0x0227, 0x0024, 0x00C6, 0x0002,
+  0x02A7, 0x0035, 0x0106, 0x0002, 0x01A7, 0x0014, 0x0086, 0x0002,
+  0x0398, 0x0065, 0x0156, 0x0002, 0x0247, 0x0024, 0x00D6, 0x0002,
+  0x02C7, 0x0045, 0x0116, 0x0002, 0x01C7, 0x0014, 0x0096, 0x0002,
+  0x0318, 0x0055, 0x0136, 0x0002, 0x0207, 0x0024, 0x00B6, 0x0002,
+  0x0287, 0x0035, 0x00F6, 0x0002, 0x0187, 0x0014, 0x0076, 0x0002,
+  0x03E8, 0x0065, 0x0177, 0x0002, 0x0277, 0x0024, 0x00E6, 0x0002,
+  0x02F7, 0x0045, 0x0126, 0x0002, 0x01F7, 0x0014, 0x00A6, 0x0002,
+  0x0368, 0x0055, 0x0146, 0x0002, 0x0237, 0x0024, 0x00C6, 0x0002,
+  0x02B7, 0x0035, 0x0106, 0x0002, 0x01B7, 0x0014, 0x0086, 0x0002,
+  0x03A8, 0x0065, 0x0156, 0x0002, 0x0257, 0x0024, 0x00D6, 0x0002,
+  0x02D7, 0x0045, 0x0116, 0x0002, 0x01D7, 0x0014, 0x0096, 0x0002,
+  0x0328, 0x0055, 0x0136, 0x0002, 0x0217, 0x0024, 0x00B6, 0x0002,
+  0x0297, 0x0035, 0x00F6, 0x0002, 0x0197, 0x0014, 0x0076, 0x0002,
+  0x03C8, 0x0065, 0x0167, 0x0002, 0x0267, 0x0024, 0x00E6, 0x0002,
+  0x02E7, 0x0045, 0x0126, 0x0002, 0x01E7, 0x0014, 0x00A6, 0x0002,
+  0x0348, 0x0055, 0x0146, 0x0002, 0x0227, 0x0024, 0x00C6, 0x0002,
+  0x02A7, 0x0035, 0x0106, 0x0002, 0x01A7, 0x0014, 0x0086, 0x0002,
+  0x0388, 0x0065, 0x0156, 0x0002, 0x0247, 0x0024, 0x00D6, 0x0002,
+  0x02C7, 0x0045, 0x0116, 0x0002, 0x01C7, 0x0014, 0x0096, 0x0002,
+  0x0308, 0x0055, 0x0136, 0x0002, 0x0207, 0x0024, 0x00B6, 0x0002,
+  0x0287, 0x0035, 0x00F6, 0x0002, 0x0187, 0x0014, 0x0076, 0x0002
+};
+
 //-----------------------------------------------------------------------------
 // Local variables
 
@@ -171,7 +275,8 @@ static void GenDecodeTabs(long count, unsigned char * bits, unsigned char * pCod
   }
 }
 
-static void GenAscTabs(TDcmpStruct * pWork)
+static void GenAscTabs(unsigned char * pChBits, unsigned char * p2C34, unsigned char * p2D34,
+                       unsigned char * p2E34, unsigned char * p2EB4)
 {
   unsigned short * pChCodeAsc = &ChCodeAsc[0xFF];
   unsigned long  acc, add;
@@ -179,7 +284,7 @@ static void GenAscTabs(TDcmpStruct * pWork)
 
   for (count = 0x00FF; pChCodeAsc >= ChCodeAsc; pChCodeAsc--, count--)
   {
-    unsigned char * pChBitsAsc = pWork->ChBitsAsc + count;
+    unsigned char * pChBitsAsc = pChBits + count;
     unsigned char bits_asc = *pChBitsAsc;
 
     if (bits_asc <= 8)
@@ -189,13 +294,13 @@ static void GenAscTabs(TDcmpStruct * pWork)
 
       do
       {
-        pWork->offs2C34[acc] = (unsigned char)count;
+        p2C34[acc] = (unsigned char)count;
         acc += add;
       } while (acc < 0x100);
     }
     else if ((acc = (*pChCodeAsc & 0xFF)) != 0)
     {
-      pWork->offs2C34[acc] = 0xFF;
+      p2C34[acc] = 0xFF;
 
       if (*pChCodeAsc & 0x3F)
       {
@@ -206,7 +311,7 @@ static void GenAscTabs(TDcmpStruct * pWork)
         acc = *pChCodeAsc >> 4;
         do
         {
-          pWork->offs2D34[acc] = (unsigned char)count;
+          p2D34[acc] = (unsigned char)count;
           acc += add;
         } while (acc < 0x100);
       }
@@ -219,7 +324,7 @@ static void GenAscTabs(TDcmpStruct * pWork)
         acc = *pChCodeAsc >> 6;
         do
         {
-          pWork->offs2E34[acc] = (unsigned char)count;
+          p2E34[acc] = (unsigned char)count;
           acc += add;
         } while (acc < 0x80);
       }
@@ -233,7 +338,7 @@ static void GenAscTabs(TDcmpStruct * pWork)
       acc = *pChCodeAsc >> 8;
       do
       {
-        pWork->offs2EB4[acc] = (unsigned char)count;
+        p2EB4[acc] = (unsigned char)count;
         acc += add;
       } while (acc < 0x100);
     }
@@ -482,7 +587,7 @@ unsigned int PKEXPORT explode(
       return CMP_INVALID_MODE;
 
     memcpy(pWork->ChBitsAsc, ChBitsAsc, sizeof(pWork->ChBitsAsc));
-    GenAscTabs(pWork);
+    GenAscTabs(pWork->ChBitsAsc, pWork->offs2C34, pWork->offs2D34, pWork->offs2E34, pWork->offs2EB4);
   }
 
   memcpy(pWork->LenBits, LenBits, sizeof(pWork->LenBits));
@@ -496,3 +601,265 @@ unsigned int PKEXPORT explode(
 
   return CMP_ABORT;
 }
+
+
+//-----------------------------------------------------------------------------
+// Table driven explode. The output, the calls to write_buf and the return
+// values are the same as those of explode, including for damaged data:
+// - explode fails when a code leaves less than 8 bits of input after it,
+//   except for the end code, so every code is checked for that here
+// - the end code is recognized before its extra bits are checked
+// - a distance before the start of the output reads the output buffer of the
+//   work buffer, so the work buffer decides what it reads, like in explode
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__) || \
+    (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define PKLIB_LITTLE_ENDIAN
+#endif
+
+// Loads bytes into the bit buffer until it has at least 56 bits, or until
+// there is no more input
+static void FastRefill(TFastDcmpStruct * pWork)
+{
+  while (pWork->bit_count < 56)
+  {
+    if (pWork->in_pos == pWork->in_bytes)
+    {
+      unsigned int size = sizeof(pWork->in_buff);
+
+      if (pWork->in_eof)
+        return;
+      pWork->in_bytes = pWork->read_buf((char *)pWork->in_buff, &size, pWork->param);
+      pWork->in_pos = 0;
+      if (pWork->in_bytes == 0)
+      {
+        pWork->in_eof = 1;
+        return;
+      }
+    }
+    pWork->bit_buff |= (unsigned long long)pWork->in_buff[pWork->in_pos++] << pWork->bit_count;
+    pWork->bit_count += 8;
+  }
+}
+
+static unsigned long FastExpand(TFastDcmpStruct * pWork)
+{
+  unsigned long long bit_buff = 0;    // Local copies, which writes to the output cannot alias
+  unsigned long bit_count = 0;
+  unsigned long outputPos = 0x1000;   // Initialize output buffer position
+  unsigned long dwResult;
+  unsigned int  copyBytes;
+
+  for (;;)
+  {
+    unsigned long nBits;              // Number of bits of the code
+    unsigned long value;
+
+    // Every code is at most 30 bits, and 8 more bits are checked after it
+    if (bit_count < 38)
+    {
+#ifdef PKLIB_LITTLE_ENDIAN
+      if (pWork->in_pos + 8 <= pWork->in_bytes)
+      {
+        unsigned long long bits;
+
+        memcpy(&bits, &pWork->in_buff[pWork->in_pos], sizeof(bits));
+        bit_buff |= bits << bit_count;
+        pWork->in_pos += (63 - bit_count) >> 3;
+        bit_count |= 56;
+      }
+      else
+#endif
+      {
+        pWork->bit_buff = bit_buff;
+        pWork->bit_count = bit_count;
+        FastRefill(pWork);
+        bit_buff = pWork->bit_buff;
+        bit_count = pWork->bit_count;
+      }
+    }
+
+    if ((bit_buff & 1) == 0)
+    {
+      // One byte, stored as it is or as an ASCII code
+      if (pWork->ctype == CMP_BINARY)
+      {
+        value = (unsigned long)(bit_buff >> 1) & 0xFF;
+        nBits = 9;
+      }
+      else
+      {
+        unsigned long bits = (unsigned long)(bit_buff >> 1);
+
+        nBits = 1;
+        if (bits & 0xFF)
+        {
+          value = pWork->offs2C34[bits & 0xFF];
+          if (value == 0xFF)
+          {
+            if (bits & 0x3F)
+            {
+              nBits += 4;
+              value = pWork->offs2D34[(bits >> 4) & 0xFF];
+            }
+            else
+            {
+              nBits += 6;
+              value = pWork->offs2E34[(bits >> 6) & 0x7F];
+            }
+          }
+        }
+        else
+        {
+          nBits += 8;
+          value = pWork->offs2EB4[(bits >> 8) & 0xFF];
+        }
+        nBits += pWork->ChBitsAsc[value];
+      }
+
+      if (nBits + 8 > bit_count)
+      {
+        dwResult = 0x306;
+        break;
+      }
+      bit_buff >>= nBits;
+      bit_count -= nBits;
+      pWork->out_buff[outputPos++] = (unsigned char)value;
+    }
+    else
+    {
+      // Copy previous block, whose length is at least 2
+      unsigned long entry = LenDecode[(bit_buff >> 1) & 0xFF];
+      unsigned long exBits = (entry >> 3) & 0x0F;
+      unsigned long copyLength;
+      unsigned long moveBack;
+      unsigned char * target;
+      unsigned char * source;
+
+      nBits = 1 + (entry & 0x07);
+      if (nBits + 8 > bit_count)
+      {
+        dwResult = 0x306;
+        break;
+      }
+
+      value = (entry >> 7) + ((unsigned long)(bit_buff >> nBits) & ((1 << exBits) - 1));
+      if (value == 0x205)
+      {
+        dwResult = 0x305;
+        break;
+      }
+      nBits += exBits;
+      copyLength = value + 2;
+
+      // Number of bytes to move back
+      entry = DistDecode[(bit_buff >> nBits) & 0xFF];
+      nBits += entry & 0x0F;
+      moveBack = entry >> 4;
+      if (copyLength == 2)
+      {
+        moveBack = (moveBack << 2) | ((unsigned long)(bit_buff >> nBits) & 0x03);
+        nBits += 2;
+      }
+      else
+      {
+        moveBack = (moveBack << pWork->dsize_bits) | ((unsigned long)(bit_buff >> nBits) & pWork->dsize_mask);
+        nBits += pWork->dsize_bits;
+      }
+      moveBack++;
+
+      if (nBits + 8 > bit_count)
+      {
+        dwResult = 0x306;
+        break;
+      }
+      bit_buff >>= nBits;
+      bit_count -= nBits;
+
+      target = &pWork->out_buff[outputPos];
+      source = target - moveBack;
+      outputPos += copyLength;
+
+      if (moveBack >= 8)
+      {
+        // 8 bytes at a time, which can write up to 7 bytes past the block
+        long left = (long)copyLength;
+        do
+        {
+          memcpy(target, source, 8);
+          target += 8;
+          source += 8;
+          left -= 8;
+        } while (left > 0);
+      }
+      else if (moveBack == 1)
+        memset(target, *source, copyLength);
+      else
+      {
+        while (copyLength-- > 0)
+          *target++ = *source++;
+      }
+    }
+
+    // If number of extracted bytes has reached 1/2 of output buffer,
+    // flush output buffer.
+    if (outputPos >= 0x2000)
+    {
+      copyBytes = 0x1000;
+      pWork->write_buf((char *)&pWork->out_buff[0x1000], &copyBytes, pWork->param);
+
+      // The last 0x1000 bytes are the dictionary of the next blocks
+      memmove(pWork->out_buff, &pWork->out_buff[0x1000], outputPos - 0x1000);
+      outputPos -= 0x1000;
+    }
+  }
+
+  copyBytes = outputPos - 0x1000;
+  pWork->write_buf((char *)&pWork->out_buff[0x1000], &copyBytes, pWork->param);
+  return dwResult;
+}
+
+unsigned int PKEXPORT explode_fast(
+  unsigned int(*read_buf)(char *buf, unsigned  int *size, void *param),
+  void(*write_buf)(char *buf, unsigned  int *size, void *param),
+  char         *work_buf,
+  void         *param)
+{
+  TFastDcmpStruct * pWork = (TFastDcmpStruct *)work_buf;
+  unsigned int size = sizeof(pWork->in_buff);
+
+  // Initialize work struct and load compressed data
+  pWork->read_buf = read_buf;
+  pWork->write_buf = write_buf;
+  pWork->param = param;
+  pWork->in_bytes = pWork->read_buf((char *)pWork->in_buff, &size, pWork->param);
+  if (pWork->in_bytes <= 4)
+    return CMP_BAD_DATA;
+
+  pWork->ctype = pWork->in_buff[0];
+  pWork->dsize_bits = pWork->in_buff[1];
+  pWork->bit_buff = 0;
+  pWork->bit_count = 0;
+  pWork->in_pos = 2;
+  pWork->in_eof = 0;
+
+  // Test for the valid dictionary size
+  if (4 > pWork->dsize_bits || pWork->dsize_bits > 6)
+    return CMP_INVALID_DICTSIZE;
+
+  pWork->dsize_mask = 0xFFFF >> (0x10 - pWork->dsize_bits);
+
+  if (pWork->ctype != CMP_BINARY)
+  {
+    if (pWork->ctype != CMP_ASCII)
+      return CMP_INVALID_MODE;
+
+    memcpy(pWork->ChBitsAsc, ChBitsAsc, sizeof(pWork->ChBitsAsc));
+    GenAscTabs(pWork->ChBitsAsc, pWork->offs2C34, pWork->offs2D34, pWork->offs2E34, pWork->offs2EB4);
+  }
+
+  if (FastExpand(pWork) != 0x306)
+    return CMP_NO_ERROR;
+
+  return CMP_ABORT;
+}
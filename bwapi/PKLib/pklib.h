@@ -15,7 +15,11 @@
 // Defines
 
 #define CMP_BUFFER_SIZE    36312        // Size of compression buffer
+#if defined(_WIN64) || defined(__LP64__)
+#define EXP_BUFFER_SIZE    12648        // Size of decompress buffer, with 64-bit pointers and longs
+#else
 #define EXP_BUFFER_SIZE    12596        // Size of decompress buffer
+#endif
 
 #define CMP_BINARY             0        // Binary compression
 #define CMP_ASCII              1        // Ascii compression
@@ -30,7 +34,11 @@
 // Define calling convention
 
 //#define PKEXPORT
+#ifdef _WIN32
 #define PKEXPORT  __cdecl               // Use for normal __cdecl calling 
+#else
+#define PKEXPORT                        // No calling convention keyword outside of Windows
+#endif
 //#define PKEXPORT  __stdcall
 //#define PKEXPORT  __fastcall
 
@@ -56,6 +64,14 @@ unsigned int PKEXPORT explode(
    char         *work_buf,
    void         *param);
 
+// Same as explode, with the same work buffer and the same output, decoding
+// with lookup tables and a 64-bit bit buffer instead of a bit at a time
+unsigned int PKEXPORT explode_fast(
+   unsigned int (PKEXPORT* read_buf)(char *buf, unsigned  int *size, void *param),
+   void         (PKEXPORT* write_buf)(char *buf, unsigned  int *size, void *param),
+   char         *work_buf,
+   void         *param);
+
 // The original name "crc32" was changed to "crc32pk" due
 // to compatibility with zlib
 unsigned long PKEXPORT crc32pk(char *buffer, unsigned int *size, unsigned long *old_crc);
@@ -4,7 +4,11 @@
 #include <BWAPI.h>
 #include "Replay.h"
 #include "ReplayTool.h"
+#include "ActionColumns.h"
+#include "ReplayIndex.h"
+#include "ReplayFingerprint.h"
 #include "ParseReplayParams.h"
+#include "StrUtil.h"
 
 ReplayTool::ParseReplayParams g_options;
 
@@ -14,7 +18,8 @@ enum ToolArgs
   ARG_Option,
   ARG_File,
   ARG_REPO,
-  ARG_COUNT
+  ARG_COUNT,
+  ARG_Level = ARG_COUNT   // Optional
 };
 
 void Message(LPCSTR pszText, LPCSTR pszCaption)
@@ -24,21 +29,39 @@ void Message(LPCSTR pszText, LPCSTR pszCaption)
 
 int Usage()
 {
-  MessageBoxA(NULL,  "Usage: Replay_Tool -[option] [replay-path] [output-dir-path]\n"
+  MessageBoxA(NULL,  "Usage: Replay_Tool -[option] [replay-path] [output-dir-path] [level]\n"
     "[option]"
     " -u Unpack replay.\n"
-    " -p Pack replay.\n"
+    " -p Pack replay from the files that unpack writes.\n"
     " -r Auto-Repair replay.\n"
+    " -i Index all replays under the [replay-path] directory into the [output-dir-path] file.\n"
+    " -a Export the actions of the replay to the [output-dir-path] file in columns.\n"
+    " -g Group the replays under the [replay-path] directory that hold the same game into the [output-dir-path] file.\n"
     "\nAliases:\n"
     " -e Extract. Alias for unpack.\n"
     " -d Decompress. Alias for unpack.\n"
     " -c Compress. Alias for pack.\n"
-    " -f Fix. Alias for repair.\n",
+    " -f Fix. Alias for repair.\n"
+    "\n[level]\n"
+    " Compression level of pack and repair: fast (default), normal or best.\n",
     "Usage", MB_OK | MB_ICONINFORMATION);
 
   return EXIT_SUCCESS;
 }
 
+bool parseCompressLevel(const char *pszLevel, CompressLevel &level)
+{
+  if (_stricmp(pszLevel, "fast") == 0)
+    level = CompressLevel_Fast;
+  else if (_stricmp(pszLevel, "normal") == 0)
+    level = CompressLevel_Normal;
+  else if (_stricmp(pszLevel, "best") == 0)
+    level = CompressLevel_Best;
+  else
+    return false;
+  return true;
+}
+
 int main(int argc, LPTSTR argv[])
 {
   ReplayTool::init();
@@ -77,6 +100,17 @@ int main(int argc, LPTSTR argv[])
     g_options.setOutRepoPath(argv[ARG_REPO]);
   }
 
+  if (argc > ARG_Level)
+  {
+    CompressLevel level;
+    if (!parseCompressLevel(argv[ARG_Level], level))
+    {
+      Message("Invalid compression level", "Fail");
+      return 0;
+    }
+    g_options.setCompressLevel(level);
+  }
+
   switch (g_options.getOption())
   {
   case 'u':
@@ -94,6 +128,10 @@ int main(int argc, LPTSTR argv[])
   case 'P':
   case 'c':
   case 'C':
+    if (packReplay(g_options))
+      Message("Packed successfully.", "Success");
+    else
+      Message("Failed writing process somewhere.", "Failure");
     break;
   case 'r':
   case 'R':
@@ -104,6 +142,33 @@ int main(int argc, LPTSTR argv[])
     else
       Message("Failed reading process somewhere.", "Failure");
     break;
+  case 'i':
+  case 'I':
+    {
+      unsigned replayCount = 0, validCount = 0;
+      if (ReplayTool::indexReplays(g_options.getReplayPath(), g_options.getOutRepoPath(), 0, &replayCount, &validCount))
+        Message(ReplayTool::StrUtil::format("Indexed %u of %u replays.", validCount, replayCount).c_str(), "Success");
+      else
+        Message("Failed writing the index.", "Failure");
+    }
+    break;
+  case 'g':
+  case 'G':
+    {
+      unsigned replayCount = 0, duplicateCount = 0;
+      if (ReplayTool::writeDuplicateReplays(g_options.getReplayPath(), g_options.getOutRepoPath(), 0, &replayCount, &duplicateCount))
+        Message(ReplayTool::StrUtil::format("Found %u duplicates in %u replays.", duplicateCount, replayCount).c_str(), "Success");
+      else
+        Message("Failed writing the duplicates.", "Failure");
+    }
+    break;
+  case 'a':
+  case 'A':
+    if (ReplayTool::exportActionColumns(g_options.getReplayPath(), g_options.getOutRepoPath(), ACFLAG_DELTA_FRAMES | ACFLAG_DICTIONARY))
+      Message("Exported actions successfully.", "Success");
+    else
+      Message("Failed reading process somewhere.", "Failure");
+    break;
   default:
     return Usage();
   }
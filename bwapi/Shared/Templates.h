@@ -28,40 +28,13 @@ namespace BWAPI
     static inline bool canUseTechUnit(Unit thisUnit, BWAPI::TechType tech, Unit targetUnit, bool checkCanTargetUnit = true, bool checkTargetsUnits = true, bool checkCanIssueCommandType = true, bool checkCommandibility = true);
     static inline bool canUseTechPosition(Unit thisUnit, BWAPI::TechType tech, Position target, bool checkTargetsPositions = true, bool checkCanIssueCommandType = true, bool checkCommandibility = true);
     //--------------------------------------------- HAS POWER ------------------------------------------------
-    const bool bPsiFieldMask[10][16] = {
-      { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 },
-      { 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
-      { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
-      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
-      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
-      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
-      { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 },
-      { 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0 },
-      { 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0 },
-      { 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 }
-    };
-    static inline bool hasPower(int x, int y, UnitType unitType, const Unitset &pylons)
+    static inline bool hasPower(int x, int y, UnitType unitType, const PowerGrid &powerGrid)
     {
       if ( unitType >= 0 && unitType < UnitTypes::None && (!unitType.requiresPsi() || !unitType.isBuilding()) )
         return true;
 
-      // Loop through all pylons for the current player
-      for (Unit i : pylons)
-      {
-        if ( !i->exists() || !i->isCompleted() )
-          continue;
-
-        Position p = i->getPosition();
-        if ( abs(p.x - x) >= 256 )
-          continue;
-
-        if ( abs(p.y - y) >= 160 )
-          continue;
-
-        if ( bPsiFieldMask[(y - p.y + 160) / 32][(x - p.x + 256) / 32] )
-          return true;
-      }
-      return false;
+      // The grid holds the psi fields of the completed pylons of the current player
+      return powerGrid.hasPower(x, y);
     }
     //-------------------------------------------- UNIT FINDER -----------------------------------------------
     template <class finder, typename _T>
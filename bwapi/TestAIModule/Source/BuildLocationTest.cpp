@@ -0,0 +1,66 @@
+#include "BuildLocationTest.h"
+#include "BWAssert.h"
+#include <vector>
+using namespace std;
+using namespace BWAPI;
+
+BuildLocationTest::BuildLocationTest()
+{
+  fail = false;
+  running = false;
+}
+void BuildLocationTest::start()
+{
+  if (fail) return;
+  running = true;
+
+  Unit depot = NULL;
+  for (Unit u : Broodwar->self()->getUnits())
+  {
+    if (u->getType().isResourceDepot())
+      depot = u;
+  }
+  BWAssertF(depot!=NULL,{fail=true;return;});
+
+  // A typical build order around the main base
+  vector< pair<UnitType, TilePosition> > requests;
+  UnitType types[] = { UnitTypes::Protoss_Pylon, UnitTypes::Protoss_Gateway, UnitTypes::Protoss_Gateway,
+                       UnitTypes::Protoss_Forge, UnitTypes::Protoss_Photon_Cannon, UnitTypes::Protoss_Pylon,
+                       UnitTypes::Protoss_Cybernetics_Core, UnitTypes::Protoss_Gateway };
+  for (UnitType t : types)
+    requests.push_back(make_pair(t, depot->getTilePosition()));
+
+  vector<TilePosition> locations = Broodwar->getBuildLocations(requests);
+  BWAssertF(locations.size()==requests.size(),{fail=true;return;});
+
+  // Nothing is planned before the first request
+  BWAssert(locations[0]==Broodwar->getBuildLocation(requests[0].first, requests[0].second));
+
+  // Every location is buildable now, and planned structures do not overlap
+  for (size_t i = 0; i < locations.size(); ++i)
+  {
+    UnitType t = requests[i].first;
+    if (locations[i]==TilePositions::None)
+      continue;
+    BWAssert(Broodwar->canBuildHere(locations[i], t));
+    for (size_t j = 0; j < i; ++j)
+    {
+      UnitType o = requests[j].first;
+      if (locations[j]==TilePositions::None)
+        continue;
+      BWAssert(locations[i].x + t.tileWidth() <= locations[j].x || locations[j].x + o.tileWidth() <= locations[i].x ||
+               locations[i].y + t.tileHeight() <= locations[j].y || locations[j].y + o.tileHeight() <= locations[i].y);
+    }
+  }
+
+  BWAssert(Broodwar->getBuildLocations(vector< pair<UnitType, TilePosition> >(1, make_pair(UnitTypes::Protoss_Zealot, depot->getTilePosition())))[0]==TilePositions::Invalid);
+  BWAssert(Broodwar->getLastError()==Errors::Incompatible_UnitType);
+}
+void BuildLocationTest::update()
+{
+  running = false;
+}
+
+void BuildLocationTest::stop()
+{
+}
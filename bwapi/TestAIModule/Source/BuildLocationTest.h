@@ -0,0 +1,12 @@
+#pragma once
+#include "TestCase.h"
+#include <BWAPI.h>
+
+class BuildLocationTest : public TestCase
+{
+  public:
+    BuildLocationTest();
+    virtual void start();
+    virtual void update();
+    virtual void stop();
+};
\ No newline at end of file
@@ -11,7 +11,19 @@
 #include "MicroTest.h"
 #include "DefaultTestModule.h"
 
-extern "C" __declspec(dllexport) void gameInit(BWAPI::Game* game) { BWAPI::BroodwarPtr = game; }
+extern "C" __declspec(dllexport) void gameInit(BWAPI::Game* game)
+{
+  BWAPI::BroodwarPtr = game;
+
+  // This module links its own copy of the map analysis, which BWAPI does not compute
+  BWAPI::MapAnalysis::onMatchStart();
+}
+
+extern "C" __declspec(dllexport) void gameEnd()
+{
+  // Stops the flow field worker of this copy before BWAPI unloads the module
+  BWAPI::MapAnalysis::onMatchEnd();
+}
 BOOL APIENTRY DllMain( HANDLE hModule, DWORD ul_reason_for_call, LPVOID lpReserved )
 {
   switch (ul_reason_for_call)
@@ -1,4 +1,5 @@
 #include "MapTest.h"
+#include <algorithm>
 using namespace std;
 using namespace BWAPI;
 void MapTest::onStart()
@@ -54,6 +55,28 @@ void MapTest::onStart()
     }
   }
 
+  //on the first frame, every visible and explored tile has changed
+  for ( int x = 0; x < 10; ++x )
+    for ( int y = 0; y < 10; ++y )
+    {
+      BWAssert(Broodwar->isTileChanged(x,y,TileLayer::Visible));
+      BWAssert(Broodwar->isTileChanged(x,y,TileLayer::Explored));
+    }
+  for(int x=50;x<60;x++)
+  {
+    for(int y=50;y<60;y++)
+    {
+      BWAssert(Broodwar->isTileChanged(x,y,TileLayer::Visible)==false);
+    }
+  }
+  BWAssert(Broodwar->isTileChanged(-1,0,TileLayer::Visible)==false);
+  BWAssert(std::find(Broodwar->getChangedTileBlocks().begin(), Broodwar->getChangedTileBlocks().end(), TilePosition(0,0)) != Broodwar->getChangedTileBlocks().end());
+  for(TilePosition block : Broodwar->getChangedTileBlocks())
+  {
+    BWAssert(block.x % TileLayer::BlockSize == 0 && block.y % TileLayer::BlockSize == 0);
+    BWAssert(block.x < Broodwar->mapWidth() && block.y < Broodwar->mapHeight());
+  }
+
   //briefly check some of these functions. Can add more test cases later if needed
   BWAssert(Broodwar->canBuildHere(TilePosition(18,12),UnitTypes::Protoss_Pylon));
   BWAssert(Broodwar->canBuildHere(TilePosition(18,12),UnitTypes::Protoss_Gateway));
@@ -16,6 +16,7 @@
 #include "GatherTest.h"
 #include "CancelConstructionTest.h"
 #include "RightClickTest.h"
+#include "BuildLocationTest.h"
 using namespace std;
 using namespace BWAPI;
 void ProtossTest::onStart()
@@ -49,6 +50,7 @@ void ProtossTest::onStart()
   this->addTestCase(new BuildTest(UnitTypes::Protoss_Pylon));
   this->addTestCase(new BuildTest(UnitTypes::Protoss_Cybernetics_Core));
   this->addTestCase(new BuildTest(UnitTypes::Protoss_Shield_Battery));
+  this->addTestCase(new BuildLocationTest());
 
   this->addTestCase(new CancelConstructionTest(UnitTypes::Protoss_Pylon));
   this->addTestCase(new BuildTest(UnitTypes::Protoss_Pylon));
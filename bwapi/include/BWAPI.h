@@ -8,37 +8,50 @@
 #include <BWAPI/Bullet.h>
 #include <BWAPI/Bulletset.h>
 #include <BWAPI/BulletType.h>
+#include <BWAPI/ClearanceMap.h>
 #include <BWAPI/Color.h>
 #include <BWAPI/Constants.h>
 #include <BWAPI/CoordinateType.h>
 #include <BWAPI/DamageType.h>
+#include <BWAPI/DistanceBatch.h>
 #include <BWAPI/Error.h>
 #include <BWAPI/Event.h>
 #include <BWAPI/EventType.h>
 #include <BWAPI/ExplosionType.h>
 #include <BWAPI/Filters.h>
 #include <BWAPI/Flag.h>
+#include <BWAPI/FlowFields.h>
 #include <BWAPI/Force.h>
 #include <BWAPI/Forceset.h>
 #include <BWAPI/Game.h>
 #include <BWAPI/GameType.h>
+#include <BWAPI/InfluenceMap.h>
 #include <BWAPI/Input.h>
 #include <BWAPI/Latency.h>
+#include <BWAPI/MapAnalysis.h>
 #include <BWAPI/Order.h>
+#include <BWAPI/Pathfinder.h>
 #include <BWAPI/Player.h>
 #include <BWAPI/Playerset.h>
 #include <BWAPI/PlayerType.h>
 #include <BWAPI/Position.h>
 #include <BWAPI/PositionUnit.h>
+#include <BWAPI/PowerGrid.h>
 #include <BWAPI/Race.h>
 #include <BWAPI/Region.h>
+#include <BWAPI/RegionDistances.h>
+#include <BWAPI/RegionGraph.h>
 #include <BWAPI/Regionset.h>
 #include <BWAPI/TechType.h>
+#include <BWAPI/TechTree.h>
+#include <BWAPI/TerrainAnalysis.h>
+#include <BWAPI/TileLayer.h>
 #include <BWAPI/TournamentAction.h>
 #include <BWAPI/Type.h>
 #include <BWAPI/Unit.h>
 #include <BWAPI/UnitCommand.h>
 #include <BWAPI/UnitCommandType.h>
+#include <BWAPI/UnitMotion.h>
 #include <BWAPI/Unitset.h>
 #include <BWAPI/UnitSizeType.h>
 #include <BWAPI/UnitType.h>
@@ -0,0 +1,96 @@
+#pragma once
+#include <BWAPI/Position.h>
+#include <BWAPI/UnitType.h>
+#include <BWAPI/UnitSizeType.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace BWAPI
+{
+  /// The ClearanceMap class stores how much free space surrounds each walk tile.
+  ///
+  /// The distance layer holds the exact Euclidean distance from the center of each walk tile to
+  /// the center of the nearest blocked walk tile, where blocked tiles are unwalkable terrain,
+  /// static buildings and resources, and everything outside of the map. It is computed with
+  /// the separable distance transform of Felzenszwalb and Huttenlocher, one pass over the
+  /// columns and one over the rows, each split between several threads.
+  ///
+  /// From the distance layer, one bit mask is derived for each of the small, medium, and large
+  /// unit size classes. A bit is set when the largest ground unit of that class fits on the tile,
+  /// meaning that the distance is at least the half width of the unit. The distance is measured
+  /// to the center of the blocked tile, which leaves the unit half a walk tile of room to place
+  /// its center anywhere inside its own tile.
+  ///
+  /// Distances are stored in pixels as 16 bit integers and the masks as 32 bit words, so a
+  /// 256x256 tile map uses about 2.4 megabytes.
+  ///
+  /// @see Game::getClearance, Game::isPassable, MapAnalysis::getClearanceMap
+  class ClearanceMap
+  {
+  public:
+    /// Computes the layers from a walkability grid.
+    ///
+    /// @param width
+    ///   The width of the map, in walk tiles.
+    /// @param height
+    ///   The height of the map, in walk tiles.
+    /// @param walkable
+    ///   Whether each walk tile is free, indexed by y * width + x.
+    /// @param threadCount (optional)
+    ///   The number of threads to use. If 0, then one thread per hardware core is used.
+    void build(int width, int height, const std::vector<bool> &walkable, unsigned int threadCount = 0);
+
+    /// Removes all data.
+    void clear();
+
+    /// Checks if the layers have been computed.
+    bool isBuilt() const { return width > 0; };
+
+    /// Retrieves the width of the layers, in walk tiles.
+    int getWidth() const { return width; };
+
+    /// Retrieves the height of the layers, in walk tiles.
+    int getHeight() const { return height; };
+
+    /// Retrieves the distance from a walk tile to the nearest blocked walk tile.
+    ///
+    /// @returns The distance in pixels, or 0 if the tile is blocked or outside of the map.
+    int getDistance(WalkPosition position) const;
+
+    /// Checks if the largest ground unit of a size class fits on a walk tile.
+    ///
+    /// @param position
+    ///   The walk tile that the center of the unit is on.
+    /// @param size
+    ///   UnitSizeTypes::Small, UnitSizeTypes::Medium, or UnitSizeTypes::Large.
+    bool isPassable(WalkPosition position, UnitSizeType size) const;
+
+    /// Checks if a unit type fits on a walk tile.
+    bool isPassable(WalkPosition position, UnitType type) const;
+
+    /// Retrieves the raw distance layer, in pixels, indexed by y * getWidth() + x.
+    const std::vector<std::uint16_t> &getDistances() const { return distances; };
+
+    /// Retrieves the raw passability layer of a size class. Bit (x % 32) of word
+    /// (y * getMaskStride() + x / 32) is set when the class fits on tile (x, y).
+    ///
+    /// @returns The mask, or an empty vector if \p size is not small, medium or large.
+    const std::vector<std::uint32_t> &getMask(UnitSizeType size) const;
+
+    /// Retrieves the number of words in each row of a passability mask.
+    int getMaskStride() const { return maskStride; };
+
+    /// Retrieves the half width, in pixels, of the largest ground unit type of a size class.
+    static int getRadius(UnitSizeType size);
+
+    /// Retrieves the half width, in pixels, of a unit type.
+    static int getRadius(UnitType type);
+  private:
+    int width = 0;
+    int height = 0;
+    int maskStride = 0;
+    std::vector<std::uint16_t> distances;
+    std::vector<std::uint32_t> masks[3];
+  };
+}
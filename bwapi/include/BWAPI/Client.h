@@ -14,4 +14,6 @@
 #include <BWAPI/Client/ShapeType.h>
 #include <BWAPI/Client/UnitCommand.h>
 #include <BWAPI/Client/UnitData.h>
+#include <BWAPI/Client/UnitHistory.h>
+#include <BWAPI/Client/UnitSnapshot.h>
 #include <BWAPI/Client/UnitImpl.h>
@@ -9,6 +9,7 @@
 #include "Event.h"
 #include "Command.h"
 #include "Shape.h"
+#include <BWAPI/TileLayer.h>
 namespace BWAPIC
 {
   struct Position
@@ -159,5 +160,12 @@ namespace BWAPI
     int unitSearchSize;
     unitFinder xUnitSearch[1700*2];
     unitFinder yUnitSearch[1700*2];
+
+    // tiles of each layer that changed on this frame, bit x % 32 of tileChanges[layer][y][x / 32]
+    unsigned int tileChanges[TileLayer::Max][256][256 / 32];
+
+    // blocks of 8x8 tiles with at least one change, (y / 8) * 32 + x / 8
+    int changedTileBlockCount;
+    unsigned short changedTileBlocks[(256 / TileLayer::BlockSize) * (256 / TileLayer::BlockSize)];
   };
 }
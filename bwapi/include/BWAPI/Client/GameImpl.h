@@ -11,6 +11,8 @@
 #include "RegionImpl.h"
 #include "UnitImpl.h"
 #include "BulletImpl.h"
+#include "UnitHistory.h"
+#include "UnitSnapshot.h"
 
 #include <list>
 #include <vector>
@@ -52,8 +54,10 @@ namespace BWAPI
       Bulletset bullets;
       Position::list nukeDots;
       Unitset selectedUnits;
-      Unitset pylons;
+      PowerGrid powerGrid;
+      TilePosition::list changedTileBlocks;
       Regionset regionsList;
+      RegionGraph regionGraph;
 
       TilePosition::list startLocations;
       std::list< Event > events;
@@ -65,7 +69,10 @@ namespace BWAPI
       Playerset _enemies;
       Playerset _observers;
       mutable Error lastError;
+      mutable DistanceBatch closestUnitCandidates;
       int textSize;
+      UnitHistory unitHistory;
+      UnitSnapshot unitSnapshot;
 
     public :
       Event makeEvent(BWAPIC::Event e);
@@ -78,6 +85,14 @@ namespace BWAPI
       const GameData* getGameData() const;
       Unit _unitFromIndex(int index);
 
+      /// Retrieves the per-unit position and hit point history, which is disabled until
+      /// UnitHistory::enable is called.
+      UnitHistory &getUnitHistory();
+
+      /// Retrieves the structure of arrays copy of all accessible units, which is not rebuilt
+      /// until UnitSnapshot::enable is called.
+      UnitSnapshot &getUnitSnapshot();
+
       virtual const Forceset& getForces() const override;
       virtual const Playerset& getPlayers() const override;
       virtual const Unitset& getAllUnits() const override;
@@ -133,7 +148,10 @@ namespace BWAPI
       virtual bool isVisible(int x, int y) const override;
       virtual bool isExplored(int x, int y) const override;
       virtual bool hasCreep(int x, int y) const override;
+      virtual bool isTileChanged(int x, int y, TileLayer::Enum layer) const override;
+      virtual const TilePosition::list &getChangedTileBlocks() const override;
       virtual bool hasPowerPrecise(int x, int y, UnitType unitType = UnitTypes::None ) const override;
+      virtual const PowerGrid &getPowerGrid() const override;
 
       virtual bool canBuildHere(TilePosition position, UnitType type, Unit builder = nullptr, bool checkExplored = false) override;
       virtual bool canMake(UnitType type, Unit builder = nullptr) const override;
@@ -194,6 +212,7 @@ namespace BWAPI
       virtual int  countdownTimer() const override;
       virtual const Regionset &getAllRegions() const override;
       virtual BWAPI::Region getRegionAt(int x, int y) const override;
+      virtual const RegionGraph &getRegionGraph() const override;
       virtual int getLastEventTime() const override;
       virtual bool setRevealAll(bool reveal = true) override;
   };
@@ -4,6 +4,7 @@
 #include <BWAPI/Client/RegionData.h>
 
 #include <BWAPI/Regionset.h>
+#include <BWAPI/RegionGraph.h>
 
 namespace BWAPI
 {
@@ -16,7 +17,7 @@ namespace BWAPI
     BWAPI::Region closestInaccessibleRgn;
   public:
     RegionImpl(int index);
-    void setNeighbors();
+    void setNeighbors(const RegionGraph &graph);
     virtual int getID() const override;
     virtual int getRegionGroupID() const override;
     virtual BWAPI::Position getCenter() const override;
@@ -0,0 +1,123 @@
+#pragma once
+#include <BWAPI/Position.h>
+#include <BWAPI/Unitset.h>
+#include <BWAPI/UnitMotion.h>
+
+#include <vector>
+
+namespace BWAPI
+{
+  /// The UnitHistory keeps the positions and hit points of every accessible unit over the last
+  /// few frames, and the current motion parameters of every accessible unit so that all of them
+  /// can be extrapolated in one pass.
+  ///
+  /// Recording is disabled by default. Once enabled, it is maintained by the client GameImpl at
+  /// the end of every frame. Each unit has a fixed-capacity ring buffer, and all buffers are
+  /// allocated once when recording is enabled.
+  ///
+  /// Example usage:
+  /// @code
+  ///   UnitHistory &history = static_cast<GameImpl*>(BroodwarPtr)->getUnitHistory();
+  ///   history.enable(24);
+  ///   // ... later
+  ///   Position before = history.getPosition(unit, 12);
+  /// @endcode
+  ///
+  /// @see UnitInterface::predictPosition
+  class UnitHistory
+  {
+  public:
+    /// The number of units that can be tracked, equal to the size of GameData::units.
+    static const int MAX_UNITS = 10000;
+
+    UnitHistory();
+
+    /// Enables recording and allocates the buffers.
+    ///
+    /// @param capacity
+    ///   The number of frames of history kept for each unit. If 0, then recording is disabled.
+    void enable(int capacity);
+
+    /// Disables recording and releases the buffers.
+    void disable();
+
+    /// Checks if recording is enabled.
+    bool isEnabled() const { return capacity > 0; };
+
+    /// Retrieves the number of frames of history kept for each unit.
+    int getCapacity() const { return capacity; };
+
+    /// Discards all recorded samples, without changing the capacity.
+    void clear();
+
+    /// Records a sample for each of the given units. Units that are not in the set lose their
+    /// history, since it is no longer contiguous.
+    ///
+    /// @note This is called by GameImpl::onMatchFrame.
+    void update(const Unitset &units);
+
+    /// Retrieves the number of consecutive frames of history recorded for a unit.
+    int getSampleCount(Unit unit) const;
+
+    /// Retrieves the recorded position of a unit.
+    ///
+    /// @param framesAgo (optional)
+    ///   The number of frames in the past, where 0 is the current frame.
+    ///
+    /// @returns The position of the unit at that frame.
+    /// @retval Positions::Unknown If there is no sample for that frame.
+    Position getPosition(Unit unit, int framesAgo = 0) const;
+
+    /// Retrieves the recorded hit points of a unit.
+    ///
+    /// @param framesAgo (optional)
+    ///   The number of frames in the past, where 0 is the current frame.
+    ///
+    /// @returns The hit points of the unit at that frame, or -1 if there is no sample for that
+    /// frame.
+    int getHitPoints(Unit unit, int framesAgo = 0) const;
+
+    /// Retrieves the units that were recorded in the current frame, in the same order as the
+    /// results of predictPositions.
+    const std::vector<Unit> &getUnits() const { return units; };
+
+    /// Predicts the position of every unit recorded in the current frame, in a single pass over
+    /// their motion parameters.
+    ///
+    /// @param frames
+    ///   The number of frames in the future to predict.
+    /// @param result
+    ///   Receives one position for each unit in getUnits.
+    ///
+    /// @see UnitMotion::predict
+    void predictPositions(int frames, std::vector<Position> &result) const;
+  private:
+    // Retrieves the buffer index of a sample, or -1 if it does not exist
+    int getSlot(Unit unit, int framesAgo) const;
+
+    int capacity;
+
+    // Per unit ring buffer state
+    std::vector<int> head;
+    std::vector<int> count;
+    std::vector<int> lastUpdate;
+    int updateCount;
+
+    // Samples, indexed by unit * capacity + slot
+    std::vector<int> x;
+    std::vector<int> y;
+    std::vector<int> hitPoints;
+
+    // Motion parameters of the current frame, one entry per unit in #units
+    std::vector<Unit> units;
+    std::vector<float> posX;
+    std::vector<float> posY;
+    std::vector<float> velocityX;
+    std::vector<float> velocityY;
+    std::vector<float> topSpeed;
+    std::vector<float> acceleration;
+    std::vector<float> range;
+    mutable std::vector<float> resultX;
+    mutable std::vector<float> resultY;
+  };
+}
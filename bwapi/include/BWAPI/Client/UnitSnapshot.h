@@ -0,0 +1,130 @@
+#pragma once
+#include <BWAPI/Position.h>
+#include <BWAPI/Unitset.h>
+
+#include <vector>
+#include <cstddef>
+
+namespace BWAPI
+{
+  /// The UnitSnapshot is a copy of the most commonly used properties of every accessible unit,
+  /// stored as parallel arrays (a structure of arrays). Computations over a whole army, such as
+  /// sums, centroids, or influence maps, can then run as tight loops over contiguous memory
+  /// instead of following Unit pointers through a hash set.
+  ///
+  /// The snapshot is disabled by default. Once enabled, it is rebuilt by the client GameImpl at
+  /// the end of every frame. The arrays are reused between frames, so rebuilding does not
+  /// allocate once the largest unit count has been reached.
+  ///
+  /// Example usage:
+  /// @code
+  ///   UnitSnapshot &snapshot = static_cast<GameImpl*>(BroodwarPtr)->getUnitSnapshot();
+  ///   snapshot.enable();
+  ///   // ... later
+  ///   std::vector<int> army;
+  ///   snapshot.filter(Broodwar->enemy()->getID(), UnitSnapshot::Completed, UnitSnapshot::Building, army);
+  ///   Position center = snapshot.getCentroid(army);
+  /// @endcode
+  class UnitSnapshot
+  {
+  public:
+    /// Flags describing the state of each unit.
+    enum Flags
+    {
+      Completed   = 1 << 0,
+      Flying      = 1 << 1,
+      Building    = 1 << 2,
+      Worker      = 1 << 3,
+      Cloaked     = 1 << 4,
+      Burrowed    = 1 << 5,
+      Detected    = 1 << 6,
+      Visible     = 1 << 7,
+      Moving      = 1 << 8,
+      Attacking   = 1 << 9,
+      UnderAttack = 1 << 10,
+      Idle        = 1 << 11,
+      Loaded      = 1 << 12
+    };
+
+    UnitSnapshot();
+
+    /// Enables or disables rebuilding the snapshot every frame.
+    void enable(bool enabled = true);
+
+    /// Checks if the snapshot is rebuilt every frame.
+    bool isEnabled() const { return enabled; };
+
+    /// Rebuilds the snapshot from the given units.
+    ///
+    /// @note This is called by GameImpl::onMatchFrame when the snapshot is enabled.
+    void update(const Unitset &units);
+
+    /// Removes all units from the snapshot.
+    void clear();
+
+    /// Retrieves the number of units in the snapshot.
+    size_t size() const { return units.size(); };
+
+    /// Checks if the snapshot contains no units.
+    bool empty() const { return units.empty(); };
+
+    /// Retrieves the unit at the given index of the arrays.
+    Unit getUnit(size_t index) const { return units[index]; };
+
+    /// The parallel arrays, each containing size() values.
+    const std::vector<Unit> &getUnits() const { return units; };
+    const std::vector<int> &getIDs() const { return ids; };
+    const std::vector<int> &getPlayers() const { return players; };
+    const std::vector<int> &getTypes() const { return types; };
+    const std::vector<int> &getX() const { return x; };
+    const std::vector<int> &getY() const { return y; };
+    const std::vector<int> &getHitPoints() const { return hitPoints; };
+    const std::vector<int> &getShields() const { return shields; };
+    const std::vector<unsigned int> &getFlags() const { return flags; };
+
+    /// Calls a function with the index of every unit in the snapshot.
+    ///
+    /// @param callback
+    ///   A function taking a size_t index.
+    template <typename _T>
+    void forEach(const _T &callback) const
+    {
+      for ( size_t i = 0; i < units.size(); ++i )
+        callback(i);
+    }
+
+    /// Selects the units that belong to a player and match a set of flags.
+    ///
+    /// @param playerID
+    ///   The ID of the player, or -1 to include every player.
+    /// @param requiredFlags
+    ///   The Flags that a unit must have.
+    /// @param excludedFlags
+    ///   The Flags that a unit must not have, or 0 to exclude none.
+    /// @param result
+    ///   Receives the indexes of the selected units.
+    ///
+    /// @returns The number of units selected.
+    size_t filter(int playerID, unsigned int requiredFlags, unsigned int excludedFlags, std::vector<int> &result) const;
+
+    /// Computes the average position of the units at the given indexes.
+    ///
+    /// @returns The average position, or Positions::Invalid if \p indexes is empty.
+    Position getCentroid(const std::vector<int> &indexes) const;
+
+    /// Computes the sum of the hit points and shields of the units at the given indexes.
+    int getTotalHealth(const std::vector<int> &indexes) const;
+  private:
+    bool enabled;
+
+    std::vector<Unit> units;
+    std::vector<int> ids;
+    std::vector<int> players;
+    std::vector<int> types;
+    std::vector<int> x;
+    std::vector<int> y;
+    std::vector<int> hitPoints;
+    std::vector<int> shields;
+    std::vector<unsigned int> flags;
+  };
+}
@@ -0,0 +1,131 @@
+#pragma once
+#include <vector>
+#include <cstddef>
+
+#include <BWAPI/Position.h>
+#include <BWAPI/PositionUnit.h>
+
+namespace BWAPI
+{
+  // Forward Declarations
+  class UnitInterface;
+  typedef UnitInterface *Unit;
+  class Unitset;
+
+  /// The DistanceBatch is a snapshot of the bounding boxes of a group of units, stored as a
+  /// structure of arrays so that the distance to a single target can be computed for every unit
+  /// at once using SIMD instructions.
+  ///
+  /// Every distance produced is identical to the one produced by UnitInterface::getDistance or
+  /// Point::getApproxDistance, including Broodwar's rounding. The vectorized kernels are selected
+  /// at compile time (AVX2, then SSE2), and a scalar implementation is used otherwise and for the
+  /// remainder of each batch.
+  ///
+  /// Example usage:
+  /// @code
+  ///   DistanceBatch batch(Broodwar->self()->getUnits());
+  ///   Unit closest = batch.getClosestUnit(Broodwar->enemy()->getStartLocation());
+  /// @endcode
+  ///
+  /// @note The snapshot is not updated when the units move. It is intended to be built once and
+  /// queried many times within the same frame. A single batch must not be queried from multiple
+  /// threads at the same time.
+  ///
+  /// @see Unitset::getDistances
+  class DistanceBatch
+  {
+  public:
+    /// Computes Point::getApproxDistance from every point to the target.
+    ///
+    /// @param x
+    ///   An array of \p count x coordinates.
+    /// @param y
+    ///   An array of \p count y coordinates.
+    /// @param count
+    ///   The number of points.
+    /// @param target
+    ///   The point to measure the distance to.
+    /// @param result
+    ///   An array of at least \p count integers that receives the distances.
+    static void getApproxDistances(const int *x, const int *y, size_t count, Position target, int *result);
+
+    /// Computes the approximate distance between the edges of every box and a target box. This
+    /// is the calculation used by UnitInterface::getDistance.
+    ///
+    /// @param left
+    ///   An array of \p count left edges, and likewise for \p top, \p right, and \p bottom.
+    /// @param count
+    ///   The number of boxes.
+    /// @param targetLeft
+    ///   The bounds of the target box, and likewise for \p targetTop, \p targetRight, and
+    ///   \p targetBottom.
+    /// @param result
+    ///   An array of at least \p count integers that receives the distances.
+    static void getEdgeDistances(const int *left, const int *top, const int *right, const int *bottom, size_t count,
+                                 int targetLeft, int targetTop, int targetRight, int targetBottom, int *result);
+
+    /// Retrieves the name of the instruction set that the kernels were compiled with.
+    ///
+    /// @returns One of "AVX2", "SSE2", or "Scalar".
+    static const char *getInstructionSet();
+
+    /// Constructs an empty batch.
+    DistanceBatch() = default;
+
+    /// Constructs a batch from the given units, in iteration order.
+    explicit DistanceBatch(const Unitset &units);
+
+    /// Replaces the contents of this batch with the given units, in iteration order.
+    void assign(const Unitset &units);
+
+    /// Appends a single unit to the batch.
+    void add(Unit unit);
+
+    /// Removes all units from the batch.
+    void clear();
+
+    /// Retrieves the number of units in the batch.
+    size_t size() const { return units.size(); };
+
+    /// Checks if the batch is empty.
+    bool empty() const { return units.empty(); };
+
+    /// Retrieves the units in the batch, in the order they were added.
+    const std::vector<Unit> &getUnits() const { return units; };
+
+    /// Computes UnitInterface::getDistance from every unit in the batch to the target.
+    ///
+    /// @param target
+    ///   The position or unit to measure the distance to.
+    /// @param result
+    ///   An array of at least size() integers that receives the distances. Units that did not
+    ///   exist when they were added, and the target unit itself, receive
+    ///   std::numeric_limits<int>::max().
+    void getDistances(PositionOrUnit target, int *result) const;
+
+    /// @overload
+    std::vector<int> getDistances(PositionOrUnit target) const;
+
+    /// Retrieves the unit in the batch that is closest to the target.
+    ///
+    /// @param target
+    ///   The position or unit to measure the distance to.
+    /// @param radius (optional)
+    ///   The maximum distance that a unit can be from the target.
+    /// @param distance (optional)
+    ///   If not nullptr, receives the distance of the unit that was found.
+    ///
+    /// @returns The closest unit, or nullptr if no unit is within \p radius. If multiple units
+    /// are equally close, then the one that was added first is returned.
+    Unit getClosestUnit(PositionOrUnit target, int radius = 999999, int *distance = nullptr) const;
+
+  private:
+    std::vector<Unit> units;
+    std::vector<size_t> missing;
+    std::vector<int> left;
+    std::vector<int> top;
+    std::vector<int> right;
+    std::vector<int> bottom;
+    mutable std::vector<int> scratch;
+  };
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <BWAPI/Position.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BWAPI
+{
+  /// The FlowFields class computes, for a destination region, the direction that a ground unit
+  /// on any walk tile of the map should move in to reach it. Moving a large group of units to
+  /// the same region then only needs one field instead of a path query per unit.
+  ///
+  /// A field is computed in two passes. The region pass runs Dijkstra's algorithm over the
+  /// region neighbor graph and finds the next region to enter from every region, which is
+  /// cheap and done as soon as a destination is requested. The walk tile pass then runs
+  /// Dijkstra's algorithm over the walkable walk tiles from the destination, with the same
+  /// move rules as the Pathfinder, and stores the best of the 8 directions for every tile.
+  /// Until the walk tile pass is done, directions point towards the next region instead.
+  ///
+  /// The destination of a region is its walkable walk tile closest to the average position of
+  /// its walkable walk tiles. Fields are computed for units that fit on a single walk tile, so
+  /// large units may get stuck on narrow passages that small units can walk through.
+  ///
+  /// Walk tile passes run on a worker thread by default, and completed fields are kept in a
+  /// least recently used cache keyed by destination region.
+  ///
+  /// Example usage:
+  /// @code
+  ///   FlowFields &flow = MapAnalysis::getFlowFields();
+  ///   int target = Broodwar->getRegionAt(attackPosition)->getID();
+  ///   for ( auto u : army )
+  ///   {
+  ///     WalkPosition direction = flow.getFlowDirection(WalkPosition(u->getPosition()), target);
+  ///     u->move(u->getPosition() + Position(direction) * 4);
+  ///   }
+  /// @endcode
+  ///
+  /// @note All members except build and clear can be called from several threads at once.
+  ///
+  /// @note The destructor stops and joins the worker thread. A FlowFields object that is
+  /// destroyed while a library is unloaded would deadlock on the loader lock, so a static
+  /// object must be cleared before its library is unloaded.
+  ///
+  /// @see MapAnalysis::getFlowFields, Pathfinder
+  class FlowFields
+  {
+  public:
+    FlowFields();
+
+    /// Stops the worker thread and waits for it to finish.
+    ~FlowFields();
+
+    /// Stores the map and finds the destination tile of each region.
+    ///
+    /// @param width
+    ///   The width of the map, in walk tiles.
+    /// @param height
+    ///   The height of the map, in walk tiles.
+    /// @param walkable
+    ///   Whether each walk tile is walkable, indexed by y * width + x.
+    /// @param regionIds
+    ///   The region of each walk tile, or -1 if it has none.
+    /// @param regionNeighbors
+    ///   The regions that can be walked to directly from each region, indexed by region ID.
+    void build(int width, int height, const std::vector<bool> &walkable,
+               const std::vector<int> &regionIds, const std::vector< std::vector<int> > &regionNeighbors);
+
+    /// Stops the worker thread and removes all data, including the cache.
+    void clear();
+
+    /// Checks if the map has been stored.
+    bool isBuilt() const { return width > 0; };
+
+    /// Retrieves the direction to move in from a walk tile to reach a region.
+    ///
+    /// If the field of the region is not in the cache, then it is requested and the direction
+    /// points towards the next region on the way until the field is ready.
+    ///
+    /// @param position
+    ///   The walk tile that the unit is on.
+    /// @param destinationId
+    ///   The ID of the destination region.
+    ///
+    /// @returns A walk tile offset whose x and y are each -1, 0, or 1. It is (0,0) if the unit
+    /// has arrived at the destination tile, the region is not accessible, or there is no ground
+    /// path from \p position.
+    WalkPosition getFlowDirection(WalkPosition position, int destinationId);
+
+    /// Requests the field of a region without querying it, so that it is ready when needed.
+    ///
+    /// @returns true if the region has a destination tile, and false otherwise.
+    bool request(int destinationId);
+
+    /// Checks if the walk tile pass of a region is done and in the cache.
+    bool isReady(int destinationId) const;
+
+    /// Waits until the worker thread has computed every requested field.
+    void waitUntilIdle();
+
+    /// Retrieves the destination tile of a region, or WalkPositions::None if it has none.
+    WalkPosition getDestination(int destinationId) const;
+
+    /// Sets whether walk tile passes run on the worker thread. The default is true. When
+    /// disabled, fields are computed by the thread that requests them.
+    void setBackgroundComputation(bool enabled);
+
+    /// Sets the maximum number of fields in the cache. The default is 32, with each field
+    /// using one byte per walk tile.
+    void setCacheSize(size_t size);
+
+    /// Retrieves the maximum number of fields in the cache.
+    size_t getCacheSize() const;
+
+    /// Removes all fields from the cache.
+    void clearCache();
+
+    /// Retrieves the number of requests that reused a cache entry.
+    unsigned int getCacheHits() const;
+
+    /// Retrieves the number of requests that required a new cache entry.
+    unsigned int getCacheMisses() const;
+  private:
+    struct CacheEntry
+    {
+      int destination;
+      bool queued;
+      std::vector<int> nextRegion;
+      std::vector<std::uint8_t> directions;
+    };
+
+    bool isValidDestination(int destinationId) const;
+    CacheEntry *getEntry(int destinationId);
+    void evict(size_t size);
+    void computeRegions(int destinationId, std::vector<int> &nextRegion) const;
+    void computeField(int destinationId, std::vector<std::uint8_t> &directions,
+                      std::vector<int> &cost, std::vector< std::pair<int,int> > &open) const;
+    void startWorker();
+    void stopWorker();
+    void runWorker();
+
+    // Map data, which does not change between build and clear
+    int width;
+    int height;
+    std::vector<std::uint8_t> passable;
+    std::vector<int> regionIds;
+    std::vector< std::vector<int> > regionNeighbors;
+    std::vector<WalkPosition> destinations;
+
+    // Field cache, most recently used first
+    mutable std::mutex mutex;
+    size_t cacheSize;
+    unsigned int cacheHits;
+    unsigned int cacheMisses;
+    std::list<CacheEntry> cache;
+    std::unordered_map<int, std::list<CacheEntry>::iterator> cacheIndex;
+
+    // Worker thread and the destinations waiting for their walk tile pass
+    bool background;
+    bool stopping;
+    int busy;
+    std::deque<int> pending;
+    std::thread worker;
+    std::condition_variable wakeup;
+    std::condition_variable idle;
+  };
+}
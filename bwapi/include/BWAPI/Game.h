@@ -1,12 +1,15 @@
 #pragma once
 #include <list>
 #include <string>
+#include <utility>
+#include <vector>
 #include <cstdarg>
 
 #include <BWAPI/Interface.h>
 #include <BWAPI/UnitType.h>
 #include <BWAPI/Error.h>
 #include <BWAPI/Color.h>
+#include <BWAPI/TileLayer.h>
 
 #include <BWAPI/Filters.h>
 #include <BWAPI/UnaryFilter.h>
@@ -28,11 +31,13 @@ namespace BWAPI
   class PlayerInterface;
   typedef PlayerInterface *Player;
   class Playerset;
+  class PowerGrid;
   class Race;
   
   class RegionInterface;
   typedef RegionInterface *Region;
 
+  class RegionGraph;
   class Regionset;
   class TechType;
   class UnitCommand;
@@ -1265,6 +1270,70 @@ namespace BWAPI
     /// @retval false if there is no path
     bool hasPath(Position source, Position destination) const;
 
+    /// Retrieves the approximate length of the shortest ground path between two positions.
+    ///
+    /// The distances between all regions are computed once when the match starts. Within the
+    /// source and destination regions, the straight line distance to the best entry and exit
+    /// regions is added, so the result is usually within a few percent of a walk tile search
+    /// while being answered in constant time.
+    ///
+    /// @param source
+    ///   The source position.
+    /// @param destination
+    ///   The destination position.
+    ///
+    /// @returns The distance in pixels, or -1 if there is no ground path between the two
+    /// positions.
+    ///
+    /// @see hasPath, MapAnalysis::getRegionDistances
+    int getGroundDistance(Position source, Position destination) const;
+
+    /// Finds a ground path between two positions on the walk tile grid, taking the size of
+    /// the unit into account.
+    ///
+    /// @param source
+    ///   The source position.
+    /// @param destination
+    ///   The destination position.
+    /// @param path
+    ///   Receives the turning points of the path, starting with \p source and ending with
+    ///   \p destination.
+    /// @param type (optional)
+    ///   The type of unit that will follow the path. Gaps that are too small for this type are
+    ///   avoided. If UnitTypes::None, then every walkable gap is used.
+    ///
+    /// @returns The length of the path in pixels, or -1 if there is no ground path.
+    ///
+    /// @note Recent paths are cached by source region, destination region and unit size, so
+    /// repeated queries between the same places are answered without searching again.
+    ///
+    /// @see getGroundDistance, MapAnalysis::getPathfinder
+    int getGroundPath(Position source, Position destination, std::vector<Position> &path, UnitType type = UnitTypes::None) const;
+
+    /// Retrieves the distance from a walk tile to the nearest walk tile that is blocked by
+    /// terrain, a static building, a resource, or the edge of the map.
+    ///
+    /// @param position
+    ///   The walk tile to check.
+    ///
+    /// @returns The distance in pixels, or 0 if \p position is blocked or invalid.
+    ///
+    /// @see isPassable, MapAnalysis::getClearanceMap
+    int getClearance(WalkPosition position) const;
+
+    /// Checks if a ground unit of the given type has enough room to stand with its center on a
+    /// walk tile, ignoring other units.
+    ///
+    /// @param position
+    ///   The walk tile to check.
+    /// @param type
+    ///   The type of the unit.
+    ///
+    /// @returns true if the unit fits on \p position, and false otherwise.
+    ///
+    /// @see getClearance
+    bool isPassable(WalkPosition position, UnitType type) const;
+
     /// Sets the alliance state of the current player with the target player.
     ///
     /// @param player
@@ -1458,6 +1527,32 @@ namespace BWAPI
     ///   A TilePosition containing the location that the structure should be constructed at.
     TilePosition getBuildLocation(UnitType type, TilePosition desiredPosition, int maxRange = 64, bool creep = false) const;
 
+    /// Retrieves build locations for several structures at once, as if construction of each
+    /// structure had started before the next one is placed. The result for each request is
+    /// the same as a call to getBuildLocation made at that point, but the units are examined
+    /// only once and the buildability of each tile is checked only once per unit type, so this
+    /// is much faster than calling getBuildLocation repeatedly.
+    ///
+    /// @param requests
+    ///   A list of unit types and their desired placement positions, in the order in which
+    ///   they are placed.
+    /// @param maxRange (optional)
+    ///   The maximum distance (in tiles) to build from each desired position.
+    /// @param creep (optional)
+    ///   A special boolean value that changes the behaviour of @Creep_Colony placement.
+    ///
+    /// @returns
+    ///   A list with one TilePosition for each request, in the same order. It contains
+    ///   TilePositions::None if no location was found, and TilePositions::Invalid if the unit
+    ///   type is not a structure, in which case the last error is set to
+    ///   Errors::Incompatible_UnitType.
+    ///
+    /// @note Planned structures reserve their tiles and the space around them, but they are not
+    /// completed, so planned pylons do not provide power and planned resource depots do not
+    /// reserve the space around them.
+    /// @see getBuildLocation
+    std::vector<TilePosition> getBuildLocations(const std::vector< std::pair<UnitType, TilePosition> > &requests, int maxRange = 64, bool creep = false) const;
+
     /// Calculates the damage received for a given player. It can be understood as the damage from
     /// \p fromType to \p toType. Does not include shields in calculation. Includes upgrades if
     /// players are provided.
@@ -1498,6 +1593,48 @@ namespace BWAPI
     /// @returns The amount of damage that fromType would deal to toType.
     /// @see getDamageFrom
     int getDamageTo(UnitType toType, UnitType fromType, Player toPlayer = nullptr, Player fromPlayer = nullptr) const;
+
+    /// Retrieves the number of owned and completed @Protoss_Pylon that power each build tile.
+    /// Use it to scan whole areas for power instead of calling hasPower for every tile.
+    ///
+    /// @returns A PowerGrid that is updated when one of your pylons is completed or destroyed,
+    /// and when a completed pylon is taken by you or from you.
+    /// @see hasPowerPrecise
+    virtual const PowerGrid &getPowerGrid() const = 0;
+
+    /// Checks if the value of a tile in one of the dynamic tile layers changed since the
+    /// previous frame. On the first frame of a match, every tile whose value is true is reported
+    /// as changed.
+    ///
+    /// @param tileX
+    ///   The x tile coordinate to check.
+    /// @param tileY
+    ///   The y tile coordinate to check.
+    /// @param layer
+    ///   The layer to check.
+    ///
+    /// @retval true If the value of the tile in the given layer changed on this frame.
+    /// @retval false If the value did not change, or if the tile is outside of the map.
+    /// @see getChangedTileBlocks
+    virtual bool isTileChanged(int tileX, int tileY, TileLayer::Enum layer) const = 0;
+    /// @overload
+    bool isTileChanged(TilePosition position, TileLayer::Enum layer) const;
+
+    /// Retrieves the blocks of TileLayer::BlockSize x TileLayer::BlockSize tiles that contain at
+    /// least one tile whose visibility, exploration, creep, or occupation changed since the
+    /// previous frame. Use it to update grids that mirror these layers by scanning only the
+    /// changed blocks with isTileChanged, instead of the whole map.
+    ///
+    /// @returns A list containing the position of the top left tile of each changed block.
+    /// @see isTileChanged
+    virtual const TilePosition::list &getChangedTileBlocks() const = 0;
+
+    /// Retrieves the regions of the map as flat arrays, for code that walks the region graph
+    /// many times per frame.
+    ///
+    /// @returns A RegionGraph that is computed when the match starts.
+    /// @see getRegionAt, getAllRegions
+    virtual const RegionGraph &getRegionGraph() const = 0;
   };
 
   extern Game *BroodwarPtr;
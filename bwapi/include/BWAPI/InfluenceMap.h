@@ -0,0 +1,171 @@
+#pragma once
+#include <BWAPI/Position.h>
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+namespace BWAPI
+{
+  // Forward Declarations
+  class UnitInterface;
+  typedef UnitInterface *Unit;
+  class Unitset;
+
+  /// The InfluenceMap class sums the threat of a group of units over a grid of cells, with one
+  /// layer for ground targets and one for air targets.
+  ///
+  /// Each source adds its value to every cell whose center is within its radius of the center of
+  /// the cell containing the source. Since discs are centered on cells, a source that moves
+  /// within its cell does not change the map, and when it moves to another cell or its weapon
+  /// changes, only its old disc is removed and the new one added. Discs are stamped row by row,
+  /// adding to each row span with SIMD instructions (AVX2, then SSE2) where available.
+  ///
+  /// Cells are either walk tiles or build tiles. Values are 32 bit integers, so adding and
+  /// removing a disc always restores the exact previous values.
+  ///
+  /// Example usage:
+  /// @code
+  ///   InfluenceMap threats;
+  ///   threats.reset(Broodwar->mapWidth(), Broodwar->mapHeight(), InfluenceMap::WalkResolution);
+  ///   // Every frame
+  ///   threats.update(Broodwar->enemy()->getUnits());
+  ///   if ( threats.getValue(InfluenceMap::Ground, myUnit->getPosition()) > 0 )
+  ///     myUnit->move(retreatPosition);
+  /// @endcode
+  class InfluenceMap
+  {
+  public:
+    /// The size of a cell, in pixels, when cells are walk tiles.
+    static const int WalkResolution = 8;
+
+    /// The size of a cell, in pixels, when cells are build tiles.
+    static const int TileResolution = 32;
+
+    /// The layers of the map.
+    enum Layer
+    {
+      /// Threat to ground units.
+      Ground = 0,
+
+      /// Threat to air units.
+      Air = 1,
+
+      LayerCount
+    };
+
+    /// Removes all sources and resizes the map.
+    ///
+    /// @param mapWidth
+    ///   The width of the map, in build tiles.
+    /// @param mapHeight
+    ///   The height of the map, in build tiles.
+    /// @param resolution (optional)
+    ///   The size of a cell in pixels, either WalkResolution or TileResolution.
+    void reset(int mapWidth, int mapHeight, int resolution = TileResolution);
+
+    /// Removes all sources and data.
+    void clear();
+
+    /// Adds a source, or moves and updates an existing one.
+    ///
+    /// @param id
+    ///   A non-negative identifier of the source, such as the ID of a unit.
+    /// @param position
+    ///   The position of the source, in pixels.
+    /// @param groundRadius
+    ///   The radius of the disc of the ground layer, in pixels.
+    /// @param groundValue
+    ///   The value added to the ground layer, or 0 for none.
+    /// @param airRadius
+    ///   The radius of the disc of the air layer, in pixels.
+    /// @param airValue
+    ///   The value added to the air layer, or 0 for none.
+    void setSource(int id, Position position, int groundRadius, int groundValue, int airRadius, int airValue);
+
+    /// Removes a source.
+    ///
+    /// @returns true if the source was removed, and false if it was not in the map.
+    bool removeSource(int id);
+
+    /// Retrieves the number of sources in the map.
+    int getSourceCount() const { return static_cast<int>(activeSources.size()); };
+
+    /// Adds, moves, or removes the threat of a unit.
+    ///
+    /// The value of each layer is the damage of the unit's weapon against that layer, including
+    /// upgrades, per frame of weapon cooldown and scaled by 256. The radius is the maximum range
+    /// of the weapon, including upgrades, plus half of the largest dimension of the unit. Units
+    /// that no longer exist, are not completed, or have no weapon are removed.
+    ///
+    /// A @Reaver threatens ground units with the weapon of its scarabs, and a @Carrier threatens
+    /// both layers with the weapons of its interceptors, or of 4 interceptors when their number
+    /// is not known. Both reach as far as their seek range. A @Bunker has the threat of its
+    /// loaded units, with one more tile of range, or of 4 @Marines when they are not known.
+    void updateUnit(Unit unit);
+
+    /// Updates the threat of every unit of a set, and removes the sources of all other units.
+    ///
+    /// This is the only call needed each frame to keep the map in sync with a set of units,
+    /// such as the units of the enemy players. BWAPI has no event for unit movement, so the
+    /// units are polled, but only the sources that changed cell, range, or value are stamped
+    /// again.
+    void update(const Unitset &units);
+
+    /// Retrieves the value of a cell.
+    ///
+    /// @param layer
+    ///   The layer to read.
+    /// @param x
+    ///   The x coordinate of the cell.
+    /// @param y
+    ///   The y coordinate of the cell.
+    ///
+    /// @returns The sum of the values of the sources covering the cell, or 0 if the cell is
+    /// outside of the map.
+    int getValue(Layer layer, int x, int y) const;
+
+    /// Retrieves the value of the cell containing a position, in pixels.
+    int getValue(Layer layer, Position position) const;
+
+    /// Retrieves the size of a cell, in pixels.
+    int getResolution() const { return resolution; };
+
+    /// Retrieves the width of the map, in cells.
+    int getWidth() const { return width; };
+
+    /// Retrieves the height of the map, in cells.
+    int getHeight() const { return height; };
+
+    /// Retrieves the raw values of a layer, indexed by y * getWidth() + x.
+    const std::vector<std::int32_t> &getLayer(Layer layer) const { return layers[layer]; };
+
+    /// Retrieves the name of the instruction set used to stamp discs, for diagnostics.
+    ///
+    /// @returns "AVX2", "SSE2", or "Scalar".
+    static const char *getInstructionSet();
+  private:
+    struct Source
+    {
+      bool active = false;
+      int index = 0;
+      unsigned int lastUpdate = 0;
+      int cellX = 0;
+      int cellY = 0;
+      int radius[LayerCount];
+      int value[LayerCount];
+    };
+
+    void stamp(Layer layer, int cellX, int cellY, int radius, int value);
+    const std::vector<int> &getSpans(int radius);
+
+    int resolution = TileResolution;
+    int width = 0;
+    int height = 0;
+    unsigned int updateCount = 0;
+    std::vector<std::int32_t> layers[LayerCount];
+    std::vector<Source> sources;
+    std::vector<int> activeSources;
+    std::map< int, std::vector<int> > spans;
+  };
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <BWAPI/ClearanceMap.h>
+#include <BWAPI/FlowFields.h>
+#include <BWAPI/Pathfinder.h>
+#include <BWAPI/RegionDistances.h>
+#include <BWAPI/TerrainAnalysis.h>
+
+namespace BWAPI
+{
+  /// The MapAnalysis namespace holds data that is computed from the static terrain of the
+  /// current map and shared by the queries in Game that need it.
+  ///
+  /// Every module links its own copy of this data. It is computed when the match starts, with
+  /// the independent analyses built on separate threads, and released at the end of the match.
+  /// If the copy was not told that the match started, or lazy building was enabled, then each
+  /// analysis is instead computed the first time that any thread requests it.
+  namespace MapAnalysis
+  {
+    /// Releases any analysis left from a previous map and computes the analysis of the map that
+    /// was just loaded, unless lazy building is enabled.
+    ///
+    /// @note This is called by GameImpl when a match starts. A module loaded into BWAPI calls it
+    /// from its gameInit function, so that its own copy is also computed before the first frame.
+    void onMatchStart();
+
+    /// Releases the analysis of the previous map and stops the flow field worker thread.
+    ///
+    /// @note This is called by GameImpl when a match ends. A module loaded into BWAPI calls it
+    /// from its gameEnd function, which BWAPI calls before unloading the module's library.
+    void onMatchEnd();
+
+    /// Retrieves the shortest ground distances between regions, computing them if needed.
+    ///
+    /// @note The getters can be called from several threads. If the analysis was not computed
+    /// when the match started, then the first call computes it while the others wait.
+    ///
+    /// @see Game::getGroundDistance
+    const RegionDistances &getRegionDistances();
+
+    /// Retrieves the walk tile pathfinder, building it if needed.
+    ///
+    /// @see Game::getGroundPath
+    Pathfinder &getPathfinder();
+
+    /// Retrieves the free space around each walk tile, computing it if needed.
+    ///
+    /// @see Game::getClearance, Game::isPassable
+    const ClearanceMap &getClearanceMap();
+
+    /// Retrieves the flow fields towards each region, storing the map if needed. Fields are
+    /// computed on a worker thread when first requested.
+    FlowFields &getFlowFields();
+
+    /// Enables or disables the terrain analysis cache files. The cache is enabled by default.
+    ///
+    /// @see getTerrainAnalysis
+    void enableTerrainCache(bool enabled = true);
+
+    /// Enables or disables lazy building. When it is enabled, onMatchStart only releases the
+    /// previous map, and each analysis is computed when it is first requested, so that a
+    /// module which does not use them does not pay for them. It is disabled by default.
+    ///
+    /// @note Lazily built analyses read the map from the thread that first requests them.
+    void enableLazyBuild(bool enabled = true);
+
+    /// Retrieves the resource clusters, base locations, and choke points of the map, analyzing
+    /// it if needed.
+    ///
+    /// If the cache is enabled, then the analysis is loaded from
+    /// bwapi-data/read/terrain-<hash>.dat or bwapi-data/write/terrain-<hash>.dat, where <hash>
+    /// is Game::mapHash. If neither file exists, then the map is analyzed and the result is
+    /// written to the second file.
+    ///
+    /// @see enableTerrainCache
+    const TerrainAnalysis &getTerrainAnalysis();
+  }
+}
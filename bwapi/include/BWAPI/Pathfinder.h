@@ -0,0 +1,184 @@
+#pragma once
+#include <BWAPI/Position.h>
+#include <BWAPI/UnitType.h>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace BWAPI
+{
+  /// The Pathfinder class finds ground paths on the walk tile grid using jump point search.
+  ///
+  /// Units are treated as squares of walk tiles. A unit of size N can stand on a tile if the
+  /// NxN square starting there is walkable, which is looked up in a clearance grid computed
+  /// when the pathfinder is built. Diagonal moves are only allowed when both adjacent straight
+  /// moves are also possible, so paths never cut through corners.
+  ///
+  /// Before searching the grid, a breadth first search over the region graph finds the
+  /// regions that the path will most likely cross. The grid search is restricted to those
+  /// regions and their neighbors, which keeps it small on large maps, and it falls back to
+  /// the whole map if no path exists inside that corridor. Queries between regions that are
+  /// not connected fail without searching the grid at all.
+  ///
+  /// Recent searches are kept in a least recently used cache keyed by source region,
+  /// destination region and unit size. A query with the same key reuses the region corridor,
+  /// and a query with the same end points returns the stored path directly.
+  ///
+  /// @note The pathfinder keeps its search state in the object, so one instance must not be
+  /// used by several threads at the same time.
+  ///
+  /// @see Game::getGroundPath, MapAnalysis::getPathfinder
+  class Pathfinder
+  {
+  public:
+    Pathfinder();
+
+    /// Builds the clearance grid and region graph.
+    ///
+    /// @param width
+    ///   The width of the map, in walk tiles.
+    /// @param height
+    ///   The height of the map, in walk tiles.
+    /// @param walkable
+    ///   Whether each walk tile is walkable, indexed by y * width + x.
+    /// @param regionIds (optional)
+    ///   The region of each walk tile, or -1 if it has none. If empty, or if there are 2^24 - 1
+    ///   regions or more, then the region pass is skipped and the whole map is always searched.
+    /// @param regionNeighbors (optional)
+    ///   The regions that can be walked to directly from each region, indexed by region ID.
+    void build(int width, int height, const std::vector<bool> &walkable,
+               const std::vector<int> &regionIds = std::vector<int>(),
+               const std::vector< std::vector<int> > &regionNeighbors = std::vector< std::vector<int> >());
+
+    /// Removes all data, including the cache.
+    void clear();
+
+    /// Checks if the pathfinder has been built.
+    bool isBuilt() const { return width > 0; };
+
+    /// Retrieves the size of a unit type, in walk tiles.
+    static int getUnitSize(UnitType type);
+
+    /// Retrieves the size of the largest square of walkable tiles starting at the given walk tile.
+    int getClearance(WalkPosition position) const;
+
+    /// Finds a ground path between two walk tiles.
+    ///
+    /// @param source
+    ///   The walk tile that the center of the unit starts on.
+    /// @param destination
+    ///   The walk tile that the center of the unit should reach.
+    /// @param unitSize
+    ///   The size of the unit, in walk tiles.
+    /// @see getUnitSize
+    /// @param path
+    ///   Receives the turning points of the path, including both end points.
+    ///
+    /// @returns The length of the path in pixels, or -1 if there is no path. In that case
+    /// \p path is empty.
+    ///
+    /// @note When a path is found inside the region corridor, it is the shortest path inside
+    /// the corridor, and it is returned without searching the whole map. A shorter path that
+    /// leaves the corridor, for example through a region that is not on the fewest-regions
+    /// route, is not considered.
+    int findPath(WalkPosition source, WalkPosition destination, int unitSize, std::vector<WalkPosition> &path);
+
+    /// Sets the maximum number of entries in the path cache. The default is 256.
+    void setCacheSize(size_t size);
+
+    /// Retrieves the maximum number of entries in the path cache.
+    size_t getCacheSize() const { return cacheSize; };
+
+    /// Removes all entries from the path cache.
+    void clearCache();
+
+    /// Retrieves the number of queries that reused a cache entry.
+    unsigned int getCacheHits() const { return cacheHits; };
+
+    /// Retrieves the number of queries that required a new cache entry.
+    unsigned int getCacheMisses() const { return cacheMisses; };
+  private:
+    // One bit per tile, packed into 32 bit words along each line
+    struct BitGrid
+    {
+      int lines = 0;
+      int length = 0;
+      int stride = 0;
+      std::vector<std::uint32_t> bits;
+    };
+
+    // A horizontal or vertical run of tiles in the same region
+    struct Run
+    {
+      int line;
+      int first;
+      int last;
+    };
+
+    struct CacheEntry
+    {
+      std::uint64_t key;
+      WalkPosition source;
+      WalkPosition destination;
+      int length;
+      std::vector<WalkPosition> path;
+      std::vector<int> corridor;
+    };
+
+    int index(int x, int y) const { return y * width + x; };
+    bool isPassable(int x, int y) const;
+    bool findAnchor(WalkPosition center, WalkPosition &anchor) const;
+    void selectSize(int size);
+    const std::vector<int> &getComponents(int size);
+    bool findCorridor(int sourceRegion, int destinationRegion, std::vector<int> &corridor);
+    void restrictToCorridor(const std::vector<int> &corridor, int startRegion, int goalRegion);
+    int jump(int x, int y, int dx, int dy) const;
+    int search(int start, int goal);
+
+    // Map data
+    int width;
+    int height;
+    std::vector<std::uint8_t> clearance;
+    std::vector<int> regionIds;
+    std::vector< std::vector<int> > regionNeighbors;
+    std::vector< std::vector<Run> > regionRows;
+    std::vector< std::vector<Run> > regionColumns;
+
+    // Passable tiles and connected areas for each unit size, computed on first use
+    std::vector<BitGrid> sizeRows;
+    std::vector<BitGrid> sizeColumns;
+    std::vector< std::vector<int> > components;
+
+    // Search state, where rows and columns point to the passable tiles of the current search
+    int unitSize;
+    int goalX;
+    int goalY;
+    const BitGrid *rows;
+    const BitGrid *columns;
+    BitGrid corridorRows;
+    BitGrid corridorColumns;
+    std::uint32_t searchStamp;
+    std::uint32_t regionStamp;
+    std::uint32_t corridorStamp;
+    std::vector<std::uint32_t> visited;
+    std::vector<std::uint32_t> closed;
+    std::vector<int> cost;
+    std::vector<int> parent;
+    std::vector< std::pair<int,int> > open;
+    std::vector<std::uint32_t> regionMarks;
+    std::vector<std::uint32_t> corridorMarks;
+    std::vector<int> corridorRegions;
+    std::vector<int> regionParent;
+    std::vector<int> regionQueue;
+
+    // Path cache, most recently used first
+    size_t cacheSize;
+    unsigned int cacheHits;
+    unsigned int cacheMisses;
+    std::list<CacheEntry> cache;
+    std::unordered_map<std::uint64_t, std::list<CacheEntry>::iterator> cacheIndex;
+  };
+}
@@ -1,7 +1,9 @@
 #pragma once
+#include <atomic>
 #include <cmath>
 #include <algorithm>
 #include <tuple>
+#include <utility>
 #include <deque>
 #include <iostream>
 
@@ -24,6 +26,57 @@ namespace BWAPI
   template<typename T, int Scale = 1>
   class Point;
 
+  /// The MapBounds class caches the dimensions of the current map so that Point::isValid and
+  /// Point::makeValid can be evaluated inline, without calling through the Game interface.
+  ///
+  /// The Game implementation sets the bounds when a match starts and resets them when it ends.
+  /// If they have not been set (for example, in an AI module's own copy of this library), then
+  /// they are retrieved from Broodwar on first use and cached for the rest of the match.
+  ///
+  /// The bounds are atomic, so positions can be checked from the threads that build the map
+  /// analysis while the main thread sets or resets them.
+  class MapBounds
+  {
+  public:
+    /// Sets the cached map size.
+    ///
+    /// @param tileWidth
+    ///   The width of the map, in build tiles.
+    /// @param tileHeight
+    ///   The height of the map, in build tiles.
+    static void set(int tileWidth, int tileHeight);
+
+    /// Clears the cached map size, so that it is retrieved from Broodwar the next time it is
+    /// needed.
+    static void reset();
+
+    /// Retrieves the width of the map, in pixels.
+    ///
+    /// @note If the Broodwar pointer is not initialized, this returns the width of the largest
+    /// (256x256) map.
+    static int getWidth()
+    {
+      int w = width.load(std::memory_order_relaxed);
+      return w != 0 ? w : fetch().first;
+    };
+
+    /// Retrieves the height of the map, in pixels.
+    ///
+    /// @note If the Broodwar pointer is not initialized, this returns the height of the largest
+    /// (256x256) map.
+    static int getHeight()
+    {
+      int h = height.load(std::memory_order_relaxed);
+      return h != 0 ? h : fetch().second;
+    };
+  private:
+    // Retrieves the map size from Broodwar, caching it if a map is loaded
+    static std::pair<int, int> fetch();
+
+    static std::atomic<int> width;
+    static std::atomic<int> height;
+  };
+
   // Restrictions (no division by 0 or types too small to contain map positions)
   template<typename T> class Point<T, 0> {};
   template<int Scale> class Point<char, Scale> {};
@@ -201,7 +254,12 @@ namespace BWAPI
     /// @retval false If this is not a valid position.
     ///
     /// @see makeValid
-    bool isValid() const;
+    bool isValid() const
+    {
+      return this->x >= 0 && this->y >= 0 &&
+             this->x < MapBounds::getWidth() / Scale &&
+             this->y < MapBounds::getHeight() / Scale;
+    };
 
     /// Checks if this point is within the game's map bounds, if not, then it will set the x and y
     /// values to be within map bounds. (Example: If x is less than 0, then x is set to 0)
@@ -211,7 +269,16 @@ namespace BWAPI
     ///
     /// @returns A reference to itself.
     /// @see isValid
-    Point &makeValid();
+    Point &makeValid()
+    {
+      // Set x/y to 0 if less than 0
+      this->setMin(0, 0);
+
+      // Set x/y to below the map width/height
+      this->setMax(static_cast<T>(MapBounds::getWidth() / Scale - 1),
+                   static_cast<T>(MapBounds::getHeight() / Scale - 1));
+      return *this;
+    };
 
     /// Gets an accurate distance measurement from this point to the given position.
     ///
@@ -0,0 +1,94 @@
+#pragma once
+#include <BWAPI/Position.h>
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace BWAPI
+{
+  /// The PowerGrid class counts how many completed pylons power each build tile, so that
+  /// checking for psi power takes constant time instead of a loop over every pylon.
+  ///
+  /// The psi field of a pylon is a fixed mask of 16x10 build tiles around the pylon. Pylons are
+  /// always aligned to the tile grid, so every pixel of a tile is powered by the same pylons,
+  /// except for the pixels on the left and top edges of the leftmost and topmost tiles of the
+  /// mask, which are exactly 256 and 160 pixels away from the pylon and therefore outside of
+  /// the field. Two smaller layers count the pylons for which this applies, so that
+  /// hasPower gives the same result as testing each pylon.
+  ///
+  /// The grid is only updated when a pylon is completed, destroyed, or changes owner.
+  ///
+  /// @see Game::getPowerGrid, Game::hasPowerPrecise
+  class PowerGrid
+  {
+  public:
+    /// Removes all pylons and resizes the grid for a new map.
+    ///
+    /// @param width
+    ///   The width of the map, in build tiles.
+    /// @param height
+    ///   The height of the map, in build tiles.
+    void reset(int width, int height);
+
+    /// Removes all pylons and data.
+    void clear();
+
+    /// Adds the psi field of a completed pylon.
+    ///
+    /// @param id
+    ///   The ID of the pylon.
+    /// @param position
+    ///   The position of the pylon, in pixels.
+    ///
+    /// @returns true if the pylon was added, and false if it was already in the grid.
+    bool addPylon(int id, Position position);
+
+    /// Removes the psi field of a pylon.
+    ///
+    /// @returns true if the pylon was removed, and false if it was not in the grid.
+    bool removePylon(int id);
+
+    /// Retrieves the number of pylons in the grid.
+    int getPylonCount() const { return static_cast<int>(pylons.size()); };
+
+    /// Checks if a pixel is inside the psi field of at least one pylon.
+    bool hasPower(int x, int y) const;
+
+    /// @overload
+    bool hasPower(Position position) const { return this->hasPower(position.x, position.y); };
+
+    /// Retrieves the number of pylons powering the center of a build tile.
+    ///
+    /// @returns The number of pylons, or 0 if the tile is outside of the map.
+    int getCount(TilePosition position) const;
+
+    /// Counts the build tiles of a rectangle whose centers are powered.
+    ///
+    /// @param topLeft
+    ///   The top left tile of the rectangle.
+    /// @param width
+    ///   The width of the rectangle, in build tiles.
+    /// @param height
+    ///   The height of the rectangle, in build tiles.
+    int countPoweredTiles(TilePosition topLeft, int width, int height) const;
+
+    /// Retrieves the width of the grid, in build tiles.
+    int getWidth() const { return width; };
+
+    /// Retrieves the height of the grid, in build tiles.
+    int getHeight() const { return height; };
+
+    /// Retrieves the raw pylon counts of the tile centers, indexed by y * getWidth() + x.
+    const std::vector<std::uint16_t> &getCounts() const { return counts; };
+  private:
+    void stamp(Position position, int delta);
+
+    int width = 0;
+    int height = 0;
+    std::vector<std::uint16_t> counts;
+    std::vector<std::uint16_t> leftEdges;
+    std::vector<std::uint16_t> topEdges;
+    std::vector< std::pair<int,Position> > pylons;
+  };
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <vector>
+#include <utility>
+
+#include <BWAPI/Position.h>
+
+namespace BWAPI
+{
+  // Forward Declarations
+  class Regionset;
+
+  /// The RegionDistances class holds the shortest ground distance between the centers of every
+  /// pair of regions. It is computed once per match, in parallel, by running Dijkstra's
+  /// algorithm from each accessible region over the region neighbor graph.
+  ///
+  /// Distances between two arbitrary positions are then refined by also considering the
+  /// neighbors of the source and destination regions as entry and exit points, so that the
+  /// result does not always detour through the center of the region that a position is in.
+  ///
+  /// @note The table uses (number of regions)^2 integers, which is at most a few megabytes for
+  /// the region counts found in melee maps.
+  ///
+  /// @see Game::getGroundDistance
+  class RegionDistances
+  {
+  public:
+    /// The input for a single region.
+    struct Node
+    {
+      /// The center of the region, in pixels.
+      Position center;
+
+      /// Whether ground units can walk in this region.
+      bool accessible = false;
+
+      /// The indexes of the neighboring regions.
+      std::vector<int> neighbors;
+    };
+
+    /// Computes the table from the given regions.
+    ///
+    /// @param nodes
+    ///   The regions, where the index of each node is its region ID.
+    /// @param threadCount (optional)
+    ///   The number of threads to use. If 0, then one thread per hardware core is used.
+    void build(const std::vector<Node> &nodes, unsigned int threadCount = 0);
+
+    /// Computes the table from the given regions, using their IDs as indexes.
+    void build(const Regionset &regions, unsigned int threadCount = 0);
+
+    /// Removes all data.
+    void clear();
+
+    /// Checks if the table has been computed.
+    bool isBuilt() const { return !nodes.empty(); };
+
+    /// Retrieves the number of regions in the table.
+    int size() const { return static_cast<int>(nodes.size()); };
+
+    /// Retrieves the ground distance between the centers of two regions.
+    ///
+    /// @returns The distance in pixels, or -1 if there is no ground path.
+    int getDistance(int fromRegion, int toRegion) const;
+
+    /// Retrieves the approximate ground distance between two positions.
+    ///
+    /// @param source
+    ///   The source position.
+    /// @param sourceRegion
+    ///   The ID of the region containing \p source.
+    /// @param destination
+    ///   The destination position.
+    /// @param destinationRegion
+    ///   The ID of the region containing \p destination.
+    ///
+    /// @returns The distance in pixels, or -1 if there is no ground path.
+    int getGroundDistance(Position source, int sourceRegion, Position destination, int destinationRegion) const;
+  private:
+    // Runs Dijkstra's algorithm from a single region and stores the row of the table
+    void computeRow(int source, std::vector< std::pair<int,int> > &queue);
+
+    std::vector<Node> nodes;
+
+    // Neighbor graph in compressed sparse row form
+    std::vector<int> edgeStart;
+    std::vector<int> edgeTarget;
+    std::vector<int> edgeLength;
+
+    // Distances, indexed by from * size() + to
+    std::vector<int> table;
+  };
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <BWAPI/Position.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace BWAPI
+{
+  /// The RegionGraph class stores the regions of the current map in flat arrays, so that code
+  /// walking the region graph, such as a pathfinder, uses contiguous array accesses instead of
+  /// Regionset iteration and Game::getRegionAt.
+  ///
+  /// It holds the region of every walk tile, with split tiles already resolved, the neighbors of
+  /// every region in compressed sparse row form together with the length and width of each
+  /// connection, and the closest neighbor of every region in the same and in another group.
+  /// It is computed once when a match starts. Members that take a region ID expect a value
+  /// between 0 and size() - 1 and do not check it.
+  ///
+  /// Example usage:
+  /// @code
+  ///   const RegionGraph &graph = Broodwar->getRegionGraph();
+  ///   int region = graph.getRegionId(WalkPosition(myUnit->getPosition()));
+  ///   for ( const RegionGraph::Edge *e = graph.edgesBegin(region); e != graph.edgesEnd(region); ++e )
+  ///   {
+  ///     if ( e->width >= UnitTypes::Terran_Siege_Tank_Tank_Mode.width() )
+  ///       Broodwar->drawLineMap(graph.getCenter(region), graph.getCenter(e->target), Colors::Green);
+  ///   }
+  /// @endcode
+  ///
+  /// @see Game::getRegionGraph, Game::getRegionAt, RegionInterface::getNeighbors
+  class RegionGraph
+  {
+  public:
+    /// The input for a single region.
+    struct Node
+    {
+      /// The center of the region, in pixels.
+      Position center;
+
+      /// The ID of the group of regions that can reach each other.
+      int groupId = 0;
+
+      /// The IDs of the neighboring regions, in the order that Broodwar stores them.
+      std::vector<int> neighbors;
+    };
+
+    /// The input for a whole map.
+    struct Input
+    {
+      /// The width of the map, in walk tiles.
+      int width = 0;
+
+      /// The height of the map, in walk tiles.
+      int height = 0;
+
+      /// The region ID of each walk tile, indexed by y * width + x. IDs that are not the index
+      /// of a node mean that the walk tile has no region.
+      std::vector<int> regionIds;
+
+      /// Whether each walk tile is walkable, indexed by y * width + x. Used to measure the
+      /// width of connections.
+      std::vector<bool> walkable;
+
+      /// The regions, where the index of each node is its region ID.
+      std::vector<Node> nodes;
+    };
+
+    /// A connection from one region to a neighbor.
+    struct Edge
+    {
+      /// The ID of the neighboring region.
+      int target;
+
+      /// The approximate distance between the centers of both regions, in pixels.
+      int length;
+
+      /// The width of the widest passage between both regions, in pixels. The walkable walk
+      /// tiles of both regions that touch are split into contiguous segments, and each segment
+      /// is measured as the diagonal of the box around it. It is 0 if there are none.
+      int width;
+    };
+
+    /// Computes the graph.
+    void build(const Input &input);
+
+    /// Removes all data.
+    void clear();
+
+    /// Checks if the graph has been computed.
+    bool isBuilt() const { return width > 0; };
+
+    /// Retrieves the number of regions.
+    int size() const { return static_cast<int>(centers.size()); };
+
+    /// Retrieves the region of a walk tile.
+    ///
+    /// @returns The region ID, or -1 if the walk tile is outside of the map or has no region.
+    int getRegionId(int walkX, int walkY) const
+    {
+      if ( walkX < 0 || walkY < 0 || walkX >= width || walkY >= height )
+        return -1;
+      std::uint16_t id = regionIds[walkY * width + walkX];
+      return id == NoRegion ? -1 : id;
+    };
+
+    /// @overload
+    int getRegionId(WalkPosition position) const { return getRegionId(position.x, position.y); };
+
+    /// Retrieves the center of a region, in pixels.
+    Position getCenter(int region) const { return centers[region]; };
+
+    /// Retrieves the number of neighbors of a region.
+    int getNeighborCount(int region) const { return edgeStart[region + 1] - edgeStart[region]; };
+
+    /// Retrieves the first connection of a region. The connections of a region are stored next
+    /// to each other, in the order of its neighbors.
+    const Edge *edgesBegin(int region) const { return edges.data() + edgeStart[region]; };
+
+    /// Retrieves the end of the connections of a region.
+    const Edge *edgesEnd(int region) const { return edges.data() + edgeStart[region + 1]; };
+
+    /// Retrieves the closest neighbor, measured between region centers, that is in the same
+    /// group as a region.
+    ///
+    /// @returns The region ID, or -1 if there is none.
+    /// @see RegionInterface::getClosestAccessibleRegion
+    int getClosestAccessibleRegion(int region) const { return closestAccessible[region]; };
+
+    /// Retrieves the closest neighbor, measured between region centers, that is in another
+    /// group than a region.
+    ///
+    /// @returns The region ID, or -1 if there is none.
+    /// @see RegionInterface::getClosestInaccessibleRegion
+    int getClosestInaccessibleRegion(int region) const { return closestInaccessible[region]; };
+  private:
+    static const std::uint16_t NoRegion = 0xFFFF;
+
+    int width = 0;
+    int height = 0;
+
+    // Region of each walk tile
+    std::vector<std::uint16_t> regionIds;
+
+    // Per region data
+    std::vector<Position> centers;
+    std::vector<int> closestAccessible;
+    std::vector<int> closestInaccessible;
+
+    // Neighbor graph in compressed sparse row form
+    std::vector<int> edgeStart;
+    std::vector<Edge> edges;
+  };
+}
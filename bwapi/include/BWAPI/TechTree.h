@@ -0,0 +1,210 @@
+#pragma once
+#include <bitset>
+#include <vector>
+#include <utility>
+
+#include <BWAPI/UnitType.h>
+#include <BWAPI/TechType.h>
+#include <BWAPI/UpgradeType.h>
+
+namespace BWAPI
+{
+  // Forward Declarations
+  class PlayerInterface;
+  typedef PlayerInterface *Player;
+
+  /// The TechTree namespace contains a precomputed dependency graph of every UnitType, TechType
+  /// and UpgradeType level, along with a solver that answers "what is still missing, and how soon
+  /// can I have it" queries against a snapshot of a Player.
+  ///
+  /// Every type is mapped to a node index. Requirements are stored as bitsets over those nodes, so
+  /// that resolving the missing prerequisites of a goal is a single pass of bitwise operations in
+  /// dependency order instead of a recursive walk over UnitType::requiredUnits.
+  ///
+  /// Example usage:
+  /// @code
+  ///   TechTree::State state(BWAPI::Broodwar->self());
+  ///   TechTree::Goal goal;
+  ///   goal.add(UnitTypes::Protoss_Dragoon, 2);
+  ///   goal.add(UpgradeTypes::Singularity_Charge);
+  ///   TechTree::Plan plan = TechTree::solve(state, goal);
+  ///   int earliestFrame = Broodwar->getFrameCount() + plan.frames;
+  /// @endcode
+  namespace TechTree
+  {
+    /// The highest upgrade level that is represented in the graph.
+    const int MAX_UPGRADE_LEVEL = 3;
+
+    /// First node index used by unit types.
+    const int UnitNodeOffset = 0;
+
+    /// First node index used by tech types.
+    const int TechNodeOffset = UnitNodeOffset + UnitTypes::Enum::MAX;
+
+    /// First node index used by upgrade types. Each upgrade type occupies #MAX_UPGRADE_LEVEL
+    /// consecutive nodes, one per level.
+    const int UpgradeNodeOffset = TechNodeOffset + TechTypes::Enum::MAX;
+
+    /// The total number of nodes in the graph.
+    const int NodeCount = UpgradeNodeOffset + UpgradeTypes::Enum::MAX * MAX_UPGRADE_LEVEL;
+
+    /// A set of nodes in the dependency graph.
+    typedef std::bitset<NodeCount> NodeSet;
+
+    /// Retrieves the node index of the given type.
+    ///
+    /// @param level (optional)
+    ///   The upgrade level, between 1 and #MAX_UPGRADE_LEVEL.
+    ///
+    /// @returns The node index, or -1 if the type is invalid.
+    int getNode(UnitType type);
+    /// @copydoc getNode(UnitType)
+    int getNode(TechType type);
+    /// @copydoc getNode(UnitType)
+    int getNode(UpgradeType type, int level = 1);
+
+    /// Retrieves the UnitType that a node represents.
+    ///
+    /// @returns The UnitType, or UnitTypes::None if the node is not a unit node.
+    UnitType getUnitType(int node);
+
+    /// Retrieves the TechType that a node represents.
+    ///
+    /// @returns The TechType, or TechTypes::None if the node is not a tech node.
+    TechType getTechType(int node);
+
+    /// Retrieves the UpgradeType and level that a node represents.
+    ///
+    /// @returns A pair of the UpgradeType and its level, or (UpgradeTypes::None, 0) if the node is
+    /// not an upgrade node.
+    std::pair<UpgradeType, int> getUpgradeType(int node);
+
+    /// Retrieves the number of frames it takes to build, research, or upgrade a node.
+    int getTime(int node);
+
+    /// Retrieves the mineral cost of a node.
+    int getMineralPrice(int node);
+
+    /// Retrieves the gas cost of a node.
+    int getGasPrice(int node);
+
+    /// Retrieves the immediate requirements of a node, including the unit that produces it.
+    ///
+    /// @note The worker/resource depot cycles (a @Probe is trained from a @Nexus which is built
+    /// by a @Probe) are broken by not listing the producing depot as a requirement of workers and
+    /// @Larvae. Every melee game starts with both.
+    const NodeSet &getRequirements(int node);
+
+    /// Retrieves the transitive closure of the requirements of a node.
+    const NodeSet &getAllRequirements(int node);
+
+    /// A snapshot of what a player owns, what it is currently making, and how long until each of
+    /// those completes. A State is meant to be constructed once per decision and then passed to
+    /// many solve calls.
+    class State
+    {
+    public:
+      /// Constructs an empty state, representing a player with nothing.
+      State();
+
+      /// Constructs a state from the given player's units, researches, and upgrades.
+      ///
+      /// @param player
+      ///   The player to take the snapshot of. If nullptr, then the state is empty.
+      explicit State(Player player);
+
+      /// Marks a node as owned and completed.
+      void setOwned(int node, int count = 1);
+
+      /// Marks a node as being in progress, completing in the given number of frames.
+      void setInProgress(int node, int remainingFrames);
+
+      /// Checks if a node is completed.
+      bool isOwned(int node) const;
+
+      /// Retrieves the number of completed units of a unit node.
+      int getCount(int node) const;
+
+      /// Retrieves the number of frames until a node completes.
+      ///
+      /// @retval 0 If the node is already owned.
+      /// @retval -1 If the node is neither owned nor in progress.
+      int getRemainingTime(int node) const;
+
+      /// The set of completed nodes.
+      const NodeSet &getOwned() const { return owned; }
+
+      /// The set of nodes that are currently in progress.
+      const NodeSet &getInProgress() const { return inProgress; }
+
+      /// The resources that are currently available, used for the resource bound.
+      int minerals = 0;
+      int gas = 0;
+
+      /// Optional income per frame. If greater than 0, the solver also bounds the completion
+      /// time by how long it takes to gather the missing resources.
+      double mineralRate = 0;
+      double gasRate = 0;
+    private:
+      NodeSet owned;
+      NodeSet inProgress;
+      std::vector<int> counts;
+      std::vector<int> remaining;
+    };
+
+    /// A list of nodes and the quantity of each that is desired.
+    class Goal
+    {
+    public:
+      /// Adds a unit type to the goal.
+      ///
+      /// @param count (optional)
+      ///   The number of completed units of this type that are desired.
+      Goal &add(UnitType type, int count = 1);
+
+      /// Adds a tech type to the goal.
+      Goal &add(TechType type);
+
+      /// Adds an upgrade type to the goal.
+      ///
+      /// @param level (optional)
+      ///   The level of the upgrade that is desired.
+      Goal &add(UpgradeType type, int level = 1);
+
+      /// The desired nodes, paired with their desired quantities.
+      std::vector< std::pair<int, int> > nodes;
+    };
+
+    /// The result of a solve.
+    struct Plan
+    {
+      /// The minimal set of nodes that must still be made, excluding anything already owned or in
+      /// progress. Contains the goal nodes themselves if they are not owned.
+      NodeSet missing;
+
+      /// The missing nodes, ordered so that every node appears after its requirements.
+      std::vector<int> order;
+
+      /// A lower bound on the number of frames until every goal is satisfied. This assumes
+      /// unlimited producers and unlimited resources, unless the State has an income rate.
+      int frames = 0;
+
+      /// The total resources required to make every missing node.
+      int minerals = 0;
+      int gas = 0;
+
+      /// Whether the goal is attainable at all (for example, heroes cannot be produced).
+      bool possible = true;
+    };
+
+    /// Solves the minimal prerequisite set and a lower-bound completion time for the goal.
+    ///
+    /// @param state
+    ///   The snapshot of the player.
+    /// @param goal
+    ///   The desired nodes.
+    ///
+    /// @returns A Plan containing the missing nodes and the lower-bound completion time.
+    Plan solve(const State &state, const Goal &goal);
+  }
+}
@@ -0,0 +1,188 @@
+#pragma once
+#include <BWAPI/Position.h>
+#include <BWAPI/UnitType.h>
+
+#include <string>
+#include <vector>
+
+namespace BWAPI
+{
+  class ClearanceMap;
+
+  /// The TerrainAnalysis class finds the resource clusters, base locations, and choke points of a
+  /// map from its static terrain.
+  ///
+  /// Static resources that lie close together are grouped into clusters. For each cluster, the
+  /// base location is the position where a resource depot can be placed, outside of the area
+  /// around resources where depots are forbidden, with the smallest total distance to the
+  /// resources of the cluster. Start locations replace the base location of the closest cluster.
+  ///
+  /// Choke points are the borders between neighboring regions that are narrow. The width of a
+  /// border is twice the largest distance from one of its walk tiles to the nearest unwalkable
+  /// walk tile, so that a wide border with a single obstacle in the middle is not a choke.
+  ///
+  /// Since the result only depends on the map, it can be saved to a file and loaded again the
+  /// next time that the same map is played, which takes a few milliseconds instead of the time
+  /// it takes to analyze the map.
+  ///
+  /// @see MapAnalysis::getTerrainAnalysis
+  class TerrainAnalysis
+  {
+  public:
+    /// A static mineral field or vespene geyser.
+    struct Resource
+    {
+      /// The type of the resource.
+      UnitType type;
+
+      /// The tile position of the top left corner of the resource.
+      TilePosition tilePosition;
+
+      /// The initial amount of resources.
+      int amount = 0;
+    };
+
+    /// The static terrain of a map.
+    struct Input
+    {
+      /// The width of the map, in build tiles.
+      int width = 0;
+
+      /// The height of the map, in build tiles.
+      int height = 0;
+
+      /// Whether each build tile is buildable, indexed by y * width + x. Static neutral buildings
+      /// should already be removed.
+      std::vector<bool> buildable;
+
+      /// Whether each walk tile is walkable, indexed by y * (width * 4) + x.
+      std::vector<bool> walkable;
+
+      /// The region ID of each walk tile, indexed by y * (width * 4) + x, or -1 for none.
+      std::vector<int> regionIds;
+
+      /// The free space around each walk tile, built from #walkable (optional). If null, then it
+      /// is computed during the analysis.
+      const ClearanceMap *clearance = nullptr;
+
+      /// The static resources on the map.
+      std::vector<Resource> resources;
+
+      /// The start locations of the map.
+      std::vector<TilePosition> startLocations;
+    };
+
+    /// A group of resources that can be gathered from one base.
+    struct ResourceCluster
+    {
+      /// The tile positions of the mineral fields.
+      std::vector<TilePosition> minerals;
+
+      /// The tile positions of the vespene geysers.
+      std::vector<TilePosition> geysers;
+
+      /// The total initial amount of resources.
+      int amount = 0;
+
+      /// The average of the centers of the resources, in pixels.
+      Position center;
+    };
+
+    /// A position where a resource depot can gather from a resource cluster.
+    struct BaseLocation
+    {
+      /// The tile position of the top left corner of the resource depot.
+      TilePosition tilePosition;
+
+      /// The center of the resource depot, in pixels.
+      Position position;
+
+      /// The index of the resource cluster, or -1 for a start location without resources.
+      int cluster = -1;
+
+      /// The ID of the region containing the center of the resource depot, or -1 for none.
+      int region = -1;
+
+      /// Whether this is one of the start locations of the map.
+      bool startLocation = false;
+    };
+
+    /// A narrow border between two regions.
+    struct ChokePoint
+    {
+      /// The IDs of the two regions, with the lower ID first.
+      int regions[2];
+
+      /// The widest point of the border, in pixels.
+      Position center;
+
+      /// The two ends of the border, in pixels.
+      Position sides[2];
+
+      /// The width of the choke point at its center, in pixels.
+      int width = 0;
+    };
+
+    /// The version of the cache file format. Files with another version are ignored.
+    static const int CacheVersion = 1;
+
+    /// The maximum distance, in pixels, between the centers of two resources of a cluster.
+    static const int ClusterDistance = 256;
+
+    /// The minimum number of mineral fields in a cluster without a vespene geyser.
+    static const int MinimumMinerals = 4;
+
+    /// Mineral fields with this amount or less are treated as path blockers, not resources.
+    static const int BlockerAmount = 64;
+
+    /// The maximum width, in pixels, of a choke point.
+    static const int MaximumChokeWidth = 256;
+
+    /// Analyzes the given terrain.
+    void analyze(const Input &input);
+
+    /// Removes all data.
+    void clear();
+
+    /// Checks if the analysis has been computed or loaded.
+    bool isAnalyzed() const { return analyzed; };
+
+    /// Retrieves the resource clusters.
+    const std::vector<ResourceCluster> &getResourceClusters() const { return clusters; };
+
+    /// Retrieves the base locations.
+    const std::vector<BaseLocation> &getBaseLocations() const { return bases; };
+
+    /// Retrieves the choke points.
+    const std::vector<ChokePoint> &getChokePoints() const { return chokes; };
+
+    /// Writes the analysis to a cache file.
+    ///
+    /// @param filename
+    ///   The path of the file.
+    /// @param mapHash
+    ///   The hash of the map that was analyzed, as returned by Game::mapHash.
+    ///
+    /// @returns true if the file was written, and false otherwise.
+    bool save(const std::string &filename, const std::string &mapHash) const;
+
+    /// Reads the analysis from a cache file.
+    ///
+    /// @param filename
+    ///   The path of the file.
+    /// @param mapHash
+    ///   The hash of the current map. The file is only used if it was written for this map.
+    ///
+    /// @returns true if the analysis was loaded. If false, then the analysis is cleared.
+    bool load(const std::string &filename, const std::string &mapHash);
+  private:
+    void findClusters(const Input &input);
+    void findBases(const Input &input);
+    void findChokePoints(const Input &input);
+
+    bool analyzed = false;
+    std::vector<ResourceCluster> clusters;
+    std::vector<BaseLocation> bases;
+    std::vector<ChokePoint> chokes;
+  };
+}
@@ -0,0 +1,31 @@
+#pragma once
+namespace BWAPI
+{
+  /// Contains the layers of dynamic tile data whose changes are tracked from frame to frame.
+  ///
+  /// @see Game::isTileChanged, Game::getChangedTileBlocks
+  namespace TileLayer
+  {
+    /// Enumeration of tile layers.
+    enum Enum
+    {
+      /// The value returned by Game::isVisible.
+      Visible  = 0,
+
+      /// The value returned by Game::isExplored.
+      Explored = 1,
+
+      /// The value returned by Game::hasCreep.
+      Creep    = 2,
+
+      /// Whether a structure occupies the tile, as used by Game::isBuildable.
+      Occupied = 3,
+
+      Max
+    };
+
+    /// The width and height, in build tiles, of the blocks returned by
+    /// Game::getChangedTileBlocks.
+    static const int BlockSize = 8;
+  }
+}
@@ -260,6 +260,20 @@ namespace BWAPI
     /// \p target.
     int getDistance(PositionOrUnit target) const;
 
+    /// Predicts where this unit will be after a number of frames, assuming that it keeps its
+    /// current heading.
+    ///
+    /// The unit accelerates towards its top speed using UnitType::acceleration, and stops at its
+    /// target position if it is known, or after its halt distance if it is no longer moving.
+    ///
+    /// @param frames
+    ///   The number of frames in the future to predict.
+    ///
+    /// @returns The predicted position of this unit.
+    /// @retval Positions::Unknown If this unit is not accessible.
+    /// @see UnitMotion
+    Position predictPosition(int frames) const;
+
     /// Using data provided by Starcraft, checks if there is a path available from this unit to
     /// the given target.
     ///
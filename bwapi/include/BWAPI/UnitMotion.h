@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+
+#include <BWAPI/Position.h>
+
+namespace BWAPI
+{
+  // Forward Declarations
+  class UnitInterface;
+  typedef UnitInterface *Unit;
+
+  /// The UnitMotion namespace contains a simple kinematic model of unit movement, used to
+  /// extrapolate where units will be a number of frames from now.
+  ///
+  /// A unit keeps its current heading. It accelerates from its current speed to its top speed
+  /// (including upgrades) at the rate given by UnitType::acceleration, and it stops after
+  /// travelling a maximum range: the distance to its move target if it is known, or the
+  /// distance it needs to halt (derived from UnitType::haltDistance) if it is no longer moving.
+  ///
+  /// The batch function takes a structure of arrays and contains no branches, so that the
+  /// compiler can vectorize predicting every unit in a single pass.
+  ///
+  /// @see UnitInterface::predictPosition
+  namespace UnitMotion
+  {
+    /// The motion parameters of a single unit.
+    struct State
+    {
+      /// The current position, in pixels.
+      float x = 0;
+      float y = 0;
+
+      /// The current velocity, in pixels per frame.
+      float velocityX = 0;
+      float velocityY = 0;
+
+      /// The top speed, in pixels per frame.
+      float topSpeed = 0;
+
+      /// The acceleration, in pixels per frame per frame. A value of 0 means that the unit's
+      /// speed does not change (its movement is driven by its animation instead).
+      float acceleration = 0;
+
+      /// The maximum distance, in pixels, that the unit will travel before it stops.
+      float range = 0;
+    };
+
+    /// Retrieves the motion parameters of a unit.
+    ///
+    /// @param unit
+    ///   The unit to retrieve the parameters of.
+    ///
+    /// @returns The State of the unit. If the unit is not accessible, then the State describes a
+    /// stationary unit at its last known position.
+    State getState(Unit unit);
+
+    /// Predicts the position of a single unit.
+    ///
+    /// @param state
+    ///   The motion parameters of the unit.
+    /// @param frames
+    ///   The number of frames in the future to predict.
+    ///
+    /// @returns The predicted position, in pixels.
+    Position predict(const State &state, int frames);
+
+    /// Predicts the positions of many units. Each pointer is an array of \p count values, one for
+    /// each member of State.
+    ///
+    /// @param frames
+    ///   The number of frames in the future to predict.
+    /// @param resultX
+    ///   An array of at least \p count values that receives the predicted x positions.
+    /// @param resultY
+    ///   An array of at least \p count values that receives the predicted y positions.
+    void predict(const float *x, const float *y, const float *velocityX, const float *velocityY,
+                 const float *topSpeed, const float *acceleration, const float *range, size_t count,
+                 int frames, float *resultX, float *resultY);
+  }
+}
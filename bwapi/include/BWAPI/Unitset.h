@@ -4,6 +4,8 @@
 #include <BWAPI/PositionUnit.h>
 #include <BWAPI/Filters.h>
 
+#include <vector>
+
 namespace BWAPI
 {
   // Forward declarations
@@ -74,6 +76,29 @@ namespace BWAPI
     Unitset getUnitsInRadius(int radius, const UnitFilter &pred = nullptr) const;
     Unit getClosestUnit(const UnitFilter &pred = nullptr, int radius = 999999) const;
 
+    /// Computes the distance from every unit in this set to the target, in iteration order. The
+    /// distances are computed in a single batch and are identical to UnitInterface::getDistance.
+    ///
+    /// @param target
+    ///   The position or unit to measure the distance to.
+    ///
+    /// @returns A vector containing one distance for each unit in this set.
+    ///
+    /// @see DistanceBatch, UnitInterface::getDistance
+    std::vector<int> getDistances(PositionOrUnit target) const;
+
+    /// Retrieves the unit in this set that is closest to the target.
+    ///
+    /// @param target
+    ///   The position or unit to measure the distance to.
+    /// @param radius (optional)
+    ///   The maximum distance that a unit can be from the target.
+    ///
+    /// @returns The closest unit in this set, or nullptr if no unit is within \p radius.
+    ///
+    /// @see DistanceBatch::getClosestUnit
+    Unit getClosestUnitTo(PositionOrUnit target, int radius = 999999) const;
+
     /// @copydoc UnitInterface::issueCommand
     bool issueCommand(UnitCommand command) const;
     
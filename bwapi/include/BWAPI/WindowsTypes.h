@@ -2,7 +2,11 @@
 
 typedef int BOOL;
 typedef void* HANDLE;
+#ifdef _WIN32
 typedef unsigned long DWORD;
+#else
+typedef unsigned int DWORD;   // 32 bits, as on Windows
+#endif
 typedef void* LPVOID;
 
 #ifndef WINAPI
@@ -1,9 +1,9 @@
 #pragma once
 
-#include <Windows.h>
 #include <cstdio>
 #include <string>
 #include "BWAPI.h"
+#include "ReplayToolDefs.h"
 
 namespace ReplayTool
 {
@@ -23,13 +23,21 @@ namespace ReplayTool
     // Retrieve highest frame count
     virtual DWORD highestFrameTick() const = 0;
 
+    // Retrieve the frame count of the current frame
+    virtual DWORD currentFrameTick() const = 0;
+
+    // Move to the first frame whose tick is not below dwFrameTick, which the next newFrame
+    // begins to read. Returns false, and ends reading, if there is no such frame.
+    virtual bool seekToFrame(DWORD dwFrameTick) = 0;
+
     // Check if data was allocated correctly
     virtual bool isGood() const = 0;
 
     template<class T>
     T read()
     {
-      T val;
+      // Reads past the end leave the value as it is
+      T val = T();
       readData(&val, sizeof(val));
       return val;
     }
@@ -0,0 +1,408 @@
+#include "ActionColumns.h"
+#include <algorithm>
+#include <cstring>
+#include "ActionList.h"
+#include "ActionParser.h"
+#include "FileWriter.h"
+#include "PKShared.h"
+#include "RepHeader.h"
+#include "ReplayReader.h"
+
+using namespace std;
+using namespace ReplayTool;
+
+namespace
+{
+  struct ColumnData
+  {
+    BYTE bEncoding;
+    vector<BYTE> data;
+  };
+
+  template<class T>
+  void appendPlain(vector<BYTE> &out, const vector<T> &values)
+  {
+    if (!values.empty())
+      out.insert(out.end(), (const BYTE*)&values[0], (const BYTE*)&values[0] + values.size() * sizeof(T));
+  }
+
+  void appendVarInt(vector<BYTE> &out, DWORD value)
+  {
+    do
+    {
+      out.push_back((BYTE)((value & 0x7F) | (value > 0x7F ? 0x80 : 0)));
+      value >>= 7;
+    } while (value > 0);
+  }
+
+  ColumnData encodeFrames(const vector<DWORD> &frames, bool delta)
+  {
+    ColumnData column;
+    if (!delta)
+    {
+      column.bEncoding = Encoding_Plain;
+      appendPlain(column.data, frames);
+      return column;
+    }
+
+    // Frames increase in valid replays, but not in damaged ones, so the differences are signed
+    column.bEncoding = Encoding_Delta;
+    DWORD previous = 0;
+    for (size_t i = 0; i < frames.size(); ++i)
+    {
+      int difference = (int)(frames[i] - previous);
+      appendVarInt(column.data, ((DWORD)difference << 1) ^ (DWORD)(difference >> 31));
+      previous = frames[i];
+    }
+    return column;
+  }
+
+  ColumnData encodeWords(const vector<WORD> &values, bool dictionary)
+  {
+    ColumnData column;
+    if (dictionary)
+    {
+      vector<WORD> table(values);
+      sort(table.begin(), table.end());
+      table.erase(unique(table.begin(), table.end()), table.end());
+
+      if (table.size() <= 256)
+      {
+        column.bEncoding = Encoding_Dictionary;
+        WORD wCount = (WORD)table.size();
+        column.data.insert(column.data.end(), (const BYTE*)&wCount, (const BYTE*)&wCount + sizeof(wCount));
+        appendPlain(column.data, table);
+        column.data.resize((column.data.size() + 3) & ~3);
+
+        for (size_t i = 0; i < values.size(); ++i)
+          column.data.push_back((BYTE)(lower_bound(table.begin(), table.end(), values[i]) - table.begin()));
+        return column;
+      }
+    }
+
+    column.bEncoding = Encoding_Plain;
+    appendPlain(column.data, values);
+    return column;
+  }
+}
+
+bool ReplayTool::writeActionColumns(const ActionList &actions, const char *pszColumnsPath, DWORD dwFlags)
+{
+  size_t count = actions.size();
+  vector<DWORD> frames(count);
+  vector<BYTE>  players(count), opcodes(count), params(count, ACTION_PARAM_NONE);
+  vector<WORD>  unitTypes(count, ACTION_COLUMN_NONE), xs(count, ACTION_COLUMN_NONE), ys(count, ACTION_COLUMN_NONE),
+                targets(count, ACTION_COLUMN_NONE);
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const ActionRecord &record = actions[i];
+    frames[i] = record.frame;
+    players[i] = record.player;
+    opcodes[i] = record.action;
+
+    switch (ActionList::getLayout(record.action))
+    {
+    case Layout_Byte:
+    case Layout_TechType:
+    case Layout_UpgradeType:
+      params[i] = record.byteParam;
+      break;
+    case Layout_UnitType:
+      unitTypes[i] = record.wordParam;
+      break;
+    case Layout_Word:
+      targets[i] = record.wordParam;
+      break;
+    case Layout_BytePair:
+      params[i] = record.pair.first;
+      break;
+    case Layout_Position:
+      xs[i] = (WORD)record.position.x;
+      ys[i] = (WORD)record.position.y;
+      break;
+    case Layout_Build:
+      unitTypes[i] = record.build.unitType;
+      xs[i] = (WORD)record.build.x;
+      ys[i] = (WORD)record.build.y;
+      params[i] = record.build.order;
+      break;
+    case Layout_RightClick:
+    case Layout_TargetClick:
+      unitTypes[i] = record.click.unitType;
+      xs[i] = (WORD)record.click.x;
+      ys[i] = (WORD)record.click.y;
+      targets[i] = record.click.targetID;
+      params[i] = ActionList::getLayout(record.action) == Layout_TargetClick ? record.click.order : record.click.how;
+      break;
+    case Layout_Select:
+      params[i] = record.extra.count;
+      break;
+    default:
+      break;
+    }
+  }
+
+  bool dictionary = (dwFlags & ACFLAG_DICTIONARY) != 0;
+  ColumnData columns[Column_Max];
+  columns[Column_Frame] = encodeFrames(frames, (dwFlags & ACFLAG_DELTA_FRAMES) != 0);
+  columns[Column_Player].bEncoding = Encoding_Plain;
+  appendPlain(columns[Column_Player].data, players);
+  columns[Column_Opcode].bEncoding = Encoding_Plain;
+  appendPlain(columns[Column_Opcode].data, opcodes);
+  columns[Column_UnitType] = encodeWords(unitTypes, dictionary);
+  columns[Column_X] = encodeWords(xs, dictionary);
+  columns[Column_Y] = encodeWords(ys, dictionary);
+  columns[Column_Target] = encodeWords(targets, dictionary);
+  columns[Column_Param].bEncoding = Encoding_Plain;
+  appendPlain(columns[Column_Param].data, params);
+
+  ActionColumnsHeader header;
+  memset(&header, 0, sizeof(header));
+  header.dwMagic = ACTION_COLUMNS_MAGIC;
+  header.wVersion = ACTION_COLUMNS_VERSION;
+  header.wColumnCount = Column_Max;
+  header.dwActionCount = (DWORD)count;
+
+  ActionColumnEntry entries[Column_Max];
+  DWORD dwOffset = sizeof(header) + sizeof(entries);
+  for (int c = 0; c < Column_Max; ++c)
+  {
+    memset(&entries[c], 0, sizeof(entries[c]));
+    entries[c].bColumnID = (BYTE)c;
+    entries[c].bEncoding = columns[c].bEncoding;
+    entries[c].dwOffset = dwOffset;
+    entries[c].dwSize = (DWORD)columns[c].data.size();
+    dwOffset = (dwOffset + entries[c].dwSize + 3) & ~3;
+  }
+
+  FileWriter fw;
+  if (!fw.Open(pszColumnsPath))
+    return false;
+
+  fw.WriteRaw(&header, sizeof(header));
+  fw.WriteRaw(entries, sizeof(entries));
+  for (int c = 0; c < Column_Max; ++c)
+  {
+    // Pad every column to 4 bytes, so that the mapped columns are aligned
+    columns[c].data.resize((columns[c].data.size() + 3) & ~3);
+    if (!columns[c].data.empty())
+      fw.WriteRaw(&columns[c].data[0], columns[c].data.size());
+  }
+  fw.Close();
+  return true;
+}
+
+bool ReplayTool::exportActionColumns(const char *pszReplayPath, const char *pszColumnsPath, DWORD dwFlags)
+{
+  FileReader fr;
+  fr.SetQuiet(true);
+  if (!fr.Open(pszReplayPath))
+    return false;
+
+  DWORD dwRepResourceID = 0;
+  if (!DecompressRead(&dwRepResourceID, sizeof(dwRepResourceID), fr) || dwRepResourceID != mmioFOURCC('r','e','R','S'))
+    return false;
+
+  replay_resource replayHeader;
+  DWORD dwActionBufferSize = 0;
+  if (!DecompressRead(&replayHeader, sizeof(replayHeader), fr) || !DecompressRead(&dwActionBufferSize, 4, fr))
+    return false;
+
+  ReplayReader repActions(dwActionBufferSize);
+  if (dwActionBufferSize && (!repActions || !DecompressRead(repActions, dwActionBufferSize, fr)))
+    return false;
+  fr.Free();
+
+  ActionList actions;
+  if (dwActionBufferSize)
+    parseActions(repActions, actions);
+  return writeActionColumns(actions, pszColumnsPath, dwFlags);
+}
+
+ActionColumnsReader::ActionColumnsReader()
+{
+  close();
+}
+
+void ActionColumnsReader::close()
+{
+  fr.Free();
+  actionCount = 0;
+  fileVersion = 0;
+  pFrames = NULL;
+  pPlayers = pOpcodes = pParams = NULL;
+  pUnitTypes = pXs = pYs = pTargets = NULL;
+  frameValues.clear();
+  unitTypeValues.clear();
+  xValues.clear();
+  yValues.clear();
+  targetValues.clear();
+  byteNone.clear();
+  wordNone.clear();
+}
+
+bool ActionColumnsReader::open(const char *pszColumnsPath)
+{
+  close();
+  fr.SetQuiet(true);
+  if (!fr.Open(pszColumnsPath))
+    return false;
+
+  DWORD dwSize = fr.Size();
+  const BYTE *pData = fr.ReadPtr(dwSize);
+  if (!pData || !read(pData, dwSize))
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool ActionColumnsReader::open(const void *pData, DWORD dwDataSize)
+{
+  close();
+  if (!read((const BYTE*)pData, dwDataSize))
+  {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool ActionColumnsReader::read(const BYTE *pData, DWORD dwDataSize)
+{
+  ActionColumnsHeader header;
+  if (dwDataSize < sizeof(header))
+    return false;
+  memcpy(&header, pData, sizeof(header));
+
+  if (header.dwMagic != ACTION_COLUMNS_MAGIC || header.wVersion > ACTION_COLUMNS_VERSION)
+    return false;
+  if (sizeof(header) + (size_t)header.wColumnCount * sizeof(ActionColumnEntry) > dwDataSize)
+    return false;
+
+  actionCount = header.dwActionCount;
+  fileVersion = header.wVersion;
+
+  const ActionColumnEntry *pEntries = (const ActionColumnEntry*)(pData + sizeof(header));
+  for (WORD c = 0; c < header.wColumnCount; ++c)
+  {
+    const ActionColumnEntry &entry = pEntries[c];
+    if ((size_t)entry.dwOffset + entry.dwSize > dwDataSize || !readColumn(entry, pData + entry.dwOffset))
+      return false;
+  }
+
+  // The frame, player and opcode are required, and the parameters default to none
+  if (!pFrames || !pPlayers || !pOpcodes)
+    return false;
+
+  if (!pUnitTypes || !pXs || !pYs || !pTargets)
+    wordNone.assign(actionCount, ACTION_COLUMN_NONE);
+  if (!pParams)
+    byteNone.assign(actionCount, ACTION_PARAM_NONE);
+
+  const WORD *pWordNone = wordNone.empty() ? NULL : &wordNone[0];
+  if (!pUnitTypes) pUnitTypes = pWordNone;
+  if (!pXs)        pXs = pWordNone;
+  if (!pYs)        pYs = pWordNone;
+  if (!pTargets)   pTargets = pWordNone;
+  if (!pParams)    pParams = byteNone.empty() ? NULL : &byteNone[0];
+  return true;
+}
+
+bool ActionColumnsReader::readColumn(const ActionColumnEntry &entry, const BYTE *pData)
+{
+  switch (entry.bColumnID)
+  {
+  case Column_Frame:
+    if (entry.bEncoding == Encoding_Plain)
+    {
+      if (entry.dwSize < actionCount * sizeof(DWORD))
+        return false;
+      pFrames = (const DWORD*)pData;
+    }
+    else if (entry.bEncoding == Encoding_Delta)
+    {
+      frameValues.resize(actionCount);
+      DWORD frame = 0, dwPos = 0;
+      for (DWORD i = 0; i < actionCount; ++i)
+      {
+        DWORD value = 0;
+        for (int shift = 0; ; shift += 7)
+        {
+          if (dwPos >= entry.dwSize || shift > 28)
+            return false;
+          BYTE b = pData[dwPos++];
+          value |= (DWORD)(b & 0x7F) << shift;
+          if (!(b & 0x80))
+            break;
+        }
+        frame += (DWORD)((int)(value >> 1) ^ -(int)(value & 1));
+        frameValues[i] = frame;
+      }
+      pFrames = frameValues.empty() ? NULL : &frameValues[0];
+      if (actionCount == 0)
+        pFrames = (const DWORD*)pData;
+    }
+    else
+    {
+      return false;
+    }
+    return true;
+  case Column_Player:
+  case Column_Opcode:
+  case Column_Param:
+    if (entry.bEncoding != Encoding_Plain || entry.dwSize < actionCount)
+      return false;
+    if (entry.bColumnID == Column_Player)
+      pPlayers = pData;
+    else if (entry.bColumnID == Column_Opcode)
+      pOpcodes = pData;
+    else
+      pParams = pData;
+    return true;
+  case Column_UnitType:
+    return (pUnitTypes = readWordColumn(entry, pData, unitTypeValues)) != NULL;
+  case Column_X:
+    return (pXs = readWordColumn(entry, pData, xValues)) != NULL;
+  case Column_Y:
+    return (pYs = readWordColumn(entry, pData, yValues)) != NULL;
+  case Column_Target:
+    return (pTargets = readWordColumn(entry, pData, targetValues)) != NULL;
+  default:
+    // A column of a later minor revision
+    return true;
+  }
+}
+
+const WORD* ActionColumnsReader::readWordColumn(const ActionColumnEntry &entry, const BYTE *pData, vector<WORD> &decoded)
+{
+  if (entry.bEncoding == Encoding_Plain)
+    return entry.dwSize >= actionCount * sizeof(WORD) ? (const WORD*)pData : NULL;
+
+  if (entry.bEncoding != Encoding_Dictionary || entry.dwSize < sizeof(WORD))
+    return NULL;
+
+  WORD wCount;
+  memcpy(&wCount, pData, sizeof(wCount));
+  DWORD dwIndexOffset = (sizeof(WORD) + wCount * sizeof(WORD) + 3) & ~3;
+  if (wCount == 0 || dwIndexOffset + actionCount > entry.dwSize)
+    return actionCount == 0 ? (const WORD*)pData : NULL;
+
+  // The table follows the count, so it is not aligned
+  WORD table[256];
+  if (wCount > 256)
+    return NULL;
+  memcpy(table, pData + sizeof(WORD), wCount * sizeof(WORD));
+
+  const BYTE *pIndexes = pData + dwIndexOffset;
+  decoded.resize(actionCount);
+  for (DWORD i = 0; i < actionCount; ++i)
+  {
+    if (pIndexes[i] >= wCount)
+      return NULL;
+    decoded[i] = table[pIndexes[i]];
+  }
+  return &decoded[0];
+}
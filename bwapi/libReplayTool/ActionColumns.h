@@ -0,0 +1,131 @@
+#pragma once
+
+#include <vector>
+#include "FileReader.h"
+#include "ReplayToolDefs.h"
+
+START_REPLAY_TOOL
+
+class ActionList;
+
+// Columnar action files store the actions of one replay as parallel arrays, one array per
+// field, so that a scan over one field only touches the bytes of that field.
+//
+// Layout, little endian:
+//   ActionColumnsHeader
+//   ActionColumnEntry[columnCount]
+//   the column data, every column starting on a 4 byte boundary
+//
+// Readers skip columns with an unknown ID, so that columns can be added without a new version.
+// The version only changes when the meaning of an existing column or encoding changes.
+#define ACTION_COLUMNS_MAGIC    mmioFOURCC('R','A','C','T')
+#define ACTION_COLUMNS_VERSION  1
+
+// Stores the frame column as differences between consecutive frames, in zigzag 7 bit encoding
+#define ACFLAG_DELTA_FRAMES 1
+// Stores the WORD columns as BYTE indexes into a table of values, if they have at most 256 values
+#define ACFLAG_DICTIONARY   2
+
+// Value of the unitType, x, y, target and param columns for actions without that parameter
+#define ACTION_COLUMN_NONE  0xFFFF
+#define ACTION_PARAM_NONE   0xFF
+
+enum ActionColumnID
+{
+  Column_Frame,     // DWORD: frame tick
+  Column_Player,    // BYTE: player ID
+  Column_Opcode,    // BYTE: ActionID
+  Column_UnitType,  // WORD: unit type of Train, Placebox, Right_Click and Target_Click
+  Column_X,         // WORD: x position of Placebox, Lift_Off, Ping_Minimap and the click actions
+  Column_Y,         // WORD: y position, as above
+  Column_Target,    // WORD: target unit of the click actions, and unit of Cancel_Train
+  Column_Param,     // BYTE: tech type, upgrade type, order of Placebox and Target_Click, queued
+                    // flag of Right_Click, unit count of selections, group type of Group_Units,
+                    // or the value of one byte actions
+  Column_Max
+};
+
+enum ActionColumnEncoding
+{
+  Encoding_Plain,       // An array of the column type
+  Encoding_Delta,       // Zigzag 7 bit encoded differences to the previous value, starting at 0
+  Encoding_Dictionary   // WORD value count, the values, padding to 4 bytes, and a BYTE index per action
+};
+
+struct ActionColumnsHeader
+{
+  DWORD dwMagic;
+  WORD  wVersion;
+  WORD  wColumnCount;
+  DWORD dwActionCount;
+  DWORD dwReserved;
+};
+
+struct ActionColumnEntry
+{
+  BYTE  bColumnID;
+  BYTE  bEncoding;
+  WORD  wReserved;
+  DWORD dwOffset;   // From the start of the file
+  DWORD dwSize;
+};
+
+// Writes the actions of a list to a columnar action file
+bool writeActionColumns(const ActionList &actions, const char *pszColumnsPath, DWORD dwFlags = 0);
+
+// Parses the actions of a replay and writes them to a columnar action file
+bool exportActionColumns(const char *pszReplayPath, const char *pszColumnsPath, DWORD dwFlags = 0);
+
+// Reads a columnar action file through a memory mapping. Plain columns point into the mapping,
+// and encoded columns are decoded once when the file is opened. Columns that are missing from
+// the file read as ACTION_COLUMN_NONE or ACTION_PARAM_NONE.
+class ActionColumnsReader
+{
+public:
+  ActionColumnsReader();
+
+  bool open(const char *pszColumnsPath);
+
+  // Reads a file that is already in memory, which must stay valid while it is read
+  bool open(const void *pData, DWORD dwDataSize);
+
+  void close();
+
+  DWORD size() const { return actionCount; }
+  WORD  version() const { return fileVersion; }
+
+  const DWORD* frames() const { return pFrames; }
+  const BYTE*  players() const { return pPlayers; }
+  const BYTE*  opcodes() const { return pOpcodes; }
+  const WORD*  unitTypes() const { return pUnitTypes; }
+  const WORD*  xs() const { return pXs; }
+  const WORD*  ys() const { return pYs; }
+  const WORD*  targets() const { return pTargets; }
+  const BYTE*  params() const { return pParams; }
+
+private:
+  bool read(const BYTE *pData, DWORD dwDataSize);
+  bool readColumn(const ActionColumnEntry &entry, const BYTE *pData);
+  const WORD* readWordColumn(const ActionColumnEntry &entry, const BYTE *pData, std::vector<WORD> &decoded);
+
+  FileReader fr;
+  DWORD actionCount;
+  WORD  fileVersion;
+
+  const DWORD *pFrames;
+  const BYTE  *pPlayers;
+  const BYTE  *pOpcodes;
+  const WORD  *pUnitTypes;
+  const WORD  *pXs;
+  const WORD  *pYs;
+  const WORD  *pTargets;
+  const BYTE  *pParams;
+
+  // Decoded columns, and the values of missing columns
+  std::vector<DWORD> frameValues;
+  std::vector<WORD>  unitTypeValues, xValues, yValues, targetValues;
+  std::vector<BYTE>  byteNone;
+  std::vector<WORD>  wordNone;
+};
+
+END_REPLAY_TOOL
@@ -0,0 +1,254 @@
+#include "ActionList.h"
+#include <cstring>
+#include "AbstractReplayReader.h"
+#include "BuildAction.h"
+#include "BurrowAction.h"
+#include "CancelTrainAction.h"
+#include "ChatReplayAction.h"
+#include "CloakAction.h"
+#include "DefaultActions.h"
+#include "GroupUnitsAction.h"
+#include "LatencyAction.h"
+#include "LeaveGameAction.h"
+#include "LiftOffAction.h"
+#include "PingMinimapAction.h"
+#include "ResearchAction.h"
+#include "RightClickAction.h"
+#include "SaveGameAction.h"
+#include "SelectAction.h"
+#include "SetReplaySpeedAction.h"
+#include "SetSpeedAction.h"
+#include "StopAction.h"
+#include "TankSiegeAction.h"
+#include "TargetClickAction.h"
+#include "TrainAction.h"
+#include "UnloadAllAction.h"
+#include "UpgradeAction.h"
+
+using namespace std;
+using namespace BWAPI;
+using namespace ReplayTool;
+
+namespace
+{
+  // Indexed by opcode, so that reading an action does not need a lookup
+  BYTE actionLayouts[256];
+}
+
+void ActionList::setLayout(ActionID action, ActionLayout layout)
+{
+  actionLayouts[action] = (BYTE)layout;
+}
+
+ActionLayout ActionList::getLayout(ActionID action)
+{
+  return (ActionLayout)actionLayouts[action];
+}
+
+void ActionList::clear()
+{
+  records.clear();
+  extra.clear();
+}
+
+void ActionList::reserve(size_t count)
+{
+  records.reserve(count);
+}
+
+const char* ActionList::getExtra(const ActionRecord &record) const
+{
+  return extra.empty() ? "" : &extra[record.extra.offset];
+}
+
+DWORD ActionList::addExtra(const void *pData, size_t size)
+{
+  DWORD offset = (DWORD)extra.size();
+  extra.insert(extra.end(), (const char*)pData, (const char*)pData + size);
+  return offset;
+}
+
+void ActionList::read(AbstractReplayReader &reader, DWORD frame, PlayerID player, ActionID action)
+{
+  ActionRecord record;
+  memset(&record, 0, sizeof(record));
+  record.frame = frame;
+  record.player = player;
+  record.action = action;
+
+  // Read the same fields in the same order as the read function of the GameAction
+  switch (actionLayouts[action])
+  {
+  case Layout_None:
+    break;
+  case Layout_Byte:
+    record.byteParam = reader.readBYTE();
+    break;
+  case Layout_TechType:
+    record.byteParam = (BYTE)reader.readTechType().getID();
+    break;
+  case Layout_UpgradeType:
+    record.byteParam = (BYTE)reader.readUpgradeType().getID();
+    break;
+  case Layout_UnitType:
+    record.wordParam = (WORD)reader.readUnitType().getID();
+    break;
+  case Layout_Word:
+    record.wordParam = reader.readWORD();
+    break;
+  case Layout_BytePair:
+    record.pair.first = reader.readBYTE();
+    record.pair.second = reader.readBYTE();
+    break;
+  case Layout_Position:
+    record.position.x = (short)reader.readWORD();
+    record.position.y = (short)reader.readWORD();
+    break;
+  case Layout_Build:
+    record.build.order = (BYTE)reader.readOrder().getID();
+    record.build.x = (short)reader.readWORD();
+    record.build.y = (short)reader.readWORD();
+    record.build.unitType = (WORD)reader.readUnitType().getID();
+    break;
+  case Layout_RightClick:
+  case Layout_TargetClick:
+    record.click.x = (short)reader.readWORD();
+    record.click.y = (short)reader.readWORD();
+    record.click.targetID = reader.readWORD();
+    record.click.unitType = (WORD)reader.readUnitType().getID();
+    if (actionLayouts[action] == Layout_TargetClick)
+      record.click.order = (BYTE)reader.readOrder().getID();
+    record.click.how = reader.readBYTE();
+    break;
+  case Layout_ReplaySpeed:
+    record.replaySpeed.paused = reader.readBYTE() > 0 ? 1 : 0;
+    record.replaySpeed.speed = reader.readDWORD();
+    record.replaySpeed.multiplier = reader.readDWORD();
+    break;
+  case Layout_Select:
+    {
+      BYTE count = reader.readBYTE();
+      if (count > SelectAction::MAX_UNITS)
+        count = SelectAction::MAX_UNITS;
+
+      WORD units[SelectAction::MAX_UNITS];
+      for (unsigned i = 0; i < count; ++i)
+        units[i] = reader.readWORD();
+
+      record.extra.count = count;
+      record.extra.size = (WORD)(count * sizeof(WORD));
+      record.extra.offset = addExtra(units, record.extra.size);
+    }
+    break;
+  case Layout_Chat:
+    {
+      record.extra.other = reader.readBYTE();
+
+      char buffer[ChatReplayAction::MAX_MSG_SIZE + 1];
+      for (unsigned i = 0; i < ChatReplayAction::MAX_MSG_SIZE; ++i)
+        buffer[i] = reader.readBYTE();
+
+      // Keep a terminator, so that getExtra returns a C string
+      size_t length = strnlen(buffer, ChatReplayAction::MAX_MSG_SIZE);
+      buffer[length] = '\0';
+      record.extra.size = (WORD)length;
+      record.extra.offset = addExtra(buffer, length + 1);
+    }
+    break;
+  case Layout_SaveLoad:
+    {
+      record.extra.value = reader.readDWORD();
+
+      // The path that the reader returns ends with its terminator, which the size includes
+      string path = reader.readCString();
+      record.extra.size = (WORD)path.size();
+      record.extra.offset = addExtra(path.c_str(), path.size() + 1);
+    }
+    break;
+  }
+
+  records.push_back(record);
+}
+
+string ActionList::toString(size_t index) const
+{
+  const ActionRecord &record = records[index];
+  PlayerID player = record.player;
+
+  // Format the action with the class that the GameAction parser would have created
+  switch (record.action)
+  {
+  case ReplayTool::Research:
+    return ResearchAction(player, TechType(record.byteParam)).toString();
+  case ReplayTool::Upgrade:
+    return UpgradeAction(player, UpgradeType(record.byteParam)).toString();
+  case ReplayTool::Train:
+    return TrainAction(player, UnitType(record.wordParam)).toString();
+  case ReplayTool::Cancel_Train:
+    return CancelTrainAction(player, record.wordParam).toString();
+  case ReplayTool::Group_Units:
+    return GroupUnitsAction(player, record.pair.first, record.pair.second).toString();
+  case ReplayTool::Save_Game:
+    return SaveGameAction(player, record.extra.value, string(getExtra(record), record.extra.size)).toString();
+  case ReplayTool::Load_Game:
+    return LoadGameAction(player, record.extra.value, string(getExtra(record), record.extra.size)).toString();
+  case ReplayTool::Placebox:
+    return BuildAction(player, Order(record.build.order), record.build.x, record.build.y, UnitType(record.build.unitType)).toString();
+  case ReplayTool::Chat_Replay:
+    return ChatReplayAction(player, record.extra.other, getExtra(record)).toString();
+  case ReplayTool::Select_Delta_Add:
+  case ReplayTool::Select_Delta_Del:
+  case ReplayTool::Select_Units:
+    {
+      SelectUnitData units[SelectAction::MAX_UNITS];
+      WORD selectData[SelectAction::MAX_UNITS];
+      memcpy(selectData, getExtra(record), record.extra.size);
+      for (unsigned i = 0; i < record.extra.count; ++i)
+      {
+        units[i].unitID = EXTRACT_SELECT_DATA_UNITID(selectData[i]);
+        units[i].data = EXTRACT_SELECT_DATA_DATA(selectData[i]);
+      }
+
+      SelectAction::SelectType type = record.action == ReplayTool::Select_Delta_Add ? SelectAction::SELECT_DeltaAdd :
+                                      record.action == ReplayTool::Select_Delta_Del ? SelectAction::SELECT_DeltaDel :
+                                                                                      SelectAction::SELECT_Units;
+      return SelectAction(player, type, units, record.extra.count).toString();
+    }
+  case ReplayTool::Cloak_On:
+  case ReplayTool::Cloak_Off:
+    return CloakAction(player, record.byteParam, record.action == ReplayTool::Cloak_On).toString();
+  case ReplayTool::Stop:
+  case ReplayTool::Return:
+    return StopAction(player, record.byteParam, record.action == ReplayTool::Stop).toString();
+  case ReplayTool::Tank_Siege:
+  case ReplayTool::Tank_Unsiege:
+    return TankSiegeAction(player, record.byteParam, record.action == ReplayTool::Tank_Siege).toString();
+  case ReplayTool::Unload_All:
+  case ReplayTool::Hold_Position:
+    return UnloadAllAction(player, record.byteParam, record.action == ReplayTool::Unload_All).toString();
+  case ReplayTool::Burrow_Up:
+  case ReplayTool::Burrow_Down:
+    return BurrowAction(player, record.byteParam, record.action == ReplayTool::Burrow_Up).toString();
+  case ReplayTool::Set_Seed:
+    return SetSpeedAction(player, record.byteParam).toString();
+  case ReplayTool::Set_Latency:
+    return LatencyAction(player, record.byteParam).toString();
+  case ReplayTool::Leave_Game:
+    return LeaveGameAction(player, record.byteParam).toString();
+  case ReplayTool::Lift_Off:
+    return LiftOffAction(player, record.position.x, record.position.y).toString();
+  case ReplayTool::Ping_Minimap:
+    return PingMinimapAction(player, record.position.x, record.position.y).toString();
+  case ReplayTool::Right_Click:
+    return RightClickAction(player, record.click.x, record.click.y, record.click.targetID,
+                            UnitType(record.click.unitType), record.click.how).toString();
+  case ReplayTool::Target_Click:
+    return TargetClickAction(player, record.click.x, record.click.y, record.click.targetID,
+                             UnitType(record.click.unitType), record.click.how, Order(record.click.order)).toString();
+  case ReplayTool::Set_Replay_Speed:
+    return SetReplaySpeedAction(player, record.replaySpeed.paused != 0, record.replaySpeed.speed,
+                                record.replaySpeed.multiplier).toString();
+  default:
+    return GameAction(player, record.action).toString();
+  }
+}
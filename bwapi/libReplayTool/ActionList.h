@@ -0,0 +1,93 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ReplayToolDefs.h"
+
+START_REPLAY_TOOL
+
+class AbstractReplayReader;
+
+// How the parameters of an action are read and stored in an ActionRecord
+enum ActionLayout
+{
+  Layout_None,          // No parameters
+  Layout_Byte,          // byteParam: queued flag, game speed, latency or leave type
+  Layout_TechType,      // byteParam
+  Layout_UpgradeType,   // byteParam
+  Layout_UnitType,      // wordParam
+  Layout_Word,          // wordParam: unit ID and data
+  Layout_BytePair,      // pair: group type and number
+  Layout_Position,      // position
+  Layout_Build,         // build
+  Layout_RightClick,    // click, without order
+  Layout_TargetClick,   // click
+  Layout_ReplaySpeed,   // replaySpeed
+  Layout_Select,        // extra: count WORDs of unit ID and data
+  Layout_Chat,          // extra: other player in other, and the message
+  Layout_SaveLoad,      // extra: save info in value, and the path
+  Layout_Max
+};
+
+// An action with its parameters decoded into a fixed size record. Which member of the union
+// holds the parameters depends on the layout of the opcode. Parameters that do not have a fixed
+// size are stored in the extra data of the ActionList.
+struct ActionRecord
+{
+  struct Position     { short x; short y; };
+  struct Build        { short x; short y; WORD unitType; BYTE order; };
+  struct Click        { short x; short y; WORD targetID; WORD unitType; BYTE how; BYTE order; };
+  struct BytePair     { BYTE first; BYTE second; };
+  struct ReplaySpeed  { DWORD speed; DWORD multiplier; BYTE paused; };
+  struct Extra        { DWORD offset; WORD size; BYTE count; BYTE other; DWORD value; };
+
+  DWORD    frame;
+  PlayerID player;
+  ActionID action;
+  union
+  {
+    BYTE        byteParam;
+    WORD        wordParam;
+    BytePair    pair;
+    Position    position;
+    Build       build;
+    Click       click;
+    ReplaySpeed replaySpeed;
+    Extra       extra;
+  };
+};
+
+// The actions of a replay, stored contiguously. Clearing the list keeps its memory, so that
+// parsing replays one after another with the same list stops allocating once it is as large
+// as the longest replay.
+class ActionList
+{
+public:
+  void clear();
+  void reserve(size_t count);
+
+  size_t size() const { return records.size(); }
+  bool empty() const { return records.empty(); }
+  const ActionRecord& operator[](size_t index) const { return records[index]; }
+
+  // Retrieves the variable length parameters of an action with an extra member
+  const char* getExtra(const ActionRecord &record) const;
+
+  // Same text as GameAction::toString for the action
+  std::string toString(size_t index) const;
+
+  // Reads the parameters of an action, and adds it to the list
+  void read(AbstractReplayReader &reader, DWORD frame, PlayerID player, ActionID action);
+
+  // Sets how an opcode is read. Opcodes without a layout are stored without parameters.
+  static void setLayout(ActionID action, ActionLayout layout);
+  static ActionLayout getLayout(ActionID action);
+
+private:
+  DWORD addExtra(const void *pData, size_t size);
+
+  std::vector<ActionRecord> records;
+  std::vector<char> extra;
+};
+
+END_REPLAY_TOOL
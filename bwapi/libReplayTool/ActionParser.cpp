@@ -7,7 +7,6 @@
 #include "BWAPI.h"
 #include "Logger.h"
 #include "ReplayReader.h"
-#include "StrUtil.h"
 
 using namespace BWAPI;
 using namespace std;
@@ -44,19 +43,57 @@ extern "C" void parseActions(AbstractReplayReader &rr, list<GameAction*> &action
   } // per-replay loop
 }
 
-extern "C" void logActions(const list<GameAction*> &actions, const char *logFilename)
+extern "C" void logActions(const list<GameAction*> &actions, const char *logFilename, bool bDebugOutput)
 {
-  Logger actionLog(logFilename);
-  string dbgStr;
-  unsigned actionNum = 0;
-
+  // The logger numbers the lines in the debugger output
+  Logger actionLog(logFilename, bDebugOutput);
   for(list<GameAction*>::const_iterator itr = actions.begin(); itr != actions.end(); ++itr)
+    actionLog.writeText((*itr)->toString().c_str());
+}
+
+void ReplayTool::parseActions(AbstractReplayReader &rr, ActionList &actions)
+{
+  actions.clear();
+  while (rr.isGood())
+  {
+    // Begin reading a new replay frame
+    rr.newFrame();
+    while (rr.isGood() && rr.isValidFrame())
+    {
+      // Get the player ID and opcode for the current command being executed
+      BYTE bPlayerID = rr.readBYTE();
+      BYTE bCommand  = rr.readBYTE();
+
+      // Opcodes without a layout are read without parameters, like a generic GameAction
+      actions.read(rr, rr.currentFrameTick(), bPlayerID, bCommand);
+    } // per-frame loop
+
+  } // per-replay loop
+}
+
+void ReplayTool::parseActions(AbstractReplayReader &rr, ActionList &frameActions, const FrameActionSink &sink)
+{
+  while (rr.isGood())
   {
-    dbgStr = StrUtil::format("%d: %s\n", actionNum, (*itr)->toString().c_str());
-    ++actionNum;
+    // Begin reading a new replay frame
+    frameActions.clear();
+    rr.newFrame();
+    while (rr.isGood() && rr.isValidFrame())
+    {
+      BYTE bPlayerID = rr.readBYTE();
+      BYTE bCommand  = rr.readBYTE();
+      frameActions.read(rr, rr.currentFrameTick(), bPlayerID, bCommand);
+    } // per-frame loop
 
-    OutputDebugStringA(dbgStr.c_str());
+    if (!frameActions.empty() && !sink(frameActions))
+      return;
+  } // per-replay loop
+}
 
-    actionLog.writeLine((*itr)->toString().c_str());
-  }
-}
\ No newline at end of file
+void ReplayTool::logActions(const ActionList &actions, const char *logFilename, bool bDebugOutput)
+{
+  // The text of some actions has a null character in it, where the line ends, as it always has
+  Logger actionLog(logFilename, bDebugOutput);
+  for (size_t i = 0; i < actions.size(); ++i)
+    actionLog.writeText(actions.toString(i).c_str());
+}
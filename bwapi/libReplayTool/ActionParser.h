@@ -1,13 +1,26 @@
 #pragma once
 
 #include "GameAction.h"
+#include <functional>
 #include <list>
+#include "ActionList.h"
 
 START_REPLAY_TOOL
 
 class AbstractReplayReader;
 
 extern "C" void parseActions(AbstractReplayReader &rr, std::list<GameAction*> &actions);
-extern "C" void logActions(const std::list<GameAction*> &actions, const char *logFilename);
+// Writes the text of every action to a trace file, and to the debugger output if bDebugOutput is set
+extern "C" void logActions(const std::list<GameAction*> &actions, const char *logFilename, bool bDebugOutput = false);
+
+// Same as above, without allocating an object per action. The list is cleared first.
+void parseActions(AbstractReplayReader &rr, ActionList &actions);
+void logActions(const ActionList &actions, const char *logFilename, bool bDebugOutput = false);
+
+// Parses one frame at a time, so that actions can be consumed while a StreamReplayReader
+// decompresses them. The list holds the actions of a frame when they are passed to the sink,
+// which stops parsing by returning false.
+typedef std::function<bool(const ActionList &frameActions)> FrameActionSink;
+void parseActions(AbstractReplayReader &rr, ActionList &frameActions, const FrameActionSink &sink);
 
 END_REPLAY_TOOL
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "DefaultActions.h"
 #include "AbstractReplayReader.h"
 #include "StrUtil.h"
+#include <cstring>
 
 using namespace std;
 using namespace BWAPI;
@@ -32,7 +33,8 @@ void ChatReplayAction::read(AbstractReplayReader &reader)
     buffer[i] = reader.readBYTE();
   }
 
-  msg = buffer;
+  // The message is only terminated when it is shorter than the buffer
+  msg.assign(buffer, strnlen(buffer, MAX_MSG_SIZE));
 }
 
 string ChatReplayAction::toString() const
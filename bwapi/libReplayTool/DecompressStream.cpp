@@ -0,0 +1,143 @@
+#include "DecompressStream.h"
+#include <cstring>
+#include "FileReader.h"
+
+using namespace ReplayTool;
+
+DecompressStream::DecompressStream()
+  : pReader(nullptr)
+  , dwOutputSize(0)
+  , dwOutputPos(0)
+  , dwCrc32Sum(0)
+  , dwSectionCount(0)
+  , dwSection(0)
+  , crc(0xFFFFFFFF)
+  , finished(false)
+  , error(true)
+  , pChunk(nullptr)
+  , dwChunkSize(0)
+  , dwChunkPos(0)
+  , dwWritePos(0)
+{
+}
+
+bool DecompressStream::fail()
+{
+  error = true;
+  finished = true;
+  return false;
+}
+
+bool DecompressStream::open(FileReader &fr, DWORD dwNewOutputSize)
+{
+  pReader = &fr;
+  dwOutputSize = dwNewOutputSize;
+  dwOutputPos = 0;
+  dwSection = 0;
+  crc = 0xFFFFFFFF;
+  finished = false;
+  error = false;
+
+  // Same as DecompressRead, which does not read empty sections
+  if ( !dwOutputSize )
+    return fail();
+
+  _Part hdr = fr.Read<_Part>();
+  if ( fr.Eof() )
+    return fail();
+  dwCrc32Sum = hdr.dwCrc32Sum;
+  dwSectionCount = hdr.dwSectionCount;
+  return true;
+}
+
+bool DecompressStream::next(const BYTE *&pData, DWORD &dwSize)
+{
+  if ( finished )
+    return false;
+
+  if ( dwSection == dwSectionCount )
+  {
+    // Every chunk is read, so the checksum can be compared
+    finished = true;
+    if ( dwOutputPos != dwOutputSize || (DWORD)crc != dwCrc32Sum )
+      error = true;
+    return false;
+  }
+
+  DWORD chunkSize = pReader->Read<DWORD>();
+  if ( chunkSize > dwOutputSize )
+    return fail();
+
+  const char *pNewChunk = (const char*)pReader->ReadPtr(chunkSize);
+  if ( pNewChunk == nullptr )
+    return fail();
+  ++dwSection;
+
+  // A chunk that does not get smaller is stored as it is, like in DecompressRead
+  DWORD dwChunkOutput = dwOutputSize - dwOutputPos;
+  if ( dwChunkOutput > SECTION_CHUNK_SIZE )
+    dwChunkOutput = SECTION_CHUNK_SIZE;
+
+  if ( chunkSize != dwChunkOutput )
+  {
+    pChunk = pNewChunk;
+    dwChunkSize = chunkSize;
+    dwChunkPos = 0;
+    dwWritePos = 0;
+
+    // explode_fast initializes its work buffer itself
+    if ( explode_fast(&readCompressed, &writeDecompressed, workBuffer, this) || dwWritePos > sizeof(outputBuffer) ||
+         dwOutputPos + dwWritePos > dwOutputSize )
+      return fail();
+
+    pData = outputBuffer;
+    dwSize = dwWritePos;
+  }
+  else
+  {
+    if ( chunkSize == 0 )
+      return fail();
+    pData = (const BYTE*)pNewChunk;
+    dwSize = chunkSize;
+  }
+
+  unsigned int dwCrcSize = dwSize;
+  crc = crc32pk((char*)pData, &dwCrcSize, &crc);
+  dwOutputPos += dwSize;
+  return true;
+}
+
+bool DecompressStream::read(FileReader &fr, DWORD dwNewOutputSize, const ChunkSink &sink)
+{
+  if ( !open(fr, dwNewOutputSize) )
+    return false;
+
+  const BYTE *pData;
+  DWORD dwSize;
+  while ( next(pData, dwSize) )
+  {
+    if ( !sink(pData, dwSize) )
+      return false;
+  }
+  return done();
+}
+
+unsigned int PKEXPORT DecompressStream::readCompressed(char *buf, unsigned int *size, void *param)
+{
+  DecompressStream *pStream = (DecompressStream*)param;
+
+  DWORD dwSize = pStream->dwChunkSize - pStream->dwChunkPos;
+  if ( dwSize > *size )
+    dwSize = *size;
+  memcpy(buf, &pStream->pChunk[pStream->dwChunkPos], dwSize);
+  pStream->dwChunkPos += dwSize;
+  return dwSize;
+}
+
+void PKEXPORT DecompressStream::writeDecompressed(char *buf, unsigned int *size, void *param)
+{
+  DecompressStream *pStream = (DecompressStream*)param;
+  if ( pStream->dwWritePos + *size <= sizeof(pStream->outputBuffer) )
+    memcpy(&pStream->outputBuffer[pStream->dwWritePos], buf, *size);
+  pStream->dwWritePos += *size;
+}
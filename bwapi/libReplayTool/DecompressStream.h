@@ -0,0 +1,71 @@
+#pragma once
+
+#include <functional>
+#include "PKShared.h"
+#include "ReplayToolDefs.h"
+
+START_REPLAY_TOOL
+
+class FileReader;
+
+// Decompresses one compressed section of a replay a chunk at a time, so that the section can be
+// consumed while it is decompressed. Memory use is one chunk of output and one explode work
+// buffer, and reading the section does not allocate.
+//
+// The checksum of the section covers all of its chunks, so it is only checked after the last
+// chunk, and a consumer has to check failed() when it is done.
+class DecompressStream
+{
+public:
+  typedef std::function<bool(const BYTE *pData, DWORD dwSize)> ChunkSink;
+
+  DecompressStream();
+
+  // Begins a section of dwOutputSize bytes at the position of the file reader, which must stay
+  // valid while the section is read
+  bool open(FileReader &fr, DWORD dwOutputSize);
+
+  // Retrieves the next chunk of output, which is valid until the next call. Returns false at
+  // the end of the section, or if the section is damaged.
+  bool next(const BYTE *&pData, DWORD &dwSize);
+
+  // Passes every chunk of a section to a sink, which can stop reading by returning false.
+  // Returns whether the whole section was read and its checksum matches.
+  bool read(FileReader &fr, DWORD dwOutputSize, const ChunkSink &sink);
+
+  // The section was read to the end, and its checksum matches
+  bool done() const { return finished && !error; }
+
+  // The section is damaged, or its checksum does not match
+  bool failed() const { return error; }
+
+  DWORD size() const { return dwOutputSize; }
+  DWORD tell() const { return dwOutputPos; }
+
+private:
+  static unsigned int PKEXPORT readCompressed(char *buf, unsigned int *size, void *param);
+  static void PKEXPORT writeDecompressed(char *buf, unsigned int *size, void *param);
+
+  bool fail();
+
+  FileReader    *pReader;
+  DWORD         dwOutputSize;
+  DWORD         dwOutputPos;
+  DWORD         dwCrc32Sum;
+  DWORD         dwSectionCount;
+  DWORD         dwSection;
+  unsigned long crc;
+  bool          finished;
+  bool          error;
+
+  // The chunk that explode is reading, and the output it has written
+  const char    *pChunk;
+  DWORD         dwChunkSize;
+  DWORD         dwChunkPos;
+  DWORD         dwWritePos;
+
+  char          workBuffer[EXP_BUFFER_SIZE];
+  BYTE          outputBuffer[SECTION_CHUNK_SIZE];
+};
+
+END_REPLAY_TOOL
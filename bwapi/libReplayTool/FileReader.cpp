@@ -1,25 +1,35 @@
 #include "FileReader.h"
 
-#include <windows.h>
+#include <cerrno>
+#include <cstdio>
 #include <string>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace ReplayTool;
 
 FileReader::FileReader()
-:hFile(NULL)
-,pMem(NULL)
+:pMem(NULL)
 ,dwFileSize(0)
 ,dwOffset(0)
 ,eof(false)
+,mapped(false)
+,quiet(false)
 {
 }
 
 FileReader::FileReader(const void *pData, DWORD dwDataSize)
-:hFile(NULL)
-,pMem((BYTE*)pData)
+:pMem((const BYTE*)pData)
 ,dwFileSize(dwDataSize)
 ,dwOffset(0)
 ,eof(false)
+,mapped(false)
+,quiet(false)
 {
 }
 
@@ -30,14 +40,17 @@ FileReader::~FileReader()
 
 void FileReader::Free()
 {
-  if ( this->pMem )
-    free(this->pMem);
-  this->pMem = NULL;
+  if ( this->pMem && this->mapped )
+  {
+#ifdef _WIN32
+    UnmapViewOfFile(this->pMem);
+#else
+    munmap((void*)this->pMem, this->dwFileSize);
+#endif
+  }
+  this->pMem    = NULL;
+  this->mapped  = false;
 
-  if ( this->hFile )
-    CloseHandle(this->hFile);
-  this->hFile = NULL;
-  
   this->dwFileSize  = 0;
   this->dwOffset    = 0;
   this->eof         = false;
@@ -45,53 +58,101 @@ void FileReader::Free()
 
 bool FileReader::Error(const char *pszMsg)
 {
+  if ( this->quiet )
+  {
+    this->Free();
+    return false;
+  }
+
+#ifdef _WIN32
+  DWORD dwError = GetLastError();
   this->Free();
 
-  LPSTR pszStr;
-  FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM, NULL, GetLastError(), 0, (LPSTR)&pszStr, 0, NULL);
+  LPSTR pszStr = NULL;
+  FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM, NULL, dwError, 0, (LPSTR)&pszStr, 0, NULL);
 
   char msg[512];
-  sprintf_s(msg, 512, "%s\n%s", pszMsg, pszStr);
+  sprintf_s(msg, 512, "%s\n%s", pszMsg ? pszMsg : "", pszStr ? pszStr : "");
   MessageBox(NULL, msg, NULL, MB_OK | MB_ICONERROR);
   LocalFree(pszStr);
+#else
+  int error = errno;
+  this->Free();
+  fprintf(stderr, "%s\n%s\n", pszMsg ? pszMsg : "", strerror(error));
+#endif
   return false;
 }
 
 bool FileReader::Open(const char *pszFilename)
 {
+  this->Free();
+
+#ifdef _WIN32
   // Open the file handle
-  this->hFile = CreateFile(pszFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
-  if ( this->hFile == INVALID_HANDLE_VALUE )
+  HANDLE hFile = CreateFile(pszFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+  if ( hFile == INVALID_HANDLE_VALUE )
     return this->Error();
-  
+
   // Retrieve the file size
   this->dwFileSize = GetFileSize(hFile, NULL);
   if ( this->dwFileSize == INVALID_FILE_SIZE )
+  {
+    CloseHandle(hFile);
     return this->Error();
+  }
 
-  // Allocate buffer
-  this->pMem = (BYTE*)malloc(this->dwFileSize);
-  if ( !this->pMem )
+  // Map the file, the view keeps it open after the handles are closed
+  if ( this->dwFileSize )
+  {
+    HANDLE hMapping = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if ( hMapping != NULL )
+    {
+      this->pMem = (const BYTE*)MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+      CloseHandle(hMapping);
+    }
+  }
+  CloseHandle(hFile);
+#else
+  // Open the file descriptor
+  int fd = open(pszFilename, O_RDONLY);
+  if ( fd == -1 )
     return this->Error();
 
-  // Read the file to memory
-  DWORD dwRead = 0;
-  if ( !ReadFile(this->hFile, this->pMem, this->dwFileSize, &dwRead, NULL) || dwRead != this->dwFileSize )
+  // Retrieve the file size
+  struct stat st;
+  if ( fstat(fd, &st) == -1 || st.st_size > 0xFFFFFFFF )
+  {
+    close(fd);
     return this->Error();
+  }
+  this->dwFileSize = (DWORD)st.st_size;
 
-  // Close the file handle
-  CloseHandle(hFile);
-  hFile = NULL;
+  // Map the file, the mapping keeps it open after the descriptor is closed
+  if ( this->dwFileSize )
+  {
+    void *pView = mmap(NULL, this->dwFileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if ( pView != MAP_FAILED )
+    {
+      madvise(pView, this->dwFileSize, MADV_SEQUENTIAL);
+      this->pMem = (const BYTE*)pView;
+    }
+  }
+  close(fd);
+#endif
+
+  if ( this->dwFileSize && !this->pMem )
+    return this->Error();
+  this->mapped = this->pMem != NULL;
   return true;
 }
 
 void FileReader::Read(void *pBuffer, DWORD dwSize)
 {
   BYTE *pb = (BYTE*)pBuffer;
-  DWORD dwNullCount = dwOffset + dwSize - dwFileSize;
-  if ( dwNullCount & 0x80000000 )
-    dwNullCount = 0;
-  DWORD dwNormCount = dwSize - dwNullCount;
+  DWORD dwNormCount = dwFileSize - dwOffset;
+  if ( dwNormCount > dwSize )
+    dwNormCount = dwSize;
+  DWORD dwNullCount = dwSize - dwNormCount;
   
   if ( dwNormCount )
   {
@@ -106,3 +167,21 @@ void FileReader::Read(void *pBuffer, DWORD dwSize)
     return;
   }
 }
+
+void FileReader::Seek(DWORD dwPosition)
+{
+  this->dwOffset = dwPosition < dwFileSize ? dwPosition : dwFileSize;
+  this->eof = false;
+}
+
+const BYTE *FileReader::ReadPtr(DWORD dwSize)
+{
+  if ( dwSize > dwFileSize - dwOffset )
+  {
+    this->eof = true;
+    return NULL;
+  }
+  const BYTE *pb = &this->pMem[dwOffset];
+  dwOffset += dwSize;
+  return pb;
+}
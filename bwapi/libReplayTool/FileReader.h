@@ -1,9 +1,13 @@
 #pragma once
-#include <windows.h>
+#include "ReplayToolDefs.h"
+#include <cstring>
 #include <string>
 
 namespace ReplayTool
 {
+  // Reads a file through a read-only memory mapping, so that reads and ReadPtr access the
+  // file contents without copying the whole file first. A FileReader constructed from memory
+  // reads that memory and does not free it.
   class FileReader
   {
   public:
@@ -19,7 +23,7 @@ namespace ReplayTool
       _T rval;
       if ( dwOffset + sizeof(_T) <= dwFileSize )
       {
-        rval = *(_T*)&this->pMem[dwOffset];
+        memcpy(&rval, &this->pMem[dwOffset], sizeof(_T));
         dwOffset += sizeof(_T);
       }
       else
@@ -30,11 +34,26 @@ namespace ReplayTool
       return rval;
     }
     void Read(void *pBuffer, DWORD dwSize);
+
+    // Retrieves the next dwSize bytes without copying them, or NULL if there are not as many
+    // bytes left. The pointer is valid until Free is called.
+    const BYTE *ReadPtr(DWORD dwSize);
+
+    // Moves to an offset that was returned by Tell, to read a section again
+    void Seek(DWORD dwPosition);
+
+    // Disables the error message box, for reading many files without supervision
+    void  SetQuiet(bool bQuiet) { quiet = bQuiet; }
+
+    DWORD Size() const { return dwFileSize; }
+    DWORD Tell() const { return dwOffset; }
+    bool  Eof() const { return eof; }
   private:
-    HANDLE  hFile;
-    BYTE    *pMem;
-    DWORD   dwFileSize;
-    DWORD   dwOffset;
-    bool    eof;
+    const BYTE  *pMem;
+    DWORD       dwFileSize;
+    DWORD       dwOffset;
+    bool        eof;
+    bool        mapped;
+    bool        quiet;
   };
-}
\ No newline at end of file
+}
@@ -1,19 +1,11 @@
 #include "FileWriter.h"
 
-#include <windows.h>
 #include <string>
 
 using namespace ReplayTool;
 
-/*  msdn sample of file appending:
-    dwPos = SetFilePointer(hAppend, 0, NULL, FILE_END);
-    LockFile(hAppend, dwPos, 0, dwBytesWrite, 0);
-    WriteFile(hAppend, buff, dwBytesWrite, &dwBytesWritten, NULL);
-    UnlockFile(hAppend, dwPos, 0, dwBytesWrite, 0);
-    */
-
 FileWriter::FileWriter()
-:hFile(NULL)
+:pFile(NULL)
 {
 }
 
@@ -24,16 +16,22 @@ FileWriter::~FileWriter()
 
 void FileWriter::Close()
 {
-  if ( this->hFile )
-    CloseHandle(this->hFile);
-  this->hFile = NULL;
+  if ( this->pFile )
+    fclose(this->pFile);
+  this->pFile = NULL;
 }
 
 bool FileWriter::Error(const char *pszMsg)
 {
   this->Close();
   if ( pszMsg )
+  {
+#ifdef _WIN32
     MessageBox(NULL, pszMsg, NULL, MB_OK | MB_ICONERROR);
+#else
+    fprintf(stderr, "%s\n", pszMsg);
+#endif
+  }
   return false;
 }
 
@@ -41,8 +39,8 @@ bool FileWriter::Open(const char *pszFilename)
 {
   // Open the file handle
   this->Close();
-  this->hFile = CreateFile(pszFilename, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
-  if ( this->hFile == INVALID_HANDLE_VALUE )
+  this->pFile = fopen(pszFilename, "wb");
+  if ( this->pFile == NULL )
     return this->Error();
   return true;
 }
@@ -69,9 +67,6 @@ void FileWriter::WriteString(std::string str)
 
 void FileWriter::WriteRaw(void *pData, size_t size)
 {
-  if ( this->hFile )
-  {
-    DWORD written;
-    WriteFile(this->hFile, pData, size, &written, NULL);
-  }
+  if ( this->pFile )
+    fwrite(pData, 1, size, this->pFile);
 }
@@ -1,5 +1,6 @@
 #pragma once
-#include <windows.h>
+#include "ReplayToolDefs.h"
+#include <cstdio>
 #include <string>
 
 namespace ReplayTool
@@ -15,13 +16,13 @@ namespace ReplayTool
     template <class _T>
     void Write(_T val)
     {
-      DWORD written;
-      WriteFile(this->hFile, &val, sizeof(_T), &written, NULL);
+      if ( this->pFile )
+        fwrite(&val, sizeof(_T), 1, this->pFile);
     }
     void  WriteRaw(void *pData, size_t size);
     void  Write7BitEncodedInt(int value);
     void  WriteString(std::string str);
   private:
-    HANDLE  hFile;
+    FILE    *pFile;
   };
 }
\ No newline at end of file
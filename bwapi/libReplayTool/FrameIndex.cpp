@@ -0,0 +1,148 @@
+#include "FrameIndex.h"
+#include <cstring>
+#include "FileReader.h"
+#include "FileWriter.h"
+#include "ReplayReader.h"
+
+using namespace std;
+using namespace ReplayTool;
+
+namespace
+{
+  struct FrameIndexHeader
+  {
+    DWORD dwMagic;
+    WORD  wVersion;
+    WORD  wReserved;
+    DWORD dwActionsSize;
+    DWORD dwInterval;
+    DWORD dwEntryCount;
+  };
+}
+
+FrameIndex::FrameIndex()
+  : dwInterval(FRAME_INDEX_DEFAULT_INTERVAL)
+  , dwActionsSize(0)
+{
+}
+
+void FrameIndex::clear()
+{
+  entries.clear();
+  dwActionsSize = 0;
+}
+
+void FrameIndex::build(const BYTE *pActions, DWORD dwSize, DWORD dwNewInterval)
+{
+  entries.clear();
+  dwInterval = dwNewInterval != 0 ? dwNewInterval : 1;
+  dwActionsSize = dwSize;
+
+  // Every frame is the tick, the byte count of its actions, and the actions. Damaged replays
+  // can go back in time, so only frames past the last indexed one are indexed, and the ticks
+  // of the entries always increase.
+  DWORD dwOffset = 0;
+  while (dwOffset + sizeof(DWORD) + sizeof(BYTE) <= dwSize)
+  {
+    DWORD dwFrameTick;
+    memcpy(&dwFrameTick, &pActions[dwOffset], sizeof(dwFrameTick));
+
+    if (entries.empty() ||
+        (dwFrameTick > entries.back().dwFrameTick && dwFrameTick - entries.back().dwFrameTick >= dwInterval))
+    {
+      Entry entry = { dwFrameTick, dwOffset };
+      entries.push_back(entry);
+    }
+    dwOffset += sizeof(DWORD) + sizeof(BYTE) + pActions[dwOffset + sizeof(DWORD)];
+  }
+}
+
+void FrameIndex::build(const ReplayReader &reader, DWORD dwNewInterval)
+{
+  build((const BYTE*)(void*)reader, (DWORD)reader.size(), dwNewInterval);
+}
+
+DWORD FrameIndex::findOffset(DWORD dwFrameTick) const
+{
+  // Binary search for the first entry past the tick
+  size_t begin = 0, end = entries.size();
+  while (begin < end)
+  {
+    size_t middle = (begin + end) / 2;
+    if (entries[middle].dwFrameTick <= dwFrameTick)
+      begin = middle + 1;
+    else
+      end = middle;
+  }
+  return begin == 0 ? 0 : entries[begin - 1].dwOffset;
+}
+
+bool FrameIndex::save(const char *pszIndexPath) const
+{
+  FrameIndexHeader header;
+  memset(&header, 0, sizeof(header));
+  header.dwMagic = FRAME_INDEX_MAGIC;
+  header.wVersion = FRAME_INDEX_VERSION;
+  header.dwActionsSize = dwActionsSize;
+  header.dwInterval = dwInterval;
+  header.dwEntryCount = (DWORD)entries.size();
+
+  FileWriter fw;
+  if (!fw.Open(pszIndexPath))
+    return false;
+
+  fw.WriteRaw(&header, sizeof(header));
+  if (!entries.empty())
+    fw.WriteRaw((void*)&entries[0], entries.size() * sizeof(Entry));
+  fw.Close();
+  return true;
+}
+
+bool FrameIndex::load(const char *pszIndexPath, DWORD dwExpectedActionsSize)
+{
+  clear();
+
+  FileReader fr;
+  fr.SetQuiet(true);
+  if (!fr.Open(pszIndexPath))
+    return false;
+
+  FrameIndexHeader header = fr.Read<FrameIndexHeader>();
+  if (fr.Eof() || header.dwMagic != FRAME_INDEX_MAGIC || header.wVersion != FRAME_INDEX_VERSION ||
+      header.dwActionsSize != dwExpectedActionsSize || header.dwInterval == 0)
+    return false;
+
+  // There is at most one entry per frame, and every frame takes at least 5 bytes
+  if (header.dwEntryCount > dwExpectedActionsSize / 5)
+    return false;
+  const BYTE *pEntries = fr.ReadPtr(header.dwEntryCount * sizeof(Entry));
+  if (pEntries == NULL)
+    return false;
+
+  entries.resize(header.dwEntryCount);
+  if (!entries.empty())
+    memcpy(&entries[0], pEntries, entries.size() * sizeof(Entry));
+  dwInterval = header.dwInterval;
+  dwActionsSize = header.dwActionsSize;
+  return true;
+}
+
+bool FrameIndex::loadOrBuild(const char *pszReplayPath, const ReplayReader &reader, bool bSave)
+{
+  if (!reader)
+    return false;
+
+  string indexPath = getIndexPath(pszReplayPath);
+  if (load(indexPath.c_str(), (DWORD)reader.size()))
+    return true;
+
+  build(reader);
+  if (bSave)
+    save(indexPath.c_str());
+  return true;
+}
+
+string FrameIndex::getIndexPath(const char *pszReplayPath)
+{
+  return string(pszReplayPath) + FRAME_INDEX_EXTENSION;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ReplayToolDefs.h"
+
+START_REPLAY_TOOL
+
+class ReplayReader;
+
+#define FRAME_INDEX_MAGIC             mmioFOURCC('R','F','I','X')
+#define FRAME_INDEX_VERSION           1
+#define FRAME_INDEX_EXTENSION         ".fidx"
+
+// About 10 seconds of game time at the Fastest game speed
+#define FRAME_INDEX_DEFAULT_INTERVAL  240
+
+// Maps frame ticks to the byte offsets of frames in the action section of a replay, for one
+// frame in every interval of frame ticks. The index is built from the frame headers alone, so
+// building it does not parse any action.
+class FrameIndex
+{
+public:
+  struct Entry
+  {
+    DWORD dwFrameTick;
+    DWORD dwOffset;
+  };
+
+  FrameIndex();
+
+  void build(const BYTE *pActions, DWORD dwActionsSize, DWORD dwInterval = FRAME_INDEX_DEFAULT_INTERVAL);
+  void build(const ReplayReader &reader, DWORD dwInterval = FRAME_INDEX_DEFAULT_INTERVAL);
+  void clear();
+
+  // Offset of the last indexed frame whose tick is not above dwFrameTick, or 0 if there is none
+  DWORD findOffset(DWORD dwFrameTick) const;
+
+  bool save(const char *pszIndexPath) const;
+
+  // Fails if the file is not an index of an action section of dwActionsSize bytes
+  bool load(const char *pszIndexPath, DWORD dwActionsSize);
+
+  // Loads the index next to a replay, or builds it if it is missing or out of date. A built
+  // index is written next to the replay if bSave is set.
+  bool loadOrBuild(const char *pszReplayPath, const ReplayReader &reader, bool bSave = true);
+
+  static std::string getIndexPath(const char *pszReplayPath);
+
+  const std::vector<Entry>& getEntries() const { return entries; }
+  DWORD getInterval() const { return dwInterval; }
+  DWORD getActionsSize() const { return dwActionsSize; }
+
+private:
+  std::vector<Entry> entries;
+  DWORD dwInterval;
+  DWORD dwActionsSize;
+};
+
+END_REPLAY_TOOL
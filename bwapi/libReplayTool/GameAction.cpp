@@ -7,21 +7,27 @@ using namespace std;
 using namespace BWAPI;
 using namespace ReplayTool;
 
+GameAction::Factory::Factory()
+{
+  for (unsigned i = 0; i < 256; ++i)
+    actions[i] = nullptr;
+}
+
 void GameAction::Factory::add(GameAction* prototype)
 {
   if (prototype != nullptr)
   {
-    if (actions.find(prototype->getAction()) == actions.end())
-      actions.insert(make_pair(prototype->getAction(), prototype));
+    if (actions[prototype->getAction()] == nullptr)
+      actions[prototype->getAction()] = prototype;
   }
 }
 
 GameAction* GameAction::Factory::create(PlayerID player, ActionID action)
 {
-  ActionMap::iterator itr = actions.find(action);
+  GameAction* prototype = actions[action];
 
-  if (itr != actions.end())
-    return (*itr).second->from(player);
+  if (prototype != nullptr)
+    return prototype->from(player);
   else
     return nullptr;
 }
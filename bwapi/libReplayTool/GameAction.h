@@ -1,6 +1,5 @@
 #pragma once
 
-#include <map>
 #include "BWAPI.h"
 #include "ReplayToolDefs.h"
 
@@ -14,13 +13,15 @@ public:
   class Factory
   {
   public:
+    Factory();
+
     void add(GameAction* prototype);
     GameAction* create(PlayerID player, ActionID AbstractAction);
     static Factory& instance();
 
   private:
-    typedef std::map<ActionID, GameAction*> ActionMap;
-    ActionMap actions;
+    // Prototypes indexed by opcode
+    GameAction* actions[256];
   };
 
   GameAction(PlayerID player, ActionID AbstractAction);
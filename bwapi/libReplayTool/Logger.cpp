@@ -1,14 +1,34 @@
 #include "Logger.h"
+#include <cstdarg>
+#include <cstring>
 
+using namespace std;
 using namespace ReplayTool;
 
-Logger::Logger(const char *filename)
+Logger::Logger(const char *filename, bool bDebugOutput)
   : file(filename == nullptr ? nullptr : fopen(filename, "a"))
+  , debugOutput(bDebugOutput)
+  , lineCount(0)
+  , writing(false)
+  , stopping(false)
 {
+  block.data.resize(LOGGER_BLOCK_SIZE);
+  block.size = 0;
 }
 
 Logger::~Logger()
 {
+  flush();
+  if (writer.joinable())
+  {
+    {
+      lock_guard<mutex> lock(queueMutex);
+      stopping = true;
+    }
+    queued.notify_one();
+    writer.join();
+  }
+
   if (file != nullptr)
   {
     fclose(file);
@@ -18,12 +38,171 @@ Logger::~Logger()
 
 void Logger::writeLine(const char *pszFormat, ...)
 {
-  if (file != nullptr)
+  if (file == nullptr)
+    return;
+
+  va_list vl;
+  va_start(vl, pszFormat);
+
+  // Format in place at the end of the block, and if the line does not fit, once more in a new
+  // block. A line that does not fit in a block of its own is formatted in a separate buffer.
+  for (int attempt = 0; attempt < 2; ++attempt)
+  {
+    size_t lineBegin = block.size;
+    size_t available = block.data.size() - lineBegin;
+
+    // The previous line may have filled the block, leaving lineBegin at its end
+    va_list args;
+    va_copy(args, vl);
+    int length = vsnprintf(block.data.data() + lineBegin, available, pszFormat, args);
+    va_end(args);
+
+    // Room is needed for the line feed too. Older CRTs return -1 for a line that does not fit.
+    if (length >= 0 && (size_t)length < available)
+    {
+      va_end(vl);
+      block.size += length;
+      endLine(lineBegin);
+      return;
+    }
+
+    if (lineBegin == 0)
+      break;
+    queueBlock();
+  }
+
+  int length = -1;
+  while (length < 0 || (size_t)length >= longLine.size())
+  {
+    longLine.resize(length < 0 ? longLine.size() * 2 + LOGGER_BLOCK_SIZE : (size_t)length + 1);
+
+    va_list args;
+    va_copy(args, vl);
+    length = vsnprintf(&longLine[0], longLine.size(), pszFormat, args);
+    va_end(args);
+  }
+  va_end(vl);
+  writeText(&longLine[0], length);
+}
+
+void Logger::writeText(const char *pszText, size_t size)
+{
+  if (file == nullptr)
+    return;
+
+  if (block.size + size >= block.data.size())
+    queueBlock();
+
+  if (size >= block.data.size())
+  {
+    // Written as it is, after what is already queued
+    flush();
+    fwrite(pszText, 1, size, file);
+    fputc('\n', file);
+    if (debugOutput)
+    {
+      string debugLine = to_string(lineCount) + ": " + string(pszText, size) + "\n";
+      OutputDebugStringA(debugLine.c_str());
+    }
+    ++lineCount;
+    return;
+  }
+
+  size_t lineBegin = block.size;
+  memcpy(&block.data[lineBegin], pszText, size);
+  block.size += size;
+  endLine(lineBegin);
+}
+
+void Logger::endLine(size_t lineBegin)
+{
+  if (debugOutput)
   {
-    va_list vl;
-    va_start(vl,pszFormat);
-    vfprintf_s(file, pszFormat, vl);
-    fprintf_s(file, "\n");
-    va_end(vl);
+    // Numbered like the lines of the action traces
+    char prefix[16];
+    sprintf_s(prefix, sizeof(prefix), "%u: ", lineCount);
+    string debugLine = prefix;
+    debugLine.append(&block.data[lineBegin], block.size - lineBegin);
+    debugLine += '\n';
+    OutputDebugStringA(debugLine.c_str());
   }
-}
\ No newline at end of file
+  block.data[block.size++] = '\n';
+  ++lineCount;
+}
+
+void Logger::queueBlock()
+{
+  if (block.size == 0)
+    return;
+
+  unique_lock<mutex> lock(queueMutex);
+  if (!writer.joinable())
+    writer = thread(&Logger::writerLoop, this);
+
+  pending.push_back(Block());
+  pending.back().data.swap(block.data);
+  pending.back().size = block.size;
+  if (!spare.empty())
+  {
+    block.data.swap(spare.back().data);
+    spare.pop_back();
+  }
+  else
+  {
+    block.data.resize(LOGGER_BLOCK_SIZE);
+  }
+  block.size = 0;
+  lock.unlock();
+  queued.notify_one();
+}
+
+void Logger::flush()
+{
+  if (file == nullptr)
+    return;
+
+  // Without a writer thread, the block is written directly
+  if (writer.joinable())
+  {
+    queueBlock();
+    unique_lock<mutex> lock(queueMutex);
+    written.wait(lock, [this]{ return pending.empty() && !writing; });
+  }
+  else if (block.size != 0)
+  {
+    writeBlock(block);
+    block.size = 0;
+  }
+  fflush(file);
+}
+
+void Logger::writeBlock(const Block &blockToWrite)
+{
+  fwrite(&blockToWrite.data[0], 1, blockToWrite.size, file);
+}
+
+void Logger::writerLoop()
+{
+  unique_lock<mutex> lock(queueMutex);
+  for (;;)
+  {
+    queued.wait(lock, [this]{ return !pending.empty() || stopping; });
+    if (pending.empty())
+      return;
+
+    Block blockToWrite;
+    blockToWrite.data.swap(pending.front().data);
+    blockToWrite.size = pending.front().size;
+    pending.pop_front();
+    writing = true;
+
+    lock.unlock();
+    writeBlock(blockToWrite);
+    lock.lock();
+
+    writing = false;
+    spare.push_back(Block());
+    spare.back().data.swap(blockToWrite.data);
+    written.notify_all();
+  }
+}
@@ -1,19 +1,73 @@
 #pragma once
 
+#include <condition_variable>
 #include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 #include "ReplayToolDefs.h"
 
 START_REPLAY_TOOL
 
+// Size of the blocks that a Logger writes to its file
+#define LOGGER_BLOCK_SIZE 0x10000
+
+// Appends lines of text to a file. Lines are formatted into a block in memory, and full blocks
+// are written by a background thread, which is only started once the first block is full. The
+// lines are in the file once the logger is flushed or destroyed.
+//
+// A logger is used by one thread at a time.
 class Logger
 {
 public:
-  Logger(const char *filename);
+  // Also sends every line to the debugger output, numbered, if bDebugOutput is set
+  Logger(const char *filename, bool bDebugOutput = false);
   ~Logger();
+
   void writeLine(const char *pszFormat, ...);
 
+  // Same as writeLine("%s", pszText), without formatting
+  void writeText(const char *pszText) { writeText(pszText, strlen(pszText)); }
+  void writeText(const char *pszText, size_t size);
+
+  // Writes everything that was logged to the file
+  void flush();
+
+  bool isOpen() const { return file != nullptr; }
+  bool hasDebugOutput() const { return debugOutput; }
+
 private:
+  struct Block
+  {
+    std::vector<char> data;
+    size_t size;
+  };
+
+  void endLine(size_t lineBegin);
+  void queueBlock();
+  void writeBlock(const Block &blockToWrite);
+  void writerLoop();
+
   FILE* file;
+  bool debugOutput;
+  unsigned lineCount;
+
+  // The block that lines are written to, and a buffer for lines that do not fit in a block
+  Block block;
+  std::vector<char> longLine;
+
+  // Blocks waiting for the writer thread, and written blocks that can be reused
+  std::thread writer;
+  std::mutex queueMutex;
+  std::condition_variable queued;
+  std::condition_variable written;
+  std::deque<Block> pending;
+  std::vector<Block> spare;
+  bool writing;
+  bool stopping;
 };
 
-END_REPLAY_TOOL
\ No newline at end of file
+END_REPLAY_TOOL
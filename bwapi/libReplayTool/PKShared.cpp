@@ -6,10 +6,10 @@
 
 using namespace ReplayTool;
 
-_Param params;
-char bWorkBuff[EXP_BUFFER_SIZE];
-char bWorkBuff2[CMP_BUFFER_SIZE];
-char bSegment[0x2000];
+// Work buffers of the calling thread, so that replays can be read on several threads at once
+REPLAY_TOOL_THREAD_LOCAL char bWorkBuff[EXP_BUFFER_SIZE];
+REPLAY_TOOL_THREAD_LOCAL char bWorkBuff2[CMP_BUFFER_SIZE];
+REPLAY_TOOL_THREAD_LOCAL char bSegment[SECTION_CHUNK_SIZE];
 
 unsigned int PKEXPORT read_buf(char *buf, unsigned int *size, void *_param)
 {
@@ -36,77 +36,91 @@ bool DecompressRead(void *pOutput, size_t outputSize, FileReader &fr)
     return false;
 
   char *_pOutput = (char*)pOutput;
+  _Param params;
   memset(bWorkBuff, 0, sizeof(bWorkBuff));
-  memset(bSegment, 0, sizeof(bSegment));
   memset(&params, 0, sizeof(params));
 
   _Part hdr = fr.Read<_Part>();
   DWORD dwPos = 0;
   for ( DWORD s = 0; s < hdr.dwSectionCount; ++s )
   {
-    size_t chunkSize = fr.Read<size_t>();
+    // Sections are read straight from the file, and decompressed straight into the output
+    DWORD chunkSize = fr.Read<DWORD>();
     if ( chunkSize > outputSize )
-    {
-      MessageBox(NULL, "ChunkSize > output", 0, 0);
       return false;
-    }
 
-    char *pTmp = (char*)malloc(chunkSize);
-    if ( pTmp != nullptr )
+    const char *pChunk = (const char*)fr.ReadPtr(chunkSize);
+    if ( pChunk == nullptr )
+      return false;
+
+    // A chunk that does not get smaller is stored as it is
+    DWORD dwChunkOutput = outputSize - dwPos;
+    if ( dwChunkOutput > SECTION_CHUNK_SIZE )
+      dwChunkOutput = SECTION_CHUNK_SIZE;
+
+    if ( chunkSize != dwChunkOutput )
     {
-      fr.Read(pTmp, chunkSize);
-      if ( chunkSize != outputSize )
-      {
-        memset(&params, 0, sizeof(params));
-        params.pCompressedData    = pTmp;
-        params.dwMaxRead          = chunkSize;
-        params.pDecompressedData  = bSegment;
-        params.dwMaxWrite         = sizeof(bSegment);
-
-        if ( explode(&read_buf, &write_buf, bWorkBuff, &params) )
-          return false;
-
-        if ( params.dwWritePos <= sizeof(bSegment) )
-        {
-          memcpy(&_pOutput[dwPos], bSegment, params.dwWritePos);
-          dwPos     += params.dwWritePos;
-        }
-      }
-      else
-      {
-        memcpy(&_pOutput[dwPos], pTmp, chunkSize);
-        dwPos += chunkSize;
-      }
-      free(pTmp);
+      memset(&params, 0, sizeof(params));
+      params.pCompressedData    = pChunk;
+      params.dwMaxRead          = chunkSize;
+      params.pDecompressedData  = &_pOutput[dwPos];
+      params.dwMaxWrite         = outputSize - dwPos;
+
+      if ( explode_fast(&read_buf, &write_buf, bWorkBuff, &params) || params.dwWritePos > params.dwMaxWrite )
+        return false;
+      dwPos += params.dwWritePos;
+    }
+    else
+    {
+      if ( chunkSize == 0 )
+        return false;
+      memcpy(&_pOutput[dwPos], pChunk, chunkSize);
+      dwPos += chunkSize;
     }
   }
 
   unsigned int  dwSize = outputSize;
-  unsigned long dwOld  = ~0;
-  return crc32pk((char*)pOutput, &dwSize, &dwOld) == hdr.dwCrc32Sum;
+  unsigned long dwOld  = 0xFFFFFFFF;
+  return (DWORD)crc32pk((char*)pOutput, &dwSize, &dwOld) == hdr.dwCrc32Sum;
+}
+
+DWORD CompressChunk(const void *pInput, DWORD dwSize, void *pOutput, CompressLevel level)
+{
+  _Param params;
+  memset(&params, 0, sizeof(params));
+  params.pCompressedData    = (const char*)pInput;
+  params.dwMaxRead          = dwSize;
+  params.pDecompressedData  = (char*)pOutput;
+  params.dwMaxWrite         = dwSize;
+
+  // implode can compare past the end of its input, so the work buffer is cleared for the output of
+  // a chunk to depend on nothing else, whichever thread compresses it
+  memset(bWorkBuff2, 0, sizeof(bWorkBuff2));
+  unsigned int dwType = CMP_BINARY;
+  unsigned int dwImplSize = level;
+  if ( implode(&read_buf, &write_buf, bWorkBuff2, &params, &dwType, &dwImplSize) || params.dwWritePos >= dwSize )
+    return 0;
+  return params.dwWritePos;
 }
 
-void CompressWrite(void *pInput, size_t inputSize, FileWriter &fw)
+void CompressWrite(void *pInput, size_t inputSize, FileWriter &fw, CompressLevel level)
 {
   if ( !pInput )
     return;
 
   char *_pInput = (char*)pInput;
-  memset(bWorkBuff2, 0, sizeof(bWorkBuff2));
-  memset(bSegment, 0, sizeof(bSegment));
-  memset(&params, 0, sizeof(params));
 
   // Write Header
   _Part hdr = { 0 };
 
   // checksum
   unsigned int  dwSize = inputSize;
-  unsigned long dwOld  = ~0;
-  hdr.dwCrc32Sum = crc32pk((char*)pInput, &dwSize, &dwOld);
+  unsigned long dwOld  = 0xFFFFFFFF;
+  hdr.dwCrc32Sum = (DWORD)crc32pk((char*)pInput, &dwSize, &dwOld);
 
   // sections
-  hdr.dwSectionCount = dwSize / 0x2000;
-  if ( dwSize % 0x2000 )
+  hdr.dwSectionCount = dwSize / SECTION_CHUNK_SIZE;
+  if ( dwSize % SECTION_CHUNK_SIZE )
     hdr.dwSectionCount++;
   
   // write
@@ -117,34 +131,20 @@ void CompressWrite(void *pInput, size_t inputSize, FileWriter &fw)
   for ( DWORD s = 0; s < hdr.dwSectionCount; ++s )
   {
     DWORD dwWriteSize = inputSize - dwPos;
-    if ( dwWriteSize > 0x2000 )
-      dwWriteSize = 0x2000;
-
-    memset(&params, 0, sizeof(params));
-    params.pCompressedData    = &_pInput[dwPos];
-    params.dwMaxRead          = dwWriteSize;
-    params.pDecompressedData  = bSegment;
-    params.dwMaxWrite         = dwWriteSize;
-
-    unsigned int dwType = 0;
-    unsigned int dwImplSize = 0x400;
-    if ( implode(&read_buf, &write_buf, bWorkBuff2, &params, &dwType, &dwImplSize) || params.dwWritePos >= dwWriteSize )
+    if ( dwWriteSize > SECTION_CHUNK_SIZE )
+      dwWriteSize = SECTION_CHUNK_SIZE;
+
+    DWORD dwCompressedSize = CompressChunk(&_pInput[dwPos], dwWriteSize, bSegment, level);
+    if ( dwCompressedSize == 0 )
     {
-      if ( !dwWriteSize )
-        return;
       fw.Write<DWORD>(dwWriteSize);
       fw.WriteRaw(&_pInput[dwPos], dwWriteSize);
-      dwPos += dwWriteSize;
     }
     else
     {
-      if ( !params.dwWritePos )
-        return;
-      fw.Write<DWORD>(params.dwWritePos);
-      fw.WriteRaw(bSegment, params.dwWritePos);
-      dwPos += dwWriteSize;
+      fw.Write<DWORD>(dwCompressedSize);
+      fw.WriteRaw(bSegment, dwCompressedSize);
     }
-
-    
+    dwPos += dwWriteSize;
   } // for
 }
@@ -1,6 +1,6 @@
 #pragma once
 #include "../PKLib/pklib.h"
-#include <windows.h>
+#include "ReplayToolDefs.h"
 
 namespace ReplayTool
 {
@@ -8,6 +8,17 @@ namespace ReplayTool
   class FileWriter;
 }
 
+// Size of the chunks that sections are compressed in
+#define SECTION_CHUNK_SIZE 0x2000
+
+// Dictionary sizes of implode, from the fastest to the smallest output. Broodwar reads all of them.
+enum CompressLevel
+{
+  CompressLevel_Fast    = 0x400,
+  CompressLevel_Normal  = 0x800,
+  CompressLevel_Best    = 0x1000
+};
+
 typedef struct __Part
 {
   DWORD dwCrc32Sum;
@@ -16,7 +27,7 @@ typedef struct __Part
 
 typedef struct __Param
 {
-  char  *pCompressedData;
+  const char *pCompressedData;
   DWORD dwReadPos;
   char  *pDecompressedData;
   DWORD dwWritePos;
@@ -28,4 +39,8 @@ typedef struct __Param
 unsigned int PKEXPORT read_buf(char *buf, unsigned int *size, void *_param);
 void PKEXPORT write_buf(char *buf, unsigned int *size, void *_param);
 bool DecompressRead(void *pOutput, size_t outputSize, ReplayTool::FileReader &fr);
-void CompressWrite(void *pInput, size_t inputSize, ReplayTool::FileWriter &fw);
\ No newline at end of file
+
+// Compresses a chunk of at most SECTION_CHUNK_SIZE bytes into pOutput, which has room for dwSize
+// bytes. Returns the compressed size, or 0 if the chunk does not get smaller and is stored as it is.
+DWORD CompressChunk(const void *pInput, DWORD dwSize, void *pOutput, CompressLevel level);
+void CompressWrite(void *pInput, size_t inputSize, ReplayTool::FileWriter &fw, CompressLevel level = CompressLevel_Fast);
\ No newline at end of file
@@ -1,5 +1,6 @@
-#pragma 
+#pragma once
 
+#include "PKShared.h"
 #include "ReplayToolDefs.h"
 
 START_REPLAY_TOOL
@@ -9,6 +10,8 @@ class ParseReplayParams
 public:
   ParseReplayParams()
     :option('\0')
+    ,compressLevel(CompressLevel_Fast)
+    ,debugOutput(false)
   {
     replayPath[0] = outRepoPath[0] = '\0';
   }
@@ -22,10 +25,19 @@ public:
   char getOption() const { return option; }
   void setOption(char val) { option = val; }
 
+  CompressLevel getCompressLevel() const { return compressLevel; }
+  void setCompressLevel(CompressLevel val) { compressLevel = val; }
+
+  // Also sends the action traces to the debugger output
+  bool getDebugOutput() const { return debugOutput; }
+  void setDebugOutput(bool val) { debugOutput = val; }
+
 private:
   char  replayPath[MAX_PATH];
   char  outRepoPath[MAX_PATH];
   char  option;
+  CompressLevel compressLevel;
+  bool  debugOutput;
 };
 
 END_REPLAY_TOOL
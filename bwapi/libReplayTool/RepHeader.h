@@ -71,4 +71,7 @@ namespace ReplayTool
     BYTE  bPlayerForceData[8];
   };
   #pragma pack()
+
+  // The header is read straight from the replay, so its layout must not depend on the platform
+  static_assert(sizeof(replay_resource) == 0x279, "replay_resource must match the replay format");
 }
\ No newline at end of file
@@ -1,50 +1,111 @@
 #include "Replay.h"
+#include <cstdlib>
 #include <fstream>
-#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
 #include "PKShared.h"
 #include "FileReader.h"
 #include "FileWriter.h"
-#include "ReplayReader.h"
+#include "StreamReplayReader.h"
 #include "RepHeader.h"
 #include "GameAction.h"
+#include "Logger.h"
 #include "ActionParser.h"
 #include "ParseReplayParams.h"
+#include "SectionCompressor.h"
 
 using namespace std;
 using namespace ReplayTool;
 
-replay_resource replayHeader;
+#ifdef _WIN32
+#define PATH_SEPARATOR '\\'
+#else
+#define PATH_SEPARATOR '/'
+#endif
 
-void writeBuffer(const char *pszFormat, const char *pszFilename, void *pBuffer, DWORD dwBufferSize)
+void writeBuffer(const std::string &filename, void *pBuffer, DWORD dwBufferSize)
 {
   FileWriter fw;
-  char szTmp[MAX_PATH];
-  sprintf(szTmp, pszFormat, pszFilename);
-  if ( fw.Open( szTmp ) )
+  if ( fw.Open( filename.c_str() ) )
     fw.WriteRaw(pBuffer, dwBufferSize);
 }
 
+// The logs that every replay adds to. They are opened with the first message instead of for
+// every message, and messages are flushed as they are written, so they are not lost if the tool
+// stops.
+namespace
+{
+  std::mutex logMutex;
+  std::unique_ptr<Logger> errLog, resultLog;
+
+  Logger &openLog(std::unique_ptr<Logger> &log, const char *pszFilename)
+  {
+    if ( !log )
+      log.reset(new Logger(pszFilename));
+    return *log;
+  }
+}
+
 bool errSimple(const char *pszText)
 {
-  std::ofstream log("Replay_errLog.log", std::ios_base::app);
-  log << pszText << "\n";
-  log.close();
+  std::lock_guard<std::mutex> lock(logMutex);
+  Logger &log = openLog(errLog, "Replay_errLog.log");
+  log.writeText(pszText);
+  log.flush();
   return false;
 }
 
+bool fileExists(const char *pszFilename)
+{
+  std::ifstream file(pszFilename);
+  return file.is_open();
+}
+
+// Writes the sections of a replay, compressed in parallel
+void writeReplay(FileWriter &fw, CompressLevel level, const replay_resource &replayHeader,
+                 const void *pActions, DWORD dwActionBufferSize, const void *pChk, DWORD dwChkBufferSize)
+{
+  SectionCompressor compressor(level);
+
+  // rep resource id
+  DWORD dwRepResourceID = mmioFOURCC('r','e','R','S');
+  compressor.add(&dwRepResourceID, sizeof(dwRepResourceID));
+
+  // header
+  compressor.add(&replayHeader, sizeof(replayHeader));
+
+  // actions
+  compressor.add(&dwActionBufferSize, sizeof(dwActionBufferSize));
+  if ( dwActionBufferSize )
+    compressor.add(pActions, dwActionBufferSize);
+
+  // chk
+  compressor.add(&dwChkBufferSize, sizeof(dwChkBufferSize));
+  if ( dwChkBufferSize )
+    compressor.add(pChk, dwChkBufferSize);
+
+  compressor.write(fw);
+}
+
 /*!
- * @fn void getActionsTraceFilepath(const ParseReplayParams& params, char actionsDbgFilepath[MAX_PATH])
+ * @fn std::string getActionsTraceFilepath(const ParseReplayParams& params)
  * @brief Generates a unique filename for the action trace file for a given replay.
  * The action trace filename format: <replay-filename>.[<ID>.]trace.txt
  * where ID is a unique number > 0 that is used if file with name <replay-filename>.trace.txt already exists
  * Example: if the provided replay filename is LastReplay.rep, then the generated action trace filename is LastReplay.trace.txt
  * and if LastReplay.trace.txt already exists, then the generated one is LastReplay.1.trace.txt, and so on ...
- * @param actionsDbgFilepath[out] a complete filepath of the action trace file.
+ * @return a complete filepath of the action trace file.
  */
-void getActionsTraceFilepath(const ParseReplayParams& params, char actionsDbgFilepath[MAX_PATH]) 
+std::string getActionsTraceFilepath(const ParseReplayParams& params)
 {
-  fstream actionsDbgFile;
   const char* replayFilename = strrchr(params.getReplayPath(), '\\');
+  const char* replayFilenameAlt = strrchr(params.getReplayPath(), '/');
+
+  if (NULL == replayFilename || (NULL != replayFilenameAlt && replayFilenameAlt > replayFilename))
+  {
+    replayFilename = replayFilenameAlt;
+  }
 
   // In case the path has no slashes i.e the replay file name only
   if (NULL == replayFilename)
@@ -57,31 +118,18 @@ void getActionsTraceFilepath(const ParseReplayParams& params, char actionsDbgFil
     ++replayFilename;
   }
 
-  actionsDbgFilepath[0] = '\0';
-
-  sprintf_s(actionsDbgFilepath, MAX_PATH, "%s\\%s.trace.txt", params.getOutRepoPath(), replayFilename);
-  actionsDbgFile.open(actionsDbgFilepath, ios::in | ios::out | ios::_Nocreate);
+  std::string basePath = std::string(params.getOutRepoPath()) + PATH_SEPARATOR + replayFilename;
+  std::string actionsDbgFilepath = basePath + ".trace.txt";
 
-  // File could be opened successfully which means that a filename collision happened
-  // a file with the same name already exists, need to generate a unique filename
-  if (actionsDbgFile)
+  // A file with the same name already exists, which means that a filename collision happened,
+  // need to generate a unique filename
+  unsigned nameCollisionID = 0;
+  while (fileExists(actionsDbgFilepath.c_str()))
   {
-    unsigned nameCollisionID = 0;
-
-    do
-    {
-      actionsDbgFile.close();
-
-      actionsDbgFilepath[0] = '\0';
-      ++nameCollisionID;
-      sprintf_s(actionsDbgFilepath, MAX_PATH, "%s\\%s.%u.trace.txt", params.getOutRepoPath(), replayFilename, nameCollisionID);
-
-      actionsDbgFile.open(actionsDbgFilepath, ios::in | ios::out | ios::_Nocreate);
-    }
-    while (actionsDbgFile);
+    ++nameCollisionID;
+    actionsDbgFilepath = basePath + "." + std::to_string(nameCollisionID) + ".trace.txt";
   }
-
-  actionsDbgFile.close();
+  return actionsDbgFilepath;
 }
 
 extern "C" bool parseReplay(const ParseReplayParams& params, DWORD dwFlags)
@@ -92,6 +140,8 @@ extern "C" bool parseReplay(const ParseReplayParams& params, DWORD dwFlags)
     return false;
 
 ///////////////////// Header
+  replay_resource replayHeader;
+
   // Read replay resource identifier
   DWORD dwRepResourceID = 0;
   // Best guess: "reRS" is "replay RESOURCE"
@@ -108,10 +158,19 @@ extern "C" bool parseReplay(const ParseReplayParams& params, DWORD dwFlags)
   if ( !DecompressRead(&dwActionBufferSize, 4, fr) )
     return errSimple("Unable to read actions size.");
 
-  // Allocate and Read replay actions
-  ReplayReader repActions(dwActionBufferSize);
-  if ( dwActionBufferSize && (!repActions || !DecompressRead(repActions, dwActionBufferSize, fr)) )
-    return errSimple("Decompressing actions failed.");
+  // Parse the actions while they are decompressed, so that the whole section is only kept in
+  // memory when it is written out again
+  DWORD dwActionsOffset = fr.Tell();
+  ReplayTool::ActionList actions;
+  DWORD dwHighestFrameTick = 0;
+  {
+    StreamReplayReader repActions(fr, dwActionBufferSize);
+    if ( dwFlags & RFLAG_REPAIR )
+      parseActions(repActions, actions);
+    if ( !repActions.verify() )
+      return errSimple("Decompressing actions failed.");
+    dwHighestFrameTick = repActions.highestFrameTick();
+  }
 
 /////////////////// Map Chk
   // get map chunk data size
@@ -120,63 +179,86 @@ extern "C" bool parseReplay(const ParseReplayParams& params, DWORD dwFlags)
     return errSimple("Unable to read chk size.");
 
   // Allocate and Read chk data
-  void *pChkBuffer = malloc(dwChkBufferSize);
-  //FileReader frChk(pChkBuffer, dwChkBufferSize);
-  if ( dwChkBufferSize && !DecompressRead(pChkBuffer, dwChkBufferSize, fr) )
+  std::unique_ptr<void, void(*)(void*)> chkBuffer(malloc(dwChkBufferSize), &free);
+  void *pChkBuffer = chkBuffer.get();
+  if ( dwChkBufferSize && (!pChkBuffer || !DecompressRead(pChkBuffer, dwChkBufferSize, fr)) )
     return errSimple("Decompressing map failed.");
 
+  // Decompress the actions again if they are extracted or the replay is rewritten
+  bool damaged = (dwFlags & RFLAG_REPAIR) && replayHeader.dwFrameCount < dwHighestFrameTick;
+  std::unique_ptr<void, void(*)(void*)> actionBuffer(nullptr, &free);
+  if ( dwActionBufferSize && ((dwFlags & RFLAG_EXTRACT) || damaged) )
+  {
+    fr.Seek(dwActionsOffset);
+    actionBuffer.reset(malloc(dwActionBufferSize));
+    if ( !actionBuffer || !DecompressRead(actionBuffer.get(), dwActionBufferSize, fr) )
+      return errSimple("Decompressing actions failed.");
+  }
+  void *pActions = actionBuffer.get();
+
+  // Everything is decompressed, release the mapping so that the replay can be rewritten
+  fr.Free();
+
   // Write extracted replay data
   if ( dwFlags & RFLAG_EXTRACT )
   {
-    writeBuffer("%s.hdr", params.getReplayPath(), &replayHeader, sizeof(replayHeader));
-    writeBuffer("%s.act", params.getReplayPath(), repActions, dwActionBufferSize);
-    writeBuffer("%s.chk", params.getReplayPath(), pChkBuffer, dwChkBufferSize);
+    std::string replayPath = params.getReplayPath();
+    writeBuffer(replayPath + ".hdr", &replayHeader, sizeof(replayHeader));
+    writeBuffer(replayPath + ".act", pActions, dwActionBufferSize);
+    writeBuffer(replayPath + ".chk", pChkBuffer, dwChkBufferSize);
   }
 
   // parse data for repair
   if ( dwFlags & RFLAG_REPAIR )
   {
-    list<ReplayTool::GameAction*> actions;
-    char actionsDbgFilepath[MAX_PATH];
+    logActions(actions, getActionsTraceFilepath(params).c_str(), params.getDebugOutput());
 
-    getActionsTraceFilepath(params, actionsDbgFilepath);
-
-    // Parse replay actions
-    parseActions(repActions, actions);
-    logActions(actions, actionsDbgFilepath);
-
-    if ( replayHeader.dwFrameCount < repActions.highestFrameTick() )
+    if ( damaged )
     {
-      std::ofstream log("Results.txt", std::ios_base::app);
-      log << params.getReplayPath() << " -- Fixed replay with " << replayHeader.dwFrameCount << " frames. Desired: " << repActions.highestFrameTick() << " frames.\n";
+      {
+        std::lock_guard<std::mutex> lock(logMutex);
+        Logger &log = openLog(resultLog, "Results.txt");
+        log.writeLine("%s -- Fixed replay with %u frames. Desired: %u frames.", params.getReplayPath(),
+                      replayHeader.dwFrameCount, dwHighestFrameTick);
+        log.flush();
+      }
 
-      replayHeader.dwFrameCount = repActions.highestFrameTick() + 100;
+      replayHeader.dwFrameCount = dwHighestFrameTick + 100;
 
       // Repair/reconstruct the replay
       FileWriter fw;
       fw.Open(params.getReplayPath());
+      writeReplay(fw, params.getCompressLevel(), replayHeader, pActions, dwActionBufferSize, pChkBuffer, dwChkBufferSize);
+    } // if replay is damaged
+  }
 
-      // write rep resource id
-      dwRepResourceID = mmioFOURCC('r','e','R','S');
-      CompressWrite(&dwRepResourceID, sizeof(dwRepResourceID), fw);
+  return true;
+}
 
-      // write header
-      CompressWrite(&replayHeader, sizeof(replayHeader), fw);
+extern "C" bool packReplay(const ParseReplayParams& params)
+{
+  // Read the files that an extract writes
+  std::string replayPath = params.getReplayPath();
+  FileReader hdrFile, actFile, chkFile;
+  if ( !hdrFile.Open((replayPath + ".hdr").c_str()) )
+    return false;
+  if ( !actFile.Open((replayPath + ".act").c_str()) )
+    return false;
+  if ( !chkFile.Open((replayPath + ".chk").c_str()) )
+    return false;
 
-      // write actions
-      CompressWrite(&dwActionBufferSize, sizeof(dwActionBufferSize), fw);
-      if ( dwActionBufferSize )
-        CompressWrite(repActions, repActions.size(), fw);
-    
-      // write chk
-      CompressWrite(&dwChkBufferSize, sizeof(dwChkBufferSize), fw);
-      if ( dwChkBufferSize )
-        CompressWrite(pChkBuffer, dwChkBufferSize, fw);
+  if ( hdrFile.Size() != sizeof(replay_resource) )
+    return errSimple("Invalid replay header size.");
+  replay_resource replayHeader = hdrFile.Read<replay_resource>();
 
-      log.close();
-    } // if replay is damaged
-  }
+  DWORD dwActionBufferSize = actFile.Size();
+  const void *pActions = dwActionBufferSize ? actFile.ReadPtr(dwActionBufferSize) : NULL;
+  DWORD dwChkBufferSize = chkFile.Size();
+  const void *pChk = dwChkBufferSize ? chkFile.ReadPtr(dwChkBufferSize) : NULL;
 
+  FileWriter fw;
+  if ( !fw.Open(params.getReplayPath()) )
+    return false;
+  writeReplay(fw, params.getCompressLevel(), replayHeader, pActions, dwActionBufferSize, pChk, dwChkBufferSize);
   return true;
 }
-
@@ -11,4 +11,8 @@ class ParseReplayParams;
 
 extern "C" bool parseReplay(const ParseReplayParams& params, DWORD dwFlags = 0);
 
+// Writes the replay from the .hdr, .act and .chk files that an extract writes next to it,
+// compressing its sections in parallel at the compression level of the parameters
+extern "C" bool packReplay(const ParseReplayParams& params);
+
 END_REPLAY_TOOL
\ No newline at end of file
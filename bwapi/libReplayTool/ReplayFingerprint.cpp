@@ -0,0 +1,242 @@
+#include "ReplayFingerprint.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <Util/sha1.h>
+#include "DecompressStream.h"
+#include "FileReader.h"
+#include "PKShared.h"
+#include "RepHeader.h"
+#include "ReplayIndex.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+using namespace ReplayTool;
+
+namespace
+{
+  const unsigned long long FNV_OFFSET_BASIS = 0xCBF29CE484222325ULL;
+  const unsigned long long FNV_PRIME        = 0x100000001B3ULL;
+
+  // Appends a fixed size string from the replay header, up to its terminator, so that whatever
+  // is left in the buffer after it does not count
+  void appendString(vector<BYTE> &key, const char *psz, size_t maxLength)
+  {
+    size_t length = 0;
+    while (length < maxLength && psz[length] != '\0')
+      ++length;
+    key.insert(key.end(), (const BYTE*)psz, (const BYTE*)psz + length);
+    key.push_back('\0');
+  }
+
+  template <typename T>
+  void appendValue(vector<BYTE> &key, const T &value)
+  {
+    key.insert(key.end(), (const BYTE*)&value, (const BYTE*)&value + sizeof(value));
+  }
+
+  // The parts of the header that are the same for everyone in a game. The name of the player who
+  // saved the replay is left out, as are the parts of the header that are not known to be shared.
+  void hashHeader(const replay_resource &header, BYTE hash[20])
+  {
+    vector<BYTE> key;
+    key.reserve(512);
+    appendValue(key, header.gameSeed.dwRandSeed);
+    appendValue(key, header.dwFrameCount);
+    appendString(key, header.networkGameHeader.szMapName, sizeof(header.networkGameHeader.szMapName));
+    appendValue(key, header.networkGameHeader.wMapWidth);
+    appendValue(key, header.networkGameHeader.wMapHeight);
+    for (int i = 0; i < 12; ++i)
+    {
+      const replay_resource::_playerEntry &entry = header.players[i];
+      appendValue(key, entry.nType);
+      appendValue(key, entry.nRace);
+      appendValue(key, entry.nTeam);
+      appendString(key, entry.szPlayerName, sizeof(entry.szPlayerName));
+    }
+    sha1::calc(&key[0], (int)key.size(), hash);
+  }
+
+  struct FingerprintEntry
+  {
+    ReplayFingerprint fingerprint;
+    size_t index;
+    bool valid;
+  };
+
+  bool operator<(const FingerprintEntry &a, const FingerprintEntry &b)
+  {
+    return a.fingerprint < b.fingerprint || (a.fingerprint == b.fingerprint && a.index < b.index);
+  }
+
+  // Reads the fingerprints of the replays in entries, drops the replays that cannot be read, and
+  // sorts the rest by fingerprint and then by path
+  void readFingerprints(WorkStealingPool &pool, const vector<string> &replays, vector<FingerprintEntry> &entries,
+                        bool bHashActions)
+  {
+    pool.run(entries.size(), [&](size_t i)
+    {
+      entries[i].valid = readReplayFingerprint(replays[entries[i].index].c_str(), entries[i].fingerprint, bHashActions);
+    });
+    entries.erase(remove_if(entries.begin(), entries.end(), [](const FingerprintEntry &entry) { return !entry.valid; }),
+                  entries.end());
+    sort(entries.begin(), entries.end());
+  }
+
+  // Calls fn with the begin and end of every run of two or more entries with the same fingerprint
+  template <typename Fn>
+  void forEachDuplicateRun(const vector<FingerprintEntry> &entries, Fn fn)
+  {
+    size_t begin = 0;
+    while (begin < entries.size())
+    {
+      size_t end = begin + 1;
+      while (end < entries.size() && entries[end].fingerprint == entries[begin].fingerprint)
+        ++end;
+      if (end - begin > 1)
+        fn(begin, end);
+      begin = end;
+    }
+  }
+
+  bool firstPathLess(const DuplicateReplays &a, const DuplicateReplays &b)
+  {
+    return a.paths[0] < b.paths[0];
+  }
+}
+
+string ReplayFingerprint::toString() const
+{
+  char szHeaderHash[41];
+  sha1::toHexString(headerHash, szHeaderHash);
+
+  char szActions[25];
+  sprintf_s(szActions, sizeof(szActions), "%08X%08X%08X", dwActionsSize, (DWORD)(actionsHash >> 32), (DWORD)actionsHash);
+  return string(szHeaderHash) + szActions;
+}
+
+bool ReplayTool::operator==(const ReplayFingerprint &a, const ReplayFingerprint &b)
+{
+  return memcmp(a.headerHash, b.headerHash, sizeof(a.headerHash)) == 0 && a.dwActionsSize == b.dwActionsSize &&
+         a.actionsHash == b.actionsHash;
+}
+
+bool ReplayTool::operator<(const ReplayFingerprint &a, const ReplayFingerprint &b)
+{
+  int headerOrder = memcmp(a.headerHash, b.headerHash, sizeof(a.headerHash));
+  if (headerOrder != 0)
+    return headerOrder < 0;
+  if (a.dwActionsSize != b.dwActionsSize)
+    return a.dwActionsSize < b.dwActionsSize;
+  return a.actionsHash < b.actionsHash;
+}
+
+bool ReplayTool::readReplayFingerprint(const char *pszReplayPath, ReplayFingerprint &fingerprint, bool bHashActions)
+{
+  memset(&fingerprint, 0, sizeof(fingerprint));
+
+  FileReader fr;
+  fr.SetQuiet(true);
+  if (!fr.Open(pszReplayPath))
+    return false;
+
+  // Same sections as parseReplay, without the map
+  DWORD dwRepResourceID = 0;
+  if (!DecompressRead(&dwRepResourceID, sizeof(dwRepResourceID), fr) || dwRepResourceID != mmioFOURCC('r','e','R','S'))
+    return false;
+
+  replay_resource replayHeader;
+  if (!DecompressRead(&replayHeader, sizeof(replayHeader), fr))
+    return false;
+
+  DWORD dwActionBufferSize = 0;
+  if (!DecompressRead(&dwActionBufferSize, 4, fr))
+    return false;
+
+  hashHeader(replayHeader, fingerprint.headerHash);
+  fingerprint.dwActionsSize = dwActionBufferSize;
+  if (!bHashActions)
+    return true;
+
+  // The bytes of the actions are hashed a chunk at a time as they are decompressed
+  unsigned long long hash = FNV_OFFSET_BASIS;
+  if (dwActionBufferSize)
+  {
+    DecompressStream actions;
+    bool read = actions.read(fr, dwActionBufferSize, [&hash](const BYTE *pData, DWORD dwSize)
+    {
+      for (DWORD i = 0; i < dwSize; ++i)
+        hash = (hash ^ pData[i]) * FNV_PRIME;
+      return true;
+    });
+    if (!read)
+      return false;
+  }
+  fingerprint.actionsHash = hash;
+  return true;
+}
+
+void ReplayTool::findDuplicateReplays(const char *pszReplayDir, vector<DuplicateReplays> &groups, unsigned threadCount,
+                                      unsigned *pReplayCount)
+{
+  groups.clear();
+
+  vector<string> replays;
+  findReplays(pszReplayDir, replays);
+  if (pReplayCount != NULL)
+    *pReplayCount = (unsigned)replays.size();
+
+  // The headers of all replays, which tell most games apart
+  vector<FingerprintEntry> entries(replays.size());
+  for (size_t i = 0; i < entries.size(); ++i)
+    entries[i].index = i;
+  WorkStealingPool pool(threadCount);
+  readFingerprints(pool, replays, entries, false);
+
+  // Only the replays that share a header with another replay have their actions hashed
+  vector<FingerprintEntry> candidates;
+  forEachDuplicateRun(entries, [&](size_t begin, size_t end)
+  {
+    candidates.insert(candidates.end(), entries.begin() + begin, entries.begin() + end);
+  });
+  readFingerprints(pool, replays, candidates, true);
+
+  // The replays of a group are in path order, since the replays are
+  forEachDuplicateRun(candidates, [&](size_t begin, size_t end)
+  {
+    groups.push_back(DuplicateReplays());
+    groups.back().fingerprint = candidates[begin].fingerprint;
+    for (size_t i = begin; i < end; ++i)
+      groups.back().paths.push_back(replays[candidates[i].index]);
+  });
+  sort(groups.begin(), groups.end(), firstPathLess);
+}
+
+bool ReplayTool::writeDuplicateReplays(const char *pszReplayDir, const char *pszOutputPath, unsigned threadCount,
+                                       unsigned *pReplayCount, unsigned *pDuplicateCount)
+{
+  vector<DuplicateReplays> groups;
+  findDuplicateReplays(pszReplayDir, groups, threadCount, pReplayCount);
+
+  // The duplicates are the replays after the first of every group
+  if (pDuplicateCount != NULL)
+  {
+    *pDuplicateCount = 0;
+    for (size_t i = 0; i < groups.size(); ++i)
+      *pDuplicateCount += (unsigned)groups[i].paths.size() - 1;
+  }
+
+  ofstream output(pszOutputPath);
+  if (!output)
+    return false;
+
+  output << "# fingerprint\tpaths of the replays of the same game\n";
+  for (size_t i = 0; i < groups.size(); ++i)
+  {
+    output << groups[i].fingerprint.toString();
+    for (size_t j = 0; j < groups[i].paths.size(); ++j)
+      output << '\t' << groups[i].paths[j];
+    output << '\n';
+  }
+  return output.good();
+}
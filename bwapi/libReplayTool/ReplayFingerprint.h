@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "ReplayToolDefs.h"
+
+START_REPLAY_TOOL
+
+// Identifies the game in a replay, whatever the replay file is called, whoever of the players or
+// observers saved it, and however it is compressed. Two replays with the same fingerprint hold
+// the same game up to the same frame.
+struct ReplayFingerprint
+{
+  // SHA-1 of the seed, the map, the players and the frame count in the replay header
+  BYTE    headerHash[20];
+
+  // Size of the action section, and the 64-bit FNV-1a hash of its decompressed bytes
+  DWORD   dwActionsSize;
+  unsigned long long actionsHash;
+
+  // The hashes in hexadecimal, as a key of 64 characters
+  std::string toString() const;
+};
+
+bool operator==(const ReplayFingerprint &a, const ReplayFingerprint &b);
+bool operator<(const ReplayFingerprint &a, const ReplayFingerprint &b);
+
+// Reads the fingerprint of a replay. The actions are hashed while they are decompressed, without
+// being parsed. If bHashActions is not set, they are not decompressed at all and the hash of the
+// actions is 0, which is enough to tell apart the replays of different games. Can be called from
+// several threads at once.
+bool readReplayFingerprint(const char *pszReplayPath, ReplayFingerprint &fingerprint, bool bHashActions = true);
+
+// Replays that hold the same game, sorted by path
+struct DuplicateReplays
+{
+  ReplayFingerprint        fingerprint;
+  std::vector<std::string> paths;
+};
+
+// Groups the replays in a directory tree that hold the same game. The headers of all replays are
+// read first, and only the replays whose header matches that of another replay have their actions
+// hashed. Only groups of two or more replays are kept, sorted by the path of their first replay.
+// Replays that cannot be read are left out. A thread count of 0 uses one thread per core.
+void findDuplicateReplays(const char *pszReplayDir, std::vector<DuplicateReplays> &groups,
+                          unsigned threadCount = 0, unsigned *pReplayCount = NULL);
+
+// Writes the groups of duplicates in a directory tree to a file, a group per line, with the
+// fingerprint and then the paths separated by tabs
+bool writeDuplicateReplays(const char *pszReplayDir, const char *pszOutputPath, unsigned threadCount = 0,
+                           unsigned *pReplayCount = NULL, unsigned *pDuplicateCount = NULL);
+
+END_REPLAY_TOOL
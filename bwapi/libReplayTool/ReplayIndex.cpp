@@ -0,0 +1,246 @@
+#include "ReplayIndex.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include "ActionParser.h"
+#include "DefaultActions.h"
+#include "FileReader.h"
+#include "PKShared.h"
+#include "RepHeader.h"
+#include "StreamReplayReader.h"
+#include "WorkStealingPool.h"
+
+#ifndef _WIN32
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+using namespace BWAPI;
+using namespace ReplayTool;
+
+namespace
+{
+  // Milliseconds per frame at the Fastest game speed
+  const double FASTEST_FRAME_MS = 42;
+
+  // Copies a fixed size string from the replay header, without the color codes
+  string headerString(const char *psz, size_t maxLength)
+  {
+    string str;
+    for (size_t i = 0; i < maxLength && psz[i] != '\0'; ++i)
+    {
+      if ((BYTE)psz[i] >= ' ')
+        str += psz[i];
+    }
+    return str;
+  }
+
+  bool isReplayFile(const string &name)
+  {
+    return name.size() > 4 && name.compare(name.size() - 4, 4, ".rep") == 0;
+  }
+
+  void findReplayFiles(const string &dir, vector<string> &replays)
+  {
+#ifdef _WIN32
+    WIN32_FIND_DATA findData;
+    HANDLE hFind = FindFirstFile((dir + "\\*").c_str(), &findData);
+    if (hFind == INVALID_HANDLE_VALUE)
+      return;
+
+    do
+    {
+      string name = findData.cFileName;
+      if (name == "." || name == "..")
+        continue;
+
+      if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+        findReplayFiles(dir + "\\" + name, replays);
+      else if (isReplayFile(name))
+        replays.push_back(dir + "\\" + name);
+    } while (FindNextFile(hFind, &findData));
+
+    FindClose(hFind);
+#else
+    DIR *pDir = opendir(dir.c_str());
+    if (pDir == NULL)
+      return;
+
+    while (dirent *pEntry = readdir(pDir))
+    {
+      string name = pEntry->d_name;
+      if (name == "." || name == "..")
+        continue;
+
+      string path = dir + "/" + name;
+      struct stat st;
+      if (stat(path.c_str(), &st) != 0)
+        continue;
+
+      if (S_ISDIR(st.st_mode))
+        findReplayFiles(path, replays);
+      else if (isReplayFile(name))
+        replays.push_back(path);
+    }
+
+    closedir(pDir);
+#endif
+  }
+}
+
+bool ReplayTool::readReplayInfo(const char *pszReplayPath, ReplayInfo &info)
+{
+  info.path = pszReplayPath;
+  info.valid = false;
+  info.mapName.clear();
+  info.frameCount = 0;
+  info.players.clear();
+  info.actionCount = 0;
+  info.actionCounts.clear();
+
+  FileReader fr;
+  fr.SetQuiet(true);
+  if (!fr.Open(pszReplayPath))
+    return false;
+
+  // Same sections as parseReplay, without the map
+  DWORD dwRepResourceID = 0;
+  if (!DecompressRead(&dwRepResourceID, sizeof(dwRepResourceID), fr) || dwRepResourceID != mmioFOURCC('r','e','R','S'))
+    return false;
+
+  replay_resource replayHeader;
+  if (!DecompressRead(&replayHeader, sizeof(replayHeader), fr))
+    return false;
+
+  DWORD dwActionBufferSize = 0;
+  if (!DecompressRead(&dwActionBufferSize, 4, fr))
+    return false;
+
+  // The actions are counted while they are decompressed, without keeping them
+  StreamReplayReader repActions(fr, dwActionBufferSize);
+  if (repActions.failed())
+    return false;
+
+  info.mapName = headerString(replayHeader.networkGameHeader.szMapName, sizeof(replayHeader.networkGameHeader.szMapName));
+  info.frameCount = replayHeader.dwFrameCount;
+
+  for (int i = 0; i < 12; ++i)
+  {
+    const replay_resource::_playerEntry &entry = replayHeader.players[i];
+    if (entry.nType != PlayerTypes::Computer && entry.nType != PlayerTypes::Player)
+      continue;
+
+    ReplayInfo::Player player;
+    player.name = headerString(entry.szPlayerName, sizeof(entry.szPlayerName));
+    player.race = Race(entry.nRace);
+    player.type = PlayerType(entry.nType);
+    player.id = (PlayerID)entry.dwStormId;
+    player.actionCount = 0;
+    player.apm = 0;
+    info.players.push_back(player);
+  }
+
+  // Count the actions, per player and per opcode
+  unsigned playerCounts[256] = { 0 };
+  unsigned opcodeCounts[256] = { 0 };
+  unsigned actionCount = 0;
+  ActionList frameActions;
+  if (dwActionBufferSize)
+  {
+    parseActions(repActions, frameActions, [&](const ActionList &actions)
+    {
+      for (size_t i = 0; i < actions.size(); ++i)
+      {
+        ++playerCounts[actions[i].player];
+        ++opcodeCounts[actions[i].action];
+      }
+      actionCount += (unsigned)actions.size();
+      return true;
+    });
+  }
+
+  // The checksum of the actions is only known once they are all decompressed
+  if (!repActions.verify())
+    return false;
+  fr.Free();
+
+  info.actionCount = actionCount;
+  for (unsigned i = 0; i < 256; ++i)
+  {
+    if (opcodeCounts[i] != 0)
+      info.actionCounts.push_back(make_pair((ActionID)i, opcodeCounts[i]));
+  }
+
+  double minutes = info.frameCount * FASTEST_FRAME_MS / 60000;
+  for (size_t i = 0; i < info.players.size(); ++i)
+  {
+    ReplayInfo::Player &player = info.players[i];
+    player.actionCount = playerCounts[player.id];
+    player.apm = minutes > 0 ? (unsigned)(player.actionCount / minutes + 0.5) : 0;
+  }
+
+  info.valid = true;
+  return true;
+}
+
+string ReplayTool::formatReplayInfo(const ReplayInfo &info)
+{
+  ostringstream ss;
+  ss << info.path << '\t' << (info.valid ? 1 : 0) << '\t' << info.mapName << '\t' << info.frameCount << '\t' << info.actionCount << '\t';
+
+  for (size_t i = 0; i < info.players.size(); ++i)
+  {
+    const ReplayInfo::Player &player = info.players[i];
+    ss << (i == 0 ? "" : ";") << player.name << ':' << player.race.c_str() << ':' << player.actionCount << ':' << player.apm;
+  }
+  ss << '\t';
+
+  for (size_t i = 0; i < info.actionCounts.size(); ++i)
+  {
+    ActionID action = info.actionCounts[i].first;
+    const char *pszActionName = action < ReplayTool::Max ? ReplayTool::pszActionNames[action] : "INVALID";
+    ss << (i == 0 ? "" : ";") << pszActionName << '=' << info.actionCounts[i].second;
+  }
+
+  return ss.str();
+}
+
+void ReplayTool::findReplays(const string &dir, vector<string> &replays)
+{
+  size_t first = replays.size();
+  findReplayFiles(dir, replays);
+  sort(replays.begin() + first, replays.end());
+}
+
+bool ReplayTool::indexReplays(const char *pszReplayDir, const char *pszIndexPath, unsigned threadCount,
+                              unsigned *pReplayCount, unsigned *pValidCount)
+{
+  vector<string> replays;
+  findReplays(pszReplayDir, replays);
+
+  // Every task formats its own line, so that only the lines are kept until the index is written
+  vector<string> lines(replays.size());
+  vector<char> valid(replays.size());
+  WorkStealingPool pool(threadCount);
+  pool.run(replays.size(), [&](size_t i)
+  {
+    ReplayInfo info;
+    valid[i] = readReplayInfo(replays[i].c_str(), info);
+    lines[i] = formatReplayInfo(info);
+  });
+
+  if (pReplayCount != NULL)
+    *pReplayCount = (unsigned)replays.size();
+  if (pValidCount != NULL)
+    *pValidCount = (unsigned)count(valid.begin(), valid.end(), 1);
+
+  ofstream index(pszIndexPath);
+  if (!index)
+    return false;
+
+  index << "# path\tvalid\tmap\tframes\tactions\tplayers (name:race:actions:apm)\taction counts\n";
+  for (size_t i = 0; i < lines.size(); ++i)
+    index << lines[i] << '\n';
+  return index.good();
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "BWAPI.h"
+#include "ReplayToolDefs.h"
+
+START_REPLAY_TOOL
+
+// Summary of a replay, as written to a replay index
+struct ReplayInfo
+{
+  struct Player
+  {
+    std::string       name;
+    BWAPI::Race       race;
+    BWAPI::PlayerType type;
+
+    // The player ID that the actions of this player carry
+    PlayerID          id;
+
+    unsigned          actionCount;
+
+    // Actions per minute at the Fastest game speed
+    unsigned          apm;
+  };
+
+  std::string         path;
+  bool                valid;
+  std::string         mapName;
+  DWORD               frameCount;
+  std::vector<Player> players;
+
+  // Number of actions of all players, in total and for every opcode that occurs
+  unsigned            actionCount;
+  std::vector< std::pair<ActionID, unsigned> > actionCounts;
+};
+
+// Reads the header and actions of a replay. Can be called from several threads at once.
+bool readReplayInfo(const char *pszReplayPath, ReplayInfo &info);
+
+// Formats a replay as one line of the index, without the line break. The columns are separated
+// by tabs: path, 1 or 0 for whether the replay could be read, map, frame count, action count,
+// the players as name:race:actions:apm separated by semicolons, and the action counts as
+// name=count separated by semicolons.
+std::string formatReplayInfo(const ReplayInfo &info);
+
+// Finds the files with the .rep extension in a directory and its subdirectories, sorted by path
+void findReplays(const std::string &dir, std::vector<std::string> &replays);
+
+// Reads every replay in a directory tree on a WorkStealingPool and writes the index of all of
+// them to one file, in path order. A thread count of 0 uses one thread per core.
+bool indexReplays(const char *pszReplayDir, const char *pszIndexPath, unsigned threadCount = 0,
+                  unsigned *pReplayCount = NULL, unsigned *pValidCount = NULL);
+
+END_REPLAY_TOOL
@@ -1,4 +1,5 @@
 #include "ReplayReader.h"
+#include "FrameIndex.h"
 #include <cstdio>
 
 using namespace BWAPI;
@@ -12,6 +13,7 @@ ReplayReader::ReplayReader(DWORD dwSize)
   , bFrameBytesRead(0)
   , dwCurrentFrameTick(0)
   , dwHighestFrameTick(0)
+  , pFrameIndex(nullptr)
   , end(false)
   , validFrame(false)
 {
@@ -113,3 +115,46 @@ DWORD ReplayReader::highestFrameTick() const
   return this->dwHighestFrameTick;
 }
 
+DWORD ReplayReader::currentFrameTick() const
+{
+  return this->dwCurrentFrameTick;
+}
+
+void ReplayReader::setFrameIndex(const FrameIndex *pIndex)
+{
+  this->pFrameIndex = pIndex;
+}
+
+bool ReplayReader::seekToFrame(DWORD dwFrameTick)
+{
+  if ( this->pActionsBegin == nullptr )
+    return false;
+
+  // An index of other actions would point anywhere
+  DWORD dwOffset = 0;
+  if ( this->pFrameIndex != nullptr && this->pFrameIndex->getActionsSize() == this->size() )
+    dwOffset = this->pFrameIndex->findOffset(dwFrameTick);
+
+  // Skip whole frames using their byte counts, without reading the actions
+  BYTE *pFrame = this->pActionsBegin + dwOffset;
+  while ( pFrame + sizeof(DWORD) + sizeof(BYTE) <= this->pActionsEnd )
+  {
+    DWORD dwTick;
+    memcpy(&dwTick, pFrame, sizeof(dwTick));
+    if ( dwTick >= dwFrameTick )
+    {
+      this->pCurrent = pFrame;
+      this->bFrameSize = 0;
+      this->bFrameBytesRead = 0;
+      this->end = false;
+      this->validFrame = false;
+      return true;
+    }
+    pFrame += sizeof(DWORD) + sizeof(BYTE) + pFrame[sizeof(DWORD)];
+  }
+
+  this->pCurrent = this->pActionsEnd;
+  this->end = true;
+  this->validFrame = false;
+  return false;
+}
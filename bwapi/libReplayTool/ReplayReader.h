@@ -5,6 +5,7 @@
 namespace ReplayTool
 {
   class ReplayReaderWrap;
+  class FrameIndex;
 
   class ReplayReader : public AbstractReplayReader
   {
@@ -33,6 +34,16 @@ namespace ReplayTool
     // Retrieve highest frame count
     DWORD highestFrameTick() const;
 
+    // Retrieve the frame count of the current frame
+    DWORD currentFrameTick() const;
+
+    // Move to the first frame whose tick is not below dwFrameTick, starting from the frame that
+    // the frame index gives, or from the first frame without an index
+    bool seekToFrame(DWORD dwFrameTick);
+
+    // Use an index for seeking. The index is not copied, and must outlive the reader.
+    void setFrameIndex(const FrameIndex *pIndex);
+
     std::string readCString();
 
   private:
@@ -50,6 +61,8 @@ namespace ReplayTool
     DWORD dwCurrentFrameTick;
     DWORD dwHighestFrameTick;
 
+    const FrameIndex *pFrameIndex;
+
     // Flags
     bool end;
     bool validFrame;
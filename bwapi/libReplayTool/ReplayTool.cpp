@@ -1,4 +1,5 @@
 #include "ReplayTool.h"
+#include "ActionList.h"
 #include "ResearchAction.h"
 #include "SaveGameAction.h"
 #include "BuildAction.h"
@@ -25,10 +26,15 @@
 using namespace ReplayTool;
 
 void InitActionFactory();
+void InitActionLayouts();
 
 void ReplayTool::init()
 {
+  // Function statics are not constructed thread-safely by VS2013, so the factory is created here
+  // rather than by the first replay that a pool thread parses
+  GameAction::Factory::instance();
   InitActionFactory();
+  InitActionLayouts();
 }
 
 void InitActionFactory()
@@ -63,4 +69,40 @@ void InitActionFactory()
   REGISTER_ACTION(TrainAction, ReplayTool::Train);
   REGISTER_ACTION(GroupUnitsAction, ReplayTool::Group_Units);
   REGISTER_ACTION(CancelTrainAction, ReplayTool::Cancel_Train);
-}
\ No newline at end of file
+}
+
+// The parameters of the actions above, for parsing them into an ActionList
+void InitActionLayouts()
+{
+  ActionList::setLayout(ReplayTool::Research, Layout_TechType);
+  ActionList::setLayout(ReplayTool::Save_Game, Layout_SaveLoad);
+  ActionList::setLayout(ReplayTool::Load_Game, Layout_SaveLoad);
+  ActionList::setLayout(ReplayTool::Placebox, Layout_Build);
+  ActionList::setLayout(ReplayTool::Chat_Replay, Layout_Chat);
+  ActionList::setLayout(ReplayTool::Select_Delta_Add, Layout_Select);
+  ActionList::setLayout(ReplayTool::Select_Delta_Del, Layout_Select);
+  ActionList::setLayout(ReplayTool::Select_Units, Layout_Select);
+  ActionList::setLayout(ReplayTool::Cloak_On, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Cloak_Off, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Lift_Off, Layout_Position);
+  ActionList::setLayout(ReplayTool::Stop, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Return, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Tank_Siege, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Tank_Unsiege, Layout_Byte);
+  // SetSpeedAction is registered under the opcode of its prototype, which is Set_Seed
+  ActionList::setLayout(ReplayTool::Set_Seed, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Unload_All, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Hold_Position, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Burrow_Up, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Burrow_Down, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Ping_Minimap, Layout_Position);
+  ActionList::setLayout(ReplayTool::Upgrade, Layout_UpgradeType);
+  ActionList::setLayout(ReplayTool::Set_Latency, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Leave_Game, Layout_Byte);
+  ActionList::setLayout(ReplayTool::Right_Click, Layout_RightClick);
+  ActionList::setLayout(ReplayTool::Target_Click, Layout_TargetClick);
+  ActionList::setLayout(ReplayTool::Set_Replay_Speed, Layout_ReplaySpeed);
+  ActionList::setLayout(ReplayTool::Train, Layout_UnitType);
+  ActionList::setLayout(ReplayTool::Group_Units, Layout_BytePair);
+  ActionList::setLayout(ReplayTool::Cancel_Train, Layout_Word);
+}
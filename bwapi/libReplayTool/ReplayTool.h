@@ -2,5 +2,7 @@
 
 namespace ReplayTool
 {
+  // Registers the replay actions. Call it before any replays are read, and before a
+  // WorkStealingPool reads replays on other threads.
   void init();
 }
\ No newline at end of file
@@ -1,6 +1,50 @@
 #pragma once
 
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <BWAPI/WindowsTypes.h>
+
+typedef std::uint8_t  BYTE;
+typedef std::uint16_t WORD;
+
+#ifndef MAX_PATH
+#define MAX_PATH 260
+#endif
+
+#ifndef mmioFOURCC
+#define mmioFOURCC(a,b,c,d) ((DWORD)(BYTE)(a) | ((DWORD)(BYTE)(b) << 8) | ((DWORD)(BYTE)(c) << 16) | ((DWORD)(BYTE)(d) << 24))
+#endif
+
+// The secure CRT functions used by the replay tool, in terms of the standard ones
+#define sprintf_s   snprintf
+#define vfprintf_s  vfprintf
+#define fprintf_s   fprintf
+
+inline int strcpy_s(char *dest, size_t size, const char *src)
+{
+  snprintf(dest, size, "%s", src);
+  return 0;
+}
+
+inline int _vsnprintf_s(char *buffer, size_t size, const char *format, va_list args)
+{
+  return vsnprintf(buffer, size, format, args);
+}
+
+inline void OutputDebugStringA(const char *) {}
+#endif
+
+// Storage that every thread has its own copy of
+#ifdef _MSC_VER
+#define REPLAY_TOOL_THREAD_LOCAL  __declspec(thread)
+#else
+#define REPLAY_TOOL_THREAD_LOCAL  __thread
+#endif
 
 #define START_REPLAY_TOOL   namespace ReplayTool {
 #define END_REPLAY_TOOL     }
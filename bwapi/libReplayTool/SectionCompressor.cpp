@@ -0,0 +1,82 @@
+#include "SectionCompressor.h"
+#include <algorithm>
+#include "FileWriter.h"
+
+using namespace std;
+using namespace ReplayTool;
+
+SectionCompressor::SectionCompressor(CompressLevel level, unsigned threadCount)
+  : level(level)
+  , pool(threadCount)
+{
+}
+
+void SectionCompressor::add(const void *pInput, size_t inputSize)
+{
+  // Same as CompressWrite, which writes nothing without an input
+  if (pInput == NULL)
+    return;
+
+  Section section;
+  section.pInput = (const char*)pInput;
+  section.dwSize = (DWORD)inputSize;
+  section.dwCrc32Sum = 0;
+  section.firstChunk = chunks.size();
+  section.dwChunkCount = (section.dwSize + SECTION_CHUNK_SIZE - 1) / SECTION_CHUNK_SIZE;
+  sections.push_back(section);
+
+  for (DWORD dwPos = 0; dwPos < section.dwSize; dwPos += SECTION_CHUNK_SIZE)
+  {
+    Chunk chunk;
+    chunk.pInput = &section.pInput[dwPos];
+    chunk.dwSize = min(section.dwSize - dwPos, (DWORD)SECTION_CHUNK_SIZE);
+    chunk.dwCompressedSize = 0;
+    chunks.push_back(chunk);
+  }
+}
+
+void SectionCompressor::write(FileWriter &fw)
+{
+  // The chunks are compressed, and the checksums of the sections computed, as separate tasks
+  output.resize(chunks.size() * SECTION_CHUNK_SIZE);
+  pool.run(chunks.size() + sections.size(), [this](size_t task)
+  {
+    if (task < chunks.size())
+    {
+      Chunk &chunk = chunks[task];
+      chunk.dwCompressedSize = CompressChunk(chunk.pInput, chunk.dwSize, &output[task * SECTION_CHUNK_SIZE], level);
+    }
+    else
+    {
+      Section &section = sections[task - chunks.size()];
+      unsigned int  dwSize = section.dwSize;
+      unsigned long dwOld  = 0xFFFFFFFF;
+      section.dwCrc32Sum = (DWORD)crc32pk((char*)section.pInput, &dwSize, &dwOld);
+    }
+  });
+
+  for (size_t s = 0; s < sections.size(); ++s)
+  {
+    const Section &section = sections[s];
+    _Part hdr = { section.dwCrc32Sum, section.dwChunkCount };
+    fw.Write<_Part>(hdr);
+
+    for (size_t i = section.firstChunk; i < section.firstChunk + section.dwChunkCount; ++i)
+    {
+      const Chunk &chunk = chunks[i];
+      if (chunk.dwCompressedSize == 0)
+      {
+        fw.Write<DWORD>(chunk.dwSize);
+        fw.WriteRaw((void*)chunk.pInput, chunk.dwSize);
+      }
+      else
+      {
+        fw.Write<DWORD>(chunk.dwCompressedSize);
+        fw.WriteRaw(&output[i * SECTION_CHUNK_SIZE], chunk.dwCompressedSize);
+      }
+    }
+  }
+
+  sections.clear();
+  chunks.clear();
+}
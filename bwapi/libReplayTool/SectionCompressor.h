@@ -0,0 +1,56 @@
+#pragma once
+
+#include <vector>
+#include "PKShared.h"
+#include "ReplayToolDefs.h"
+#include "WorkStealingPool.h"
+
+START_REPLAY_TOOL
+
+class FileWriter;
+
+// Compresses sections like CompressWrite, but compresses the chunks of all the sections that are
+// added before a write in parallel. The output is the same as that of CompressWrite with the same
+// level, one section after the other.
+class SectionCompressor
+{
+public:
+  // A thread count of 0 uses one thread per core
+  explicit SectionCompressor(CompressLevel level = CompressLevel_Fast, unsigned threadCount = 0);
+
+  // Adds a section to the next write. The input is not copied, and must stay valid until then.
+  void add(const void *pInput, size_t inputSize);
+
+  // Compresses the added sections, and writes them in the order that they were added
+  void write(FileWriter &fw);
+
+  CompressLevel getLevel() const { return level; }
+  unsigned getThreadCount() const { return pool.getThreadCount(); }
+
+private:
+  struct Section
+  {
+    const char *pInput;
+    DWORD dwSize;
+    DWORD dwCrc32Sum;
+    size_t firstChunk;
+    DWORD dwChunkCount;
+  };
+
+  struct Chunk
+  {
+    const char *pInput;
+    DWORD dwSize;
+    DWORD dwCompressedSize;
+  };
+
+  CompressLevel level;
+  WorkStealingPool pool;
+  std::vector<Section> sections;
+  std::vector<Chunk> chunks;
+
+  // SECTION_CHUNK_SIZE bytes for the output of every chunk
+  std::vector<char> output;
+};
+
+END_REPLAY_TOOL
@@ -0,0 +1,241 @@
+#include "StreamReplayReader.h"
+#include <cstring>
+#include "FileReader.h"
+
+using namespace ReplayTool;
+
+StreamReplayReader::StreamReplayReader(FileReader &fr, DWORD dwSectionSize)
+  : pChunk(nullptr)
+  , dwChunkSize(0)
+  , dwChunkPos(0)
+  , dwSize(dwSectionSize)
+  , dwPos(0)
+  , dwNextFrame(0)
+  , bFrameSize(0)
+  , bFrameBytesRead(0)
+  , dwCurrentFrameTick(0)
+  , dwHighestFrameTick(0)
+  , dwPendingFrameTick(0)
+  , bPendingFrameSize(0)
+  , pendingFrame(false)
+  , good(false)
+  , end(false)
+  , validFrame(false)
+{
+  // An empty section is not stored, like in ReplayReader, whose reads of an empty buffer end
+  if ( dwSize == 0 )
+    good = true;
+  else
+    good = this->stream.open(fr, dwSize);
+}
+
+bool StreamReplayReader::isGood() const
+{
+  return this->good && this->end == false;
+}
+
+bool StreamReplayReader::failed() const
+{
+  return !this->good || this->stream.failed();
+}
+
+bool StreamReplayReader::verify()
+{
+  if ( this->dwPos < this->dwSize )
+    this->readRaw(nullptr, this->dwSize - this->dwPos);
+  return !this->failed() && (this->dwSize == 0 || this->stream.done());
+}
+
+size_t StreamReplayReader::size() const
+{
+  return this->dwSize;
+}
+
+bool StreamReplayReader::readRaw(void* data, size_t size)
+{
+  if ( !this->good || this->dwPos + size > this->dwSize )
+    return false;
+
+  // Most reads are of a few bytes within the current chunk
+  if ( this->dwChunkPos + size < this->dwChunkSize )
+  {
+    if ( data != nullptr )
+      memcpy(data, &this->pChunk[this->dwChunkPos], size);
+    this->dwChunkPos += (DWORD)size;
+    this->dwPos += (DWORD)size;
+    return true;
+  }
+
+  BYTE *pData = (BYTE*)data;
+  while ( size > 0 )
+  {
+    // Decompress the next chunk when the current one is used up
+    if ( this->dwChunkPos == this->dwChunkSize )
+    {
+      this->dwChunkPos = 0;
+      if ( !this->stream.next(this->pChunk, this->dwChunkSize) )
+      {
+        this->dwChunkSize = 0;
+        this->good = false;
+        return false;
+      }
+    }
+
+    DWORD dwCopy = this->dwChunkSize - this->dwChunkPos;
+    if ( dwCopy > size )
+      dwCopy = (DWORD)size;
+    if ( pData != nullptr )
+    {
+      memcpy(pData, &this->pChunk[this->dwChunkPos], dwCopy);
+      pData += dwCopy;
+    }
+    this->dwChunkPos += dwCopy;
+    this->dwPos += dwCopy;
+    size -= dwCopy;
+  }
+
+  // Finish the stream after the last byte, so that the checksum is compared
+  if ( this->dwPos == this->dwSize && this->dwChunkPos == this->dwChunkSize )
+  {
+    const BYTE *pNone;
+    DWORD dwNone;
+    this->stream.next(pNone, dwNone);
+  }
+  return true;
+}
+
+void StreamReplayReader::readData(void* data, size_t size)
+{
+  // The special case when the action buffer is empty
+  if ( this->dwSize == 0 )
+  {
+    this->end = true;
+  }
+  else if ( this->readRaw(data, size) )
+  {
+    this->bFrameBytesRead += (BYTE)size;
+
+    if ( this->bFrameBytesRead >= this->bFrameSize )
+      this->validFrame = false;
+
+    if ( this->dwPos >= this->dwSize )
+      this->end = true;
+  }
+  else
+  {
+    this->end = true;
+  }
+}
+
+void StreamReplayReader::newFrame()
+{
+  DWORD dwFrameStart = this->dwPos;
+
+  // Read the frame time and byte count, unless a seek has read them
+  DWORD dwNewFrameTick;
+  if ( this->pendingFrame )
+  {
+    this->pendingFrame = false;
+    dwFrameStart -= sizeof(DWORD) + sizeof(BYTE);
+    dwNewFrameTick = this->dwPendingFrameTick;
+    this->bFrameSize = this->bPendingFrameSize;
+    if ( this->dwPos >= this->dwSize )
+      this->end = true;
+  }
+  else
+  {
+    dwNewFrameTick = this->readDWORD();
+    this->bFrameSize = this->readBYTE();
+  }
+
+  this->dwCurrentFrameTick = dwNewFrameTick;
+  if ( dwNewFrameTick > this->dwHighestFrameTick )
+    this->dwHighestFrameTick = dwNewFrameTick;
+
+  this->bFrameBytesRead = 0;
+  this->dwNextFrame = dwFrameStart + sizeof(DWORD) + sizeof(BYTE) + this->bFrameSize;
+
+  // Set as valid frame
+  this->validFrame = true;
+}
+
+std::string StreamReplayReader::readCString()
+{
+  if ( !this->isGood() )
+    return "";
+
+  // The terminator is part of the string, like in ReplayReader
+  std::string str;
+  while ( this->isGood() )
+  {
+    char c;
+    DWORD dwOldPos = this->dwPos;
+    this->readData(&c, sizeof(c));
+    if ( this->dwPos == dwOldPos )
+      break;
+    str += c;
+    if ( c == '\0' )
+      break;
+  }
+  return str;
+}
+
+bool StreamReplayReader::isValidFrame() const
+{
+  return this->validFrame;
+}
+
+DWORD StreamReplayReader::highestFrameTick() const
+{
+  return this->dwHighestFrameTick;
+}
+
+DWORD StreamReplayReader::currentFrameTick() const
+{
+  return this->dwCurrentFrameTick;
+}
+
+bool StreamReplayReader::seekToFrame(DWORD dwFrameTick)
+{
+  if ( this->pendingFrame )
+  {
+    if ( this->dwPendingFrameTick >= dwFrameTick )
+      return true;
+    if ( !this->readRaw(nullptr, this->bPendingFrameSize) )
+      this->dwPos = this->dwSize;
+    this->pendingFrame = false;
+  }
+  else if ( this->dwPos > this->dwNextFrame )
+  {
+    return false;
+  }
+  else if ( !this->readRaw(nullptr, this->dwNextFrame - this->dwPos) )
+  {
+    this->dwPos = this->dwSize;
+  }
+
+  // Skip whole frames using their byte counts, without reading the actions
+  this->validFrame = false;
+  this->bFrameSize = 0;
+  this->bFrameBytesRead = 0;
+  while ( this->dwPos + sizeof(DWORD) + sizeof(BYTE) <= this->dwSize )
+  {
+    DWORD dwTick = 0;
+    BYTE bSize = 0;
+    if ( !this->readRaw(&dwTick, sizeof(dwTick)) || !this->readRaw(&bSize, sizeof(bSize)) )
+      break;
+
+    if ( dwTick >= dwFrameTick )
+    {
+      this->dwPendingFrameTick = dwTick;
+      this->bPendingFrameSize = bSize;
+      this->pendingFrame = true;
+      return true;
+    }
+    if ( !this->readRaw(nullptr, bSize) )
+      break;
+  }
+
+  this->end = true;
+  return false;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "AbstractReplayReader.h"
+#include "DecompressStream.h"
+
+namespace ReplayTool
+{
+  class FileReader;
+
+  // Reads the action section of a replay while it is decompressed, one chunk at a time,
+  // instead of decompressing the whole section first. Reads the same data as a ReplayReader
+  // over the decompressed section.
+  class StreamReplayReader : public AbstractReplayReader
+  {
+  public:
+    // Begins to read a compressed section of dwSize bytes at the position of the file reader,
+    // which must stay valid while the section is read
+    StreamReplayReader(FileReader &fr, DWORD dwSize);
+
+    // Check if the section can still be read
+    bool isGood() const;
+
+    // Check if the section is damaged, or if its checksum does not match, which is only known
+    // after the whole section is read
+    bool failed() const;
+
+    // Decompress the rest of the section without reading it, and check if it is intact
+    bool verify();
+
+    // Read a chunk of data
+    void readData(void* data, size_t size);
+
+    // Get the size of the decompressed section
+    size_t size() const;
+
+    // Begin reading a new frame
+    void newFrame();
+
+    // Check if the current frame is still valid
+    bool isValidFrame() const;
+
+    // Retrieve highest frame count
+    DWORD highestFrameTick() const;
+
+    // Retrieve the frame count of the current frame
+    DWORD currentFrameTick() const;
+
+    // Move to the first frame whose tick is not below dwFrameTick, skipping frames from the end
+    // of the current frame. The section is read once, so this only seeks forward, and fails if
+    // the current frame was read past its end.
+    bool seekToFrame(DWORD dwFrameTick);
+
+    std::string readCString();
+
+  private:
+    // Copy or skip the next bytes of the section, without the frame bookkeeping
+    bool readRaw(void* data, size_t size);
+
+    DecompressStream stream;
+
+    // The chunk being read
+    const BYTE *pChunk;
+    DWORD dwChunkSize;
+    DWORD dwChunkPos;
+
+    // Bytes of the section read so far, and the offset where the next frame begins
+    DWORD dwSize;
+    DWORD dwPos;
+    DWORD dwNextFrame;
+
+    // Frame bytes
+    BYTE bFrameSize;
+    BYTE bFrameBytesRead;
+
+    // Frame time
+    DWORD dwCurrentFrameTick;
+    DWORD dwHighestFrameTick;
+
+    // A frame header that a seek has read, which the next frame uses
+    DWORD dwPendingFrameTick;
+    BYTE bPendingFrameSize;
+    bool pendingFrame;
+
+    // Flags
+    bool good;
+    bool end;
+    bool validFrame;
+  };
+}
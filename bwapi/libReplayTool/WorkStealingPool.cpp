@@ -0,0 +1,95 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+using namespace ReplayTool;
+
+WorkStealingPool::WorkStealingPool(unsigned threadCount)
+  : threadCount(threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency()))
+  , queues(this->threadCount)
+{
+}
+
+void WorkStealingPool::run(size_t taskCount, const std::function<void(size_t)> &task)
+{
+  // Give every thread a contiguous share of the tasks
+  for (unsigned w = 0; w < threadCount; ++w)
+  {
+    size_t begin = taskCount * w / threadCount;
+    size_t end = taskCount * (w + 1) / threadCount;
+    for (size_t i = begin; i < end; ++i)
+      queues[w].tasks.push_back(i);
+  }
+
+  // The calling thread is the first worker. A task that throws stops only its own thread, and the
+  // first exception is rethrown once every thread is joined.
+  std::vector<std::exception_ptr> errors(threadCount);
+  std::vector<std::thread> threads;
+  for (unsigned w = 1; w < threadCount; ++w)
+    threads.push_back(std::thread(&WorkStealingPool::runWorkerSafe, this, w, std::cref(task), std::ref(errors[w])));
+  runWorkerSafe(0, task, errors[0]);
+
+  for (size_t i = 0; i < threads.size(); ++i)
+    threads[i].join();
+
+  // Tasks that were not run are dropped, so that the pool can be run again
+  for (unsigned w = 0; w < threadCount; ++w)
+    queues[w].tasks.clear();
+
+  for (unsigned w = 0; w < threadCount; ++w)
+  {
+    if (errors[w])
+      std::rethrow_exception(errors[w]);
+  }
+}
+
+bool WorkStealingPool::popTask(unsigned worker, size_t &task)
+{
+  Queue &queue = queues[worker];
+  std::lock_guard<std::mutex> lock(queue.mutex);
+  if (queue.tasks.empty())
+    return false;
+
+  task = queue.tasks.back();
+  queue.tasks.pop_back();
+  return true;
+}
+
+bool WorkStealingPool::stealTask(unsigned worker, size_t &task)
+{
+  // Start with the next thread, so that thieves spread over the victims
+  for (unsigned i = 1; i < threadCount; ++i)
+  {
+    Queue &queue = queues[(worker + i) % threadCount];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (!queue.tasks.empty())
+    {
+      task = queue.tasks.front();
+      queue.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingPool::runWorkerSafe(unsigned worker, const std::function<void(size_t)> &task, std::exception_ptr &error)
+{
+  try
+  {
+    runWorker(worker, task);
+  }
+  catch (...)
+  {
+    error = std::current_exception();
+  }
+}
+
+void WorkStealingPool::runWorker(unsigned worker, const std::function<void(size_t)> &task)
+{
+  // Tasks are only added before the workers start, so once every queue is empty there is
+  // nothing left to do
+  size_t next;
+  while (popTask(worker, next) || stealTask(worker, next))
+    task(next);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "ReplayToolDefs.h"
+
+START_REPLAY_TOOL
+
+// Runs a batch of independent tasks on a fixed number of threads. Every thread starts with an
+// equal share of the tasks and takes them from the back of its own queue, and a thread whose
+// queue is empty steals from the front of another thread's queue, so that a few slow tasks do
+// not leave the other threads idle.
+class WorkStealingPool
+{
+public:
+  // A thread count of 0 uses one thread per core
+  explicit WorkStealingPool(unsigned threadCount = 0);
+
+  unsigned getThreadCount() const { return threadCount; }
+
+  // Calls task(i) once for every i in [0, taskCount), and returns when all calls are done.
+  // Calls run on the pool threads and the calling thread, in no particular order. If a task
+  // throws, its thread runs no more tasks, and the exception is rethrown after the other threads
+  // finish theirs.
+  void run(size_t taskCount, const std::function<void(size_t)> &task);
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+  };
+
+  bool popTask(unsigned worker, size_t &task);
+  bool stealTask(unsigned worker, size_t &task);
+  void runWorker(unsigned worker, const std::function<void(size_t)> &task);
+  void runWorkerSafe(unsigned worker, const std::function<void(size_t)> &task, std::exception_ptr &error);
+
+  unsigned threadCount;
+  std::vector<Queue> queues;
+};
+
+END_REPLAY_TOOL
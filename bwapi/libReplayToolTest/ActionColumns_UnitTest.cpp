@@ -0,0 +1,185 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ActionColumns.h"
+#include "ActionList.h"
+#include "ActionParser.h"
+#include "DefaultActions.h"
+#include "FileReader.h"
+#include "ReplayIndex.h"
+#include "ReplayReader.h"
+#include "ReplayTestData.h"
+
+using namespace std;
+using namespace testing;
+using namespace ReplayTool;
+
+#ifdef _WIN32
+#define ACTION_COLUMNS_TEMP_FILE          "TestData\\ActionColumns.tmp"
+#else
+#define ACTION_COLUMNS_TEMP_FILE          "TestData/ActionColumns.tmp"
+#endif
+
+static void parseBuffer(const vector<BYTE> &buffer, ActionList &actions)
+{
+  ReplayReader reader((DWORD)buffer.size());
+  if (!buffer.empty())
+    memcpy((void*)reader, &buffer[0], buffer.size());
+  parseActions(reader, actions);
+}
+
+static void expectSameActions(const ActionList &actions, const ActionColumnsReader &columns)
+{
+  ASSERT_EQ(actions.size(), columns.size());
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    ASSERT_EQ(actions[i].frame, columns.frames()[i]) << i;
+    ASSERT_EQ(actions[i].player, columns.players()[i]) << i;
+    ASSERT_EQ(actions[i].action, columns.opcodes()[i]) << i;
+
+    if (actions[i].action == ReplayTool::Train)
+      ASSERT_EQ(actions[i].wordParam, columns.unitTypes()[i]) << i;
+    if (actions[i].action == ReplayTool::Right_Click)
+    {
+      ASSERT_EQ((WORD)actions[i].click.x, columns.xs()[i]) << i;
+      ASSERT_EQ((WORD)actions[i].click.y, columns.ys()[i]) << i;
+      ASSERT_EQ(actions[i].click.targetID, columns.targets()[i]) << i;
+      ASSERT_EQ(actions[i].click.how, columns.params()[i]) << i;
+    }
+    if (actions[i].action == ReplayTool::Research)
+      ASSERT_EQ(actions[i].byteParam, columns.params()[i]) << i;
+    if (ActionList::getLayout(actions[i].action) == Layout_None)
+    {
+      ASSERT_EQ(ACTION_COLUMN_NONE, columns.unitTypes()[i]) << i;
+      ASSERT_EQ(ACTION_PARAM_NONE, columns.params()[i]) << i;
+    }
+  }
+}
+
+TEST(ActionColumnsTest, RoundTrip)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  // Every encoding gives back the same columns
+  const DWORD flags[] = { 0, ACFLAG_DELTA_FRAMES, ACFLAG_DICTIONARY, ACFLAG_DELTA_FRAMES | ACFLAG_DICTIONARY };
+  for (size_t r = 0; r < replays.size(); r += 20)
+  {
+    vector<BYTE> buffer;
+    ASSERT_TRUE(readActionBuffer(replays[r], buffer)) << replays[r];
+    ActionList actions;
+    parseBuffer(buffer, actions);
+
+    for (size_t f = 0; f < sizeof(flags) / sizeof(flags[0]); ++f)
+    {
+      ASSERT_TRUE(writeActionColumns(actions, ACTION_COLUMNS_TEMP_FILE, flags[f]));
+
+      ActionColumnsReader columns;
+      ASSERT_TRUE(columns.open(ACTION_COLUMNS_TEMP_FILE)) << replays[r];
+      EXPECT_EQ(ACTION_COLUMNS_VERSION, columns.version());
+      expectSameActions(actions, columns);
+    }
+  }
+
+  // The same as exporting the replay directly
+  ASSERT_TRUE(exportActionColumns(replays[0].c_str(), ACTION_COLUMNS_TEMP_FILE));
+  ActionColumnsReader columns;
+  ASSERT_TRUE(columns.open(ACTION_COLUMNS_TEMP_FILE));
+  ReplayInfo info;
+  ASSERT_TRUE(readReplayInfo(replays[0].c_str(), info));
+  EXPECT_EQ(info.actionCount, columns.size());
+
+  columns.close();
+  remove(ACTION_COLUMNS_TEMP_FILE);
+}
+
+TEST(ActionColumnsTest, RejectsOtherFiles)
+{
+  ActionList actions;
+  ASSERT_TRUE(writeActionColumns(actions, ACTION_COLUMNS_TEMP_FILE));
+
+  FileReader fr;
+  ASSERT_TRUE(fr.Open(ACTION_COLUMNS_TEMP_FILE));
+  vector<BYTE> file(fr.Size());
+  fr.Read(&file[0], fr.Size());
+  fr.Free();
+  remove(ACTION_COLUMNS_TEMP_FILE);
+
+  ActionColumnsReader columns;
+  ASSERT_TRUE(columns.open(&file[0], (DWORD)file.size()));
+  EXPECT_EQ(0u, columns.size());
+
+  vector<BYTE> newer(file);
+  ActionColumnsHeader *pHeader = (ActionColumnsHeader*)&newer[0];
+  ++pHeader->wVersion;
+  EXPECT_FALSE(columns.open(&newer[0], (DWORD)newer.size()));
+
+  vector<BYTE> other(file);
+  other[0] = 'X';
+  EXPECT_FALSE(columns.open(&other[0], (DWORD)other.size()));
+  EXPECT_FALSE(columns.open(&file[0], sizeof(ActionColumnsHeader)));
+  EXPECT_FALSE(columns.open(REPLAYS_SOURCE_DIR "/missing.act"));
+}
+
+TEST(ActionColumnsTest, DISABLED_ScanBenchmark)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  // Frames of one replay follow the frames of the previous one, so all replays parse as one
+  vector<BYTE> buffer, replayBuffer;
+  for (size_t r = 0; r < replays.size(); ++r)
+  {
+    ASSERT_TRUE(readActionBuffer(replays[r], replayBuffer)) << replays[r];
+    buffer.insert(buffer.end(), replayBuffer.begin(), replayBuffer.end());
+  }
+  ActionList actions;
+  parseBuffer(buffer, actions);
+  ASSERT_TRUE(writeActionColumns(actions, ACTION_COLUMNS_TEMP_FILE, ACFLAG_DELTA_FRAMES | ACFLAG_DICTIONARY));
+
+  auto begin = chrono::high_resolution_clock::now();
+  ActionColumnsReader columns;
+  ASSERT_TRUE(columns.open(ACTION_COLUMNS_TEMP_FILE));
+  auto opened = chrono::high_resolution_clock::now();
+
+  // Count the units that every player trains
+  vector<unsigned> trained(256 * 256);
+  const BYTE *pOpcodes = columns.opcodes();
+  const BYTE *pPlayers = columns.players();
+  const WORD *pUnitTypes = columns.unitTypes();
+  unsigned trainCount = 0;
+  for (DWORD i = 0; i < columns.size(); ++i)
+  {
+    if (pOpcodes[i] == ReplayTool::Train)
+    {
+      ++trained[pPlayers[i] * 256 + (pUnitTypes[i] & 0xFF)];
+      ++trainCount;
+    }
+  }
+  auto end = chrono::high_resolution_clock::now();
+
+  unsigned expectedTrainCount = 0;
+  for (size_t i = 0; i < actions.size(); ++i)
+    expectedTrainCount += actions[i].action == ReplayTool::Train ? 1 : 0;
+  EXPECT_EQ(expectedTrainCount, trainCount);
+  EXPECT_EQ(actions.size(), columns.size());
+
+  FileReader fr;
+  ASSERT_TRUE(fr.Open(ACTION_COLUMNS_TEMP_FILE));
+  DWORD dwFileSize = fr.Size();
+  fr.Free();
+  columns.close();
+  remove(ACTION_COLUMNS_TEMP_FILE);
+
+  double openSeconds = chrono::duration<double>(opened - begin).count();
+  double scanSeconds = chrono::duration<double>(end - opened).count();
+  cout << "[ BENCHMARK ] " << actions.size() << " actions in " << dwFileSize / 1024 << " KB, opened in "
+       << openSeconds * 1000 << " ms and scanned in " << scanSeconds * 1000 << " ms" << endl;
+}
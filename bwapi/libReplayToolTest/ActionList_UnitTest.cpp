@@ -0,0 +1,134 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+#include "ActionList.h"
+#include "ActionParser.h"
+#include "DefaultActions.h"
+#include "ReplayIndex.h"
+#include "ReplayReader.h"
+#include "ReplayTestData.h"
+
+using namespace std;
+using namespace testing;
+using namespace ReplayTool;
+
+static void copyToReader(const vector<BYTE> &buffer, ReplayReader &reader)
+{
+  if (!buffer.empty())
+    memcpy((void*)reader, &buffer[0], buffer.size());
+}
+
+TEST(ActionListTest, ReadActions)
+{
+  // Frame 3: a train and a select of two units by player 1, and an unregistered opcode by player 2
+  const BYTE data[] = { 3, 0, 0, 0, 13,
+                        1, ReplayTool::Train, 0x07, 0x00,
+                        1, ReplayTool::Select_Units, 2, 0x34, 0x12, 0x05, 0x00,
+                        2, ReplayTool::Cheat };
+  ReplayReader reader(sizeof(data));
+  memcpy((void*)reader, data, sizeof(data));
+
+  ActionList actions;
+  parseActions(reader, actions);
+  ASSERT_EQ(3u, actions.size());
+
+  EXPECT_EQ(3u, actions[0].frame);
+  EXPECT_EQ(1, actions[0].player);
+  EXPECT_EQ(ReplayTool::Train, actions[0].action);
+  EXPECT_EQ(BWAPI::UnitTypes::Terran_SCV.getID(), actions[0].wordParam);
+
+  EXPECT_EQ(ReplayTool::Select_Units, actions[1].action);
+  EXPECT_EQ(2, actions[1].extra.count);
+
+  EXPECT_EQ(2, actions[2].player);
+  EXPECT_EQ(ReplayTool::Cheat, actions[2].action);
+
+  // Parsing again starts over
+  ReplayReader reader2(sizeof(data));
+  memcpy((void*)reader2, data, sizeof(data));
+  parseActions(reader2, actions);
+  EXPECT_EQ(3u, actions.size());
+}
+
+TEST(ActionListTest, SameStringsAsGameActions)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  vector<BYTE> buffer;
+  ActionList actions;
+  for (size_t r = 0; r < replays.size(); ++r)
+  {
+    ASSERT_TRUE(readActionBuffer(replays[r], buffer)) << replays[r];
+
+    ReplayReader gameActionReader((DWORD)buffer.size());
+    copyToReader(buffer, gameActionReader);
+    list<GameAction*> gameActions;
+    parseActions(gameActionReader, gameActions);
+
+    ReplayReader actionListReader((DWORD)buffer.size());
+    copyToReader(buffer, actionListReader);
+    parseActions(actionListReader, actions);
+
+    ASSERT_EQ(gameActions.size(), actions.size()) << replays[r];
+    EXPECT_EQ(gameActionReader.highestFrameTick(), actionListReader.highestFrameTick());
+
+    size_t i = 0;
+    for (list<GameAction*>::const_iterator itr = gameActions.begin(); itr != gameActions.end(); ++itr, ++i)
+    {
+      EXPECT_EQ((*itr)->getPlayer(), actions[i].player);
+      EXPECT_EQ((*itr)->getAction(), actions[i].action);
+      EXPECT_EQ((*itr)->toString(), actions.toString(i)) << replays[r] << ", action " << i;
+      delete *itr;
+    }
+  }
+}
+
+TEST(ActionListTest, DISABLED_ParseBenchmark)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  vector< vector<BYTE> > buffers(replays.size());
+  for (size_t r = 0; r < replays.size(); ++r)
+    ASSERT_TRUE(readActionBuffer(replays[r], buffers[r])) << replays[r];
+
+  size_t gameActionCount = 0, actionListCount = 0;
+  auto begin = chrono::high_resolution_clock::now();
+  for (size_t r = 0; r < buffers.size(); ++r)
+  {
+    ReplayReader reader((DWORD)buffers[r].size());
+    copyToReader(buffers[r], reader);
+    list<GameAction*> gameActions;
+    parseActions(reader, gameActions);
+
+    gameActionCount += gameActions.size();
+    for (list<GameAction*>::const_iterator itr = gameActions.begin(); itr != gameActions.end(); ++itr)
+      delete *itr;
+  }
+  auto middle = chrono::high_resolution_clock::now();
+
+  ActionList actions;
+  for (size_t r = 0; r < buffers.size(); ++r)
+  {
+    ReplayReader reader((DWORD)buffers[r].size());
+    copyToReader(buffers[r], reader);
+    parseActions(reader, actions);
+    actionListCount += actions.size();
+  }
+  auto end = chrono::high_resolution_clock::now();
+
+  EXPECT_EQ(gameActionCount, actionListCount);
+
+  double gameActionSeconds = chrono::duration<double>(middle - begin).count();
+  double actionListSeconds = chrono::duration<double>(end - middle).count();
+  cout << "[ BENCHMARK ] " << actionListCount << " actions parsed in " << gameActionSeconds * 1000 << " ms as GameActions, "
+       << actionListSeconds * 1000 << " ms into an ActionList: " << actionListCount / actionListSeconds << " actions/s" << endl;
+}
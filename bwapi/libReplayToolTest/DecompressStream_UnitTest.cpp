@@ -0,0 +1,230 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ActionList.h"
+#include "ActionParser.h"
+#include "DecompressStream.h"
+#include "FileReader.h"
+#include "PKShared.h"
+#include "ReplayIndex.h"
+#include "ReplayReader.h"
+#include "ReplayTestData.h"
+#include "StreamReplayReader.h"
+
+using namespace std;
+using namespace testing;
+using namespace ReplayTool;
+
+TEST(DecompressStreamTest, SameBytesAsDecompressRead)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  vector<BYTE> expected, streamed;
+  for (size_t r = 0; r < replays.size(); ++r)
+  {
+    ASSERT_TRUE(readActionBuffer(replays[r], expected)) << replays[r];
+    if (expected.empty())
+      continue;
+
+    FileReader fr;
+    fr.SetQuiet(true);
+    DWORD dwActionBufferSize;
+    ASSERT_TRUE(fr.Open(replays[r].c_str()) && skipToActions(fr, dwActionBufferSize));
+
+    streamed.clear();
+    DecompressStream stream;
+    EXPECT_TRUE(stream.read(fr, dwActionBufferSize, [&](const BYTE *pData, DWORD dwSize)
+    {
+      EXPECT_LE(dwSize, (DWORD)SECTION_CHUNK_SIZE);
+      streamed.insert(streamed.end(), pData, pData + dwSize);
+      return true;
+    })) << replays[r];
+    EXPECT_TRUE(stream.done());
+    EXPECT_TRUE(expected == streamed) << replays[r];
+  }
+}
+
+TEST(DecompressStreamTest, DetectsDamage)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  // The largest replay has the most chunks to damage
+  size_t largest = 0;
+  vector<BYTE> buffer, contents;
+  for (size_t r = 0; r < replays.size(); ++r)
+  {
+    ASSERT_TRUE(readActionBuffer(replays[r], buffer));
+    if (buffer.size() > contents.size())
+    {
+      contents.swap(buffer);
+      largest = r;
+    }
+  }
+
+  FileReader file;
+  file.SetQuiet(true);
+  DWORD dwActionBufferSize;
+  ASSERT_TRUE(file.Open(replays[largest].c_str()) && skipToActions(file, dwActionBufferSize));
+  contents.resize(file.Size() - file.Tell());
+  file.Read(&contents[0], (DWORD)contents.size());
+
+  // Damage a byte in the middle of the compressed actions
+  vector<BYTE> damaged(contents.begin(), contents.end());
+  damaged[damaged.size() / 4] ^= 0x5A;
+
+  FileReader intact(&contents[0], (DWORD)contents.size());
+  StreamReplayReader good(intact, dwActionBufferSize);
+  EXPECT_TRUE(good.verify());
+
+  FileReader fr(&damaged[0], (DWORD)damaged.size());
+  DecompressStream stream;
+  EXPECT_FALSE(stream.read(fr, dwActionBufferSize, [](const BYTE*, DWORD) { return true; }));
+  EXPECT_TRUE(stream.failed());
+
+  FileReader fr2(&damaged[0], (DWORD)damaged.size());
+  StreamReplayReader reader(fr2, dwActionBufferSize);
+  ActionList actions;
+  parseActions(reader, actions);
+  EXPECT_FALSE(reader.verify());
+  EXPECT_TRUE(reader.failed());
+}
+
+TEST(DecompressStreamTest, SameActionsAsReplayReader)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  vector<BYTE> buffer;
+  ActionList expected, frameActions;
+  for (size_t r = 0; r < replays.size(); ++r)
+  {
+    ASSERT_TRUE(readActionBuffer(replays[r], buffer));
+    if (buffer.empty())
+      continue;
+
+    ReplayReader reader((DWORD)buffer.size());
+    memcpy((void*)reader, &buffer[0], buffer.size());
+    parseActions(reader, expected);
+
+    FileReader fr;
+    fr.SetQuiet(true);
+    DWORD dwActionBufferSize;
+    ASSERT_TRUE(fr.Open(replays[r].c_str()) && skipToActions(fr, dwActionBufferSize));
+    StreamReplayReader streamReader(fr, dwActionBufferSize);
+
+    // Frame by frame, the actions are the same as the actions of the whole section
+    size_t count = 0;
+    parseActions(streamReader, frameActions, [&](const ActionList &actions)
+    {
+      for (size_t i = 0; i < actions.size() && count < expected.size(); ++i, ++count)
+      {
+        EXPECT_EQ(expected[count].frame, actions[i].frame);
+        EXPECT_EQ(expected.toString(count), actions.toString(i)) << replays[r] << ", action " << count;
+      }
+      return !HasFailure();
+    });
+    EXPECT_EQ(expected.size(), count) << replays[r];
+    EXPECT_EQ(reader.highestFrameTick(), streamReader.highestFrameTick()) << replays[r];
+    EXPECT_TRUE(streamReader.verify()) << replays[r];
+    if (HasFailure())
+      return;
+  }
+}
+
+TEST(DecompressStreamTest, SeekForward)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  vector<BYTE> buffer;
+  for (size_t r = 0; r < replays.size(); r += 10)
+  {
+    ASSERT_TRUE(readActionBuffer(replays[r], buffer));
+    if (buffer.empty())
+      continue;
+
+    ReplayReader reader((DWORD)buffer.size());
+    memcpy((void*)reader, &buffer[0], buffer.size());
+
+    FileReader fr;
+    fr.SetQuiet(true);
+    DWORD dwActionBufferSize;
+    ASSERT_TRUE(fr.Open(replays[r].c_str()) && skipToActions(fr, dwActionBufferSize));
+    StreamReplayReader streamReader(fr, dwActionBufferSize);
+
+    // Seeking twice to the same tick stays on the frame, and seeks further on skip frames
+    for (DWORD tick = 0; ; tick += 500)
+    {
+      bool found = reader.seekToFrame(tick);
+      ASSERT_EQ(found, streamReader.seekToFrame(tick)) << replays[r] << ", tick " << tick;
+      ASSERT_EQ(found, streamReader.seekToFrame(tick)) << replays[r] << ", tick " << tick;
+      if (!found)
+        break;
+
+      reader.newFrame();
+      streamReader.newFrame();
+      ASSERT_EQ(reader.currentFrameTick(), streamReader.currentFrameTick()) << replays[r];
+      ASSERT_EQ(reader.readBYTE(), streamReader.readBYTE()) << replays[r];
+    }
+  }
+}
+
+TEST(DecompressStreamTest, DISABLED_StreamBenchmark)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  // Decompressing whole sections before parsing, against parsing while decompressing
+  size_t actionCounts[2] = { 0, 0 };
+  size_t largestBuffer = 0;
+  double seconds[2];
+  ActionList actions;
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    auto begin = chrono::high_resolution_clock::now();
+    for (size_t r = 0; r < replays.size(); ++r)
+    {
+      FileReader fr;
+      fr.SetQuiet(true);
+      DWORD dwActionBufferSize;
+      ASSERT_TRUE(fr.Open(replays[r].c_str()) && skipToActions(fr, dwActionBufferSize));
+      if (dwActionBufferSize == 0)
+        continue;
+
+      if (pass == 0)
+      {
+        ReplayReader reader(dwActionBufferSize);
+        ASSERT_TRUE(DecompressRead(reader, dwActionBufferSize, fr));
+        parseActions(reader, actions);
+        actionCounts[pass] += actions.size();
+        largestBuffer = max(largestBuffer, (size_t)dwActionBufferSize);
+      }
+      else
+      {
+        StreamReplayReader reader(fr, dwActionBufferSize);
+        parseActions(reader, actions, [&](const ActionList &frameActions)
+        {
+          actionCounts[pass] += frameActions.size();
+          return true;
+        });
+        ASSERT_TRUE(reader.verify());
+      }
+    }
+    seconds[pass] = chrono::duration<double>(chrono::high_resolution_clock::now() - begin).count();
+  }
+  EXPECT_EQ(actionCounts[0], actionCounts[1]);
+
+  cout << "[ BENCHMARK ] " << actionCounts[1] << " actions in " << seconds[0] * 1000 << " ms decompressed first (buffers up to "
+       << largestBuffer / 1024 << " KB), " << seconds[1] * 1000 << " ms streamed (" << sizeof(DecompressStream) / 1024 << " KB)" << endl;
+}
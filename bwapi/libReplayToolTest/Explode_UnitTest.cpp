@@ -0,0 +1,280 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../PKLib/pklib.h"
+#include "FileReader.h"
+#include "PKShared.h"
+#include "ReplayIndex.h"
+
+using namespace std;
+using namespace testing;
+using namespace ReplayTool;
+
+#ifdef _WIN32
+#define REPLAYS_SOURCE_DIR                "TestData\\Replays"
+#else
+#define REPLAYS_SOURCE_DIR                "TestData/Replays"
+#endif
+
+typedef unsigned int (PKEXPORT *ExplodeFunction)(
+  unsigned int (PKEXPORT* read_buf)(char *buf, unsigned int *size, void *param),
+  void         (PKEXPORT* write_buf)(char *buf, unsigned int *size, void *param),
+  char *work_buf, void *param);
+
+namespace
+{
+  // Input of a decoder, read in pieces of random sizes if the seed is set, and its output
+  struct DecodeRun
+  {
+    const vector<char> *pInput;
+    size_t inputPos;
+    unsigned seed;
+    vector<char> output;
+    vector<unsigned> writeSizes;
+    unsigned result;
+  };
+
+  unsigned int PKEXPORT readInput(char *buf, unsigned int *size, void *param)
+  {
+    DecodeRun *run = (DecodeRun*)param;
+    size_t count = min((size_t)*size, run->pInput->size() - run->inputPos);
+    if (run->seed != 0)
+    {
+      run->seed = run->seed * 1103515245 + 12345;
+      count = min(count, (size_t)(5 + (run->seed >> 16) % 60));
+    }
+    if (count != 0)
+      memcpy(buf, &(*run->pInput)[run->inputPos], count);
+    run->inputPos += count;
+    return (unsigned int)count;
+  }
+
+  void PKEXPORT writeOutput(char *buf, unsigned int *size, void *param)
+  {
+    DecodeRun *run = (DecodeRun*)param;
+    run->output.insert(run->output.end(), buf, buf + *size);
+    run->writeSizes.push_back(*size);
+  }
+
+  // Decodes with a zeroed work buffer, so that distances before the start of the output read
+  // the same zeroes with both decoders
+  void decode(ExplodeFunction function, const vector<char> &input, unsigned seed, DecodeRun &run)
+  {
+    static char workBuffer[EXP_BUFFER_SIZE];
+    memset(workBuffer, 0, sizeof(workBuffer));
+
+    run.pInput = &input;
+    run.inputPos = 0;
+    run.seed = seed;
+    run.output.clear();
+    run.writeSizes.clear();
+    run.result = function(&readInput, &writeOutput, workBuffer, &run);
+  }
+
+  // Decodes with both decoders, which must give the same results
+  void compareDecoders(const vector<char> &input, unsigned seed, const string &what)
+  {
+    DecodeRun reference, fast;
+    decode(&explode, input, seed, reference);
+    decode(&explode_fast, input, seed, fast);
+    EXPECT_EQ(reference.result, fast.result) << what;
+    EXPECT_TRUE(reference.writeSizes == fast.writeSizes) << what;
+    EXPECT_TRUE(reference.output == fast.output) << what;
+  }
+
+  vector<char> implodeChunk(const vector<char> &data, unsigned int type, unsigned int dsize)
+  {
+    static char workBuffer[CMP_BUFFER_SIZE];
+    DecodeRun run;
+    run.pInput = &data;
+    run.inputPos = 0;
+    run.seed = 0;
+    implode(&readInput, &writeOutput, workBuffer, &run, &type, &dsize);
+    return run.output;
+  }
+}
+
+// The compressed chunks of all sections of the replays
+static void readReplayChunks(vector< vector<char> > &chunks)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+
+  for (size_t r = 0; r < replays.size(); ++r)
+  {
+    FileReader fr;
+    fr.SetQuiet(true);
+    if (!fr.Open(replays[r].c_str()))
+      continue;
+
+    // Stops at the end of the file, or at data that is not a section
+    for (;;)
+    {
+      _Part hdr = fr.Read<_Part>();
+      const BYTE *pChunk = NULL;
+      for (DWORD s = 0; s < hdr.dwSectionCount && !fr.Eof(); ++s)
+      {
+        DWORD chunkSize = fr.Read<DWORD>();
+        pChunk = fr.ReadPtr(chunkSize);
+        if (pChunk == NULL)
+          break;
+        chunks.push_back(vector<char>((const char*)pChunk, (const char*)pChunk + chunkSize));
+      }
+      if (fr.Eof() || pChunk == NULL)
+        break;
+    }
+  }
+}
+
+// The chunks that explode decodes, and their output
+static void readDecodedChunks(vector< vector<char> > &chunks, vector< vector<char> > &outputs)
+{
+  vector< vector<char> > allChunks;
+  readReplayChunks(allChunks);
+
+  DecodeRun run;
+  for (size_t i = 0; i < allChunks.size(); ++i)
+  {
+    decode(&explode, allChunks[i], 0, run);
+    if (run.result == CMP_NO_ERROR && !run.output.empty())
+    {
+      chunks.push_back(allChunks[i]);
+      outputs.push_back(run.output);
+    }
+  }
+}
+
+TEST(ExplodeTest, SameOutputOnReplays)
+{
+  vector< vector<char> > chunks;
+  readReplayChunks(chunks);
+  ASSERT_FALSE(chunks.empty());
+
+  // Stored chunks, which are not compressed, are compared too
+  for (size_t i = 0; i < chunks.size(); ++i)
+  {
+    compareDecoders(chunks[i], 0, "chunk " + to_string(i));
+    compareDecoders(chunks[i], (unsigned)i + 1, "chunk " + to_string(i) + ", read in pieces");
+    if (HasFailure())
+      return;
+  }
+}
+
+TEST(ExplodeTest, SameOutputForAllModes)
+{
+  vector< vector<char> > chunks, outputs;
+  readDecodedChunks(chunks, outputs);
+  ASSERT_FALSE(outputs.empty());
+
+  const unsigned int types[] = { CMP_BINARY, CMP_ASCII };
+  const unsigned int dsizes[] = { 0x400, 0x800, 0x1000 };
+  DecodeRun run;
+  for (size_t i = 0; i < outputs.size(); i += 25)
+  {
+    for (int t = 0; t < 2; ++t)
+    {
+      for (int d = 0; d < 3; ++d)
+      {
+        vector<char> compressed = implodeChunk(outputs[i], types[t], dsizes[d]);
+        compareDecoders(compressed, 0, "chunk " + to_string(i) + ", type " + to_string(types[t]) + ", dsize " + to_string(dsizes[d]));
+
+        decode(&explode_fast, compressed, 0, run);
+        EXPECT_EQ((unsigned)CMP_NO_ERROR, run.result);
+        EXPECT_TRUE(outputs[i] == run.output);
+        if (HasFailure())
+          return;
+      }
+    }
+  }
+}
+
+TEST(ExplodeTest, FuzzAgainstReference)
+{
+  vector< vector<char> > chunks, outputs;
+  readDecodedChunks(chunks, outputs);
+  ASSERT_FALSE(chunks.empty());
+
+  // ASCII chunks too, which the replays do not have
+  for (size_t i = 0, count = chunks.size(); i < count; i += 10)
+    chunks.push_back(implodeChunk(outputs[i], CMP_ASCII, 0x1000));
+
+  unsigned seed = 20031;
+  for (unsigned iteration = 0; iteration < 20000; ++iteration)
+  {
+    seed = seed * 1103515245 + 12345;
+    vector<char> input = chunks[(seed >> 8) % chunks.size()];
+
+    // Flip bits, cut the end off, or replace the end with noise, mostly past the header so that
+    // the decoders get further than the header checks
+    seed = seed * 1103515245 + 12345;
+    unsigned mutation = (seed >> 16) % 4;
+    size_t position = 2 + (seed >> 4) % (input.size() - 2);
+    if (mutation == 0)
+    {
+      for (int flips = 1 + (seed & 3); flips > 0; --flips)
+      {
+        seed = seed * 1103515245 + 12345;
+        input[(seed >> 8) % input.size()] ^= (char)(1 << ((seed >> 4) & 7));
+      }
+    }
+    else if (mutation == 1)
+    {
+      input.resize(position);
+    }
+    else if (mutation == 2)
+    {
+      for (size_t i = position; i < input.size(); ++i)
+      {
+        seed = seed * 1103515245 + 12345;
+        input[i] = (char)(seed >> 16);
+      }
+    }
+    else
+    {
+      seed = seed * 1103515245 + 12345;
+      input[1] = (char)(3 + (seed >> 16) % 5);
+      input[0] = (char)((seed >> 8) % 3);
+    }
+
+    compareDecoders(input, iteration % 2 ? iteration : 0, "iteration " + to_string(iteration));
+    if (HasFailure())
+      return;
+  }
+}
+
+TEST(ExplodeTest, DISABLED_ExplodeBenchmark)
+{
+  vector< vector<char> > chunks, outputs;
+  readDecodedChunks(chunks, outputs);
+  ASSERT_FALSE(chunks.empty());
+
+  size_t outputSize = 0;
+  for (size_t i = 0; i < outputs.size(); ++i)
+    outputSize += outputs[i].size();
+
+  const int passes = 5;
+  double seconds[2];
+  DecodeRun run;
+  run.output.reserve(0x10000);
+  for (int f = 0; f < 2; ++f)
+  {
+    ExplodeFunction function = f == 0 ? &explode : &explode_fast;
+    auto begin = chrono::high_resolution_clock::now();
+    for (int pass = 0; pass < passes; ++pass)
+    {
+      for (size_t i = 0; i < chunks.size(); ++i)
+        decode(function, chunks[i], 0, run);
+    }
+    seconds[f] = chrono::duration<double>(chrono::high_resolution_clock::now() - begin).count();
+  }
+
+  double megabytes = (double)outputSize * passes / (1024 * 1024);
+  cout << "[ BENCHMARK ] " << chunks.size() << " chunks, " << megabytes << " MB decompressed: explode "
+       << megabytes / seconds[0] << " MB/s, explode_fast " << megabytes / seconds[1] << " MB/s ("
+       << seconds[0] / seconds[1] << "x)" << endl;
+}
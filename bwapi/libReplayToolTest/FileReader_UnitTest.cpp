@@ -0,0 +1,109 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "FileReader.h"
+#include "FileWriter.h"
+#include "ParseReplayParams.h"
+#include "Replay.h"
+#include "ReplayIndex.h"
+
+using namespace std;
+using namespace testing;
+using namespace ReplayTool;
+
+#ifdef _WIN32
+#define REPLAYS_SOURCE_DIR                "TestData\\Replays"
+#define FILE_READER_TEMP_FILE             "TestData\\FileReader.tmp"
+#else
+#define REPLAYS_SOURCE_DIR                "TestData/Replays"
+#define FILE_READER_TEMP_FILE             "TestData/FileReader.tmp"
+#endif
+
+TEST(FileReaderTest, ReadFromMemory)
+{
+  const BYTE data[] = { 1, 2, 3, 4, 5, 6, 7 };
+  FileReader fr(data, sizeof(data));
+
+  EXPECT_EQ(7u, fr.Size());
+  EXPECT_EQ(0x0201, fr.Read<WORD>());
+
+  const BYTE *pb = fr.ReadPtr(2);
+  ASSERT_TRUE(pb == &data[2]);
+  EXPECT_EQ(4u, fr.Tell());
+  EXPECT_TRUE(fr.ReadPtr(4) == NULL);
+  EXPECT_TRUE(fr.Eof());
+
+  // Reading past the end fills the rest with zeros
+  BYTE buffer[5] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+  fr.Read(buffer, sizeof(buffer));
+  EXPECT_EQ(5, buffer[0]);
+  EXPECT_EQ(7, buffer[2]);
+  EXPECT_EQ(0, buffer[3]);
+  EXPECT_EQ(0, buffer[4]);
+  EXPECT_EQ(0u, fr.Read<DWORD>());
+
+  // The memory is not owned, so freeing only forgets it
+  fr.Free();
+  EXPECT_EQ(0u, fr.Size());
+  EXPECT_EQ(1, data[0]);
+}
+
+TEST(FileReaderTest, OpenMapsFile)
+{
+  FileWriter fw;
+  ASSERT_TRUE(fw.Open(FILE_READER_TEMP_FILE));
+  fw.Write<DWORD>(0x12345678);
+  fw.WriteRaw((void*)"replay", 6);
+  fw.Close();
+
+  FileReader fr;
+  ASSERT_TRUE(fr.Open(FILE_READER_TEMP_FILE));
+  EXPECT_EQ(10u, fr.Size());
+  EXPECT_EQ(0x12345678u, fr.Read<DWORD>());
+
+  const BYTE *pb = fr.ReadPtr(6);
+  ASSERT_TRUE(pb != NULL);
+  EXPECT_EQ(string("replay"), string((const char*)pb, 6));
+  EXPECT_FALSE(fr.Eof());
+
+  fr.Free();
+  remove(FILE_READER_TEMP_FILE);
+}
+
+TEST(FileReaderTest, DISABLED_DecompressReplaysBenchmark)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  // Total size of the compressed replays
+  double totalBytes = 0;
+  for (size_t i = 0; i < replays.size(); ++i)
+  {
+    FileReader fr;
+    ASSERT_TRUE(fr.Open(replays[i].c_str()));
+    totalBytes += fr.Size();
+  }
+
+  // Open and decompress every replay, without parsing the actions
+  unsigned parsed = 0;
+  ParseReplayParams params;
+  auto begin = chrono::high_resolution_clock::now();
+  for (size_t i = 0; i < replays.size(); ++i)
+  {
+    params.setReplayPath(replays[i].c_str());
+    parsed += parseReplay(params, 0) ? 1 : 0;
+  }
+  auto end = chrono::high_resolution_clock::now();
+
+  EXPECT_EQ(replays.size(), parsed);
+
+  double seconds = chrono::duration<double>(end - begin).count();
+  cout << "[ BENCHMARK ] " << replays.size() << " replays, "
+       << totalBytes / (1024 * 1024) << " MB decompressed in " << seconds * 1000 << " ms: "
+       << totalBytes / (1024 * 1024) / seconds << " MB/s" << endl;
+}
@@ -0,0 +1,202 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "FrameIndex.h"
+#include "ReplayIndex.h"
+#include "ReplayReader.h"
+#include "ReplayTestData.h"
+
+using namespace std;
+using namespace testing;
+using namespace ReplayTool;
+
+#ifdef _WIN32
+#define FRAME_INDEX_TEMP_FILE             "TestData\\FrameIndex.tmp"
+#else
+#define FRAME_INDEX_TEMP_FILE             "TestData/FrameIndex.tmp"
+#endif
+
+// The ticks of all frames, from the frame headers
+static vector<DWORD> frameTicks(const vector<BYTE> &buffer)
+{
+  vector<DWORD> ticks;
+  for (size_t offset = 0; offset + 5 <= buffer.size(); offset += 5 + buffer[offset + 4])
+  {
+    DWORD tick;
+    memcpy(&tick, &buffer[offset], sizeof(tick));
+    ticks.push_back(tick);
+  }
+  return ticks;
+}
+
+TEST(FrameIndexTest, SeekToFrame)
+{
+  // Frames 0, 5 and 12, with actions of 2, 0 and 3 bytes
+  const BYTE data[] = { 0, 0, 0, 0, 2, 1, 0x2C,
+                        5, 0, 0, 0, 0,
+                        12, 0, 0, 0, 3, 1, 0x1A, 0 };
+  ReplayReader reader(sizeof(data));
+  memcpy((void*)reader, data, sizeof(data));
+
+  FrameIndex index;
+  index.build(reader, 5);
+  ASSERT_EQ(3u, index.getEntries().size());
+  EXPECT_EQ(0u, index.findOffset(4));
+  EXPECT_EQ(7u, index.findOffset(5));
+  EXPECT_EQ(12u, index.findOffset(100));
+
+  reader.setFrameIndex(&index);
+  EXPECT_TRUE(reader.seekToFrame(6));
+  reader.newFrame();
+  EXPECT_EQ(12u, reader.currentFrameTick());
+  EXPECT_EQ(1, reader.readBYTE());
+
+  // Seeking back works, and so does seeking without an index
+  reader.setFrameIndex(NULL);
+  EXPECT_TRUE(reader.seekToFrame(1));
+  reader.newFrame();
+  EXPECT_EQ(5u, reader.currentFrameTick());
+
+  EXPECT_FALSE(reader.seekToFrame(13));
+  EXPECT_FALSE(reader.isGood());
+  EXPECT_TRUE(reader.seekToFrame(0));
+  EXPECT_TRUE(reader.isGood());
+}
+
+TEST(FrameIndexTest, SeekInReplays)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  vector<BYTE> buffer;
+  for (size_t r = 0; r < replays.size(); ++r)
+  {
+    ASSERT_TRUE(readActionBuffer(replays[r], buffer)) << replays[r];
+    vector<DWORD> ticks = frameTicks(buffer);
+    if (ticks.empty())
+      continue;
+
+    ReplayReader reader((DWORD)buffer.size());
+    memcpy((void*)reader, &buffer[0], buffer.size());
+    FrameIndex index;
+    index.build(reader, 100);
+    reader.setFrameIndex(&index);
+
+    // Every seek lands on the first frame at or after the tick, when the ticks increase
+    for (size_t i = 0; i < ticks.size(); i += 97)
+    {
+      if (i > 0 && ticks[i] < ticks[i - 1])
+        break;
+      DWORD target = ticks[i] > 0 ? ticks[i] - 1 : 0;
+      size_t expected = i;
+      while (expected > 0 && ticks[expected - 1] >= target)
+        --expected;
+
+      ASSERT_TRUE(reader.seekToFrame(target)) << replays[r];
+      reader.newFrame();
+      EXPECT_EQ(ticks[expected], reader.currentFrameTick()) << replays[r] << ", frame " << i;
+    }
+  }
+}
+
+TEST(FrameIndexTest, SaveAndLoad)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  vector<BYTE> buffer;
+  ASSERT_TRUE(readActionBuffer(replays[0], buffer));
+  ReplayReader reader((DWORD)buffer.size());
+  memcpy((void*)reader, &buffer[0], buffer.size());
+
+  FrameIndex index;
+  index.build(reader);
+  ASSERT_FALSE(index.getEntries().empty());
+  ASSERT_TRUE(index.save(FRAME_INDEX_TEMP_FILE));
+
+  FrameIndex loaded;
+  ASSERT_TRUE(loaded.load(FRAME_INDEX_TEMP_FILE, (DWORD)buffer.size()));
+  EXPECT_EQ(index.getInterval(), loaded.getInterval());
+  ASSERT_EQ(index.getEntries().size(), loaded.getEntries().size());
+  for (size_t i = 0; i < index.getEntries().size(); ++i)
+  {
+    EXPECT_EQ(index.getEntries()[i].dwFrameTick, loaded.getEntries()[i].dwFrameTick);
+    EXPECT_EQ(index.getEntries()[i].dwOffset, loaded.getEntries()[i].dwOffset);
+  }
+
+  // An index of a different action section is rejected
+  EXPECT_FALSE(loaded.load(FRAME_INDEX_TEMP_FILE, (DWORD)buffer.size() + 1));
+  EXPECT_TRUE(loaded.getEntries().empty());
+
+  // The index next to a replay is written once, and then loaded
+  string replayPath = FRAME_INDEX_TEMP_FILE;
+  string indexPath = FrameIndex::getIndexPath(replayPath.c_str());
+  remove(indexPath.c_str());
+  EXPECT_TRUE(loaded.loadOrBuild(replayPath.c_str(), reader));
+  EXPECT_TRUE(loaded.load(indexPath.c_str(), (DWORD)buffer.size()));
+  EXPECT_EQ(index.getEntries().size(), loaded.getEntries().size());
+
+  remove(indexPath.c_str());
+  remove(FRAME_INDEX_TEMP_FILE);
+}
+
+TEST(FrameIndexTest, DISABLED_SeekBenchmark)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  // The longest replay gives the most frames to skip
+  vector<BYTE> buffer, longest;
+  for (size_t r = 0; r < replays.size(); ++r)
+  {
+    ASSERT_TRUE(readActionBuffer(replays[r], buffer));
+    if (buffer.size() > longest.size())
+      longest.swap(buffer);
+  }
+
+  ReplayReader reader((DWORD)longest.size());
+  memcpy((void*)reader, &longest[0], longest.size());
+  vector<DWORD> ticks = frameTicks(longest);
+  ASSERT_FALSE(ticks.empty());
+
+  auto begin = chrono::high_resolution_clock::now();
+  FrameIndex index;
+  index.build(reader);
+  auto built = chrono::high_resolution_clock::now();
+
+  // The same pseudo random seeks, with and without the index
+  const unsigned seekCount = 10000;
+  DWORD tickSum[2] = { 0, 0 };
+  chrono::high_resolution_clock::time_point seekTimes[3];
+  seekTimes[0] = chrono::high_resolution_clock::now();
+  for (int pass = 0; pass < 2; ++pass)
+  {
+    reader.setFrameIndex(pass == 0 ? NULL : &index);
+    unsigned seed = 12345;
+    for (unsigned i = 0; i < seekCount; ++i)
+    {
+      seed = seed * 1103515245 + 12345;
+      if (reader.seekToFrame(ticks[(seed >> 8) % ticks.size()]))
+      {
+        reader.newFrame();
+        tickSum[pass] += reader.currentFrameTick();
+      }
+    }
+    seekTimes[pass + 1] = chrono::high_resolution_clock::now();
+  }
+  EXPECT_EQ(tickSum[0], tickSum[1]);
+
+  double buildSeconds = chrono::duration<double>(built - begin).count();
+  double scanSeconds = chrono::duration<double>(seekTimes[1] - seekTimes[0]).count();
+  double indexSeconds = chrono::duration<double>(seekTimes[2] - seekTimes[1]).count();
+  cout << "[ BENCHMARK ] " << ticks.size() << " frames indexed in " << buildSeconds * 1000 << " ms, " << seekCount
+       << " seeks in " << scanSeconds * 1000 << " ms without the index, " << indexSeconds * 1000 << " ms with it" << endl;
+}
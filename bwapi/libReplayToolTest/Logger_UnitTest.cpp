@@ -0,0 +1,198 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ActionList.h"
+#include "ActionParser.h"
+#include "FileReader.h"
+#include "Logger.h"
+#include "ReplayIndex.h"
+#include "ReplayReader.h"
+#include "ReplayTestData.h"
+#include "StrUtil.h"
+
+using namespace std;
+using namespace testing;
+using namespace ReplayTool;
+
+#ifdef _WIN32
+#define LOGGER_TEMP_FILE                  "TestData\\Logger.tmp"
+#define LOGGER_TEMP_FILE2                 "TestData\\Logger2.tmp"
+#else
+#define LOGGER_TEMP_FILE                  "TestData/Logger.tmp"
+#define LOGGER_TEMP_FILE2                 "TestData/Logger2.tmp"
+#endif
+
+static string readText(const char *pszPath)
+{
+  FileReader fr;
+  fr.SetQuiet(true);
+  if (!fr.Open(pszPath) || fr.Size() == 0)
+    return string();
+  return string((const char*)fr.ReadPtr(fr.Size()), fr.Size());
+}
+
+TEST(LoggerTest, WritesLinesInOrder)
+{
+  remove(LOGGER_TEMP_FILE);
+
+  // Enough lines for several blocks, with lines that do not fit in a block in between
+  string expected;
+  string longLine(LOGGER_BLOCK_SIZE + 100, 'x');
+  {
+    Logger log(LOGGER_TEMP_FILE);
+    ASSERT_TRUE(log.isOpen());
+    for (unsigned i = 0; i < 50000; ++i)
+    {
+      log.writeLine("Line %u of %s", i, "the log");
+      expected += StrUtil::format("Line %u of %s\n", i, "the log");
+      if (i % 20000 == 10)
+      {
+        log.writeText(longLine.c_str());
+        log.writeLine("%s%u", longLine.c_str(), i);
+        expected += longLine + "\n" + longLine + to_string(i) + "\n";
+      }
+    }
+    log.writeText("", 0);
+    expected += "\n";
+  }
+  EXPECT_TRUE(expected == readText(LOGGER_TEMP_FILE));
+
+  // Logs are appended to
+  {
+    Logger log(LOGGER_TEMP_FILE);
+    log.writeLine("Appended");
+  }
+  EXPECT_TRUE(expected + "Appended\n" == readText(LOGGER_TEMP_FILE));
+  remove(LOGGER_TEMP_FILE);
+}
+
+TEST(LoggerTest, LinesThatFillBlocks)
+{
+  remove(LOGGER_TEMP_FILE);
+
+  // With its line feed, each line is 1/256 of a block, so every 256th line fills one exactly
+  string expected;
+  string line(LOGGER_BLOCK_SIZE / 256 - 1, 'x');
+  {
+    Logger log(LOGGER_TEMP_FILE);
+    for (unsigned i = 0; i < 1000; ++i)
+    {
+      log.writeLine("%s", line.c_str());
+      expected += line + "\n";
+    }
+  }
+  EXPECT_TRUE(expected == readText(LOGGER_TEMP_FILE));
+  remove(LOGGER_TEMP_FILE);
+}
+
+TEST(LoggerTest, Flush)
+{
+  remove(LOGGER_TEMP_FILE);
+  Logger log(LOGGER_TEMP_FILE);
+  log.writeLine("First");
+  log.flush();
+  EXPECT_EQ("First\n", readText(LOGGER_TEMP_FILE));
+
+  // Once the writer thread is started too
+  string expected = "First\n";
+  for (unsigned i = 0; i < 10000; ++i)
+  {
+    log.writeLine("%u", i);
+    expected += to_string(i) + "\n";
+  }
+  log.flush();
+  EXPECT_TRUE(expected == readText(LOGGER_TEMP_FILE));
+
+  Logger closed(nullptr);
+  EXPECT_FALSE(closed.isOpen());
+  closed.writeLine("Nothing");
+  closed.flush();
+  remove(LOGGER_TEMP_FILE);
+}
+
+// The trace as it was written before, with a file write per line and per line feed
+static void logActionsUnbuffered(const ActionList &actions, const char *logFilename)
+{
+  FILE *file = fopen(logFilename, "a");
+  string dbgStr, actionStr;
+  for (size_t i = 0; i < actions.size(); ++i)
+  {
+    actionStr = actions.toString(i);
+    dbgStr = StrUtil::format("%d: %s\n", (unsigned)i, actionStr.c_str());
+    OutputDebugStringA(dbgStr.c_str());
+    fprintf(file, "%s", actionStr.c_str());
+    fprintf(file, "\n");
+  }
+  fclose(file);
+}
+
+static bool readActions(const string &replay, ActionList &actions)
+{
+  vector<BYTE> buffer;
+  if (!readActionBuffer(replay, buffer))
+    return false;
+  ReplayReader reader((DWORD)buffer.size());
+  if (!buffer.empty())
+    memcpy((void*)reader, &buffer[0], buffer.size());
+  parseActions(reader, actions);
+  return true;
+}
+
+TEST(LoggerTest, SameTraceAsUnbuffered)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  remove(LOGGER_TEMP_FILE);
+  remove(LOGGER_TEMP_FILE2);
+  ActionList actions;
+  for (size_t r = 0; r < replays.size(); r += 20)
+  {
+    ASSERT_TRUE(readActions(replays[r], actions)) << replays[r];
+    logActionsUnbuffered(actions, LOGGER_TEMP_FILE);
+    logActions(actions, LOGGER_TEMP_FILE2);
+  }
+
+  EXPECT_TRUE(readText(LOGGER_TEMP_FILE) == readText(LOGGER_TEMP_FILE2));
+  remove(LOGGER_TEMP_FILE);
+  remove(LOGGER_TEMP_FILE2);
+}
+
+TEST(LoggerTest, DISABLED_TraceBenchmark)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  // The actions of the replays, parsed beforehand
+  vector<ActionList> replayActions(replays.size() < 50 ? replays.size() : 50);
+  size_t actionCount = 0;
+  for (size_t r = 0; r < replayActions.size(); ++r)
+  {
+    ASSERT_TRUE(readActions(replays[r], replayActions[r])) << replays[r];
+    actionCount += replayActions[r].size();
+  }
+
+  remove(LOGGER_TEMP_FILE);
+  remove(LOGGER_TEMP_FILE2);
+  auto begin = chrono::high_resolution_clock::now();
+  for (size_t r = 0; r < replayActions.size(); ++r)
+    logActionsUnbuffered(replayActions[r], LOGGER_TEMP_FILE);
+  auto unbuffered = chrono::high_resolution_clock::now();
+  for (size_t r = 0; r < replayActions.size(); ++r)
+    logActions(replayActions[r], LOGGER_TEMP_FILE2);
+  auto buffered = chrono::high_resolution_clock::now();
+  remove(LOGGER_TEMP_FILE);
+  remove(LOGGER_TEMP_FILE2);
+
+  double unbufferedSeconds = chrono::duration<double>(unbuffered - begin).count();
+  double bufferedSeconds = chrono::duration<double>(buffered - unbuffered).count();
+  cout << "[ BENCHMARK ] " << actionCount << " actions traced in " << unbufferedSeconds * 1000 << " ms a line at a time, "
+       << bufferedSeconds * 1000 << " ms with the Logger" << endl;
+}
@@ -19,6 +19,12 @@ public:
   // Retrieve highest frame count
   MOCK_CONST_METHOD0(highestFrameTick, DWORD());
 
+  // Retrieve the frame count of the current frame
+  MOCK_CONST_METHOD0(currentFrameTick, DWORD());
+
+  // Move to the first frame whose tick is not below dwFrameTick
+  MOCK_METHOD1(seekToFrame, bool(DWORD));
+
   // Check if data was allocated correctly
   MOCK_CONST_METHOD0(isGood, bool());
 
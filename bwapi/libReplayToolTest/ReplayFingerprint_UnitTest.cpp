@@ -0,0 +1,240 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include "FileReader.h"
+#include "FileWriter.h"
+#include "PKShared.h"
+#include "RepHeader.h"
+#include "ReplayFingerprint.h"
+#include "ReplayIndex.h"
+
+using namespace std;
+using namespace testing;
+using namespace ReplayTool;
+
+#ifdef _WIN32
+#define REPLAYS_SOURCE_DIR                "TestData\\Replays"
+#define FINGERPRINT_TEMP_FILE             "TestData\\Fingerprint1.rep"
+#define FINGERPRINT_TEMP_FILE2            "TestData\\Fingerprint2.rep"
+#define FINGERPRINT_OUTPUT_FILE           "TestData\\Fingerprint.tmp"
+#else
+#define REPLAYS_SOURCE_DIR                "TestData/Replays"
+#define FINGERPRINT_TEMP_FILE             "TestData/Fingerprint1.rep"
+#define FINGERPRINT_TEMP_FILE2            "TestData/Fingerprint2.rep"
+#define FINGERPRINT_OUTPUT_FILE           "TestData/Fingerprint.tmp"
+#endif
+
+namespace
+{
+  // The decompressed sections of a replay
+  struct ReplaySections
+  {
+    DWORD dwRepResourceID;
+    replay_resource header;
+    vector<char> actions;
+    vector<char> chk;
+  };
+
+  bool readSection(FileReader &fr, vector<char> &section)
+  {
+    DWORD dwSize = 0;
+    if (!DecompressRead(&dwSize, sizeof(dwSize), fr))
+      return false;
+    section.resize(dwSize);
+    return dwSize == 0 || DecompressRead(&section[0], dwSize, fr);
+  }
+
+  bool readReplaySections(const char *pszPath, ReplaySections &replay)
+  {
+    FileReader fr;
+    fr.SetQuiet(true);
+    return fr.Open(pszPath) &&
+           DecompressRead(&replay.dwRepResourceID, sizeof(replay.dwRepResourceID), fr) &&
+           DecompressRead(&replay.header, sizeof(replay.header), fr) &&
+           readSection(fr, replay.actions) && readSection(fr, replay.chk);
+  }
+
+  bool writeReplaySections(const char *pszPath, ReplaySections &replay, CompressLevel level)
+  {
+    FileWriter fw;
+    if (!fw.Open(pszPath))
+      return false;
+
+    DWORD sizes[2] = { (DWORD)replay.actions.size(), (DWORD)replay.chk.size() };
+    CompressWrite(&replay.dwRepResourceID, sizeof(replay.dwRepResourceID), fw, level);
+    CompressWrite(&replay.header, sizeof(replay.header), fw, level);
+    CompressWrite(&sizes[0], sizeof(sizes[0]), fw, level);
+    if (sizes[0])
+      CompressWrite(&replay.actions[0], sizes[0], fw, level);
+    CompressWrite(&sizes[1], sizeof(sizes[1]), fw, level);
+    if (sizes[1])
+      CompressWrite(&replay.chk[0], sizes[1], fw, level);
+    return true;
+  }
+
+  bool sameFile(const char *pszPath1, const char *pszPath2)
+  {
+    FileReader fr1, fr2;
+    if (!fr1.Open(pszPath1) || !fr2.Open(pszPath2) || fr1.Size() != fr2.Size())
+      return false;
+    return fr1.Size() == 0 || memcmp(fr1.ReadPtr(fr1.Size()), fr2.ReadPtr(fr2.Size()), fr1.Size()) == 0;
+  }
+}
+
+TEST(ReplayFingerprintTest, SameGameInAnotherFile)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  ReplayFingerprint original;
+  ASSERT_TRUE(readReplayFingerprint(replays[0].c_str(), original));
+  EXPECT_EQ(64u, original.toString().size());
+
+  // Saved by someone else and compressed differently, the file changes but the game does not
+  ReplaySections replay;
+  ASSERT_TRUE(readReplaySections(replays[0].c_str(), replay));
+  ASSERT_FALSE(replay.actions.empty());
+  strcpy_s(replay.header.networkGameHeader.szCurrentPlayerName, sizeof(replay.header.networkGameHeader.szCurrentPlayerName), "Observer");
+  ASSERT_TRUE(writeReplaySections(FINGERPRINT_TEMP_FILE, replay, CompressLevel_Best));
+  EXPECT_FALSE(sameFile(replays[0].c_str(), FINGERPRINT_TEMP_FILE));
+
+  ReplayFingerprint copy;
+  ASSERT_TRUE(readReplayFingerprint(FINGERPRINT_TEMP_FILE, copy));
+  EXPECT_TRUE(original == copy);
+  EXPECT_EQ(original.toString(), copy.toString());
+
+  // Without the actions, only the header is compared
+  ReplayFingerprint headerOnly;
+  ASSERT_TRUE(readReplayFingerprint(FINGERPRINT_TEMP_FILE, headerOnly, false));
+  EXPECT_EQ(0, memcmp(original.headerHash, headerOnly.headerHash, sizeof(original.headerHash)));
+  EXPECT_EQ(original.dwActionsSize, headerOnly.dwActionsSize);
+  EXPECT_EQ(0u, headerOnly.actionsHash);
+
+  // Another action is another game, with the same header
+  replay.actions[replay.actions.size() / 2] ^= 1;
+  ASSERT_TRUE(writeReplaySections(FINGERPRINT_TEMP_FILE, replay, CompressLevel_Fast));
+  ReplayFingerprint changed;
+  ASSERT_TRUE(readReplayFingerprint(FINGERPRINT_TEMP_FILE, changed));
+  EXPECT_EQ(0, memcmp(original.headerHash, changed.headerHash, sizeof(original.headerHash)));
+  EXPECT_NE(original.actionsHash, changed.actionsHash);
+  EXPECT_FALSE(original == changed);
+
+  // So is a game of another length
+  replay.actions[replay.actions.size() / 2] ^= 1;
+  ++replay.header.dwFrameCount;
+  ASSERT_TRUE(writeReplaySections(FINGERPRINT_TEMP_FILE, replay, CompressLevel_Fast));
+  ASSERT_TRUE(readReplayFingerprint(FINGERPRINT_TEMP_FILE, changed));
+  EXPECT_NE(0, memcmp(original.headerHash, changed.headerHash, sizeof(original.headerHash)));
+  EXPECT_EQ(original.actionsHash, changed.actionsHash);
+
+  EXPECT_FALSE(readReplayFingerprint(FINGERPRINT_OUTPUT_FILE, changed));
+  remove(FINGERPRINT_TEMP_FILE);
+}
+
+TEST(ReplayFingerprintTest, FindDuplicates)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  // A renamed copy, and a copy that someone else saved
+  ReplaySections replay;
+  ASSERT_TRUE(readReplaySections(replays[0].c_str(), replay));
+  ASSERT_TRUE(writeReplaySections(FINGERPRINT_TEMP_FILE, replay, CompressLevel_Fast));
+  strcpy_s(replay.header.networkGameHeader.szCurrentPlayerName, sizeof(replay.header.networkGameHeader.szCurrentPlayerName), "Observer");
+  ASSERT_TRUE(writeReplaySections(FINGERPRINT_TEMP_FILE2, replay, CompressLevel_Normal));
+
+  vector<DuplicateReplays> groups;
+  unsigned replayCount = 0;
+  findDuplicateReplays("TestData", groups, 0, &replayCount);
+  EXPECT_EQ(replays.size() + 2, replayCount);
+
+  // The same groups as from the full fingerprints of all replays
+  vector<string> allReplays;
+  findReplays("TestData", allReplays);
+  map< ReplayFingerprint, vector<string> > byFingerprint;
+  for (size_t i = 0; i < allReplays.size(); ++i)
+  {
+    ReplayFingerprint fingerprint;
+    if (readReplayFingerprint(allReplays[i].c_str(), fingerprint))
+      byFingerprint[fingerprint].push_back(allReplays[i]);
+  }
+
+  size_t expectedGroups = 0;
+  for (auto it = byFingerprint.begin(); it != byFingerprint.end(); ++it)
+  {
+    if (it->second.size() < 2)
+      continue;
+    ++expectedGroups;
+
+    bool found = false;
+    for (size_t g = 0; g < groups.size(); ++g)
+      found |= groups[g].fingerprint == it->first && groups[g].paths == it->second;
+    EXPECT_TRUE(found) << it->second[0];
+  }
+  EXPECT_EQ(expectedGroups, groups.size());
+
+  bool copiesFound = false;
+  for (size_t g = 0; g < groups.size(); ++g)
+  {
+    const vector<string> &paths = groups[g].paths;
+    if (find(paths.begin(), paths.end(), replays[0]) != paths.end())
+    {
+      copiesFound = find(paths.begin(), paths.end(), string(FINGERPRINT_TEMP_FILE)) != paths.end() &&
+                    find(paths.begin(), paths.end(), string(FINGERPRINT_TEMP_FILE2)) != paths.end();
+    }
+  }
+  EXPECT_TRUE(copiesFound);
+
+  // Every group is a line after the heading
+  unsigned duplicateCount = 0;
+  ASSERT_TRUE(writeDuplicateReplays("TestData", FINGERPRINT_OUTPUT_FILE, 0, NULL, &duplicateCount));
+  EXPECT_LE(2u, duplicateCount);
+  FileReader fr;
+  ASSERT_TRUE(fr.Open(FINGERPRINT_OUTPUT_FILE));
+  const char *pText = (const char*)fr.ReadPtr(fr.Size());
+  EXPECT_EQ(groups.size() + 1, (size_t)count(pText, pText + fr.Size(), '\n'));
+  fr.Free();
+
+  remove(FINGERPRINT_TEMP_FILE);
+  remove(FINGERPRINT_TEMP_FILE2);
+  remove(FINGERPRINT_OUTPUT_FILE);
+}
+
+TEST(ReplayFingerprintTest, DISABLED_DuplicateBenchmark)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  // Hashing the actions of every replay, against hashing only those of the replays whose headers match
+  auto begin = chrono::high_resolution_clock::now();
+  unsigned hashed = 0;
+  for (size_t i = 0; i < replays.size(); ++i)
+  {
+    ReplayFingerprint fingerprint;
+    hashed += readReplayFingerprint(replays[i].c_str(), fingerprint) ? 1 : 0;
+  }
+  auto allHashed = chrono::high_resolution_clock::now();
+
+  vector<DuplicateReplays> groups;
+  findDuplicateReplays(REPLAYS_SOURCE_DIR, groups, 1);
+  auto grouped = chrono::high_resolution_clock::now();
+
+  size_t duplicateCount = 0;
+  for (size_t g = 0; g < groups.size(); ++g)
+    duplicateCount += groups[g].paths.size() - 1;
+
+  double hashSeconds = chrono::duration<double>(allHashed - begin).count();
+  double groupSeconds = chrono::duration<double>(grouped - allHashed).count();
+  cout << "[ BENCHMARK ] " << hashed << " replays fingerprinted in " << hashSeconds * 1000 << " ms, grouped in "
+       << groupSeconds * 1000 << " ms on 1 thread: " << duplicateCount << " duplicates in " << groups.size() << " groups" << endl;
+}
@@ -0,0 +1,151 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ReplayIndex.h"
+#include "WorkStealingPool.h"
+
+using namespace std;
+using namespace testing;
+using namespace ReplayTool;
+
+#ifdef _WIN32
+#define REPLAYS_SOURCE_DIR                "TestData\\Replays"
+#define REPLAY_INDEX_TEMP_FILE            "TestData\\ReplayIndex.tmp"
+#else
+#define REPLAYS_SOURCE_DIR                "TestData/Replays"
+#define REPLAY_INDEX_TEMP_FILE            "TestData/ReplayIndex.tmp"
+#endif
+
+TEST(WorkStealingPoolTest, RunsEveryTaskOnce)
+{
+  vector< atomic<int> > calls(1000);
+  for (size_t i = 0; i < calls.size(); ++i)
+    calls[i] = 0;
+
+  // The first tasks are slow, so that the other threads steal the rest of the first share
+  WorkStealingPool pool(4);
+  EXPECT_EQ(4u, pool.getThreadCount());
+  pool.run(calls.size(), [&](size_t i)
+  {
+    if (i < 10)
+      this_thread::sleep_for(chrono::milliseconds(5));
+    ++calls[i];
+  });
+
+  for (size_t i = 0; i < calls.size(); ++i)
+    EXPECT_EQ(1, calls[i]) << "Task " << i;
+
+  // The pool can be reused, and does nothing without tasks
+  pool.run(0, [&](size_t i) { ++calls[i]; });
+  pool.run(3, [&](size_t i) { ++calls[i]; });
+  EXPECT_EQ(2, calls[2]);
+  EXPECT_EQ(1, calls[3]);
+}
+
+TEST(WorkStealingPoolTest, RethrowsTaskException)
+{
+  vector< atomic<int> > calls(100);
+  for (size_t i = 0; i < calls.size(); ++i)
+    calls[i] = 0;
+
+  // The other threads still run every task that the throwing one did not get to
+  WorkStealingPool pool(4);
+  EXPECT_THROW(pool.run(calls.size(), [&](size_t i)
+  {
+    if (i == 0)
+      throw runtime_error("task failed");
+    ++calls[i];
+  }), runtime_error);
+
+  for (size_t i = 1; i < calls.size(); ++i)
+    EXPECT_EQ(1, calls[i]) << "Task " << i;
+
+  pool.run(1, [&](size_t i) { ++calls[i]; });
+  EXPECT_EQ(1, calls[0]);
+}
+
+TEST(ReplayIndexTest, ReadReplayInfo)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  ReplayInfo info;
+  ASSERT_TRUE(readReplayInfo(replays[0].c_str(), info));
+  EXPECT_TRUE(info.valid);
+  EXPECT_FALSE(info.mapName.empty());
+  EXPECT_GT(info.frameCount, 0u);
+  EXPECT_GE(info.players.size(), 2u);
+  EXPECT_GT(info.actionCount, 0u);
+
+  // Player actions are a part of all actions, and so are the counts per opcode
+  unsigned playerActions = 0, opcodeActions = 0;
+  for (size_t i = 0; i < info.players.size(); ++i)
+  {
+    EXPECT_FALSE(info.players[i].name.empty());
+    playerActions += info.players[i].actionCount;
+  }
+  for (size_t i = 0; i < info.actionCounts.size(); ++i)
+    opcodeActions += info.actionCounts[i].second;
+  EXPECT_LE(playerActions, info.actionCount);
+  EXPECT_EQ(info.actionCount, opcodeActions);
+
+  EXPECT_FALSE(readReplayInfo(REPLAYS_SOURCE_DIR "/missing.rep", info));
+  EXPECT_FALSE(info.valid);
+}
+
+TEST(ReplayIndexTest, SameIndexOnAnyThreadCount)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  // The index is the same with one thread as with one thread per core
+  unsigned replayCount = 0, validCount = 0;
+  ASSERT_TRUE(indexReplays(REPLAYS_SOURCE_DIR, REPLAY_INDEX_TEMP_FILE, 1, &replayCount, &validCount));
+
+  ifstream serialFile(REPLAY_INDEX_TEMP_FILE);
+  string serialIndex((istreambuf_iterator<char>(serialFile)), istreambuf_iterator<char>());
+  serialFile.close();
+
+  ASSERT_TRUE(indexReplays(REPLAYS_SOURCE_DIR, REPLAY_INDEX_TEMP_FILE, 0, &replayCount, &validCount));
+
+  ifstream parallelFile(REPLAY_INDEX_TEMP_FILE);
+  string parallelIndex((istreambuf_iterator<char>(parallelFile)), istreambuf_iterator<char>());
+  parallelFile.close();
+  remove(REPLAY_INDEX_TEMP_FILE);
+
+  EXPECT_EQ(replays.size(), replayCount);
+  EXPECT_EQ(replays.size(), validCount);
+  EXPECT_EQ(serialIndex, parallelIndex);
+  EXPECT_EQ(replays.size() + 1, (size_t)count(parallelIndex.begin(), parallelIndex.end(), '\n'));
+}
+
+TEST(ReplayIndexTest, DISABLED_IndexReplaysBenchmark)
+{
+  unsigned replayCount = 0;
+  auto begin = chrono::high_resolution_clock::now();
+  ASSERT_TRUE(indexReplays(REPLAYS_SOURCE_DIR, REPLAY_INDEX_TEMP_FILE, 1, &replayCount));
+  auto middle = chrono::high_resolution_clock::now();
+
+  WorkStealingPool pool;
+  ASSERT_TRUE(indexReplays(REPLAYS_SOURCE_DIR, REPLAY_INDEX_TEMP_FILE, 0, &replayCount));
+  auto end = chrono::high_resolution_clock::now();
+  remove(REPLAY_INDEX_TEMP_FILE);
+
+  double serialSeconds = chrono::duration<double>(middle - begin).count();
+  double parallelSeconds = chrono::duration<double>(end - middle).count();
+  cout << "[ BENCHMARK ] " << replayCount << " replays indexed in " << serialSeconds * 1000 << " ms on 1 thread, "
+       << parallelSeconds * 1000 << " ms on " << pool.getThreadCount() << " threads: "
+       << replayCount / parallelSeconds << " replays/s" << endl;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include "FileReader.h"
+#include "PKShared.h"
+#include "RepHeader.h"
+
+#ifdef _WIN32
+#define REPLAYS_SOURCE_DIR                "TestData\\Replays"
+#else
+#define REPLAYS_SOURCE_DIR                "TestData/Replays"
+#endif
+
+// Reads the sections before the actions, leaving the reader at the compressed actions
+inline bool skipToActions(ReplayTool::FileReader &fr, DWORD &dwActionBufferSize)
+{
+  DWORD dwRepResourceID = 0;
+  ReplayTool::replay_resource replayHeader;
+  dwActionBufferSize = 0;
+  return DecompressRead(&dwRepResourceID, sizeof(dwRepResourceID), fr) &&
+         DecompressRead(&replayHeader, sizeof(replayHeader), fr) &&
+         DecompressRead(&dwActionBufferSize, sizeof(dwActionBufferSize), fr);
+}
+
+// Decompresses the action section of a replay
+inline bool readActionBuffer(const std::string &path, std::vector<BYTE> &buffer)
+{
+  ReplayTool::FileReader fr;
+  fr.SetQuiet(true);
+  DWORD dwActionBufferSize;
+  if (!fr.Open(path.c_str()) || !skipToActions(fr, dwActionBufferSize))
+    return false;
+
+  buffer.resize(dwActionBufferSize);
+  return dwActionBufferSize == 0 || DecompressRead(&buffer[0], dwActionBufferSize, fr);
+}
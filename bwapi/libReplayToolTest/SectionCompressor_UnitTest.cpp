@@ -0,0 +1,278 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DecompressStream.h"
+#include "FileReader.h"
+#include "FileWriter.h"
+#include "ParseReplayParams.h"
+#include "PKShared.h"
+#include "RepHeader.h"
+#include "Replay.h"
+#include "ReplayIndex.h"
+#include "SectionCompressor.h"
+
+using namespace std;
+using namespace testing;
+using namespace ReplayTool;
+
+#ifdef _WIN32
+#define REPLAYS_SOURCE_DIR                "TestData\\Replays"
+#define COMPRESS_TEMP_FILE                "TestData\\SectionCompressor.tmp"
+#define COMPRESS_TEMP_FILE2               "TestData\\SectionCompressor2.tmp"
+#else
+#define REPLAYS_SOURCE_DIR                "TestData/Replays"
+#define COMPRESS_TEMP_FILE                "TestData/SectionCompressor.tmp"
+#define COMPRESS_TEMP_FILE2               "TestData/SectionCompressor2.tmp"
+#endif
+
+namespace
+{
+  // The decompressed sections of a replay
+  struct ReplaySections
+  {
+    DWORD dwRepResourceID;
+    replay_resource header;
+    vector<char> actions;
+    vector<char> chk;
+  };
+
+  bool readSection(FileReader &fr, vector<char> &section)
+  {
+    DWORD dwSize = 0;
+    if (!DecompressRead(&dwSize, sizeof(dwSize), fr))
+      return false;
+    section.resize(dwSize);
+    return dwSize == 0 || DecompressRead(&section[0], dwSize, fr);
+  }
+
+  bool readReplaySections(const char *pszPath, ReplaySections &replay)
+  {
+    FileReader fr;
+    fr.SetQuiet(true);
+    return fr.Open(pszPath) &&
+           DecompressRead(&replay.dwRepResourceID, sizeof(replay.dwRepResourceID), fr) &&
+           DecompressRead(&replay.header, sizeof(replay.header), fr) &&
+           readSection(fr, replay.actions) && readSection(fr, replay.chk);
+  }
+
+  // Adds the sections in the order that Replay.cpp writes them
+  void addSections(SectionCompressor &compressor, ReplaySections &replay, DWORD sizes[2])
+  {
+    sizes[0] = (DWORD)replay.actions.size();
+    sizes[1] = (DWORD)replay.chk.size();
+    compressor.add(&replay.dwRepResourceID, sizeof(replay.dwRepResourceID));
+    compressor.add(&replay.header, sizeof(replay.header));
+    compressor.add(&sizes[0], sizeof(sizes[0]));
+    if (sizes[0])
+      compressor.add(&replay.actions[0], sizes[0]);
+    compressor.add(&sizes[1], sizeof(sizes[1]));
+    if (sizes[1])
+      compressor.add(&replay.chk[0], sizes[1]);
+  }
+
+  void compressWriteSections(FileWriter &fw, ReplaySections &replay, CompressLevel level)
+  {
+    DWORD sizes[2] = { (DWORD)replay.actions.size(), (DWORD)replay.chk.size() };
+    CompressWrite(&replay.dwRepResourceID, sizeof(replay.dwRepResourceID), fw, level);
+    CompressWrite(&replay.header, sizeof(replay.header), fw, level);
+    CompressWrite(&sizes[0], sizeof(sizes[0]), fw, level);
+    if (sizes[0])
+      CompressWrite(&replay.actions[0], sizes[0], fw, level);
+    CompressWrite(&sizes[1], sizeof(sizes[1]), fw, level);
+    if (sizes[1])
+      CompressWrite(&replay.chk[0], sizes[1], fw, level);
+  }
+
+  vector<char> readFile(const char *pszPath)
+  {
+    FileReader fr;
+    fr.SetQuiet(true);
+    vector<char> contents;
+    if (fr.Open(pszPath) && fr.Size() != 0)
+    {
+      contents.resize(fr.Size());
+      fr.Read(&contents[0], fr.Size());
+    }
+    return contents;
+  }
+
+  bool sameSections(const ReplaySections &a, const ReplaySections &b)
+  {
+    return a.dwRepResourceID == b.dwRepResourceID && memcmp(&a.header, &b.header, sizeof(a.header)) == 0 &&
+           a.actions == b.actions && a.chk == b.chk;
+  }
+}
+
+TEST(SectionCompressorTest, SameOutputAsCompressWrite)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  const CompressLevel levels[] = { CompressLevel_Fast, CompressLevel_Normal, CompressLevel_Best };
+  for (size_t r = 0; r < replays.size(); r += 20)
+  {
+    ReplaySections replay, readBack;
+    ASSERT_TRUE(readReplaySections(replays[r].c_str(), replay)) << replays[r];
+
+    for (int l = 0; l < 3; ++l)
+    {
+      {
+        FileWriter fw;
+        ASSERT_TRUE(fw.Open(COMPRESS_TEMP_FILE));
+        compressWriteSections(fw, replay, levels[l]);
+      }
+      {
+        FileWriter fw;
+        ASSERT_TRUE(fw.Open(COMPRESS_TEMP_FILE2));
+        SectionCompressor compressor(levels[l], 4);
+        DWORD sizes[2];
+        addSections(compressor, replay, sizes);
+        compressor.write(fw);
+      }
+      EXPECT_TRUE(readFile(COMPRESS_TEMP_FILE) == readFile(COMPRESS_TEMP_FILE2)) << replays[r] << ", level " << levels[l];
+
+      // Both readers read the sections back
+      ASSERT_TRUE(readReplaySections(COMPRESS_TEMP_FILE2, readBack)) << replays[r] << ", level " << levels[l];
+      EXPECT_TRUE(sameSections(replay, readBack)) << replays[r] << ", level " << levels[l];
+    }
+  }
+  remove(COMPRESS_TEMP_FILE);
+  remove(COMPRESS_TEMP_FILE2);
+}
+
+TEST(SectionCompressorTest, StoresIncompressibleChunks)
+{
+  // Noise does not get smaller, so every chunk but the compressible last one is stored as it is
+  vector<char> data(3 * SECTION_CHUNK_SIZE + 500);
+  unsigned seed = 1234;
+  for (size_t i = 0; i < 3 * SECTION_CHUNK_SIZE; ++i)
+  {
+    seed = seed * 1103515245 + 12345;
+    data[i] = (char)(seed >> 16);
+  }
+
+  {
+    FileWriter fw;
+    ASSERT_TRUE(fw.Open(COMPRESS_TEMP_FILE));
+    SectionCompressor compressor(CompressLevel_Best, 2);
+    compressor.add(&data[0], data.size());
+    compressor.write(fw);
+  }
+
+  FileReader fr;
+  ASSERT_TRUE(fr.Open(COMPRESS_TEMP_FILE));
+  EXPECT_GT(fr.Size(), sizeof(_Part) + 4 * sizeof(DWORD) + 3 * SECTION_CHUNK_SIZE);
+  EXPECT_LT(fr.Size(), sizeof(_Part) + 4 * sizeof(DWORD) + data.size());
+
+  vector<char> readBack(data.size());
+  ASSERT_TRUE(DecompressRead(&readBack[0], (DWORD)readBack.size(), fr));
+  EXPECT_TRUE(data == readBack);
+
+  FileReader fr2;
+  ASSERT_TRUE(fr2.Open(COMPRESS_TEMP_FILE));
+  vector<char> streamed;
+  DecompressStream stream;
+  EXPECT_TRUE(stream.read(fr2, (DWORD)data.size(), [&](const BYTE *pData, DWORD dwSize)
+  {
+    streamed.insert(streamed.end(), pData, pData + dwSize);
+    return true;
+  }));
+  EXPECT_TRUE(data == streamed);
+
+  fr.Free();
+  fr2.Free();
+  remove(COMPRESS_TEMP_FILE);
+}
+
+TEST(SectionCompressorTest, UnpackAndPack)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  ReplaySections original, packed;
+  ASSERT_TRUE(readReplaySections(replays[0].c_str(), original));
+  vector<char> contents = readFile(replays[0].c_str());
+  {
+    FileWriter fw;
+    ASSERT_TRUE(fw.Open(COMPRESS_TEMP_FILE));
+    fw.WriteRaw(&contents[0], contents.size());
+  }
+
+  ParseReplayParams params;
+  params.setReplayPath(COMPRESS_TEMP_FILE);
+  params.setOutRepoPath("TestData");
+  params.setCompressLevel(CompressLevel_Best);
+  ASSERT_TRUE(parseReplay(params, RFLAG_EXTRACT));
+  remove(COMPRESS_TEMP_FILE);
+  ASSERT_TRUE(packReplay(params));
+
+  ASSERT_TRUE(readReplaySections(COMPRESS_TEMP_FILE, packed));
+  EXPECT_TRUE(sameSections(original, packed));
+
+  remove(COMPRESS_TEMP_FILE);
+  remove(COMPRESS_TEMP_FILE ".hdr");
+  remove(COMPRESS_TEMP_FILE ".act");
+  remove(COMPRESS_TEMP_FILE ".chk");
+}
+
+TEST(SectionCompressorTest, DISABLED_CompressBenchmark)
+{
+  vector<string> replays;
+  findReplays(REPLAYS_SOURCE_DIR, replays);
+  ASSERT_FALSE(replays.empty());
+
+  vector<ReplaySections> sections(replays.size());
+  size_t inputSize = 0;
+  for (size_t r = 0; r < replays.size(); ++r)
+  {
+    ASSERT_TRUE(readReplaySections(replays[r].c_str(), sections[r]));
+    inputSize += sections[r].actions.size() + sections[r].chk.size();
+  }
+
+  // Every level serially with CompressWrite, then with a SectionCompressor on every core
+  const CompressLevel levels[] = { CompressLevel_Fast, CompressLevel_Normal, CompressLevel_Best };
+  const char *names[] = { "fast", "normal", "best" };
+  unsigned threadCount = SectionCompressor().getThreadCount();
+  for (int l = 0; l < 3; ++l)
+  {
+    double seconds[2];
+    size_t outputSize = 0;
+    for (int parallel = 0; parallel < 2; ++parallel)
+    {
+      SectionCompressor compressor(levels[l]);
+      auto begin = chrono::high_resolution_clock::now();
+      for (size_t r = 0; r < sections.size(); ++r)
+      {
+        FileWriter fw;
+        ASSERT_TRUE(fw.Open(COMPRESS_TEMP_FILE));
+        if (parallel)
+        {
+          DWORD sizes[2];
+          addSections(compressor, sections[r], sizes);
+          compressor.write(fw);
+        }
+        else
+        {
+          compressWriteSections(fw, sections[r], levels[l]);
+          fw.Close();
+          FileReader fr;
+          ASSERT_TRUE(fr.Open(COMPRESS_TEMP_FILE));
+          outputSize += fr.Size();
+        }
+      }
+      seconds[parallel] = chrono::duration<double>(chrono::high_resolution_clock::now() - begin).count();
+    }
+
+    cout << "[ BENCHMARK ] " << sections.size() << " replays, " << inputSize / 1024 << " KB packed to "
+         << outputSize / 1024 << " KB at level " << names[l] << ": " << seconds[0] * 1000 << " ms serially, "
+         << seconds[1] * 1000 << " ms on " << threadCount << " threads" << endl;
+  }
+  remove(COMPRESS_TEMP_FILE);
+}